@@ -3,9 +3,18 @@
 #version 330 core
 in vec4 Fragment_Color;
 
+#if defined(TEXTURED)
+in vec3 Fragment_Texture_Coordinate;
+uniform sampler2DArray Texture_Array;
+#endif
+
 out vec4 Out_Color;
 
 void main(void)
 {
+#if defined(TEXTURED)
+   Out_Color = Fragment_Color * texture(Texture_Array, Fragment_Texture_Coordinate);
+#else
    Out_Color = Fragment_Color;
+#endif
 };
@@ -1,13 +1,54 @@
 /* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
 
 #version 330 core
-layout(location = 0) in vec3 Vertex_Position;
+layout(location = 0) in vec2 Vertex_Position;
 layout(location = 1) in vec4 Vertex_Color;
 
+// NOTE: INSTANCED reads a per-instance transform, color and material from
+// attributes with a divisor of 1. PER_OBJECT takes the same values from the
+// object uniform block (see uniforms.glsl), which is the naive
+// one-draw-per-object path it's compared with.
+#if defined(INSTANCED)
+layout(location = 2) in vec4 Instance_Basis;
+layout(location = 3) in vec4 Instance_Color;
+layout(location = 4) in vec2 Instance_Offset;
+layout(location = 5) in uint Instance_Material;
+#endif
+
 out vec4 Fragment_Color;
 
+// NOTE: TEXTURED samples a texture array, with the instance's material as the
+// layer and the unit quad's position as the texture coordinate.
+#if defined(TEXTURED)
+#if !defined(INSTANCED) && !defined(PER_OBJECT)
+#error TEXTURED needs a per-instance material to pick the layer.
+#endif
+out vec3 Fragment_Texture_Coordinate;
+#endif
+
+#if defined(INSTANCED) || defined(PER_OBJECT)
+const vec4 Material_Tints[4] = vec4[4](vec4(1.0f, 1.0f, 1.0f, 1.0f),
+                                       vec4(1.0f, 0.5f, 0.5f, 1.0f),
+                                       vec4(0.5f, 1.0f, 0.5f, 1.0f),
+                                       vec4(0.5f, 0.5f, 1.0f, 1.0f));
+#endif
+
 void main(void)
 {
-   Fragment_Color = Vertex_Color;
-   gl_Position = vec4(Vertex_Position.x, Vertex_Position.y, Vertex_Position.z, 1.0f);
+#if defined(INSTANCED) || defined(PER_OBJECT)
+   vec2 Position = (Instance_Offset +
+                    Vertex_Position.x*Instance_Basis.xy +
+                    Vertex_Position.y*Instance_Basis.zw);
+
+#if defined(TEXTURED)
+   Fragment_Color = Vertex_Color * Instance_Color * Pass_Tint;
+   Fragment_Texture_Coordinate = vec3(Vertex_Position.xy + 0.5f, float(Instance_Material));
+#else
+   Fragment_Color = Vertex_Color * Instance_Color * Material_Tints[Instance_Material % 4u] * Pass_Tint;
+#endif
+   gl_Position = vec4(Apply_Camera(Position), 0.0f, 1.0f);
+#else
+   Fragment_Color = Vertex_Color * Pass_Tint;
+   gl_Position = vec4(Apply_Camera(Vertex_Position), 0.0f, 1.0f);
+#endif
 };
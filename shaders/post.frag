@@ -0,0 +1,48 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+#version 330 core
+in vec2 Fragment_Texture_Coordinate;
+
+uniform sampler2DArray Source;
+uniform vec4 Tint;
+
+out vec4 Out_Color;
+
+// NOTE: Without a define this is a copy. BRIGHT keeps what is brighter than
+// the threshold, scaled down evenly so the hue stays. BLUR_X and BLUR_Y are
+// the two halves of a separable 9 tap gaussian.
+#define BRIGHT_THRESHOLD 0.6f
+
+vec4 Sample(vec2 Offset)
+{
+   return(texture(Source, vec3(Fragment_Texture_Coordinate + Offset, 0.0f)));
+}
+
+void main(void)
+{
+#if defined(BRIGHT)
+   vec4 Color = Sample(vec2(0.0f));
+   float Brightness = max(Color.r, max(Color.g, Color.b));
+   float Scale = max(Brightness - BRIGHT_THRESHOLD, 0.0f) / max(Brightness, 1e-5f);
+   Out_Color = vec4(Color.rgb*Scale, 1.0f);
+#elif defined(BLUR_X) || defined(BLUR_Y)
+   const float Weights[5] = float[5](0.227027f, 0.1945946f, 0.1216216f, 0.054054f, 0.016216f);
+   vec2 Texel = 1.0f / vec2(textureSize(Source, 0).xy);
+#if defined(BLUR_X)
+   vec2 Step = vec2(Texel.x, 0.0f);
+#else
+   vec2 Step = vec2(0.0f, Texel.y);
+#endif
+
+   vec3 Sum = Sample(vec2(0.0f)).rgb*Weights[0];
+   for(int Tap = 1; Tap < 5; ++Tap)
+   {
+      Sum += (Sample(Step*float(Tap)).rgb + Sample(-Step*float(Tap)).rgb)*Weights[Tap];
+   }
+   Out_Color = vec4(Sum, 1.0f);
+#else
+   Out_Color = Sample(vec2(0.0f));
+#endif
+
+   Out_Color *= Tint;
+};
@@ -0,0 +1,14 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+#version 330 core
+out vec2 Fragment_Texture_Coordinate;
+
+void main(void)
+{
+   // NOTE: One triangle twice the size of the target covers all of it, with
+   // the corners picked by the vertex index, so there are no attributes.
+   vec2 Corner = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+
+   Fragment_Texture_Coordinate = Corner;
+   gl_Position = vec4(Corner*2.0f - 1.0f, 0.0f, 1.0f);
+};
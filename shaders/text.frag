@@ -0,0 +1,21 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+#version 330 core
+in vec4 Fragment_Color;
+in vec2 Fragment_Texture_Coordinate;
+
+uniform sampler2DArray Glyph_Atlas;
+
+out vec4 Out_Color;
+
+void main(void)
+{
+   // NOTE: The atlas holds a signed distance field with the glyph's edge at
+   // 0.5. Blending across however much it changes over one pixel keeps the
+   // edge a pixel wide at any size.
+   float Distance = texture(Glyph_Atlas, vec3(Fragment_Texture_Coordinate, 0.0f)).r - 0.5f;
+   float Width = max(fwidth(Distance), 1e-5f);
+   float Coverage = clamp(Distance / Width + 0.5f, 0.0f, 1.0f);
+
+   Out_Color = vec4(Fragment_Color.rgb, Fragment_Color.a * Coverage);
+};
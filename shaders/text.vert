@@ -0,0 +1,27 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+#version 330 core
+layout(location = 0) in vec4 Glyph_Rectangle; // NOTE: Min in XY, max in ZW, in pixels.
+layout(location = 1) in vec4 Glyph_Color;
+layout(location = 2) in uint Glyph_Slot;
+
+// NOTE: Two over the viewport size, which takes pixels to clip space.
+uniform vec2 Pixel_Scale;
+
+out vec4 Fragment_Color;
+out vec2 Fragment_Texture_Coordinate;
+
+#define ATLAS_COLUMNS 16u // NOTE: OPENGL_TEXT_ATLAS_COLUMNS on the CPU side.
+
+void main(void)
+{
+   // NOTE: Each glyph is a four vertex strip, and the vertex index picks the
+   // corner of both its rectangle and its atlas cell.
+   vec2 Corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));
+   vec2 Position = mix(Glyph_Rectangle.xy, Glyph_Rectangle.zw, Corner);
+   vec2 Cell = vec2(float(Glyph_Slot % ATLAS_COLUMNS), float(Glyph_Slot / ATLAS_COLUMNS));
+
+   Fragment_Color = Glyph_Color * Pass_Tint;
+   Fragment_Texture_Coordinate = (Cell + Corner) / float(ATLAS_COLUMNS);
+   gl_Position = vec4(Position*Pixel_Scale - 1.0f, 0.0f, 1.0f);
+};
@@ -0,0 +1,53 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Uniform blocks shared by every program, spliced in after the defines.
+// The layouts are std140 and mirrored by the opengl_*_uniforms structs in
+// opengl_renderer.h, so the two have to change together. Binding points are
+// assigned by name when a program is linked.
+layout(std140) uniform Camera_Uniforms
+{
+   vec4 Camera_Transform; // NOTE: Scale in XY, translation in ZW.
+};
+
+layout(std140) uniform Pass_Uniforms
+{
+   vec4 Pass_Tint;
+   uint Pass_Uses_Camera;
+};
+
+// NOTE: Only PER_OBJECT programs declare the object block. It holds a range
+// of OBJECT_UNIFORMS_PER_RANGE objects (OPENGL_OBJECT_UNIFORMS_PER_RANGE on
+// the CPU side), and each draw picks its own with Object_Index.
+#if defined(PER_OBJECT)
+#define OBJECT_UNIFORMS_PER_RANGE 256
+
+struct object_uniforms
+{
+   vec4 Basis;
+   vec4 Color;
+   vec2 Offset;
+   uint Material;
+};
+
+layout(std140) uniform Object_Uniforms
+{
+   object_uniforms Objects[OBJECT_UNIFORMS_PER_RANGE];
+};
+
+uniform uint Object_Index;
+
+#define Instance_Basis Objects[Object_Index].Basis
+#define Instance_Color Objects[Object_Index].Color
+#define Instance_Offset Objects[Object_Index].Offset
+#define Instance_Material Objects[Object_Index].Material
+#endif
+
+vec2 Apply_Camera(vec2 Position)
+{
+   vec2 Result = Position;
+   if(Pass_Uses_Camera != 0u)
+   {
+      Result = Position*Camera_Transform.xy + Camera_Transform.zw;
+   }
+   return(Result);
+}
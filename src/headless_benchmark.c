@@ -0,0 +1,509 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: The headless app's benchmark suite (-bench results.json, or make
+// bench). It runs a fixed set of synthetic scenes, each stressing one part
+// of the renderer, for the same number of frames every time:
+//
+//    tiny_draws:  thousands of single quad draws, so per-draw CPU cost dominates
+//    huge_mesh:   a few draws of one large mesh, bound by vertex processing
+//    state_churn: draws that switch vertex arrays on every call
+//    streaming:   dynamic vertices and instance data rewritten every frame
+//    fill_rate:   stacked full-screen blended quads, bound by pixel throughput
+//    text:        100k glyphs of text rewritten every frame, in one draw
+//
+// Each scene gets BENCHMARK_WARMUP_FRAMES untimed frames first, so that
+// programs, caches and the stream ring have settled. Every frame ends in a
+// glFinish, so that frame times include the work llvmpipe does on its own
+// threads rather than only what it costs to queue it. Results go to a JSON
+// file with one value per line, so two runs diff cleanly.
+//
+// With -software (make software_bench), every scene is run again on the
+// software backend, and one extra frame is rendered by both and compared, so
+// the speedup over llvmpipe is reported next to how far the images differ.
+// The software backend doesn't draw text, so its text scene only measures
+// laying the glyphs out, and its image is expected to differ.
+
+#define BENCHMARK_WARMUP_FRAMES 8
+
+#define BENCHMARK_TINY_DRAW_COUNT 16384
+#define BENCHMARK_GRID_SIZE 256 // NOTE: Vertices per side, the most u16 indices can address.
+#define BENCHMARK_GRID_DRAW_COUNT 2
+#define BENCHMARK_CHURN_MESH_COUNT 64
+#define BENCHMARK_CHURN_DRAW_COUNT 4096
+#define BENCHMARK_CHURN_BATCH_COUNT 64
+#define BENCHMARK_CHURN_BATCH_SIZE 16
+#define BENCHMARK_STREAM_QUAD_COUNT 32768
+#define BENCHMARK_STREAM_INSTANCE_COUNT 8192
+#define BENCHMARK_FILL_LAYER_COUNT 16
+#define BENCHMARK_TEXT_GLYPH_COUNT 100000
+
+typedef enum {
+   Benchmark_Scene_Tiny_Draws,
+   Benchmark_Scene_Huge_Mesh,
+   Benchmark_Scene_State_Churn,
+   Benchmark_Scene_Streaming,
+   Benchmark_Scene_Fill_Rate,
+   Benchmark_Scene_Text,
+
+   Benchmark_Scene_Count,
+} benchmark_scene;
+
+static char *Benchmark_Scene_Names[Benchmark_Scene_Count] =
+{
+   "tiny_draws",
+   "huge_mesh",
+   "state_churn",
+   "streaming",
+   "fill_rate",
+   "text",
+};
+
+typedef struct {
+   opengl_mesh Grid_Mesh;
+   opengl_mesh Churn_Meshes[BENCHMARK_CHURN_MESH_COUNT];
+   opengl_instance_batch Churn_Batches[BENCHMARK_CHURN_BATCH_COUNT];
+   opengl_instance_batch Stream_Batch;
+
+   // NOTE: Uploads made by the scenes themselves. Everything else is counted
+   // by the renderer.
+   u64 Bytes_Uploaded;
+} benchmark_resources;
+
+typedef struct {
+   double Mean;
+   double Min;
+   double P50;
+   double P90;
+   double P99;
+   double Max;
+   double Draw_Calls;
+   double State_Calls;
+   u64 Bytes_Uploaded;
+   u64 Checksum;
+} benchmark_result;
+
+typedef struct {
+   benchmark_result Opengl;
+   benchmark_result Software;
+   headless_cross_check Cross_Check;
+} benchmark_comparison;
+
+static void Create_Benchmark_Grid(opengl_mesh *Mesh, arena *Arena)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   u32 Side = BENCHMARK_GRID_SIZE;
+   vertex *Vertices = Push_Array(Arena, Side*Side, vertex);
+   for(u32 Y = 0; Y < Side; ++Y)
+   {
+      for(u32 X = 0; X < Side; ++X)
+      {
+         vertex *Vertex = Vertices + Y*Side + X;
+         Vertex->Position.X = (float)X / (Side - 1) - 0.5f;
+         Vertex->Position.Y = (float)Y / (Side - 1) - 0.5f;
+         Vertex->Color = (vec4){(float)X / Side, (float)Y / Side, (float)((X ^ Y) & 1), 1.0f};
+      }
+   }
+
+   u32 Index_Count = (Side - 1)*(Side - 1)*6;
+   u16 *Indices = Push_Array(Arena, Index_Count, u16);
+   u16 *Index = Indices;
+   for(u32 Y = 0; Y < Side - 1; ++Y)
+   {
+      for(u32 X = 0; X < Side - 1; ++X)
+      {
+         u16 Corner = (u16)(Y*Side + X);
+         *Index++ = Corner;
+         *Index++ = (u16)(Corner + 1);
+         *Index++ = (u16)(Corner + Side + 1);
+         *Index++ = Corner;
+         *Index++ = (u16)(Corner + Side + 1);
+         *Index++ = (u16)(Corner + Side);
+      }
+   }
+
+   Initialize_Opengl_Mesh(Mesh, Vertices, Side*Side, Indices, Index_Count);
+   End_Temporary_Memory(Temporary);
+}
+
+static void Create_Benchmark_Polygon(opengl_mesh *Mesh, u32 Side_Count, vec4 Color)
+{
+   // NOTE: A triangle fan around the center, expressed as indices.
+   vertex Vertices[BENCHMARK_CHURN_MESH_COUNT + 3];
+   u16 Indices[(BENCHMARK_CHURN_MESH_COUNT + 2)*3];
+   Assert(Side_Count + 1 <= Array_Count(Vertices));
+
+   Vertices[0].Position = (vec2){0, 0};
+   Vertices[0].Color = Color;
+   for(u32 Side = 0; Side < Side_Count; ++Side)
+   {
+      float Angle = 2.0f*3.14159265f*(float)Side / (float)Side_Count;
+      Vertices[Side + 1].Position = (vec2){0.5f*cosf(Angle), 0.5f*sinf(Angle)};
+      Vertices[Side + 1].Color = Color;
+
+      Indices[Side*3 + 0] = 0;
+      Indices[Side*3 + 1] = (u16)(Side + 1);
+      Indices[Side*3 + 2] = (u16)(((Side + 1) % Side_Count) + 1);
+   }
+
+   Initialize_Opengl_Mesh(Mesh, Vertices, Side_Count + 1, Indices, Side_Count*3);
+}
+
+static void Create_Benchmark_Resources(benchmark_resources *Resources, opengl_context *GL, arena *Arena)
+{
+   Create_Benchmark_Grid(&Resources->Grid_Mesh, Arena);
+
+   for(u32 Index = 0; Index < BENCHMARK_CHURN_MESH_COUNT; ++Index)
+   {
+      vec4 Color = {(float)Index / BENCHMARK_CHURN_MESH_COUNT, 0.5f, 1.0f - (float)Index / BENCHMARK_CHURN_MESH_COUNT, 1.0f};
+      Create_Benchmark_Polygon(Resources->Churn_Meshes + Index, Index + 3, Color);
+   }
+
+   // NOTE: Every batch gets its own vertex array and instance buffer, even
+   // though they all draw the same quad.
+   for(u32 Index = 0; Index < BENCHMARK_CHURN_BATCH_COUNT; ++Index)
+   {
+      opengl_instance *Instances = Build_Test_Instances(Arena, BENCHMARK_CHURN_BATCH_SIZE);
+      Initialize_Opengl_Instance_Batch(Resources->Churn_Batches + Index, &GL->Quad_Mesh, Instances, BENCHMARK_CHURN_BATCH_SIZE);
+   }
+
+   opengl_instance *Instances = Build_Test_Instances(Arena, BENCHMARK_STREAM_INSTANCE_COUNT);
+   Initialize_Opengl_Instance_Batch(&Resources->Stream_Batch, &GL->Quad_Mesh, Instances, BENCHMARK_STREAM_INSTANCE_COUNT);
+}
+
+static void Destroy_Benchmark_Resources(benchmark_resources *Resources)
+{
+   Destroy_Opengl_Mesh(&Resources->Grid_Mesh);
+   for(u32 Index = 0; Index < BENCHMARK_CHURN_MESH_COUNT; ++Index)
+   {
+      Destroy_Opengl_Mesh(Resources->Churn_Meshes + Index);
+   }
+   for(u32 Index = 0; Index < BENCHMARK_CHURN_BATCH_COUNT; ++Index)
+   {
+      Destroy_Opengl_Instance_Batch(Resources->Churn_Batches + Index);
+   }
+   Destroy_Opengl_Instance_Batch(&Resources->Stream_Batch);
+}
+
+static void Push_Benchmark_Scene(opengl_context *GL, headless_context *Headless, platform_memory *Memory, benchmark_resources *Resources, benchmark_scene Scene, int Frame_Index)
+{
+   vec4 Background = {0.1f, 0.1f, 0.1f, 1.0f};
+   Push_Render_Clear(GL, Render_Pass_Scene, Background);
+
+   opengl_material Material = {0};
+   Material.Program = GL->Per_Object_Program;
+
+   switch(Scene)
+   {
+      case Benchmark_Scene_Tiny_Draws:
+      {
+         Record_Test_Objects_In_Parallel(GL, &Memory->Frame, BENCHMARK_TINY_DRAW_COUNT, Frame_Index, 0);
+      } break;
+
+      case Benchmark_Scene_Huge_Mesh:
+      {
+         // NOTE: Overlapping copies, so every draw covers most of the view.
+         for(int Index = 0; Index < BENCHMARK_GRID_DRAW_COUNT; ++Index)
+         {
+            float Angle = (float)Frame_Index*0.02f + (float)Index;
+            float Scale = 1.6f - 0.2f*Index;
+
+            opengl_instance Instance = {0};
+            Instance.Basis_X = (vec2){cosf(Angle)*Scale, sinf(Angle)*Scale};
+            Instance.Basis_Y = (vec2){-sinf(Angle)*Scale, cosf(Angle)*Scale};
+            Instance.Color = (vec4){1, 1, 1, 1};
+
+            Push_Render_Mesh(GL, Render_Pass_Scene, Material, &Resources->Grid_Mesh, Instance, (float)Index / BENCHMARK_GRID_DRAW_COUNT);
+         }
+      } break;
+
+      case Benchmark_Scene_State_Churn:
+      {
+         // NOTE: Consecutive depths cycle through the meshes, so the sorted
+         // order binds a different vertex array for every draw.
+         int Columns = (int)sqrtf((float)BENCHMARK_CHURN_DRAW_COUNT);
+         float Cell = 2.0f / Columns;
+         for(int Index = 0; Index < BENCHMARK_CHURN_DRAW_COUNT; ++Index)
+         {
+            opengl_instance Instance = {0};
+            Instance.Basis_X.X = Cell;
+            Instance.Basis_Y.Y = Cell;
+            Instance.Color = (vec4){1, 1, 1, 1};
+            Instance.Offset.X = -1.0f + ((Index % Columns) + 0.5f)*Cell;
+            Instance.Offset.Y = -1.0f + ((Index / Columns) + 0.5f)*Cell;
+
+            opengl_mesh *Mesh = Resources->Churn_Meshes + ((Index + Frame_Index) % BENCHMARK_CHURN_MESH_COUNT);
+            Push_Render_Mesh(GL, Render_Pass_Scene, Material, Mesh, Instance, (float)Index / BENCHMARK_CHURN_DRAW_COUNT);
+         }
+
+         for(int Index = 0; Index < BENCHMARK_CHURN_BATCH_COUNT; ++Index)
+         {
+            Push_Instance_Batch(GL, Resources->Churn_Batches + Index);
+         }
+      } break;
+
+      case Benchmark_Scene_Streaming:
+      {
+         Push_Test_Quads(GL, BENCHMARK_STREAM_QUAD_COUNT, Frame_Index);
+
+         // NOTE: Every instance is moved and reuploaded, as if simulated.
+         opengl_instance_batch *Batch = &Resources->Stream_Batch;
+         float Drift = 0.001f*((Frame_Index % 2) ? 1.0f : -1.0f);
+         for(u32 Index = 0; Index < Batch->Count; ++Index)
+         {
+            Batch->Instances[Index].Offset.X += Drift;
+         }
+         Update_Opengl_Instance_Batch(Batch, 0, Batch->Count);
+         Resources->Bytes_Uploaded += (u64)Batch->Count*sizeof(opengl_instance);
+
+         Push_Instance_Batch(GL, Batch);
+      } break;
+
+      case Benchmark_Scene_Fill_Rate:
+      {
+         for(int Layer = 0; Layer < BENCHMARK_FILL_LAYER_COUNT; ++Layer)
+         {
+            float Shade = (float)Layer / BENCHMARK_FILL_LAYER_COUNT;
+            vec4 Color = {Shade, 1.0f - Shade, 0.5f, 0.1f};
+            Push_Quad(GL, (vec2){-1, -1}, (vec2){1, 1}, Color);
+         }
+      } break;
+
+      case Benchmark_Scene_Text:
+      {
+         Push_Test_Text(GL, BENCHMARK_TEXT_GLYPH_COUNT, Frame_Index, Headless->Height);
+      } break;
+
+      case Benchmark_Scene_Count: break;
+   }
+}
+
+static u64 Get_Benchmark_Uploaded_Bytes(opengl_context *GL, benchmark_resources *Resources)
+{
+   u64 Result = (GL->Vertex_Stream.Bytes_Pushed +
+                 GL->Uniform_Stream.Bytes_Pushed +
+                 GL->Meshes.Total_Bytes_Uploaded +
+                 GL->Textures.Bytes_Uploaded +
+                 GL->Text.Stream.Bytes_Pushed +
+                 GL->Text.Bytes_Uploaded +
+                 Resources->Bytes_Uploaded);
+   return(Result);
+}
+
+static u64 Checksum_Benchmark_Frame(arena *Arena, software_renderer *Software, int Width, int Height)
+{
+   // NOTE: Same hash as Consume_Readback_Frame, so changes in what a scene
+   // draws show up next to changes in how fast it draws it.
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   size Pixel_Count = (size)Width*(size)Height;
+   u32 *Pixels = Push_Array(Arena, Pixel_Count, u32);
+   if(Software)
+   {
+      Read_Software_Pixels(Software, (u8 *)Pixels);
+   }
+   else
+   {
+      Bind_Opengl_Buffer(GL_PIXEL_PACK_BUFFER, 0);
+      glReadPixels(0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, Pixels);
+   }
+
+   u64 Result = 0;
+   for(size Index = 0; Index < Pixel_Count; ++Index)
+   {
+      Result = (Result * 31) + Pixels[Index];
+   }
+
+   End_Temporary_Memory(Temporary);
+   return(Result);
+}
+
+static int Compare_Benchmark_Times(const void *A, const void *B)
+{
+   u64 Left = *(u64 *)A;
+   u64 Right = *(u64 *)B;
+   int Result = (Left > Right) - (Left < Right);
+   return(Result);
+}
+
+// NOTE: Renders with GL, or with Software when it's set.
+static benchmark_result Run_Benchmark_Scene(opengl_context *GL, software_renderer *Software, headless_context *Headless, platform_memory *Memory,
+                                            benchmark_resources *Resources, benchmark_scene Scene)
+{
+   benchmark_result Result = {0};
+
+   temporary_memory Temporary = Begin_Temporary_Memory(&Memory->Permanent);
+   u64 *Frame_Times = Push_Array(&Memory->Permanent, Headless->Frame_Count, u64);
+
+   u64 Uploaded_Before = 0;
+   u64 Draw_Calls = 0;
+   u64 State_Calls = 0;
+   for(int Frame_Index = 0; Frame_Index < BENCHMARK_WARMUP_FRAMES + Headless->Frame_Count; ++Frame_Index)
+   {
+      int Timed_Index = Frame_Index - BENCHMARK_WARMUP_FRAMES;
+      if(Timed_Index == 0)
+      {
+         Uploaded_Before = Get_Benchmark_Uploaded_Bytes(GL, Resources);
+      }
+
+      PROFILE_BEGIN_FRAME(&GL->Profiler);
+      u64 Frame_Start = Get_Clock();
+
+      Reset_Arena(&Memory->Frame);
+      Begin_Opengl_Frame(GL);
+      Push_Benchmark_Scene(GL, Headless, Memory, Resources, Scene, Frame_Index);
+      if(Software)
+      {
+         Render_With_Software(GL, Software);
+      }
+      else
+      {
+         Render_With_Opengl(GL);
+      }
+      glFinish();
+
+      if(Timed_Index >= 0)
+      {
+         Frame_Times[Timed_Index] = Get_Clock() - Frame_Start;
+         Draw_Calls += GL->Stats.Draw_Calls;
+         State_Calls += GL->Stats.State_Calls_Issued;
+      }
+
+      PROFILE_END_FRAME(&GL->Profiler);
+   }
+
+   Result.Bytes_Uploaded = Get_Benchmark_Uploaded_Bytes(GL, Resources) - Uploaded_Before;
+   Result.Draw_Calls = (double)Draw_Calls / Headless->Frame_Count;
+   Result.State_Calls = (double)State_Calls / Headless->Frame_Count;
+   Result.Checksum = Checksum_Benchmark_Frame(&Memory->Frame, Software, Headless->Width, Headless->Height);
+
+   u64 Total = 0;
+   for(int Index = 0; Index < Headless->Frame_Count; ++Index)
+   {
+      Total += Frame_Times[Index];
+   }
+   qsort(Frame_Times, Headless->Frame_Count, sizeof(u64), Compare_Benchmark_Times);
+
+   // NOTE: Nearest rank percentiles.
+   int Last = Headless->Frame_Count - 1;
+   Result.Mean = (double)Total / 1e6 / Headless->Frame_Count;
+   Result.Min = (double)Frame_Times[0] / 1e6;
+   Result.P50 = (double)Frame_Times[(Last*50) / 100] / 1e6;
+   Result.P90 = (double)Frame_Times[(Last*90) / 100] / 1e6;
+   Result.P99 = (double)Frame_Times[(Last*99) / 100] / 1e6;
+   Result.Max = (double)Frame_Times[Last] / 1e6;
+
+   End_Temporary_Memory(Temporary);
+   return(Result);
+}
+
+static void Cross_Check_Benchmark_Scene(opengl_context *GL, software_renderer *Software, headless_context *Headless, platform_memory *Memory,
+                                        benchmark_resources *Resources, benchmark_scene Scene, headless_cross_check *Check)
+{
+   Reset_Arena(&Memory->Frame);
+   Begin_Opengl_Frame(GL);
+   Push_Benchmark_Scene(GL, Headless, Memory, Resources, Scene, BENCHMARK_WARMUP_FRAMES + Headless->Frame_Count);
+   Render_With_Opengl(GL);
+   Render_With_Software(GL, Software);
+   Cross_Check_Software_Frame(Check, Software, &Memory->Frame);
+}
+
+static bool Run_Headless_Benchmark(opengl_context *GL, software_renderer *Software, headless_context *Headless, platform_memory *Memory)
+{
+   bool Result = false;
+
+   benchmark_resources Resources = {0};
+   Create_Benchmark_Resources(&Resources, GL, &Memory->Permanent);
+
+   benchmark_comparison Results[Benchmark_Scene_Count] = {0};
+   for(int Scene = 0; Scene < Benchmark_Scene_Count; ++Scene)
+   {
+      benchmark_comparison *Scene_Result = Results + Scene;
+      Scene_Result->Opengl = Run_Benchmark_Scene(GL, 0, Headless, Memory, &Resources, (benchmark_scene)Scene);
+
+      benchmark_result *Opengl = &Scene_Result->Opengl;
+      printf("%-12s %8.3f ms mean, %8.3f p50, %8.3f p99, %8.1f draw calls, %8.2f MB uploaded per frame\n",
+             Benchmark_Scene_Names[Scene], Opengl->Mean, Opengl->P50, Opengl->P99, Opengl->Draw_Calls,
+             (double)Opengl->Bytes_Uploaded / (1024.0*1024.0) / Headless->Frame_Count);
+
+      if(Software)
+      {
+         Scene_Result->Software = Run_Benchmark_Scene(GL, Software, Headless, Memory, &Resources, (benchmark_scene)Scene);
+         Cross_Check_Benchmark_Scene(GL, Software, Headless, Memory, &Resources, (benchmark_scene)Scene, &Scene_Result->Cross_Check);
+
+         benchmark_result *Result_Software = &Scene_Result->Software;
+         headless_cross_check *Check = &Scene_Result->Cross_Check;
+         printf("%-12s %8.3f ms mean, %8.3f p50, %8.3f p99 in software: %.2fx llvmpipe, %llu pixels off by more than one, max difference %u\n",
+                "", Result_Software->Mean, Result_Software->P50, Result_Software->P99, Opengl->Mean / Result_Software->Mean,
+                (unsigned long long)Check->Pixels_Mismatched, Check->Max_Difference);
+      }
+   }
+   GL_CHECK;
+
+   Destroy_Benchmark_Resources(&Resources);
+
+   FILE *File = fopen(Headless->Benchmark_Path, "w");
+   if(File)
+   {
+      fprintf(File, "{\n");
+      fprintf(File, "   \"renderer\": \"%s\",\n", glGetString(GL_RENDERER));
+      if(Software)
+      {
+         fprintf(File, "   \"software_simd\": \"%s\",\n", Simd_Level_Names[Software->Simd_Level]);
+      }
+      fprintf(File, "   \"width\": %d,\n", Headless->Width);
+      fprintf(File, "   \"height\": %d,\n", Headless->Height);
+      fprintf(File, "   \"warmup_frames\": %d,\n", BENCHMARK_WARMUP_FRAMES);
+      fprintf(File, "   \"frames\": %d,\n", Headless->Frame_Count);
+      fprintf(File, "   \"recording_threads\": %u,\n", Get_Thread_Count());
+      fprintf(File, "   \"scenes\":\n");
+      fprintf(File, "   [\n");
+      for(int Scene = 0; Scene < Benchmark_Scene_Count; ++Scene)
+      {
+         benchmark_result *Scene_Result = &Results[Scene].Opengl;
+         fprintf(File, "      {\n");
+         fprintf(File, "         \"name\": \"%s\",\n", Benchmark_Scene_Names[Scene]);
+         fprintf(File, "         \"frame_ms_mean\": %.4f,\n", Scene_Result->Mean);
+         fprintf(File, "         \"frame_ms_min\": %.4f,\n", Scene_Result->Min);
+         fprintf(File, "         \"frame_ms_p50\": %.4f,\n", Scene_Result->P50);
+         fprintf(File, "         \"frame_ms_p90\": %.4f,\n", Scene_Result->P90);
+         fprintf(File, "         \"frame_ms_p99\": %.4f,\n", Scene_Result->P99);
+         fprintf(File, "         \"frame_ms_max\": %.4f,\n", Scene_Result->Max);
+         fprintf(File, "         \"draw_calls_per_frame\": %.1f,\n", Scene_Result->Draw_Calls);
+         fprintf(File, "         \"state_calls_per_frame\": %.1f,\n", Scene_Result->State_Calls);
+         fprintf(File, "         \"bytes_uploaded\": %llu,\n", (unsigned long long)Scene_Result->Bytes_Uploaded);
+         fprintf(File, "         \"bytes_uploaded_per_frame\": %llu,\n", (unsigned long long)(Scene_Result->Bytes_Uploaded / Headless->Frame_Count));
+         if(Software)
+         {
+            benchmark_result *Result_Software = &Results[Scene].Software;
+            headless_cross_check *Check = &Results[Scene].Cross_Check;
+            fprintf(File, "         \"software_frame_ms_mean\": %.4f,\n", Result_Software->Mean);
+            fprintf(File, "         \"software_frame_ms_min\": %.4f,\n", Result_Software->Min);
+            fprintf(File, "         \"software_frame_ms_p50\": %.4f,\n", Result_Software->P50);
+            fprintf(File, "         \"software_frame_ms_p90\": %.4f,\n", Result_Software->P90);
+            fprintf(File, "         \"software_frame_ms_p99\": %.4f,\n", Result_Software->P99);
+            fprintf(File, "         \"software_frame_ms_max\": %.4f,\n", Result_Software->Max);
+            fprintf(File, "         \"software_speedup\": %.3f,\n", Scene_Result->Mean / Result_Software->Mean);
+            fprintf(File, "         \"software_pixels_compared\": %llu,\n", (unsigned long long)Check->Pixels_Compared);
+            fprintf(File, "         \"software_pixels_exact\": %llu,\n", (unsigned long long)Check->Pixels_Exact);
+            fprintf(File, "         \"software_pixels_mismatched\": %llu,\n", (unsigned long long)Check->Pixels_Mismatched);
+            fprintf(File, "         \"software_max_difference\": %u,\n", Check->Max_Difference);
+            fprintf(File, "         \"software_checksum\": \"%016llx\",\n", (unsigned long long)Result_Software->Checksum);
+         }
+         fprintf(File, "         \"checksum\": \"%016llx\"\n", (unsigned long long)Scene_Result->Checksum);
+         fprintf(File, "      }%s\n", (Scene + 1 < Benchmark_Scene_Count) ? "," : "");
+      }
+      fprintf(File, "   ]\n");
+      fprintf(File, "}\n");
+      fclose(File);
+
+      printf("Wrote %s\n", Headless->Benchmark_Path);
+      Result = true;
+   }
+   else
+   {
+      fprintf(stderr, "Failed to open %s for writing.\n", Headless->Benchmark_Path);
+   }
+
+   return(Result);
+}
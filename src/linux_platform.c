@@ -0,0 +1,771 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Implementation of the platform API shared by every Linux entry point
+// (main_wayland.c, main_headless.c). Anything specific to a window system
+// stays in its main file.
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+// NOTE: Main loops that block create the wake event up front and poll on it.
+// Until then Wake_Main_Thread has nothing to signal.
+static int Linux_Wake_Event = -1;
+
+static int Linux_Get_Wake_Handle(void)
+{
+   if(Linux_Wake_Event == -1)
+   {
+      Linux_Wake_Event = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+      Platform_Counters.Syscall_Count++;
+   }
+   return(Linux_Wake_Event);
+}
+
+static void Linux_Clear_Wake_Event(void)
+{
+   u64 Value;
+   while(read(Linux_Wake_Event, &Value, sizeof(Value)) > 0);
+}
+
+static WAKE_MAIN_THREAD(Wake_Main_Thread)
+{
+   // NOTE: Not counted, for the same reason as futex wakes in the job system:
+   // this can run on any thread, and it's signaling rather than I/O.
+   if(Linux_Wake_Event != -1)
+   {
+      u64 Value = 1;
+      write(Linux_Wake_Event, &Value, sizeof(Value));
+   }
+}
+
+static GET_CLOCK(Get_Clock)
+{
+   struct timespec Time;
+   clock_gettime(CLOCK_MONOTONIC, &Time);
+
+   u64 Result = (u64)Time.tv_sec*1000000000ull + (u64)Time.tv_nsec;
+   return(Result);
+}
+
+static INITIALIZE_MEMORY(Initialize_Memory)
+{
+   bool Result = false;
+
+   size Total_Size = Permanent_Size + Frame_Size;
+   u8 *Base = mmap(0, Total_Size, PROT_READ|PROT_WRITE, MAP_ANONYMOUS|MAP_PRIVATE, -1, 0);
+   Platform_Counters.Allocation_Count++;
+   Platform_Counters.Syscall_Count++;
+
+   if(Base != MAP_FAILED)
+   {
+      Initialize_Arena(&Memory->Permanent, Base, Permanent_Size);
+      Initialize_Arena(&Memory->Frame, Base + Permanent_Size, Frame_Size);
+      Result = true;
+   }
+   else
+   {
+      fprintf(stderr, "Failed to allocate %td bytes of platform memory.\n", Total_Size);
+   }
+
+   return(Result);
+}
+
+static READ_ENTIRE_FILE(Read_Entire_File)
+{
+   char *Result = 0;
+
+   int File = open(Path, O_RDONLY);
+   Platform_Counters.Syscall_Count++;
+   if(File != -1)
+   {
+      struct stat File_Information;
+      Platform_Counters.Syscall_Count++;
+      if(fstat(File, &File_Information) == 0)
+      {
+         size Arena_Used = Arena->Used;
+
+         size Total_Size = File_Information.st_size;
+         char *Contents = Push_Size(Arena, Total_Size+1);
+
+         size Total_Read = 0;
+         while(Total_Read < Total_Size)
+         {
+            size Single_Read = read(File, Contents+Total_Read, Total_Size-Total_Read);
+            Platform_Counters.Syscall_Count++;
+            if(Single_Read == 0)
+            {
+               break; // Done.
+            }
+            else if(Single_Read == -1)
+            {
+               fprintf(stderr, "Failed to read file %s.\n", Path);
+               break;
+            }
+            else
+            {
+               Total_Read += Single_Read;
+            }
+         }
+
+         if(Total_Read == Total_Size)
+         {
+            // NOTE: Null terminate.
+            Contents[Total_Size] = 0;
+            Result = Contents;
+            if(Size)
+            {
+               *Size = Total_Size;
+            }
+         }
+         else
+         {
+            Arena->Used = Arena_Used;
+         }
+      }
+      else
+      {
+         fprintf(stderr, "Failed to determine size of file %s.\n", Path);
+      }
+
+      close(File);
+      Platform_Counters.Syscall_Count++;
+   }
+   else
+   {
+      fprintf(stderr, "Failed to open file %s.\n", Path);
+   }
+
+   return(Result);
+}
+
+static MAP_ENTIRE_FILE(Map_Entire_File)
+{
+   void *Result = 0;
+
+   int File = open(Path, O_RDONLY);
+   Platform_Counters.Syscall_Count++;
+   if(File != -1)
+   {
+      struct stat File_Information;
+      Platform_Counters.Syscall_Count++;
+      if(fstat(File, &File_Information) == 0 && File_Information.st_size > 0)
+      {
+         // NOTE: MAP_POPULATE reads the whole file in up front, rather than
+         // leaving it to page faults wherever the mapping is first read.
+         size File_Size = File_Information.st_size;
+         void *Memory = mmap(0, File_Size, PROT_READ, MAP_PRIVATE|MAP_POPULATE, File, 0);
+         Platform_Counters.Syscall_Count++;
+         if(Memory != MAP_FAILED)
+         {
+            Result = Memory;
+            *Size = File_Size;
+         }
+         else
+         {
+            fprintf(stderr, "Failed to map file %s.\n", Path);
+         }
+      }
+
+      close(File);
+      Platform_Counters.Syscall_Count++;
+   }
+
+   return(Result);
+}
+
+static UNMAP_ENTIRE_FILE(Unmap_Entire_File)
+{
+   munmap(Memory, Size);
+   Platform_Counters.Syscall_Count++;
+}
+
+static FILE_EXISTS(File_Exists)
+{
+   bool Result = (access(Path, F_OK) == 0);
+   Platform_Counters.Syscall_Count++;
+
+   return(Result);
+}
+
+static WRITE_ENTIRE_FILE(Write_Entire_File)
+{
+   bool Result = false;
+
+   char Temporary_Path[512];
+   if(snprintf(Temporary_Path, sizeof(Temporary_Path), "%s.tmp", Path) < (int)sizeof(Temporary_Path))
+   {
+      int File = open(Temporary_Path, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+      Platform_Counters.Syscall_Count++;
+      if(File == -1 && errno == ENOENT)
+      {
+         // NOTE: Create the parent directory and try once more.
+         char Directory[512];
+         strcpy(Directory, Path);
+         char *Slash = strrchr(Directory, '/');
+         if(Slash)
+         {
+            *Slash = 0;
+            mkdir(Directory, 0755);
+            File = open(Temporary_Path, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+            Platform_Counters.Syscall_Count += 2;
+         }
+      }
+
+      if(File != -1)
+      {
+         u8 *Bytes = Data;
+         size Total_Written = 0;
+         while(Total_Written < Size)
+         {
+            size Single_Write = write(File, Bytes+Total_Written, Size-Total_Written);
+            Platform_Counters.Syscall_Count++;
+            if(Single_Write <= 0)
+            {
+               fprintf(stderr, "Failed to write file %s.\n", Path);
+               break;
+            }
+            Total_Written += Single_Write;
+         }
+         close(File);
+         Platform_Counters.Syscall_Count++;
+
+         if(Total_Written == Size && rename(Temporary_Path, Path) == 0)
+         {
+            Result = true;
+         }
+         else
+         {
+            unlink(Temporary_Path);
+         }
+         Platform_Counters.Syscall_Count++;
+      }
+      else
+      {
+         fprintf(stderr, "Failed to open file %s for writing.\n", Path);
+      }
+   }
+
+   return(Result);
+}
+
+#define LINUX_MAX_WATCHES 8
+#define LINUX_MAX_CHANGED_FILES 32
+#define LINUX_MAX_PATH 256
+
+typedef struct {
+   int Inotify;
+   int Watch_Count;
+   int Watch_Descriptors[LINUX_MAX_WATCHES];
+   char Watch_Paths[LINUX_MAX_WATCHES][LINUX_MAX_PATH];
+
+   int Changed_Count;
+   int Changed_Read_Index;
+   char Changed_Paths[LINUX_MAX_CHANGED_FILES][LINUX_MAX_PATH];
+} linux_file_watcher;
+
+static linux_file_watcher Linux_File_Watcher;
+
+static WATCH_DIRECTORY(Watch_Directory)
+{
+   bool Result = false;
+
+   linux_file_watcher *Watcher = &Linux_File_Watcher;
+   if(Watcher->Watch_Count == 0)
+   {
+      Watcher->Inotify = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+      Platform_Counters.Syscall_Count++;
+   }
+
+   if(Watcher->Inotify != -1 && Watcher->Watch_Count < LINUX_MAX_WATCHES && strlen(Path) < LINUX_MAX_PATH)
+   {
+      // NOTE: Editors either rewrite files in place (IN_CLOSE_WRITE) or write a
+      // new file and rename it over the old one (IN_MOVED_TO).
+      int Descriptor = inotify_add_watch(Watcher->Inotify, Path, IN_CLOSE_WRITE|IN_MOVED_TO);
+      Platform_Counters.Syscall_Count++;
+      if(Descriptor != -1)
+      {
+         int Index = Watcher->Watch_Count++;
+         Watcher->Watch_Descriptors[Index] = Descriptor;
+         strcpy(Watcher->Watch_Paths[Index], Path);
+         Result = true;
+      }
+      else
+      {
+         fprintf(stderr, "Failed to watch directory %s.\n", Path);
+      }
+   }
+
+   return(Result);
+}
+
+static GET_CHANGED_FILE(Get_Changed_File)
+{
+   char *Result = 0;
+
+   linux_file_watcher *Watcher = &Linux_File_Watcher;
+   if(Watcher->Changed_Read_Index < Watcher->Changed_Count)
+   {
+      Result = Watcher->Changed_Paths[Watcher->Changed_Read_Index++];
+   }
+
+   return(Result);
+}
+
+// NOTE: Returns the descriptor that becomes readable when a watched file
+// changes, for main loops that block in poll, or -1 if nothing is watched.
+static int Linux_Get_File_Watch_Handle(void)
+{
+   linux_file_watcher *Watcher = &Linux_File_Watcher;
+   int Result = (Watcher->Watch_Count > 0) ? Watcher->Inotify : -1;
+   return(Result);
+}
+
+static bool Linux_Poll_File_Watches(void)
+{
+   // NOTE: This is called by the main loop as part of event processing, next
+   // to the window system dispatch, so it is not counted as a renderer
+   // syscall. Changes are queued for Get_Changed_File until the next poll.
+   linux_file_watcher *Watcher = &Linux_File_Watcher;
+   Watcher->Changed_Count = 0;
+   Watcher->Changed_Read_Index = 0;
+
+   if(Watcher->Watch_Count > 0)
+   {
+      char Buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+      size Read_Size;
+      while((Read_Size = read(Watcher->Inotify, Buffer, sizeof(Buffer))) > 0)
+      {
+         for(char *At = Buffer; At < Buffer + Read_Size;)
+         {
+            struct inotify_event *Event = (struct inotify_event *)At;
+            At += sizeof(struct inotify_event) + Event->len;
+
+            char *Directory = 0;
+            for(int Index = 0; Index < Watcher->Watch_Count; ++Index)
+            {
+               if(Watcher->Watch_Descriptors[Index] == Event->wd)
+               {
+                  Directory = Watcher->Watch_Paths[Index];
+                  break;
+               }
+            }
+
+            if(Directory && Event->len > 0 && Watcher->Changed_Count < LINUX_MAX_CHANGED_FILES)
+            {
+               char Path[LINUX_MAX_PATH];
+               int Length = snprintf(Path, sizeof(Path), "%s/%s", Directory, Event->name);
+               if(Length > 0 && Length < (int)sizeof(Path))
+               {
+                  // NOTE: A single save usually produces several events.
+                  bool Duplicate = false;
+                  for(int Index = 0; Index < Watcher->Changed_Count; ++Index)
+                  {
+                     if(strcmp(Watcher->Changed_Paths[Index], Path) == 0)
+                     {
+                        Duplicate = true;
+                        break;
+                     }
+                  }
+
+                  if(!Duplicate)
+                  {
+                     strcpy(Watcher->Changed_Paths[Watcher->Changed_Count++], Path);
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   bool Result = (Watcher->Changed_Count > 0);
+   return(Result);
+}
+
+// NOTE: Work-stealing deques follow Chase and Lev, with the memory orderings
+// from "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et
+// al.). The owner pushes and pops at Bottom without contention; thieves race
+// each other (and the owner, for the last job) with a CAS on Top. Jobs are
+// copied out before the CAS, so a slot the owner reuses after a successful
+// steal is never read.
+#define LINUX_MAX_THREADS 64
+#define LINUX_JOB_QUEUE_SIZE 4096
+#define LINUX_JOB_SPIN_COUNT 4096
+#define LINUX_BACKGROUND_QUEUE_SIZE 256
+#define LINUX_BACKGROUND_THREAD_INDEX 0xFFFFFFFF
+
+typedef struct {
+   job_function *Function;
+   void *Data;
+   job_counter *Counter;
+} linux_job;
+
+typedef struct {
+   // NOTE: Top and Bottom sit on separate cache lines, since thieves hammer
+   // one and the owner the other.
+   _Alignas(64) _Atomic s64 Top;
+   _Alignas(64) _Atomic s64 Bottom;
+   _Alignas(64) linux_job Jobs[LINUX_JOB_QUEUE_SIZE];
+} linux_job_queue;
+
+typedef struct {
+   u32 Thread_Count;
+   linux_job_queue *Queues;
+   pthread_t Threads[LINUX_MAX_THREADS];
+
+   _Atomic bool Running;
+
+   // NOTE: Idle workers sleep on a futex. Wake_Sequence changes on every wake
+   // so a worker can't miss one between deciding to sleep and sleeping.
+   _Atomic u32 Wake_Sequence;
+   _Atomic u32 Sleeper_Count;
+
+   // NOTE: The background thread blocks on a condition variable instead.
+   // Its jobs are slow by definition, so there's nothing to gain by spinning.
+   bool Has_Background_Thread;
+   pthread_t Background_Thread;
+   pthread_mutex_t Background_Mutex;
+   pthread_cond_t Background_Condition;
+   u32 Background_Read_Index;
+   u32 Background_Write_Index;
+   linux_job Background_Jobs[LINUX_BACKGROUND_QUEUE_SIZE];
+} linux_job_system;
+
+static linux_job_system Linux_Jobs;
+static _Thread_local u32 Linux_Thread_Index;
+
+static inline void Linux_Spin_Pause(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+   __builtin_ia32_pause();
+#endif
+}
+
+static void Linux_Push_Job(linux_job_queue *Queue, linux_job Job)
+{
+   s64 Bottom = atomic_load_explicit(&Queue->Bottom, memory_order_relaxed);
+   s64 Top = atomic_load_explicit(&Queue->Top, memory_order_acquire);
+   Assert(Bottom - Top < LINUX_JOB_QUEUE_SIZE);
+
+   Queue->Jobs[Bottom & (LINUX_JOB_QUEUE_SIZE - 1)] = Job;
+   atomic_thread_fence(memory_order_release);
+   atomic_store_explicit(&Queue->Bottom, Bottom + 1, memory_order_relaxed);
+}
+
+static bool Linux_Pop_Job(linux_job_queue *Queue, linux_job *Job)
+{
+   bool Result = false;
+
+   s64 Bottom = atomic_load_explicit(&Queue->Bottom, memory_order_relaxed) - 1;
+   atomic_store_explicit(&Queue->Bottom, Bottom, memory_order_relaxed);
+   atomic_thread_fence(memory_order_seq_cst);
+   s64 Top = atomic_load_explicit(&Queue->Top, memory_order_relaxed);
+
+   if(Top <= Bottom)
+   {
+      *Job = Queue->Jobs[Bottom & (LINUX_JOB_QUEUE_SIZE - 1)];
+      Result = true;
+
+      if(Top == Bottom)
+      {
+         // NOTE: The last job, which a thief may be going for as well.
+         if(!atomic_compare_exchange_strong_explicit(&Queue->Top, &Top, Top + 1, memory_order_seq_cst, memory_order_relaxed))
+         {
+            Result = false;
+         }
+         atomic_store_explicit(&Queue->Bottom, Bottom + 1, memory_order_relaxed);
+      }
+   }
+   else
+   {
+      atomic_store_explicit(&Queue->Bottom, Bottom + 1, memory_order_relaxed);
+   }
+
+   return(Result);
+}
+
+static bool Linux_Steal_Job(linux_job_queue *Queue, linux_job *Job)
+{
+   bool Result = false;
+
+   s64 Top = atomic_load_explicit(&Queue->Top, memory_order_acquire);
+   atomic_thread_fence(memory_order_seq_cst);
+   s64 Bottom = atomic_load_explicit(&Queue->Bottom, memory_order_acquire);
+
+   if(Top < Bottom)
+   {
+      *Job = Queue->Jobs[Top & (LINUX_JOB_QUEUE_SIZE - 1)];
+      Result = atomic_compare_exchange_strong_explicit(&Queue->Top, &Top, Top + 1, memory_order_seq_cst, memory_order_relaxed);
+   }
+
+   return(Result);
+}
+
+static bool Linux_Find_Job(linux_job *Job)
+{
+   u32 Thread_Index = Linux_Thread_Index;
+   bool Result = Linux_Pop_Job(Linux_Jobs.Queues + Thread_Index, Job);
+
+   // NOTE: Victims are visited starting from the next thread over, so thieves
+   // spread out instead of all hitting thread 0 first.
+   for(u32 Offset = 1; !Result && Offset < Linux_Jobs.Thread_Count; ++Offset)
+   {
+      u32 Victim = (Thread_Index + Offset) % Linux_Jobs.Thread_Count;
+      Result = Linux_Steal_Job(Linux_Jobs.Queues + Victim, Job);
+   }
+
+   return(Result);
+}
+
+static void Linux_Run_Job(linux_job *Job)
+{
+   Job->Function(Job->Data);
+   atomic_fetch_sub_explicit(&Job->Counter->Pending, 1, memory_order_release);
+}
+
+static bool Linux_Has_Queued_Jobs(void)
+{
+   bool Result = false;
+   for(u32 Index = 0; !Result && Index < Linux_Jobs.Thread_Count; ++Index)
+   {
+      linux_job_queue *Queue = Linux_Jobs.Queues + Index;
+      Result = (atomic_load(&Queue->Top) < atomic_load(&Queue->Bottom));
+   }
+   return(Result);
+}
+
+static void *Linux_Worker_Thread(void *Parameter)
+{
+   Linux_Thread_Index = (u32)(size)Parameter;
+
+   u32 Idle_Count = 0;
+   while(atomic_load_explicit(&Linux_Jobs.Running, memory_order_acquire))
+   {
+      linux_job Job;
+      if(Linux_Find_Job(&Job))
+      {
+         Linux_Run_Job(&Job);
+         Idle_Count = 0;
+      }
+      else if(++Idle_Count < LINUX_JOB_SPIN_COUNT)
+      {
+         Linux_Spin_Pause();
+      }
+      else
+      {
+         // NOTE: Announce the sleep before the final check for work. A job
+         // pushed after that check sees the sleeper and bumps the sequence,
+         // which makes the futex wait return immediately.
+         u32 Sequence = atomic_load(&Linux_Jobs.Wake_Sequence);
+         atomic_fetch_add(&Linux_Jobs.Sleeper_Count, 1);
+         if(!Linux_Has_Queued_Jobs() && atomic_load(&Linux_Jobs.Running))
+         {
+            syscall(SYS_futex, &Linux_Jobs.Wake_Sequence, FUTEX_WAIT_PRIVATE, Sequence, 0, 0, 0);
+         }
+         atomic_fetch_sub(&Linux_Jobs.Sleeper_Count, 1);
+         Idle_Count = 0;
+      }
+   }
+
+   return(0);
+}
+
+static void *Linux_Background_Thread(void *Parameter)
+{
+   // NOTE: An index past every queue, so Start_Job's assert catches jobs
+   // started from here.
+   Linux_Thread_Index = LINUX_BACKGROUND_THREAD_INDEX;
+
+   pthread_mutex_lock(&Linux_Jobs.Background_Mutex);
+   for(;;)
+   {
+      if(Linux_Jobs.Background_Read_Index != Linux_Jobs.Background_Write_Index)
+      {
+         u32 Index = Linux_Jobs.Background_Read_Index++ % LINUX_BACKGROUND_QUEUE_SIZE;
+         linux_job Job = Linux_Jobs.Background_Jobs[Index];
+
+         pthread_mutex_unlock(&Linux_Jobs.Background_Mutex);
+         Linux_Run_Job(&Job);
+         pthread_mutex_lock(&Linux_Jobs.Background_Mutex);
+      }
+      else if(atomic_load(&Linux_Jobs.Running))
+      {
+         pthread_cond_wait(&Linux_Jobs.Background_Condition, &Linux_Jobs.Background_Mutex);
+      }
+      else
+      {
+         break;
+      }
+   }
+   pthread_mutex_unlock(&Linux_Jobs.Background_Mutex);
+
+   return(0);
+}
+
+static void Linux_Wake_Workers(int Count)
+{
+   atomic_fetch_add(&Linux_Jobs.Wake_Sequence, 1);
+   syscall(SYS_futex, &Linux_Jobs.Wake_Sequence, FUTEX_WAKE_PRIVATE, Count, 0, 0, 0);
+}
+
+static INITIALIZE_JOBS(Initialize_Jobs)
+{
+   bool Result = true;
+
+   if(Worker_Count == 0)
+   {
+      long Core_Count = sysconf(_SC_NPROCESSORS_ONLN);
+      Worker_Count = (Core_Count > 1) ? (u32)(Core_Count - 1) : 0;
+   }
+   if(Worker_Count > LINUX_MAX_THREADS - 1)
+   {
+      Worker_Count = LINUX_MAX_THREADS - 1;
+   }
+
+   u32 Thread_Count = Worker_Count + 1;
+   size Queue_Size = Thread_Count * sizeof(linux_job_queue);
+   linux_job_queue *Queues = mmap(0, Queue_Size, PROT_READ|PROT_WRITE, MAP_ANONYMOUS|MAP_PRIVATE, -1, 0);
+   Platform_Counters.Allocation_Count++;
+   Platform_Counters.Syscall_Count++;
+
+   if(Queues != MAP_FAILED)
+   {
+      Linux_Jobs.Queues = Queues;
+      Linux_Jobs.Thread_Count = 1;
+      Linux_Thread_Index = 0;
+      atomic_store(&Linux_Jobs.Running, true);
+
+      for(u32 Index = 1; Index < Thread_Count; ++Index)
+      {
+         if(pthread_create(Linux_Jobs.Threads + Index, 0, Linux_Worker_Thread, (void *)(size)Index) == 0)
+         {
+            Linux_Jobs.Thread_Count++;
+         }
+         else
+         {
+            fprintf(stderr, "Failed to start worker thread %u.\n", Index);
+            break;
+         }
+      }
+
+      pthread_mutex_init(&Linux_Jobs.Background_Mutex, 0);
+      pthread_cond_init(&Linux_Jobs.Background_Condition, 0);
+      if(pthread_create(&Linux_Jobs.Background_Thread, 0, Linux_Background_Thread, 0) == 0)
+      {
+         Linux_Jobs.Has_Background_Thread = true;
+      }
+      else
+      {
+         fprintf(stderr, "Failed to start the background thread.\n");
+         Result = false;
+      }
+   }
+   else
+   {
+      fprintf(stderr, "Failed to allocate job queues.\n");
+      Result = false;
+   }
+
+   return(Result);
+}
+
+static DESTROY_JOBS(Destroy_Jobs)
+{
+   if(Linux_Jobs.Queues)
+   {
+      atomic_store(&Linux_Jobs.Running, false);
+      Linux_Wake_Workers(LINUX_MAX_THREADS);
+
+      for(u32 Index = 1; Index < Linux_Jobs.Thread_Count; ++Index)
+      {
+         pthread_join(Linux_Jobs.Threads[Index], 0);
+      }
+
+      // NOTE: The background thread finishes whatever is still queued first.
+      if(Linux_Jobs.Has_Background_Thread)
+      {
+         pthread_mutex_lock(&Linux_Jobs.Background_Mutex);
+         pthread_cond_signal(&Linux_Jobs.Background_Condition);
+         pthread_mutex_unlock(&Linux_Jobs.Background_Mutex);
+         pthread_join(Linux_Jobs.Background_Thread, 0);
+      }
+      pthread_cond_destroy(&Linux_Jobs.Background_Condition);
+      pthread_mutex_destroy(&Linux_Jobs.Background_Mutex);
+
+      munmap(Linux_Jobs.Queues, Linux_Jobs.Thread_Count * sizeof(linux_job_queue));
+
+      linux_job_system Zero = {0};
+      Linux_Jobs = Zero;
+   }
+}
+
+static START_JOB(Start_Job)
+{
+   Assert(Linux_Jobs.Queues);
+   Assert(Linux_Thread_Index < Linux_Jobs.Thread_Count);
+
+   linux_job Job = {Function, Data, Counter};
+   atomic_fetch_add_explicit(&Counter->Pending, 1, memory_order_relaxed);
+   Linux_Push_Job(Linux_Jobs.Queues + Linux_Thread_Index, Job);
+
+   // NOTE: Futex wakes aren't counted as platform syscalls. They're the price
+   // of using the job system at all, not a per-frame allocation or I/O that
+   // the steady state checks are looking for.
+   atomic_thread_fence(memory_order_seq_cst);
+   if(atomic_load_explicit(&Linux_Jobs.Sleeper_Count, memory_order_relaxed) > 0)
+   {
+      Linux_Wake_Workers(1);
+   }
+}
+
+static WAIT_FOR_JOBS(Wait_For_Jobs)
+{
+   while(atomic_load_explicit(&Counter->Pending, memory_order_acquire) > 0)
+   {
+      linux_job Job;
+      if(Linux_Find_Job(&Job))
+      {
+         Linux_Run_Job(&Job);
+      }
+      else
+      {
+         Linux_Spin_Pause();
+      }
+   }
+}
+
+static START_BACKGROUND_JOB(Start_Background_Job)
+{
+   Assert(Linux_Jobs.Has_Background_Thread);
+
+   linux_job Job = {Function, Data, Counter};
+   atomic_fetch_add_explicit(&Counter->Pending, 1, memory_order_relaxed);
+
+   // NOTE: Not counted either; see Start_Job.
+   pthread_mutex_lock(&Linux_Jobs.Background_Mutex);
+   Assert(Linux_Jobs.Background_Write_Index - Linux_Jobs.Background_Read_Index < LINUX_BACKGROUND_QUEUE_SIZE);
+   Linux_Jobs.Background_Jobs[Linux_Jobs.Background_Write_Index++ % LINUX_BACKGROUND_QUEUE_SIZE] = Job;
+   pthread_cond_signal(&Linux_Jobs.Background_Condition);
+   pthread_mutex_unlock(&Linux_Jobs.Background_Mutex);
+}
+
+static GET_THREAD_INDEX(Get_Thread_Index)
+{
+   return(Linux_Thread_Index);
+}
+
+static GET_THREAD_COUNT(Get_Thread_Count)
+{
+   u32 Result = (Linux_Jobs.Thread_Count > 0) ? Linux_Jobs.Thread_Count : 1;
+   return(Result);
+}
@@ -0,0 +1,1518 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: This file is the entry point for the headless Linux build. It has no
+// window system dependency: EGL hands us a surfaceless context (or a pbuffer
+// when surfaceless isn't available), the renderer draws into an offscreen
+// framebuffer, and frames are optionally read back through a PBO ring. This
+// lets the renderer run on machines with no compositor, e.g. under llvmpipe.
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared.h"
+#include "platform.h"
+#include "mesh_format.h"
+#include "opengl_capture.h"
+#include "opengl_renderer.h"
+#include "software_renderer.h"
+#include "opengl_renderer.c"
+#include "software_renderer.c"
+#include "linux_platform.c"
+
+#define HEADLESS_MAX_MESHES 8
+
+typedef enum {
+   Pooled_Path_Indirect,
+   Pooled_Path_Cpu_Loop,
+   Pooled_Path_Per_Object,
+} pooled_path;
+
+typedef struct {
+   EGLDisplay Opengl_Display;
+   EGLConfig Opengl_Configuration;
+   EGLContext Opengl_Context;
+   EGLSurface Opengl_Surface;
+
+   int Width;
+   int Height;
+   int Frame_Count;
+   int Quad_Count;
+   int Instance_Count;
+   bool Draw_Naive;
+   int Object_Count;
+   int Worker_Count;
+   bool Cull_Enabled;
+   cull_mode Cull_Mode;
+   int Pooled_Count;
+   pooled_path Pooled_Path;
+   bool Readback_Enabled;
+   char *Output_Path;
+   char *Capture_Path;
+   char *Benchmark_Path;
+   bool Software_Enabled;
+   bool Cross_Check; // NOTE: Render with both backends and compare.
+   bool Damage_Enabled;
+   bool Hud_Enabled;
+   int Text_Count; // NOTE: Glyphs per frame.
+   int Text_Slots; // NOTE: Zero for the whole atlas.
+   bool Bloom_Enabled;
+   float Bloom_Intensity;
+
+   int Mesh_Count;
+   char *Mesh_Paths[HEADLESS_MAX_MESHES];
+   u32 Mesh_Handles[HEADLESS_MAX_MESHES];
+   int Mesh_Resident_Frames[HEADLESS_MAX_MESHES];
+   int Upload_Budget; // NOTE: In KB, zero for the renderer's default.
+
+   int Texture_Count;
+   int Texture_Budget; // NOTE: In MB, zero for the renderer's default.
+   u32 *Texture_Handles;
+} headless_context;
+
+static void Destroy_Headless(headless_context *Headless)
+{
+   if(Headless->Opengl_Display != EGL_NO_DISPLAY)
+   {
+      eglMakeCurrent(Headless->Opengl_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+   }
+   if(Headless->Opengl_Surface != EGL_NO_SURFACE)
+   {
+      eglDestroySurface(Headless->Opengl_Display, Headless->Opengl_Surface);
+   }
+   if(Headless->Opengl_Context != EGL_NO_CONTEXT)
+   {
+      eglDestroyContext(Headless->Opengl_Display, Headless->Opengl_Context);
+   }
+   if(Headless->Opengl_Display != EGL_NO_DISPLAY)
+   {
+      eglTerminate(Headless->Opengl_Display);
+   }
+}
+
+static EGLDisplay Get_Surfaceless_Display(void)
+{
+   EGLDisplay Result = EGL_NO_DISPLAY;
+
+   // NOTE: Client extensions are queried against EGL_NO_DISPLAY. Mesa exposes
+   // a surfaceless platform that needs neither a window system nor a DRM
+   // device, which is exactly what we want on CI and render farm machines.
+   const char *Client_Extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+   if(Client_Extensions && strstr(Client_Extensions, "EGL_MESA_platform_surfaceless"))
+   {
+      PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT =
+         (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+      if(eglGetPlatformDisplayEXT)
+      {
+         Result = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, 0);
+      }
+   }
+
+   return(Result);
+}
+
+static bool Initialize_Egl(headless_context *Headless)
+{
+   bool Result = false;
+
+   EGLint Configuration_Attributes[] =
+      {
+         EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+         EGL_RED_SIZE, 8,
+         EGL_GREEN_SIZE, 8,
+         EGL_BLUE_SIZE, 8,
+         EGL_ALPHA_SIZE, 8,
+         EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+         EGL_NONE,
+      };
+
+   EGLint Context_Attributes[] =
+      {
+         EGL_CONTEXT_MAJOR_VERSION, 3,
+         EGL_CONTEXT_MINOR_VERSION, 3,
+         EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+         EGL_NONE,
+      };
+
+   EGLint Pbuffer_Attributes[] =
+      {
+         EGL_WIDTH, 1,
+         EGL_HEIGHT, 1,
+         EGL_NONE,
+      };
+
+   bool Surfaceless = true;
+   Headless->Opengl_Display = Get_Surfaceless_Display();
+   if(Headless->Opengl_Display == EGL_NO_DISPLAY)
+   {
+      Surfaceless = false;
+      Headless->Opengl_Display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+   }
+
+   if(Headless->Opengl_Display != EGL_NO_DISPLAY)
+   {
+      EGLint Major, Minor;
+      if(eglInitialize(Headless->Opengl_Display, &Major, &Minor))
+      {
+         const char *Extensions = eglQueryString(Headless->Opengl_Display, EGL_EXTENSIONS);
+         if(!Extensions || !strstr(Extensions, "EGL_KHR_surfaceless_context"))
+         {
+            Surfaceless = false;
+         }
+
+         if(eglBindAPI(EGL_OPENGL_API))
+         {
+            EGLint Configuration_Count = 0;
+            if(Surfaceless && strstr(Extensions, "EGL_KHR_no_config_context"))
+            {
+               Headless->Opengl_Configuration = EGL_NO_CONFIG_KHR;
+               Configuration_Count = 1;
+            }
+            else
+            {
+               eglChooseConfig(Headless->Opengl_Display, Configuration_Attributes, &Headless->Opengl_Configuration, 1, &Configuration_Count);
+            }
+
+            if(Configuration_Count > 0)
+            {
+               Headless->Opengl_Context = eglCreateContext(Headless->Opengl_Display, Headless->Opengl_Configuration, EGL_NO_CONTEXT, Context_Attributes);
+               if(Headless->Opengl_Context != EGL_NO_CONTEXT)
+               {
+                  // NOTE: Even in the pbuffer fallback, the surface only exists
+                  // to satisfy eglMakeCurrent. All rendering goes to the
+                  // offscreen framebuffer, so its size doesn't matter.
+                  if(!Surfaceless)
+                  {
+                     Headless->Opengl_Surface = eglCreatePbufferSurface(Headless->Opengl_Display, Headless->Opengl_Configuration, Pbuffer_Attributes);
+                  }
+
+                  if(Surfaceless || Headless->Opengl_Surface != EGL_NO_SURFACE)
+                  {
+                     if(eglMakeCurrent(Headless->Opengl_Display, Headless->Opengl_Surface, Headless->Opengl_Surface, Headless->Opengl_Context))
+                     {
+                        printf("EGL %d.%d (%s): %s\n", Major, Minor, (Surfaceless) ? "surfaceless" : "pbuffer", glGetString(GL_RENDERER));
+                        Result = true;
+                     }
+                     else
+                     {
+                        fprintf(stderr, "EGL failed to make the OpenGL context current.\n");
+                     }
+                  }
+                  else
+                  {
+                     fprintf(stderr, "EGL failed to create a pbuffer surface.\n");
+                  }
+               }
+               else
+               {
+                  fprintf(stderr, "EGL failed to create an OpenGL context.\n");
+               }
+            }
+            else
+            {
+               fprintf(stderr, "EGL failed to choose a configuration.\n");
+            }
+         }
+         else
+         {
+            fprintf(stderr, "EGL failed to bind OpenGL API.\n");
+         }
+      }
+      else
+      {
+         fprintf(stderr, "EGL failed to initialize.\n");
+      }
+   }
+   else
+   {
+      fprintf(stderr, "EGL failed to get a display.\n");
+   }
+
+   return(Result);
+}
+
+static void Write_Frame_Ppm(opengl_readback_frame *Frame, char *Path)
+{
+   FILE *File = fopen(Path, "wb");
+   if(File)
+   {
+      fprintf(File, "P6\n%d %d\n255\n", Frame->Width, Frame->Height);
+
+      // NOTE: OpenGL returns rows bottom-up, PPM expects them top-down.
+      for(int Y = Frame->Height - 1; Y >= 0; --Y)
+      {
+         u8 *Row = Frame->Pixels + (size)Y*Frame->Width*4;
+         for(int X = 0; X < Frame->Width; ++X)
+         {
+            fwrite(Row + X*4, 3, 1, File);
+         }
+      }
+      fclose(File);
+   }
+   else
+   {
+      fprintf(stderr, "Failed to open %s for writing.\n", Path);
+   }
+}
+
+static u64 Consume_Readback_Frame(headless_context *Headless, opengl_readback_frame *Frame)
+{
+   // NOTE: Touch every pixel so the readback cost is actually paid and the
+   // checksum can be compared between runs.
+   u64 Result = 0;
+   u32 *Pixels = (u32 *)Frame->Pixels;
+   size Pixel_Count = (size)Frame->Width * (size)Frame->Height;
+   for(size Index = 0; Index < Pixel_Count; ++Index)
+   {
+      Result = (Result * 31) + Pixels[Index];
+   }
+
+   if(Headless->Output_Path && Frame->Frame_Index == (u64)(Headless->Frame_Count - 1))
+   {
+      Write_Frame_Ppm(Frame, Headless->Output_Path);
+   }
+
+   return(Result);
+}
+
+typedef struct {
+   u64 Pixels_Compared;
+   u64 Pixels_Exact;
+   u64 Pixels_Mismatched; // NOTE: Off by more than one in any channel.
+   u32 Max_Difference;
+} headless_cross_check;
+
+// NOTE: Compares the software framebuffer against the GL one. The GL image is
+// read synchronously, which stalls, but cross-checking is about correctness.
+static void Cross_Check_Software_Frame(headless_cross_check *Check, software_renderer *Software, arena *Arena)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   size Pixel_Count = (size)Software->Width*(size)Software->Height;
+   u8 *Expected = Push_Array(Arena, Pixel_Count*4, u8);
+   u8 *Actual = Push_Array(Arena, Pixel_Count*4, u8);
+   Bind_Opengl_Buffer(GL_PIXEL_PACK_BUFFER, 0);
+   glReadPixels(0, 0, Software->Width, Software->Height, GL_RGBA, GL_UNSIGNED_BYTE, Expected);
+   Read_Software_Pixels(Software, Actual);
+
+   for(size Index = 0; Index < Pixel_Count; ++Index)
+   {
+      u32 Difference = 0;
+      for(int Channel = 0; Channel < 4; ++Channel)
+      {
+         int Delta = abs((int)Expected[Index*4 + Channel] - (int)Actual[Index*4 + Channel]);
+         if((u32)Delta > Difference)
+         {
+            Difference = (u32)Delta;
+         }
+      }
+
+      Check->Pixels_Exact += (Difference == 0);
+      Check->Pixels_Mismatched += (Difference > 1);
+      if(Difference > Check->Max_Difference)
+      {
+         Check->Max_Difference = Difference;
+      }
+   }
+   Check->Pixels_Compared += (u64)Pixel_Count;
+
+   End_Temporary_Memory(Temporary);
+}
+
+static void Push_Test_Scene(opengl_context *GL)
+{
+   vec4 Background = {0.0f, 0.0f, 1.0f, 1.0f};
+   Push_Render_Clear(GL, Render_Pass_Scene, Background);
+
+   opengl_material Material = {0};
+   Material.Program = GL->Basic_Program;
+
+   opengl_instance Identity = {0};
+   Push_Render_Mesh(GL, Render_Pass_Scene, Material, &GL->Triangle_Mesh, Identity, 0.5f);
+}
+
+static void Push_Test_Meshes(opengl_context *GL, headless_context *Headless, int Frame_Index)
+{
+   // NOTE: Streamed meshes are drawn side by side as soon as they are
+   // resident, each scaled to fit its cell.
+   opengl_material Material = {0};
+   Material.Program = GL->Per_Object_Program;
+
+   float Cell = 2.0f / Headless->Mesh_Count;
+   for(int Index = 0; Index < Headless->Mesh_Count; ++Index)
+   {
+      opengl_mesh *Mesh = Get_Opengl_Mesh(GL, Headless->Mesh_Handles[Index]);
+      if(Mesh)
+      {
+         if(Headless->Mesh_Resident_Frames[Index] < 0)
+         {
+            Headless->Mesh_Resident_Frames[Index] = Frame_Index;
+         }
+
+         float Width = Mesh->Bounds_Max.X - Mesh->Bounds_Min.X;
+         float Height = Mesh->Bounds_Max.Y - Mesh->Bounds_Min.Y;
+         float Extent = (Width > Height) ? Width : Height;
+         float Scale = (Extent > 0) ? 0.9f*Cell / Extent : 1.0f;
+
+         opengl_instance Instance = {0};
+         Instance.Basis_X.X = Scale;
+         Instance.Basis_Y.Y = Scale;
+         Instance.Color = (vec4){1, 1, 1, 1};
+         Instance.Offset.X = -1.0f + (Index + 0.5f)*Cell - 0.5f*(Mesh->Bounds_Min.X + Mesh->Bounds_Max.X)*Scale;
+         Instance.Offset.Y = -0.5f*(Mesh->Bounds_Min.Y + Mesh->Bounds_Max.Y)*Scale;
+
+         Push_Render_Mesh(GL, Render_Pass_Scene, Material, Mesh, Instance, 0.25f);
+      }
+   }
+}
+
+#define TEST_TEXTURES_VISIBLE 16
+#define TEST_TEXTURE_FRAMES_PER_STEP 4
+#define TEST_TEXTURE_DIRECTORY "test_textures" // NOTE: Created on first write.
+
+static u32 *Create_Test_Textures(opengl_context *GL, arena *Arena, int Count)
+{
+   // NOTE: Textures alternate between two sizes, so they land in two arrays.
+   u32 *Result = Push_Array(Arena, Count, u32);
+
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+   for(int Index = 0; Index < Count; ++Index)
+   {
+      int Size = (Index % 2) ? 128 : 256;
+      int Header_Size = 32;
+      size File_Size = Header_Size + Size*Size*3;
+      u8 *File = Push_Size(Arena, File_Size);
+      snprintf((char *)File, Header_Size, "P6\n%d %d\n255\n", Size, Size);
+
+      // NOTE: The header is padded with a comment, so the pixels always start
+      // at the same offset.
+      size Length = strlen((char *)File);
+      File[Length] = '#';
+      memset(File + Length + 1, ' ', Header_Size - Length - 2);
+      File[Header_Size - 1] = '\n';
+
+      u8 *Pixel = File + Header_Size;
+      for(int Y = 0; Y < Size; ++Y)
+      {
+         for(int X = 0; X < Size; ++X)
+         {
+            bool Checker = ((X / 32) + (Y / 32)) % 2;
+            *Pixel++ = (u8)(Checker ? 255 : (Index * 37) % 256);
+            *Pixel++ = (u8)(X * 255 / Size);
+            *Pixel++ = (u8)(Checker ? (Index * 91) % 256 : Y * 255 / Size);
+         }
+      }
+
+      char Path[64];
+      snprintf(Path, sizeof(Path), TEST_TEXTURE_DIRECTORY "/texture_%03d.ppm", Index);
+      Write_Entire_File(Path, File, File_Size);
+      Result[Index] = Load_Opengl_Texture(GL, Path);
+   }
+   End_Temporary_Memory(Temporary);
+
+   return(Result);
+}
+
+static void Push_Test_Textures(opengl_context *GL, headless_context *Headless, int Frame_Index)
+{
+   // NOTE: A window of textured quads that slides along the texture list, so
+   // textures keep scrolling out of use (and eventually out of the budget)
+   // while new ones stream in.
+   opengl_material Material = {0};
+   Material.Program = GL->Textured_Program;
+
+   int Visible = (Headless->Texture_Count < TEST_TEXTURES_VISIBLE) ? Headless->Texture_Count : TEST_TEXTURES_VISIBLE;
+   int First = Frame_Index / TEST_TEXTURE_FRAMES_PER_STEP;
+   int Columns = (int)sqrtf((float)Visible);
+   if(Columns*Columns < Visible) Columns++;
+   float Cell = 2.0f / Columns;
+
+   for(int Index = 0; Index < Visible; ++Index)
+   {
+      u32 Layer;
+      u32 Handle = Headless->Texture_Handles[(First + Index) % Headless->Texture_Count];
+      if(Use_Opengl_Texture(GL, Handle, &Material.Texture, &Layer))
+      {
+         int Column = Index % Columns;
+         int Row = Index / Columns;
+
+         opengl_instance Instance = {0};
+         Instance.Basis_X.X = 0.9f*Cell;
+         Instance.Basis_Y.Y = 0.9f*Cell;
+         Instance.Color = (vec4){1, 1, 1, 1};
+         Instance.Offset.X = -1.0f + (Column + 0.5f)*Cell;
+         Instance.Offset.Y = -1.0f + (Row + 0.5f)*Cell;
+         Instance.Material = Layer;
+
+         Push_Render_Mesh(GL, Render_Pass_Scene, Material, &GL->Quad_Mesh, Instance, 0.3f);
+      }
+   }
+}
+
+static void Push_Test_Quads(opengl_context *GL, int Quad_Count, int Frame_Index)
+{
+   // NOTE: A grid of small quads that drifts every frame, standing in for
+   // dynamic geometry that has to be regenerated each frame.
+   int Columns = (int)sqrtf((float)Quad_Count) + 1;
+   float Cell = 2.0f / Columns;
+   float Drift = (float)(Frame_Index % 64) / 64.0f * Cell;
+
+   for(int Index = 0; Index < Quad_Count; ++Index)
+   {
+      int Column = Index % Columns;
+      int Row = Index / Columns;
+
+      vec2 Min = {-1.0f + Column*Cell + Drift*0.5f, -1.0f + Row*Cell};
+      vec2 Max = {Min.X + Cell*0.5f, Min.Y + Cell*0.5f};
+      vec4 Color = {(float)Column / Columns, (float)Row / Columns, 0.5f, 1.0f};
+
+      Push_Quad(GL, Min, Max, Color);
+   }
+}
+
+static void Push_Test_Text(opengl_context *GL, int Glyph_Count, int Frame_Index, int Height)
+{
+   // NOTE: Lines of small text that change every frame, standing in for
+   // dense debug output. Lines wrap back to the top once the screen is full,
+   // so large counts overdraw rather than run off screen.
+   float Size = 7.0f;
+   float Line_Height = 10.0f;
+   int Line_Count = (int)((float)Height / Line_Height);
+   if(Line_Count < 1)
+   {
+      Line_Count = 1;
+   }
+
+   int Remaining = Glyph_Count;
+   for(int Line = 0; Remaining > 0; ++Line)
+   {
+      char String[128];
+      snprintf(String, sizeof(String), "%06d/%04d: The quick brown fox jumps over the lazy dog! {0123456789} <ABCDEFGHIJKLMNOPQRSTUVWXYZ>",
+               Line, Frame_Index);
+
+      // NOTE: The last line is cut short so exactly Glyph_Count are drawn.
+      int Visible = 0;
+      for(char *At = String; *At; ++At)
+      {
+         if((u8)*At > ' ' && ++Visible == Remaining)
+         {
+            At[1] = 0;
+            break;
+         }
+      }
+      Remaining -= Visible;
+
+      vec2 Position = {4.0f, (float)Height - (float)(Line % Line_Count + 1)*Line_Height};
+      vec4 Color = {0.6f + 0.4f*(float)(Line % 3)*0.5f, 1.0f, 0.6f + 0.4f*(float)(Line % 5)*0.25f, 1.0f};
+      Push_Text(GL, Position, Size, Color, String);
+   }
+}
+
+// NOTE: Counters from the previous frame, since this one's aren't known until
+// it has been drawn.
+static void Push_Headless_Hud(opengl_context *GL, headless_context *Headless, opengl_frame_stats *Stats, int Frame_Index, u64 Frame_Time)
+{
+   opengl_text *Text = &GL->Text;
+   vec2 Position = {8.0f, (float)Headless->Height - 22.0f};
+   vec4 Color = {1.0f, 1.0f, 0.4f, 1.0f};
+   Push_Text_Format(GL, Position, 14.0f, Color,
+                    "Frame %d: %.3f ms\n"
+                    "%u commands, %u draw calls, %u state calls (%u elided)\n"
+                    "%u glyphs, atlas %llu hits, %llu misses, %llu evictions",
+                    Frame_Index, (double)Frame_Time / 1e6,
+                    Stats->Commands_Submitted, Stats->Draw_Calls, Stats->State_Calls_Issued, Stats->State_Calls_Elided,
+                    Stats->Glyphs, (unsigned long long)Text->Hit_Count, (unsigned long long)Text->Miss_Count,
+                    (unsigned long long)Text->Eviction_Count);
+}
+
+static opengl_instance *Build_Test_Instances(arena *Arena, int Instance_Count)
+{
+   // NOTE: A static field of small rotated quads with varied colors and
+   // materials, standing in for a scene of many copies of the same mesh.
+   opengl_instance *Result = Push_Array(Arena, Instance_Count, opengl_instance);
+
+   int Columns = (int)sqrtf((float)Instance_Count) + 1;
+   float Cell = 2.0f / Columns;
+
+   for(int Index = 0; Index < Instance_Count; ++Index)
+   {
+      int Column = Index % Columns;
+      int Row = Index / Columns;
+
+      float Angle = (float)Index * 0.1f;
+      float Scale = Cell * 0.7f;
+
+      opengl_instance *Instance = Result + Index;
+      Instance->Basis_X.X = cosf(Angle) * Scale;
+      Instance->Basis_X.Y = sinf(Angle) * Scale;
+      Instance->Basis_Y.X = -sinf(Angle) * Scale;
+      Instance->Basis_Y.Y = cosf(Angle) * Scale;
+      Instance->Color.R = (float)Column / Columns;
+      Instance->Color.G = (float)Row / Columns;
+      Instance->Color.B = 1.0f;
+      Instance->Color.A = 1.0f;
+      Instance->Offset.X = -1.0f + (Column + 0.5f)*Cell;
+      Instance->Offset.Y = -1.0f + (Row + 0.5f)*Cell;
+      Instance->Material = (u32)Index;
+   }
+
+   return(Result);
+}
+
+// NOTE: Pooled objects are a set of small polygons with 3 to
+// TEST_POOLED_SHAPE_COUNT + 2 sides, packed into one mesh pool and drawn
+// through an indirect batch. The same shapes also exist as ordinary meshes, to
+// compare against drawing each object on its own.
+#define TEST_POOLED_SHAPE_COUNT 16
+
+typedef struct {
+   opengl_mesh_pool Pool;
+   opengl_indirect_batch Batch;
+   u32 Handles[TEST_POOLED_SHAPE_COUNT];
+   opengl_mesh Meshes[TEST_POOLED_SHAPE_COUNT];
+} test_pooled_scene;
+
+static void Initialize_Test_Pooled_Scene(test_pooled_scene *Scene, arena *Arena, int Object_Count, bool Force_Cpu_Loop)
+{
+   vertex_layout *Layout = Opengl_Vertex_Layouts + Mesh_Vertex_Format_Standard;
+   Initialize_Opengl_Mesh_Pool(&Scene->Pool, Layout, GL_UNSIGNED_INT, 1024, 4096);
+
+   for(u32 Shape = 0; Shape < TEST_POOLED_SHAPE_COUNT; ++Shape)
+   {
+      vertex Vertices[TEST_POOLED_SHAPE_COUNT + 3];
+      u32 Indices[(TEST_POOLED_SHAPE_COUNT + 2)*3];
+      u16 Short_Indices[(TEST_POOLED_SHAPE_COUNT + 2)*3];
+
+      u32 Side_Count = Shape + 3;
+      vec4 Color = {1.0f, (float)Shape / TEST_POOLED_SHAPE_COUNT, 0.25f, 1.0f};
+      Vertices[0].Position = (vec2){0, 0};
+      Vertices[0].Color = Color;
+      for(u32 Side = 0; Side < Side_Count; ++Side)
+      {
+         float Angle = 2.0f*3.14159265f*(float)Side / (float)Side_Count;
+         Vertices[Side + 1].Position = (vec2){0.5f*cosf(Angle), 0.5f*sinf(Angle)};
+         Vertices[Side + 1].Color = Color;
+
+         Indices[Side*3 + 0] = 0;
+         Indices[Side*3 + 1] = Side + 1;
+         Indices[Side*3 + 2] = ((Side + 1) % Side_Count) + 1;
+      }
+      for(u32 Index = 0; Index < Side_Count*3; ++Index)
+      {
+         Short_Indices[Index] = (u16)Indices[Index];
+      }
+
+      vec2 Bounds_Min, Bounds_Max;
+      Get_Vertex_Bounds(Vertices, Side_Count + 1, &Bounds_Min, &Bounds_Max);
+      Scene->Handles[Shape] = Add_Opengl_Pool_Mesh(&Scene->Pool, Layout, Vertices, Side_Count + 1,
+                                                   GL_UNSIGNED_INT, Indices, Side_Count*3, Bounds_Min, Bounds_Max);
+      Initialize_Opengl_Mesh(Scene->Meshes + Shape, Vertices, Side_Count + 1, Short_Indices, Side_Count*3);
+   }
+
+   Initialize_Opengl_Indirect_Batch(&Scene->Batch, &Scene->Pool, Arena, (u32)Object_Count);
+   Scene->Batch.Force_Cpu_Loop = Force_Cpu_Loop;
+}
+
+static void Destroy_Test_Pooled_Scene(test_pooled_scene *Scene)
+{
+   Destroy_Opengl_Indirect_Batch(&Scene->Batch);
+   Destroy_Opengl_Mesh_Pool(&Scene->Pool);
+   for(u32 Shape = 0; Shape < TEST_POOLED_SHAPE_COUNT; ++Shape)
+   {
+      Destroy_Opengl_Mesh(Scene->Meshes + Shape);
+   }
+}
+
+static void Push_Test_Pooled_Objects(opengl_context *GL, test_pooled_scene *Scene, int Object_Count, pooled_path Path, int Frame_Index)
+{
+   opengl_material Material = {0};
+   Material.Program = GL->Per_Object_Program;
+
+   int Columns = (int)sqrtf((float)Object_Count) + 1;
+   float Cell = 2.0f / Columns;
+   float Angle = (float)Frame_Index * 0.05f;
+
+   Reset_Opengl_Indirect_Batch(&Scene->Batch);
+   for(int Index = 0; Index < Object_Count; ++Index)
+   {
+      float Object_Angle = Angle + (float)Index;
+      float Scale = Cell * 0.9f;
+      u32 Shape = (u32)Index % TEST_POOLED_SHAPE_COUNT;
+
+      opengl_instance Instance = {0};
+      Instance.Basis_X = (vec2){cosf(Object_Angle)*Scale, sinf(Object_Angle)*Scale};
+      Instance.Basis_Y = (vec2){-sinf(Object_Angle)*Scale, cosf(Object_Angle)*Scale};
+      Instance.Color = (vec4){1, 1, 1, 1};
+      Instance.Offset.X = -1.0f + ((Index % Columns) + 0.5f)*Cell;
+      Instance.Offset.Y = -1.0f + ((Index / Columns) + 0.5f)*Cell;
+      Instance.Material = (u32)Index;
+
+      if(Path == Pooled_Path_Per_Object)
+      {
+         Push_Render_Mesh(GL, Render_Pass_Scene, Material, Scene->Meshes + Shape, Instance, (float)Index / Object_Count);
+      }
+      else
+      {
+         Push_Indirect_Draw(&Scene->Batch, Scene->Handles[Shape], Instance);
+      }
+   }
+
+   if(Path != Pooled_Path_Per_Object)
+   {
+      Push_Indirect_Batch(GL, &Scene->Batch);
+   }
+}
+
+// NOTE: Objects are recorded as one draw command each, in jobs of
+// TEST_OBJECTS_PER_JOB, to exercise parallel command recording. They sit on
+// a grid that exactly covers the view, unless culling is on: then the grid
+// covers TEST_CULL_WORLD_SCALE times the view along each axis and the camera
+// pans across it, so most objects are off screen on any given frame.
+#define TEST_OBJECTS_PER_JOB 1024
+#define TEST_CULL_WORLD_SCALE 4.0f
+
+typedef struct {
+   opengl_context *GL;
+   u32 *Objects; // NOTE: Indices of the objects to record, or null for all.
+   int First;
+   int Count;
+   int Total;
+   int Frame_Index;
+   float World_Scale;
+   vec2 Camera;
+} test_object_job;
+
+static void Get_Test_Object_Placement(int Index, int Total, float World_Scale, vec2 *Center, float *Scale)
+{
+   int Columns = (int)sqrtf((float)Total) + 1;
+   float Cell = 2.0f*World_Scale / Columns;
+
+   int Column = Index % Columns;
+   int Row = Index / Columns;
+   Center->X = -World_Scale + (Column + 0.5f)*Cell;
+   Center->Y = -World_Scale + (Row + 0.5f)*Cell;
+   *Scale = Cell * 0.5f;
+}
+
+static vec2 Get_Test_Camera(int Frame_Index)
+{
+   float Angle = (float)Frame_Index * 0.02f;
+   vec2 Result = {2.0f*cosf(Angle), 2.0f*sinf(Angle)};
+   return(Result);
+}
+
+static JOB_FUNCTION(Record_Test_Objects)
+{
+   test_object_job *Job = Data;
+   opengl_context *GL = Job->GL;
+
+   opengl_material Material = {0};
+   Material.Program = GL->Per_Object_Program;
+
+   int Columns = (int)sqrtf((float)Job->Total) + 1;
+   float Angle = (float)Job->Frame_Index * 0.05f;
+
+   for(int Item = Job->First; Item < Job->First + Job->Count; ++Item)
+   {
+      int Index = (Job->Objects) ? (int)Job->Objects[Item] : Item;
+      int Column = Index % Columns;
+      int Row = Index / Columns;
+
+      vec2 Center;
+      float Scale;
+      Get_Test_Object_Placement(Index, Job->Total, Job->World_Scale, &Center, &Scale);
+      float Object_Angle = Angle + (float)Index;
+
+      opengl_instance Instance = {0};
+      Instance.Basis_X.X = cosf(Object_Angle) * Scale;
+      Instance.Basis_X.Y = sinf(Object_Angle) * Scale;
+      Instance.Basis_Y.X = -sinf(Object_Angle) * Scale;
+      Instance.Basis_Y.Y = cosf(Object_Angle) * Scale;
+      Instance.Color.R = 1.0f;
+      Instance.Color.G = (float)Row / Columns;
+      Instance.Color.B = (float)Column / Columns;
+      Instance.Color.A = 1.0f;
+      Instance.Offset.X = Center.X - Job->Camera.X;
+      Instance.Offset.Y = Center.Y - Job->Camera.Y;
+      Instance.Material = (u32)Index;
+
+      // NOTE: Each object gets its own depth, so the sorted order doesn't
+      // depend on which thread recorded it.
+      float Depth = (float)Index / (float)Job->Total;
+      Push_Render_Mesh(GL, Render_Pass_Scene, Material, &GL->Quad_Mesh, Instance, Depth);
+   }
+}
+
+static void Initialize_Test_Cull_Set(opengl_cull_set *Set, arena *Arena, int Object_Count, cull_mode Mode)
+{
+   // NOTE: Objects spin in place, so a box around the quad's rotation circle
+   // bounds them on every frame and the set never changes.
+   Initialize_Opengl_Cull_Set(Set, Arena, (u32)Object_Count, Mode);
+   for(int Index = 0; Index < Object_Count; ++Index)
+   {
+      vec2 Center;
+      float Scale;
+      Get_Test_Object_Placement(Index, Object_Count, TEST_CULL_WORLD_SCALE, &Center, &Scale);
+
+      float Radius = 0.5f*Scale*sqrtf(2.0f);
+      vec3 Box_Center = {Center.X, Center.Y, 0};
+      vec3 Box_Extent = {Radius, Radius, 0};
+      Add_Opengl_Cull_Object(Set, Box_Center, Box_Extent);
+   }
+
+   // NOTE: Built up front, so the first frame's cull time is like the rest.
+   if(Mode == Cull_Mode_Bvh)
+   {
+      Build_Opengl_Cull_Bvh(Set);
+   }
+}
+
+static void Record_Test_Objects_In_Parallel(opengl_context *GL, arena *Arena, int Object_Count, int Frame_Index, opengl_cull_set *Cull)
+{
+   int Item_Count = Object_Count;
+   float World_Scale = 1.0f;
+   vec2 Camera = {0};
+   u32 *Objects = 0;
+   if(Cull)
+   {
+      World_Scale = TEST_CULL_WORLD_SCALE;
+      Camera = Get_Test_Camera(Frame_Index);
+
+      mat4 View = Mat4_Orthographic(Camera.X - 1, Camera.X + 1, Camera.Y - 1, Camera.Y + 1, -1, 1);
+      frustum Frustum = Frustum_From_Mat4(View);
+      Item_Count = (int)Cull_Opengl_Objects(GL, Cull, &Frustum);
+      Objects = Cull->Visible;
+   }
+
+   int Job_Count = (Item_Count + TEST_OBJECTS_PER_JOB - 1) / TEST_OBJECTS_PER_JOB;
+   test_object_job *Jobs = Push_Array(Arena, Job_Count, test_object_job);
+
+   job_counter Counter = {0};
+   for(int Index = 0; Index < Job_Count; ++Index)
+   {
+      test_object_job *Job = Jobs + Index;
+      Job->GL = GL;
+      Job->Objects = Objects;
+      Job->First = Index*TEST_OBJECTS_PER_JOB;
+      Job->Count = Item_Count - Job->First;
+      if(Job->Count > TEST_OBJECTS_PER_JOB)
+      {
+         Job->Count = TEST_OBJECTS_PER_JOB;
+      }
+      Job->Total = Object_Count;
+      Job->Frame_Index = Frame_Index;
+      Job->World_Scale = World_Scale;
+      Job->Camera = Camera;
+
+      Start_Job(Record_Test_Objects, Job, &Counter);
+   }
+   Wait_For_Jobs(&Counter);
+}
+
+#include "headless_benchmark.c"
+
+static void Print_Usage(char *Program)
+{
+   fprintf(stderr, "Usage: %s [-frames N] [-width W] [-height H] [-quads N] [-instances N [-naive]] [-objects N [-cull spheres|aabbs|bvh]] [-pooled N [-pooled-path indirect|loop|objects]] [-workers N] [-mesh file.mesh]... [-upload-budget KB] [-textures N [-texture-budget MB]] [-readback] [-output frame.ppm] [-capture trace.gltrace] [-software | -cross-check] [-damage] [-hud] [-text N [-text-slots N]] [-bloom INTENSITY] [-bench results.json]\n", Program);
+}
+
+static bool Parse_Arguments(headless_context *Headless, int Argument_Count, char **Arguments)
+{
+   bool Result = true;
+
+   for(int Index = 1; Index < Argument_Count; ++Index)
+   {
+      char *Argument = Arguments[Index];
+      bool Has_Value = (Index + 1 < Argument_Count);
+
+      if(strcmp(Argument, "-frames") == 0 && Has_Value)
+      {
+         Headless->Frame_Count = atoi(Arguments[++Index]);
+      }
+      else if(strcmp(Argument, "-width") == 0 && Has_Value)
+      {
+         Headless->Width = atoi(Arguments[++Index]);
+      }
+      else if(strcmp(Argument, "-height") == 0 && Has_Value)
+      {
+         Headless->Height = atoi(Arguments[++Index]);
+      }
+      else if(strcmp(Argument, "-quads") == 0 && Has_Value)
+      {
+         Headless->Quad_Count = atoi(Arguments[++Index]);
+      }
+      else if(strcmp(Argument, "-instances") == 0 && Has_Value)
+      {
+         Headless->Instance_Count = atoi(Arguments[++Index]);
+      }
+      else if(strcmp(Argument, "-objects") == 0 && Has_Value)
+      {
+         Headless->Object_Count = atoi(Arguments[++Index]);
+      }
+      else if(strcmp(Argument, "-cull") == 0 && Has_Value)
+      {
+         char *Mode = Arguments[++Index];
+         Headless->Cull_Enabled = true;
+         if(strcmp(Mode, "spheres") == 0)
+         {
+            Headless->Cull_Mode = Cull_Mode_Spheres;
+         }
+         else if(strcmp(Mode, "aabbs") == 0)
+         {
+            Headless->Cull_Mode = Cull_Mode_Aabbs;
+         }
+         else if(strcmp(Mode, "bvh") == 0)
+         {
+            Headless->Cull_Mode = Cull_Mode_Bvh;
+         }
+         else
+         {
+            Result = false;
+         }
+      }
+      else if(strcmp(Argument, "-pooled") == 0 && Has_Value)
+      {
+         Headless->Pooled_Count = atoi(Arguments[++Index]);
+      }
+      else if(strcmp(Argument, "-pooled-path") == 0 && Has_Value)
+      {
+         char *Path = Arguments[++Index];
+         if(strcmp(Path, "indirect") == 0)
+         {
+            Headless->Pooled_Path = Pooled_Path_Indirect;
+         }
+         else if(strcmp(Path, "loop") == 0)
+         {
+            Headless->Pooled_Path = Pooled_Path_Cpu_Loop;
+         }
+         else if(strcmp(Path, "objects") == 0)
+         {
+            Headless->Pooled_Path = Pooled_Path_Per_Object;
+         }
+         else
+         {
+            Result = false;
+         }
+      }
+      else if(strcmp(Argument, "-workers") == 0 && Has_Value)
+      {
+         Headless->Worker_Count = atoi(Arguments[++Index]);
+      }
+      else if(strcmp(Argument, "-mesh") == 0 && Has_Value && Headless->Mesh_Count < HEADLESS_MAX_MESHES)
+      {
+         Headless->Mesh_Paths[Headless->Mesh_Count++] = Arguments[++Index];
+      }
+      else if(strcmp(Argument, "-upload-budget") == 0 && Has_Value)
+      {
+         Headless->Upload_Budget = atoi(Arguments[++Index]);
+      }
+      else if(strcmp(Argument, "-textures") == 0 && Has_Value)
+      {
+         Headless->Texture_Count = atoi(Arguments[++Index]);
+      }
+      else if(strcmp(Argument, "-texture-budget") == 0 && Has_Value)
+      {
+         Headless->Texture_Budget = atoi(Arguments[++Index]);
+      }
+      else if(strcmp(Argument, "-naive") == 0)
+      {
+         Headless->Draw_Naive = true;
+      }
+      else if(strcmp(Argument, "-readback") == 0)
+      {
+         Headless->Readback_Enabled = true;
+      }
+      else if(strcmp(Argument, "-output") == 0 && Has_Value)
+      {
+         Headless->Readback_Enabled = true;
+         Headless->Output_Path = Arguments[++Index];
+      }
+      else if(strcmp(Argument, "-capture") == 0 && Has_Value)
+      {
+         Headless->Capture_Path = Arguments[++Index];
+      }
+      else if(strcmp(Argument, "-bench") == 0 && Has_Value)
+      {
+         Headless->Benchmark_Path = Arguments[++Index];
+      }
+      else if(strcmp(Argument, "-software") == 0)
+      {
+         Headless->Software_Enabled = true;
+      }
+      else if(strcmp(Argument, "-cross-check") == 0)
+      {
+         Headless->Software_Enabled = true;
+         Headless->Cross_Check = true;
+      }
+      else if(strcmp(Argument, "-damage") == 0)
+      {
+         Headless->Damage_Enabled = true;
+      }
+      else if(strcmp(Argument, "-hud") == 0)
+      {
+         Headless->Hud_Enabled = true;
+      }
+      else if(strcmp(Argument, "-text") == 0 && Has_Value)
+      {
+         Headless->Text_Count = atoi(Arguments[++Index]);
+      }
+      else if(strcmp(Argument, "-text-slots") == 0 && Has_Value)
+      {
+         Headless->Text_Slots = atoi(Arguments[++Index]);
+         if(Headless->Text_Slots < 1 || Headless->Text_Slots > OPENGL_TEXT_MAX_SLOTS)
+         {
+            Result = false;
+         }
+      }
+      else if(strcmp(Argument, "-bloom") == 0 && Has_Value)
+      {
+         Headless->Bloom_Enabled = true;
+         Headless->Bloom_Intensity = (float)atof(Arguments[++Index]);
+      }
+      else
+      {
+         Result = false;
+      }
+   }
+
+   if(Headless->Frame_Count <= 0 || Headless->Width <= 0 || Headless->Height <= 0)
+   {
+      Result = false;
+   }
+
+   // NOTE: Post-processing passes only exist in the GL frame graph.
+   if(Headless->Bloom_Enabled && Headless->Software_Enabled)
+   {
+      Result = false;
+   }
+
+   return(Result);
+}
+
+int main(int Argument_Count, char **Arguments)
+{
+   headless_context Headless = {0};
+   Headless.Opengl_Display = EGL_NO_DISPLAY;
+   Headless.Opengl_Context = EGL_NO_CONTEXT;
+   Headless.Opengl_Surface = EGL_NO_SURFACE;
+   Headless.Width = 640;
+   Headless.Height = 480;
+   Headless.Frame_Count = 100;
+
+   if(!Parse_Arguments(&Headless, Argument_Count, Arguments))
+   {
+      Print_Usage(Arguments[0]);
+      return(1);
+   }
+
+   platform_memory Memory = {0};
+   if(!Initialize_Memory(&Memory, 256*1024*1024, 64*1024*1024))
+   {
+      return(1);
+   }
+
+   if(!Initialize_Jobs((u32)Headless.Worker_Count))
+   {
+      return(1);
+   }
+
+   if(!Initialize_Egl(&Headless))
+   {
+      Destroy_Headless(&Headless);
+      return(1);
+   }
+
+   if(Headless.Capture_Path && !Begin_Opengl_Capture(Headless.Capture_Path, Headless.Width, Headless.Height))
+   {
+      Destroy_Headless(&Headless);
+      return(1);
+   }
+
+   opengl_offscreen Offscreen = {0};
+   if(!Initialize_Opengl_Offscreen(&Offscreen, Headless.Width, Headless.Height))
+   {
+      Destroy_Headless(&Headless);
+      return(1);
+   }
+
+   // NOTE: Frames rendered only in software are read back from its own
+   // framebuffer, so the ring is only for GL's.
+   bool Render_Opengl = (!Headless.Software_Enabled || Headless.Cross_Check);
+   bool Opengl_Readback = (Headless.Readback_Enabled && Render_Opengl);
+
+   opengl_readback Readback = {0};
+   if(Opengl_Readback)
+   {
+      Initialize_Opengl_Readback(&Readback, Headless.Width, Headless.Height);
+   }
+
+   opengl_context *GL = Push_Struct(&Memory.Permanent, opengl_context);
+   Initialize_Opengl(GL, &Memory);
+   Resize_Opengl(Headless.Width, Headless.Height);
+   if(Headless.Damage_Enabled)
+   {
+      Resize_Opengl_Damage(GL, Headless.Width, Headless.Height);
+   }
+
+   software_renderer *Software = 0;
+   opengl_readback_frame Software_Frame = {0};
+   if(Headless.Software_Enabled)
+   {
+      Software = Push_Struct(&Memory.Permanent, software_renderer);
+      Initialize_Software(Software, &Memory, Headless.Width, Headless.Height);
+
+      Software_Frame.Width = Headless.Width;
+      Software_Frame.Height = Headless.Height;
+      Software_Frame.Pixels = Push_Array(&Memory.Permanent, (size)Headless.Width*Headless.Height*4, u8);
+   }
+
+   // NOTE: The benchmark suite brings its own scenes, so the scene arguments
+   // are ignored.
+   if(Headless.Benchmark_Path)
+   {
+      bool Benchmarked = Run_Headless_Benchmark(GL, Software, &Headless, &Memory);
+
+      Destroy_Opengl_Offscreen(&Offscreen);
+      End_Opengl_Capture();
+      Destroy_Headless(&Headless);
+      Destroy_Jobs();
+
+      return((Benchmarked) ? 0 : 1);
+   }
+
+   opengl_instance_batch Instance_Batch = {0};
+   if(Headless.Instance_Count > 0)
+   {
+      opengl_instance *Instances = Build_Test_Instances(&Memory.Permanent, Headless.Instance_Count);
+      Initialize_Opengl_Instance_Batch(&Instance_Batch, &GL->Quad_Mesh, Instances, Headless.Instance_Count);
+      Instance_Batch.Draw_Naive = Headless.Draw_Naive;
+   }
+   if(Headless.Upload_Budget > 0)
+   {
+      GL->Meshes.Upload_Budget = (u64)Headless.Upload_Budget*1024;
+   }
+   for(int Index = 0; Index < Headless.Mesh_Count; ++Index)
+   {
+      Headless.Mesh_Handles[Index] = Load_Opengl_Mesh(GL, Headless.Mesh_Paths[Index]);
+      Headless.Mesh_Resident_Frames[Index] = -1;
+   }
+
+   if(Headless.Texture_Budget > 0)
+   {
+      GL->Textures.Budget = (u64)Headless.Texture_Budget*1024*1024;
+   }
+   if(Headless.Texture_Count > 0)
+   {
+      Headless.Texture_Handles = Create_Test_Textures(GL, &Memory.Permanent, Headless.Texture_Count);
+   }
+
+   if(Headless.Text_Slots > 0)
+   {
+      Set_Opengl_Text_Slot_Count(GL, (u32)Headless.Text_Slots);
+   }
+
+   test_pooled_scene Pooled_Scene = {0};
+   if(Headless.Pooled_Count > 0)
+   {
+      Initialize_Test_Pooled_Scene(&Pooled_Scene, &Memory.Permanent, Headless.Pooled_Count, Headless.Pooled_Path == Pooled_Path_Cpu_Loop);
+   }
+
+   opengl_cull_set Cull_Set = {0};
+   if(Headless.Cull_Enabled && Headless.Object_Count > 0)
+   {
+      Initialize_Test_Cull_Set(&Cull_Set, &Memory.Permanent, Headless.Object_Count, Headless.Cull_Mode);
+   }
+
+   opengl_frame_stats Totals = {0};
+   opengl_frame_stats Last_Stats = {0};
+   u64 Last_Frame_Time = 0;
+   int Full_Redraws = 0;
+   u64 Slowest_Frame = 0;
+   u64 Streaming_Time = 0;
+   u64 Idle_Time = 0;
+   int Streaming_Frames = 0;
+
+   u64 Checksum = 0;
+   int Readback_Count = 0;
+   int Readback_Stalls = 0;
+
+   software_stats Software_Totals = {0};
+   headless_cross_check Cross_Check = {0};
+
+   u64 Start = Get_Clock();
+   for(int Frame_Index = 0; Frame_Index < Headless.Frame_Count; ++Frame_Index)
+   {
+      PROFILE_BEGIN_FRAME(&GL->Profiler);
+      u64 Frame_Start = Get_Clock();
+      bool Streaming = Has_Pending_Opengl_Textures(GL);
+
+      Linux_Poll_File_Watches();
+
+      Reset_Arena(&Memory.Frame);
+      platform_counters Frame_Counters = Platform_Counters;
+
+      Begin_Opengl_Frame(GL);
+
+      PROFILE_BEGIN_CPU(&GL->Profiler, "Generate");
+      Push_Test_Scene(GL);
+      Push_Test_Meshes(GL, &Headless, Frame_Index);
+      if(Headless.Texture_Count > 0)
+      {
+         Push_Test_Textures(GL, &Headless, Frame_Index);
+      }
+      Push_Test_Quads(GL, Headless.Quad_Count, Frame_Index);
+      if(Headless.Instance_Count > 0)
+      {
+         Push_Instance_Batch(GL, &Instance_Batch);
+      }
+      if(Headless.Pooled_Count > 0)
+      {
+         Push_Test_Pooled_Objects(GL, &Pooled_Scene, Headless.Pooled_Count, Headless.Pooled_Path, Frame_Index);
+      }
+      if(Headless.Text_Count > 0)
+      {
+         Push_Test_Text(GL, Headless.Text_Count, Frame_Index, Headless.Height);
+      }
+      if(Headless.Hud_Enabled)
+      {
+         Push_Headless_Hud(GL, &Headless, &Last_Stats, Frame_Index, Last_Frame_Time);
+      }
+      if(Headless.Bloom_Enabled)
+      {
+         Add_Opengl_Bloom(GL, Headless.Width, Headless.Height, Headless.Bloom_Intensity);
+      }
+      PROFILE_END_CPU(&GL->Profiler, "Generate");
+
+      PROFILE_BEGIN_CPU(&GL->Profiler, "Record");
+      if(Headless.Object_Count > 0)
+      {
+         opengl_cull_set *Cull = (Headless.Cull_Enabled) ? &Cull_Set : 0;
+         Record_Test_Objects_In_Parallel(GL, &Memory.Frame, Headless.Object_Count, Frame_Index, Cull);
+      }
+      PROFILE_END_CPU(&GL->Profiler, "Record");
+
+      PROFILE_BEGIN_CPU(&GL->Profiler, "Render");
+      if(Render_Opengl)
+      {
+         // NOTE: The offscreen framebuffer is never swapped, so it always
+         // holds the previous frame.
+         GL->Damage.Buffer_Age = 1;
+         Render_With_Opengl(GL);
+      }
+      if(Software)
+      {
+         Render_With_Software(GL, Software);
+         if(!Render_Opengl)
+         {
+            // NOTE: With both backends they sort the same commands, so GL's
+            // counts already cover them.
+            GL->Stats.Commands_Submitted = Software->Stats.Commands_Submitted;
+            GL->Stats.Commands_Dropped += Software->Stats.Commands_Dropped;
+         }
+         Software_Totals.Triangles += Software->Stats.Triangles;
+         Software_Totals.Triangles_Dropped += Software->Stats.Triangles_Dropped;
+         Software_Totals.Bin_Entries += Software->Stats.Bin_Entries;
+         Software_Totals.Batches += Software->Stats.Batches;
+         Software_Totals.Tiles_Rasterized += Software->Stats.Tiles_Rasterized;
+         Software_Totals.Draws_Unsupported += Software->Stats.Draws_Unsupported;
+         Software_Totals.Bytes_Fetched += Software->Stats.Bytes_Fetched;
+         Software_Totals.Setup_Time += Software->Stats.Setup_Time;
+         Software_Totals.Raster_Time += Software->Stats.Raster_Time;
+      }
+      PROFILE_END_CPU(&GL->Profiler, "Render");
+      Totals.Commands_Submitted += GL->Stats.Commands_Submitted;
+      Totals.Commands_Dropped += GL->Stats.Commands_Dropped;
+      Totals.State_Calls_Issued += GL->Stats.State_Calls_Issued;
+      Totals.State_Calls_Elided += GL->Stats.State_Calls_Elided;
+      Totals.Draw_Calls += GL->Stats.Draw_Calls;
+      Totals.Uniform_Blocks += GL->Stats.Uniform_Blocks;
+      Totals.Cull_Tested += GL->Stats.Cull_Tested;
+      Totals.Cull_Visible += GL->Stats.Cull_Visible;
+      Totals.Cull_Nodes_Visited += GL->Stats.Cull_Nodes_Visited;
+      Totals.Cull_Time += GL->Stats.Cull_Time;
+      Totals.Damage_Rects += GL->Stats.Damage_Rects;
+      Totals.Damage_Pixels += GL->Stats.Damage_Pixels;
+      Totals.Commands_Skipped += GL->Stats.Commands_Skipped;
+      Totals.Glyphs += GL->Stats.Glyphs;
+      Totals.Glyph_Misses += GL->Stats.Glyph_Misses;
+      Full_Redraws += (GL->Stats.Damage_Full) ? 1 : 0;
+      Last_Stats = GL->Stats;
+
+      PROFILE_BEGIN_CPU(&GL->Profiler, "Readback");
+      if(Headless.Cross_Check)
+      {
+         Cross_Check_Software_Frame(&Cross_Check, Software, &Memory.Frame);
+      }
+      if(Headless.Readback_Enabled && !Opengl_Readback)
+      {
+         Read_Software_Pixels(Software, Software_Frame.Pixels);
+         Software_Frame.Frame_Index = (u64)Frame_Index;
+         Checksum += Consume_Readback_Frame(&Headless, &Software_Frame);
+         Readback_Count++;
+      }
+      if(Opengl_Readback)
+      {
+         // NOTE: Retire whatever has already finished without blocking, then
+         // queue this frame. We only wait when the whole ring is in flight.
+         opengl_readback_frame Frame;
+         while(Map_Opengl_Readback(&Readback, &Frame, false))
+         {
+            Checksum += Consume_Readback_Frame(&Headless, &Frame);
+            Unmap_Opengl_Readback(&Readback);
+            Readback_Count++;
+         }
+
+         if(!Queue_Opengl_Readback(&Readback, Frame_Index))
+         {
+            Readback_Stalls++;
+            if(Map_Opengl_Readback(&Readback, &Frame, true))
+            {
+               Checksum += Consume_Readback_Frame(&Headless, &Frame);
+               Unmap_Opengl_Readback(&Readback);
+               Readback_Count++;
+            }
+            Queue_Opengl_Readback(&Readback, Frame_Index);
+         }
+      }
+      PROFILE_END_CPU(&GL->Profiler, "Readback");
+
+      PROFILE_BEGIN_CPU(&GL->Profiler, "Flush");
+      glFlush();
+      PROFILE_END_CPU(&GL->Profiler, "Flush");
+
+      // NOTE: Steady state frames must not go back to the OS. Frames that
+      // (re)load assets are the only exception.
+      if(!GL->Loading_This_Frame)
+      {
+         Assert(Platform_Counters.Allocation_Count == Frame_Counters.Allocation_Count);
+         Assert(Platform_Counters.Syscall_Count == Frame_Counters.Syscall_Count);
+      }
+
+      u64 Frame_Time = Get_Clock() - Frame_Start;
+      Last_Frame_Time = Frame_Time;
+      if(Frame_Time > Slowest_Frame)
+      {
+         Slowest_Frame = Frame_Time;
+      }
+      if(Streaming)
+      {
+         Streaming_Time += Frame_Time;
+         Streaming_Frames++;
+      }
+      else
+      {
+         Idle_Time += Frame_Time;
+      }
+
+      PROFILE_END_FRAME(&GL->Profiler);
+   }
+
+   if(Opengl_Readback)
+   {
+      opengl_readback_frame Frame;
+      while(Map_Opengl_Readback(&Readback, &Frame, true))
+      {
+         Checksum += Consume_Readback_Frame(&Headless, &Frame);
+         Unmap_Opengl_Readback(&Readback);
+         Readback_Count++;
+      }
+   }
+   glFinish();
+   double Elapsed = (double)(Get_Clock() - Start) / 1e9;
+
+   GL_CHECK;
+
+   printf("%d frames at %dx%d in %.3fs: %.2f frames/s, %.3f ms/frame\n",
+          Headless.Frame_Count, Headless.Width, Headless.Height, Elapsed,
+          Headless.Frame_Count / Elapsed, 1000.0 * Elapsed / Headless.Frame_Count);
+
+   printf("Platform: %llu allocations, %llu syscalls; arenas peaked at %td KB permanent, %td KB frame\n",
+          (unsigned long long)Platform_Counters.Allocation_Count,
+          (unsigned long long)Platform_Counters.Syscall_Count,
+          Memory.Permanent.Peak_Used / 1024, Memory.Frame.Peak_Used / 1024);
+
+   if(Headless.Quad_Count > 0)
+   {
+      opengl_stream_buffer *Stream = &GL->Vertex_Stream;
+      printf("Streamed %.2f MB (%s), %u fence waits, %u overflows\n",
+             (double)Stream->Bytes_Pushed / (1024.0*1024.0),
+             (Stream->Persistent) ? "persistent" : "unsynchronized",
+             Stream->Fence_Wait_Count, Stream->Overflow_Count);
+   }
+
+   printf("Commands: %.1f submitted, %.1f state calls issued, %.1f elided, %.1f draw calls per frame (%u dropped, %u recording threads)\n",
+          (double)Totals.Commands_Submitted / Headless.Frame_Count,
+          (double)Totals.State_Calls_Issued / Headless.Frame_Count,
+          (double)Totals.State_Calls_Elided / Headless.Frame_Count,
+          (double)Totals.Draw_Calls / Headless.Frame_Count,
+          Totals.Commands_Dropped, Get_Thread_Count());
+
+   // NOTE: A run that dropped commands didn't draw the scene it was asked to,
+   // so its timings aren't comparable with anything. Say so, and fail.
+   int Exit_Code = 0;
+   if(Totals.Commands_Dropped > 0)
+   {
+      fprintf(stderr, "Dropped %u commands over %d frames, so the scene was not fully drawn.\n",
+              Totals.Commands_Dropped, Headless.Frame_Count);
+      Exit_Code = 1;
+   }
+
+   opengl_stream_buffer *Uniform_Stream = &GL->Uniform_Stream;
+   printf("Uniforms: %.1f blocks, %.1f KB per frame in one upload (%s, %d byte alignment), %u fence waits, %u overflows\n",
+          (double)Totals.Uniform_Blocks / Headless.Frame_Count,
+          (double)Uniform_Stream->Bytes_Pushed / (1024.0*Headless.Frame_Count),
+          (Uniform_Stream->Persistent) ? "persistent" : "unsynchronized",
+          GL->Capabilities.Uniform_Buffer_Alignment,
+          Uniform_Stream->Fence_Wait_Count, Uniform_Stream->Overflow_Count);
+
+   if(Headless.Cull_Enabled && Headless.Object_Count > 0)
+   {
+      char *Mode_Names[] = {"spheres", "aabbs", "bvh"};
+      printf("Culling (%s, %s): %.1f tested, %.1f visible, %.1f culled per frame in %.4f ms",
+             Mode_Names[Headless.Cull_Mode], Simd_Level_Names[Get_Simd_Level()],
+             (double)Totals.Cull_Tested / Headless.Frame_Count,
+             (double)Totals.Cull_Visible / Headless.Frame_Count,
+             (double)(Totals.Cull_Tested - Totals.Cull_Visible) / Headless.Frame_Count,
+             (double)Totals.Cull_Time / 1e6 / Headless.Frame_Count);
+      if(Headless.Cull_Mode == Cull_Mode_Bvh)
+      {
+         printf(", %.1f of %u BVH nodes visited", (double)Totals.Cull_Nodes_Visited / Headless.Frame_Count, Cull_Set.Node_Count);
+      }
+      printf("\n");
+   }
+
+   if(Headless.Damage_Enabled && Render_Opengl)
+   {
+      double Frames = (double)Headless.Frame_Count;
+      printf("Damage: %.2f%% of pixels redrawn, %.1f rects, %.1f commands skipped per frame; %d full redraws\n",
+             100.0*(double)Totals.Damage_Pixels / ((double)Headless.Width*Headless.Height*Frames),
+             (double)Totals.Damage_Rects / Frames, (double)Totals.Commands_Skipped / Frames, Full_Redraws);
+   }
+
+   if(Headless.Text_Count > 0 || Headless.Hud_Enabled)
+   {
+      opengl_text *Text = &GL->Text;
+      printf("Text: %.1f glyphs per frame in one draw, %.1f rasterized; atlas %u of %u slots, %llu hits, %llu misses, %llu evictions, %llu dropped, %.1f KB uploaded; %u overflows\n",
+             (double)Totals.Glyphs / Headless.Frame_Count, (double)Totals.Glyph_Misses / Headless.Frame_Count,
+             Text->Used_Slot_Count, Text->Slot_Count,
+             (unsigned long long)Text->Hit_Count, (unsigned long long)Text->Miss_Count,
+             (unsigned long long)Text->Eviction_Count, (unsigned long long)Text->Drop_Count,
+             (double)Text->Bytes_Uploaded / 1024.0, Text->Stream.Overflow_Count);
+   }
+
+   if(Headless.Bloom_Enabled)
+   {
+      opengl_graph *Graph = &GL->Graph;
+      printf("Frame graph: %u passes, %u culled; transients peaked at %.2f MB in %u textures, %.2f MB allocated naively; pool %.2f MB, %u textures created, %u deleted\n",
+             Last_Stats.Graph_Passes, Last_Stats.Graph_Passes_Culled,
+             (double)Last_Stats.Transient_Bytes / (1024.0*1024.0), Last_Stats.Transient_Textures,
+             (double)Last_Stats.Naive_Transient_Bytes / (1024.0*1024.0),
+             (double)Graph->Pool_Bytes / (1024.0*1024.0), Graph->Textures_Created, Graph->Textures_Deleted);
+   }
+
+   if(Headless.Instance_Count > 0)
+   {
+      printf("%s %d instances %s\n", (Exit_Code) ? "Tried to draw" : "Drew", Headless.Instance_Count,
+             (Headless.Draw_Naive) ? "one draw per object" : "instanced");
+      Destroy_Opengl_Instance_Batch(&Instance_Batch);
+   }
+
+   if(Headless.Pooled_Count > 0)
+   {
+      char *Path_Names[] = {"one multi-draw indirect", "a CPU loop over indirect commands", "one draw per object"};
+      bool Fallback = (Headless.Pooled_Path == Pooled_Path_Indirect && !GL->Capabilities.Has_Multi_Draw_Indirect);
+      printf("Drew %d pooled objects with %s%s\n", Headless.Pooled_Count,
+             Path_Names[(Fallback) ? Pooled_Path_Cpu_Loop : Headless.Pooled_Path],
+             (Fallback) ? " (no ARB_multi_draw_indirect)" : "");
+      Destroy_Test_Pooled_Scene(&Pooled_Scene);
+   }
+
+   if(Headless.Mesh_Count > 0)
+   {
+      for(int Index = 0; Index < Headless.Mesh_Count; ++Index)
+      {
+         opengl_mesh *Mesh = Get_Opengl_Mesh(GL, Headless.Mesh_Handles[Index]);
+         if(Mesh)
+         {
+            opengl_mesh_asset *Asset = GL->Meshes.Assets + (Headless.Mesh_Handles[Index] - 1);
+            printf("Mesh %s: %u %s vertices (%.2f MB), %u triangles, %u LODs, resident at frame %d after %.2f ms\n",
+                   Asset->Path, Mesh->Vertex_Count, Mesh->Layout->Name,
+                   (double)Mesh->Vertex_Count*Mesh->Layout->Stride / (1024.0*1024.0),
+                   Mesh->Lods[0].Index_Count/3, Mesh->Lod_Count,
+                   Headless.Mesh_Resident_Frames[Index], (double)(Asset->Resident_Time - Asset->Request_Time) / 1e6);
+         }
+         else
+         {
+            printf("Mesh %s: not resident\n", Headless.Mesh_Paths[Index]);
+         }
+      }
+      printf("Uploaded %.2f MB of meshes at up to %llu KB per frame; slowest frame %.3f ms\n",
+             (double)GL->Meshes.Total_Bytes_Uploaded / (1024.0*1024.0),
+             (unsigned long long)GL->Meshes.Upload_Budget / 1024, (double)Slowest_Frame / 1e6);
+      Destroy_Opengl_Meshes(GL);
+   }
+
+   if(Headless.Texture_Count > 0)
+   {
+      opengl_texture_manager *Textures = &GL->Textures;
+      int Idle_Frames = Headless.Frame_Count - Streaming_Frames;
+      printf("Textures: %u uploads, %.2f MB at %.1f MB/s, %u evictions, %.2f MB resident\n",
+             Textures->Upload_Count, (double)Textures->Bytes_Uploaded / (1024.0*1024.0),
+             (Streaming_Time > 0) ? ((double)Textures->Bytes_Uploaded / (1024.0*1024.0)) / ((double)Streaming_Time / 1e9) : 0.0,
+             Textures->Eviction_Count,
+             (double)Textures->Resident_Bytes / (1024.0*1024.0));
+      printf("Frame time: %.3f ms while streaming (%d frames), %.3f ms otherwise (%d frames)\n",
+             (Streaming_Frames > 0) ? (double)Streaming_Time / 1e6 / Streaming_Frames : 0.0, Streaming_Frames,
+             (Idle_Frames > 0) ? (double)Idle_Time / 1e6 / Idle_Frames : 0.0, Idle_Frames);
+      Destroy_Opengl_Textures(GL);
+   }
+
+   if(Software)
+   {
+      double Frames = (double)Headless.Frame_Count;
+      printf("Software (%s, %u threads, %d pixel tiles): %.1f triangles, %.1f bin entries, %.1f tiles, %.1f batches per frame; %.3f ms setup, %.3f ms raster per frame\n",
+             Simd_Level_Names[Software->Simd_Level], Get_Thread_Count(), SOFTWARE_TILE_SIZE,
+             (double)Software_Totals.Triangles / Frames, (double)Software_Totals.Bin_Entries / Frames,
+             (double)Software_Totals.Tiles_Rasterized / Frames, (double)Software_Totals.Batches / Frames,
+             (double)Software_Totals.Setup_Time / 1e6 / Frames, (double)Software_Totals.Raster_Time / 1e6 / Frames);
+      printf("Software: %.2f MB fetched from GL per frame, %.1f triangles dropped, %.1f draws unsupported per frame\n",
+             (double)Software_Totals.Bytes_Fetched / (1024.0*1024.0) / Frames,
+             (double)Software_Totals.Triangles_Dropped / Frames, (double)Software_Totals.Draws_Unsupported / Frames);
+   }
+
+   if(Headless.Cross_Check)
+   {
+      printf("Cross-check: %llu of %llu pixels off by more than one (%.3f%% exact), max channel difference %u\n",
+             (unsigned long long)Cross_Check.Pixels_Mismatched, (unsigned long long)Cross_Check.Pixels_Compared,
+             100.0*(double)Cross_Check.Pixels_Exact / (double)Cross_Check.Pixels_Compared, Cross_Check.Max_Difference);
+   }
+
+   if(Headless.Readback_Enabled)
+   {
+      printf("Read back %d frames (%d ring stalls), checksum %016llx\n",
+             Readback_Count, Readback_Stalls, (unsigned long long)Checksum);
+      if(Opengl_Readback)
+      {
+         Destroy_Opengl_Readback(&Readback);
+      }
+   }
+
+   PROFILE_WRITE_REPORT(&GL->Profiler, "profile.csv");
+   PROFILE_DESTROY(&GL->Profiler);
+
+   Destroy_Opengl_Offscreen(&Offscreen);
+   End_Opengl_Capture();
+   Destroy_Headless(&Headless);
+   Destroy_Jobs();
+
+   return(Exit_Code);
+}
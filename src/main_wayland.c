@@ -2,20 +2,25 @@
 
 // NOTE: This file is the entry point for the Wayland-based Linux build. Each
 // supported platform will have its code constrained to a single file, which
-// will quarantine the underlying platform from the renderer.
+// will quarantine the underlying platform from the renderer. The OS services
+// shared by all Linux entry points live in linux_platform.c.
 
 #include <wayland-client.h>
 #include <wayland-egl.h>
 #include <unistd.h>
-#include <fcntl.h>
-#include <sys/stat.h>
-#include <sys/mman.h>
+#include <poll.h>
+#include <sys/resource.h>
 #include <linux/input-event-codes.h>
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
 #include <GL/gl.h>
 
+#include <math.h>
+#include <stdarg.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "external/xdg-shell-client-protocol.h"
@@ -26,62 +31,11 @@
 
 #include "shared.h"
 #include "platform.h"
+#include "mesh_format.h"
+#include "opengl_capture.h"
 #include "opengl_renderer.h"
 #include "opengl_renderer.c"
-
-static READ_ENTIRE_FILE(Read_Entire_File)
-{
-   char *Result = 0;
-
-   struct stat File_Information;
-   if(stat(Path, &File_Information) == 0)
-   {
-      int File = open(Path, O_RDONLY);
-      if(File != -1)
-      {
-         size Total_Size = File_Information.st_size;
-         Result = mmap(0, Total_Size+1, PROT_READ|PROT_WRITE, MAP_ANONYMOUS|MAP_PRIVATE, -1, 0);
-         if(Result)
-         {
-            size Total_Read = 0;
-            while(Total_Read < Total_Size)
-            {
-               size Single_Read = read(File, Result+Total_Read, Total_Size-Total_Read);
-               if(Single_Read == 0)
-               {
-                  break; // Done.
-               }
-               else if(Single_Read == -1)
-               {
-                  fprintf(stderr, "Failed to read file %s.\n", Path);
-                  break;
-               }
-               else
-               {
-                  Total_Read += Single_Read;
-               }
-            }
-
-            // NOTE: Null terminate.
-            Result[Total_Size] = 0;
-         }
-         else
-         {
-            fprintf(stderr, "Failed to allocate file %s.\n", Path);
-         }
-      }
-      else
-      {
-         fprintf(stderr, "Failed to open file %s.\n", Path);
-      }
-   }
-   else
-   {
-      fprintf(stderr, "Failed to determine size of file %s.\n", Path);
-   }
-
-   return(Result);
-}
+#include "linux_platform.c"
 
 typedef struct {
    struct wl_display *Display;
@@ -106,6 +60,40 @@ typedef struct {
    bool Running;
    bool Alt_Pressed;
 
+   // NOTE: The loop only renders when something changed (Needs_Redraw), the
+   // compositor has asked for a frame (no Frame_Callback outstanding) and the
+   // window isn't suspended. Otherwise it sleeps in poll. A hidden surface
+   // gets no frame callbacks, so occluded windows stop drawing on their own;
+   // Suspended covers compositors that say so explicitly.
+   struct wl_callback *Frame_Callback;
+   bool Needs_Redraw;
+   bool Suspended;
+   bool Spin; // NOTE: Renders flat out without blocking, for comparison.
+
+   u64 Wakeup_Count;
+   u64 Frame_Count;
+
+   // NOTE: Damage tracking needs EGL_EXT_buffer_age, to know what the back
+   // buffer still holds. Swapping with damage is optional on top of that,
+   // and only tells the compositor which parts changed.
+   bool Has_Buffer_Age;
+   PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC Swap_Buffers_With_Damage;
+   bool Full_Redraw; // NOTE: Redraws and presents everything, for comparison.
+   u64 Unchanged_Frame_Count;
+   u64 Pixels_Redrawn;
+   u64 Pixels_Total;
+
+   // NOTE: The HUD shows the previous frame's counters. It's only redrawn
+   // along with everything else, so it never keeps the loop awake by itself.
+   bool Hud;
+   opengl_frame_stats Last_Stats;
+   u64 Last_Frame_Time;
+
+   // NOTE: Post-processing adds passes damage tracking can't see, so frames
+   // with bloom are always redrawn in full.
+   bool Bloom;
+   float Bloom_Intensity;
+
    struct zxdg_decoration_manager_v1 *Decoration_Manager;
    struct zxdg_toplevel_decoration_v1 *Toplevel_Decoration;
 } wayland_context;
@@ -120,7 +108,14 @@ static void Global_Registry(void *Data, struct wl_registry *Registry, u32 ID, co
    }
    else if(strcmp(Interface, xdg_wm_base_interface.name) == 0)
    {
-      Wayland->Desktop_Base = wl_registry_bind(Registry, ID, &xdg_wm_base_interface, 1);
+      // NOTE: Version 6 adds the suspended toplevel state, when the protocol
+      // headers we were built against know about it.
+#if defined(XDG_TOPLEVEL_STATE_SUSPENDED_SINCE_VERSION)
+      u32 Desktop_Version = (Version < 6) ? Version : 6;
+#else
+      u32 Desktop_Version = 1;
+#endif
+      Wayland->Desktop_Base = wl_registry_bind(Registry, ID, &xdg_wm_base_interface, Desktop_Version);
    }
    else if(strcmp(Interface, zxdg_decoration_manager_v1_interface.name) == 0)
    {
@@ -165,6 +160,22 @@ static const struct xdg_surface_listener Desktop_Surface_Listener =
 static void Configure_Desktop_Toplevel(void *Data, struct xdg_toplevel *Toplevel, s32 Width, s32 Height, struct wl_array *States)
 {
    wayland_context *Wayland = Data;
+   Wayland->Needs_Redraw = true;
+
+#if defined(XDG_TOPLEVEL_STATE_SUSPENDED_SINCE_VERSION)
+   Wayland->Suspended = false;
+
+   u32 *State = States->data;
+   size State_Count = States->size / sizeof(u32);
+   for(size Index = 0; Index < State_Count; ++Index)
+   {
+      if(State[Index] == XDG_TOPLEVEL_STATE_SUSPENDED)
+      {
+         Wayland->Suspended = true;
+      }
+   }
+#endif
+
    if(Width > 0 && Height > 0)
    {
       Wayland->Window_Width = Width;
@@ -182,10 +193,34 @@ static void Close_Desktop_Toplevel(void *Data, struct xdg_toplevel *Toplevel)
    wayland_context *Wayland = Data;
    Wayland->Running = false;
 }
+#if defined(XDG_TOPLEVEL_STATE_SUSPENDED_SINCE_VERSION)
+static void Configure_Desktop_Toplevel_Bounds(void *Data, struct xdg_toplevel *Toplevel, s32 Width, s32 Height)
+{
+}
+static void Report_Desktop_Toplevel_Capabilities(void *Data, struct xdg_toplevel *Toplevel, struct wl_array *Capabilities)
+{
+}
+#endif
 static const struct xdg_toplevel_listener Desktop_Toplevel_Listener =
 {
    .configure = Configure_Desktop_Toplevel,
    .close = Close_Desktop_Toplevel,
+#if defined(XDG_TOPLEVEL_STATE_SUSPENDED_SINCE_VERSION)
+   .configure_bounds = Configure_Desktop_Toplevel_Bounds,
+   .wm_capabilities = Report_Desktop_Toplevel_Capabilities,
+#endif
+};
+
+// NOTE: Configure frame callbacks.
+static void Done_Frame(void *Data, struct wl_callback *Callback, u32 Time)
+{
+   wayland_context *Wayland = Data;
+   wl_callback_destroy(Callback);
+   Wayland->Frame_Callback = 0;
+}
+static const struct wl_callback_listener Frame_Listener =
+{
+   .done = Done_Frame,
 };
 
 static void Toggle_Wayland_Fullscreen(wayland_context *Wayland)
@@ -217,6 +252,7 @@ static void Key_Keyboard(void *Data, struct wl_keyboard *Keyboard, u32 Serial, u
 {
    wayland_context *Wayland = (wayland_context *)Data;
    bool Pressed = (State == WL_KEYBOARD_KEY_STATE_PRESSED);
+   Wayland->Needs_Redraw = true;
 
    switch(Key)
    {
@@ -267,6 +303,11 @@ static const struct wl_keyboard_listener Keyboard_Listener =
 
 static void Destroy_Wayland(wayland_context *Wayland)
 {
+   if(Wayland->Frame_Callback)
+   {
+      wl_callback_destroy(Wayland->Frame_Callback);
+   }
+
    // NOTE: Destroy OpenGL.
    if(Wayland->Opengl_Surface != EGL_NO_SURFACE)
    {
@@ -382,9 +423,32 @@ static bool Initialize_Egl(wayland_context *Wayland, int Width, int Height)
                      {
                         if(eglMakeCurrent(Wayland->Opengl_Display, Wayland->Opengl_Surface, Wayland->Opengl_Surface, Wayland->Opengl_Context))
                         {
-                           if(!eglSwapInterval(Wayland->Opengl_Display, 1))
+                           // NOTE: Frames are normally paced by wl_surface
+                           // frame callbacks in the main loop, so swaps
+                           // shouldn't block on top of that. The spinning
+                           // loop has nothing else to throttle it.
+                           EGLint Swap_Interval = (Wayland->Spin) ? 1 : 0;
+                           if(!eglSwapInterval(Wayland->Opengl_Display, Swap_Interval))
                            {
-                              fprintf(stderr, "EGL failed to enable vsync.\n");
+                              fprintf(stderr, "EGL failed to set the swap interval.\n");
+                           }
+
+                           // NOTE: The KHR and EXT versions of swapping with
+                           // damage take the same arguments.
+                           const char *Extensions = eglQueryString(Wayland->Opengl_Display, EGL_EXTENSIONS);
+                           if(Extensions)
+                           {
+                              Wayland->Has_Buffer_Age = (strstr(Extensions, "EGL_EXT_buffer_age") != 0);
+                              if(strstr(Extensions, "EGL_KHR_swap_buffers_with_damage"))
+                              {
+                                 Wayland->Swap_Buffers_With_Damage =
+                                    (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+                              }
+                              else if(strstr(Extensions, "EGL_EXT_swap_buffers_with_damage"))
+                              {
+                                 Wayland->Swap_Buffers_With_Damage =
+                                    (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)eglGetProcAddress("eglSwapBuffersWithDamageEXT");
+                              }
                            }
 
                            Result = true;
@@ -523,25 +587,320 @@ static void Initialize_Wayland(wayland_context *Wayland, int Width, int Height)
    }
 }
 
-int main(void)
+static void Push_Test_Scene(opengl_context *GL)
+{
+   vec4 Background = {0.0f, 0.0f, 1.0f, 1.0f};
+   Push_Render_Clear(GL, Render_Pass_Scene, Background);
+
+   opengl_material Material = {0};
+   Material.Program = GL->Basic_Program;
+
+   opengl_instance Identity = {0};
+   Push_Render_Mesh(GL, Render_Pass_Scene, Material, &GL->Triangle_Mesh, Identity, 0.5f);
+}
+
+static void Wait_For_Wayland_Events(wayland_context *Wayland, bool Block)
+{
+   // NOTE: Events already queued have to be dispatched before reading, or poll
+   // could go to sleep with them still sitting in the queue.
+   while(wl_display_prepare_read(Wayland->Display) != 0)
+   {
+      wl_display_dispatch_pending(Wayland->Display);
+   }
+
+   // NOTE: If the socket is full the rest goes out once it's writable again.
+   short Display_Events = POLLIN;
+   if(wl_display_flush(Wayland->Display) == -1 && errno == EAGAIN)
+   {
+      Display_Events |= POLLOUT;
+   }
+
+   // NOTE: File changes only matter when we're able to draw a frame to pick
+   // them up. Otherwise the unread inotify descriptor would keep poll from
+   // ever sleeping.
+   int Watch_Handle = Linux_Get_File_Watch_Handle();
+   bool Can_Draw = (!Wayland->Frame_Callback && !Wayland->Suspended);
+
+   struct pollfd Files[3] =
+   {
+      {wl_display_get_fd(Wayland->Display), Display_Events, 0},
+      {Linux_Get_Wake_Handle(), POLLIN, 0},
+      {(Can_Draw) ? Watch_Handle : -1, POLLIN, 0},
+   };
+
+   int Ready = poll(Files, Array_Count(Files), (Block) ? -1 : 0);
+   if(Block)
+   {
+      Wayland->Wakeup_Count++;
+   }
+
+   if(Ready > 0 && (Files[0].revents & POLLIN))
+   {
+      wl_display_read_events(Wayland->Display);
+   }
+   else
+   {
+      wl_display_cancel_read(Wayland->Display);
+   }
+
+   if(Ready > 0 && (Files[0].revents & (POLLERR|POLLHUP)))
+   {
+      fprintf(stderr, "Lost the connection to the Wayland display.\n");
+      Wayland->Running = false;
+   }
+
+   if(wl_display_dispatch_pending(Wayland->Display) == -1)
+   {
+      Wayland->Running = false;
+   }
+
+   if(Ready > 0 && (Files[1].revents & POLLIN))
+   {
+      Linux_Clear_Wake_Event();
+      Wayland->Needs_Redraw = true;
+   }
+   if(Ready > 0 && (Files[2].revents & POLLIN))
+   {
+      Wayland->Needs_Redraw = true;
+   }
+}
+
+static void Push_Wayland_Hud(wayland_context *Wayland, opengl_context *GL)
+{
+   opengl_frame_stats *Stats = &Wayland->Last_Stats;
+   vec2 Position = {8.0f, (float)Wayland->Window_Height - 22.0f};
+   vec4 Color = {1.0f, 1.0f, 0.4f, 1.0f};
+   Push_Text_Format(GL, Position, 14.0f, Color,
+                    "Frame %llu: %.3f ms, %llu wakeups\n"
+                    "%u commands, %u draw calls, %u state calls (%u elided)\n"
+                    "Damage: %.1f%% of pixels redrawn, %llu unchanged frames",
+                    (unsigned long long)Wayland->Frame_Count, (double)Wayland->Last_Frame_Time / 1e6,
+                    (unsigned long long)Wayland->Wakeup_Count,
+                    Stats->Commands_Submitted, Stats->Draw_Calls, Stats->State_Calls_Issued, Stats->State_Calls_Elided,
+                    (Wayland->Pixels_Total) ? 100.0*(double)Wayland->Pixels_Redrawn / (double)Wayland->Pixels_Total : 100.0,
+                    (unsigned long long)Wayland->Unchanged_Frame_Count);
+}
+
+static void Render_Wayland_Frame(wayland_context *Wayland, opengl_context *GL, platform_memory *Memory)
 {
+   PROFILE_BEGIN_FRAME(&GL->Profiler);
+   u64 Frame_Start = Get_Clock();
+
+   Linux_Poll_File_Watches();
+
+   Reset_Arena(&Memory->Frame);
+   platform_counters Frame_Counters = Platform_Counters;
+
+   // NOTE: Without a buffer age every frame is a full redraw anyway, so
+   // damage tracking stays off.
+   opengl_damage *Damage = &GL->Damage;
+   bool Track_Damage = (Wayland->Has_Buffer_Age && !Wayland->Full_Redraw);
+   if(Track_Damage && (Damage->Width != Wayland->Window_Width || Damage->Height != Wayland->Window_Height))
+   {
+      Resize_Opengl_Damage(GL, Wayland->Window_Width, Wayland->Window_Height);
+   }
+
+   Begin_Opengl_Frame(GL);
+   Push_Test_Scene(GL);
+   if(Wayland->Hud)
+   {
+      Push_Wayland_Hud(Wayland, GL);
+   }
+   if(Wayland->Bloom)
+   {
+      Add_Opengl_Bloom(GL, Wayland->Window_Width, Wayland->Window_Height, Wayland->Bloom_Intensity);
+   }
+
+   if(Track_Damage)
+   {
+      EGLint Age = 0;
+      if(!eglQuerySurface(Wayland->Opengl_Display, Wayland->Opengl_Surface, EGL_BUFFER_AGE_EXT, &Age))
+      {
+         Age = 0;
+      }
+      Damage->Buffer_Age = Age;
+   }
+
+   PROFILE_BEGIN_CPU(&GL->Profiler, "Render");
+   Render_With_Opengl(GL);
+   PROFILE_END_CPU(&GL->Profiler, "Render");
+
+   // NOTE: A frame that changed nothing isn't presented at all, which also
+   // leaves the back buffer, and so its age, as it was.
+   bool Partial = (Track_Damage && !Damage->Full);
+   bool Unchanged = (Partial && Damage->Rect_Count == 0);
+
+   Wayland->Pixels_Total += (u64)Wayland->Window_Width*Wayland->Window_Height;
+   Wayland->Pixels_Redrawn += ((Track_Damage) ? GL->Stats.Damage_Pixels :
+                               (u64)Wayland->Window_Width*Wayland->Window_Height);
+
+   PROFILE_BEGIN_CPU(&GL->Profiler, "Swap");
+   if(Unchanged)
+   {
+      Wayland->Unchanged_Frame_Count++;
+   }
+   else
+   {
+      if(!Wayland->Spin)
+      {
+         // NOTE: Requested before the swap, which commits the surface, so the
+         // callback fires when the compositor wants the frame after this one.
+         Wayland->Frame_Callback = wl_surface_frame(Wayland->Surface);
+         wl_callback_add_listener(Wayland->Frame_Callback, &Frame_Listener, Wayland);
+      }
+
+      if(Partial && Wayland->Swap_Buffers_With_Damage)
+      {
+         EGLint Rects[4*OPENGL_DAMAGE_MAX_RECTS];
+         for(u32 Index = 0; Index < Damage->Rect_Count; ++Index)
+         {
+            opengl_rect *Rect = Damage->Rects + Index;
+            Rects[4*Index + 0] = Rect->X;
+            Rects[4*Index + 1] = Rect->Y;
+            Rects[4*Index + 2] = Rect->Width;
+            Rects[4*Index + 3] = Rect->Height;
+         }
+         Wayland->Swap_Buffers_With_Damage(Wayland->Opengl_Display, Wayland->Opengl_Surface, Rects, (EGLint)Damage->Rect_Count);
+      }
+      else
+      {
+         eglSwapBuffers(Wayland->Opengl_Display, Wayland->Opengl_Surface);
+      }
+   }
+   PROFILE_END_CPU(&GL->Profiler, "Swap");
+
+   // NOTE: Steady state frames must not go back to the OS. Frames that
+   // (re)load assets are the only exception.
+   if(!GL->Loading_This_Frame)
+   {
+      Assert(Platform_Counters.Allocation_Count == Frame_Counters.Allocation_Count);
+      Assert(Platform_Counters.Syscall_Count == Frame_Counters.Syscall_Count);
+   }
+
+   PROFILE_END_FRAME(&GL->Profiler);
+
+   // NOTE: The scene is static, so another frame is only needed while shader
+   // builds or mesh uploads are still in flight.
+   Wayland->Needs_Redraw = (Has_Pending_Opengl_Programs(GL) || Has_Pending_Opengl_Meshes(GL));
+   Wayland->Frame_Count++;
+   Wayland->Last_Stats = GL->Stats;
+   Wayland->Last_Frame_Time = Get_Clock() - Frame_Start;
+}
+
+static double Get_Process_Cpu_Seconds(void)
+{
+   struct rusage Usage;
+   getrusage(RUSAGE_SELF, &Usage);
+
+   double Result = ((double)Usage.ru_utime.tv_sec + (double)Usage.ru_utime.tv_usec/1e6 +
+                    (double)Usage.ru_stime.tv_sec + (double)Usage.ru_stime.tv_usec/1e6);
+   return(Result);
+}
+
+int main(int Argument_Count, char **Arguments)
+{
+   platform_memory Memory = {0};
+   if(!Initialize_Memory(&Memory, 64*1024*1024, 16*1024*1024))
+   {
+      return(1);
+   }
+
+   // NOTE: The renderer sizes its per-thread command buffers from the job
+   // system, so it has to be up first.
+   if(!Initialize_Jobs(0))
+   {
+      return(1);
+   }
+
    wayland_context Wayland = {0};
+   char *Capture_Path = 0;
+   for(int Index = 1; Index < Argument_Count; ++Index)
+   {
+      if(strcmp(Arguments[Index], "-spin") == 0)
+      {
+         Wayland.Spin = true;
+      }
+      else if(strcmp(Arguments[Index], "-capture") == 0 && Index + 1 < Argument_Count)
+      {
+         Capture_Path = Arguments[++Index];
+      }
+      else if(strcmp(Arguments[Index], "-full-redraw") == 0)
+      {
+         Wayland.Full_Redraw = true;
+      }
+      else if(strcmp(Arguments[Index], "-hud") == 0)
+      {
+         Wayland.Hud = true;
+      }
+      else if(strcmp(Arguments[Index], "-bloom") == 0 && Index + 1 < Argument_Count)
+      {
+         Wayland.Bloom = true;
+         Wayland.Bloom_Intensity = (float)atof(Arguments[++Index]);
+      }
+      else
+      {
+         fprintf(stderr, "Usage: %s [-spin] [-full-redraw] [-hud] [-bloom INTENSITY] [-capture trace.gltrace]\n", Arguments[0]);
+         return(1);
+      }
+   }
+
+   Wayland.Needs_Redraw = true;
    Initialize_Wayland(&Wayland, 640, 480);
+   if(Capture_Path && !Begin_Opengl_Capture(Capture_Path, 640, 480))
+   {
+      return(1);
+   }
 
-   opengl_context GL = {0};
-   Initialize_Opengl(&GL);
+   opengl_context *GL = Push_Struct(&Memory.Permanent, opengl_context);
+   Initialize_Opengl(GL, &Memory);
+
+   u64 Start = Get_Clock();
+   double Start_Cpu = Get_Process_Cpu_Seconds();
 
    while(Wayland.Running)
    {
-      wl_display_dispatch_pending(Wayland.Display);
+      if(Wayland.Spin)
+      {
+         // NOTE: The old loop: dispatch whatever arrived and draw regardless.
+         wl_display_dispatch_pending(Wayland.Display);
+         wl_display_flush(Wayland.Display);
+         Wayland.Wakeup_Count++;
 
-      Render_With_Opengl(&GL);
+         Render_Wayland_Frame(&Wayland, GL, &Memory);
+      }
+      else
+      {
+         bool Draw = (Wayland.Needs_Redraw && !Wayland.Frame_Callback && !Wayland.Suspended);
+         if(Draw)
+         {
+            Render_Wayland_Frame(&Wayland, GL, &Memory);
+         }
+         Wait_For_Wayland_Events(&Wayland, !Wayland.Needs_Redraw || Wayland.Frame_Callback || Wayland.Suspended);
+      }
+   }
 
-      eglSwapBuffers(Wayland.Opengl_Display, Wayland.Opengl_Surface);
-      wl_display_flush(Wayland.Display);
+   double Elapsed = (double)(Get_Clock() - Start) / 1e9;
+   double Cpu = Get_Process_Cpu_Seconds() - Start_Cpu;
+   if(Elapsed > 0.0)
+   {
+      printf("Ran %.1fs: %.1f%% CPU, %.1f wakeups/s, %.1f frames/s\n", Elapsed,
+             100.0 * Cpu / Elapsed, Wayland.Wakeup_Count / Elapsed, Wayland.Frame_Count / Elapsed);
    }
+   if(Wayland.Pixels_Total > 0)
+   {
+      printf("Damage (%s%s): %.2f%% of pixels redrawn, %llu unchanged frames not presented\n",
+             (Wayland.Has_Buffer_Age && !Wayland.Full_Redraw) ? "buffer age" : "full redraws",
+             (Wayland.Swap_Buffers_With_Damage) ? ", swap with damage" : "",
+             100.0*(double)Wayland.Pixels_Redrawn / (double)Wayland.Pixels_Total,
+             (unsigned long long)Wayland.Unchanged_Frame_Count);
+   }
+
+   PROFILE_WRITE_REPORT(&GL->Profiler, "profile.csv");
+   PROFILE_DESTROY(&GL->Profiler);
 
+   End_Opengl_Capture();
    Destroy_Wayland(&Wayland);
+   Destroy_Jobs();
 
    return(0);
 }
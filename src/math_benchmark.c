@@ -0,0 +1,308 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Micro-benchmark for the batched math kernels in shared_math.h. Every
+// kernel is run at every SIMD level the CPU supports over a range of batch
+// sizes, and the time per element is reported next to the speedup over the
+// scalar path. Each level's output is also checked against the scalar one,
+// so a broken vector path fails the run instead of just looking fast.
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared.h"
+#include "platform.h"
+#include "linux_platform.c"
+
+#define MATH_BENCHMARK_MAX_BATCH 65536
+#define MATH_BENCHMARK_ELEMENTS_PER_RUN (1 << 22)
+#define MATH_BENCHMARK_RUN_COUNT 5
+#define MATH_BENCHMARK_TOLERANCE 1e-4f
+
+typedef enum {
+   Math_Kernel_Transform_Points,
+   Math_Kernel_Multiply_Matrices,
+   Math_Kernel_Compose_Trs,
+
+   Math_Kernel_Count,
+} math_kernel;
+
+static char *Math_Kernel_Names[Math_Kernel_Count] = {"transform_points", "multiply_matrices", "compose_trs"};
+
+typedef struct {
+   vec3_array Points;
+   vec3_array Translations;
+   quat_array Rotations;
+   vec3_array Scales;
+   mat4_array A;
+   mat4_array B;
+
+   // NOTE: One output set per SIMD level, so they can be compared.
+   vec3_array Transformed[Simd_Level_Count];
+   mat4_array Matrices[Simd_Level_Count];
+} math_benchmark;
+
+static u32 Random_State = 0x9E3779B9;
+
+static float Random_Float(float Min, float Max)
+{
+   Random_State ^= Random_State << 13;
+   Random_State ^= Random_State >> 17;
+   Random_State ^= Random_State << 5;
+
+   float Result = Min + (Max - Min)*((float)(Random_State >> 8) / (float)(1 << 24));
+   return(Result);
+}
+
+static float *Push_Random_Floats(arena *Arena, u32 Count, float Min, float Max)
+{
+   float *Result = Push_Array(Arena, Count, float);
+   for(u32 Index = 0; Index < Count; ++Index)
+   {
+      Result[Index] = Random_Float(Min, Max);
+   }
+   return(Result);
+}
+
+static vec3_array Push_Vec3_Array(arena *Arena, u32 Count, float Min, float Max)
+{
+   vec3_array Result;
+   Result.X = Push_Random_Floats(Arena, Count, Min, Max);
+   Result.Y = Push_Random_Floats(Arena, Count, Min, Max);
+   Result.Z = Push_Random_Floats(Arena, Count, Min, Max);
+   return(Result);
+}
+
+static mat4_array Push_Mat4_Array(arena *Arena, u32 Count, float Min, float Max)
+{
+   mat4_array Result;
+   for(int Element = 0; Element < 16; ++Element)
+   {
+      Result.E[Element] = Push_Random_Floats(Arena, Count, Min, Max);
+   }
+   return(Result);
+}
+
+static void Initialize_Math_Benchmark(math_benchmark *Bench, arena *Arena, u32 Count)
+{
+   Bench->Points = Push_Vec3_Array(Arena, Count, -100, 100);
+   Bench->Translations = Push_Vec3_Array(Arena, Count, -100, 100);
+   Bench->Scales = Push_Vec3_Array(Arena, Count, 0.1f, 4);
+   Bench->A = Push_Mat4_Array(Arena, Count, -2, 2);
+   Bench->B = Push_Mat4_Array(Arena, Count, -2, 2);
+
+   Bench->Rotations.X = Push_Array(Arena, Count, float);
+   Bench->Rotations.Y = Push_Array(Arena, Count, float);
+   Bench->Rotations.Z = Push_Array(Arena, Count, float);
+   Bench->Rotations.W = Push_Array(Arena, Count, float);
+   for(u32 Index = 0; Index < Count; ++Index)
+   {
+      quat Rotation = {Random_Float(-1, 1), Random_Float(-1, 1), Random_Float(-1, 1), Random_Float(-1, 1)};
+      Rotation = Quat_Normalize(Rotation);
+      Bench->Rotations.X[Index] = Rotation.X;
+      Bench->Rotations.Y[Index] = Rotation.Y;
+      Bench->Rotations.Z[Index] = Rotation.Z;
+      Bench->Rotations.W[Index] = Rotation.W;
+   }
+
+   for(int Level = 0; Level < Simd_Level_Count; ++Level)
+   {
+      Bench->Transformed[Level] = Push_Vec3_Array(Arena, Count, 0, 0);
+      Bench->Matrices[Level] = Push_Mat4_Array(Arena, Count, 0, 0);
+   }
+}
+
+static void Run_Math_Kernel(math_benchmark *Bench, math_kernel Kernel, simd_level Level, u32 Count)
+{
+   // NOTE: Any fixed matrix will do for the point transform.
+   static mat4 Transform = {{{0.8f, 0.6f, 0, 0}, {-0.6f, 0.8f, 0, 0}, {0, 0, 2, 0}, {10, -20, 30, 1}}};
+
+   switch(Kernel)
+   {
+      case Math_Kernel_Transform_Points: {
+         Transform_Points_With(Level, &Transform, Bench->Points, Bench->Transformed[Level], Count);
+      } break;
+
+      case Math_Kernel_Multiply_Matrices: {
+         Multiply_Matrices_With(Level, Bench->A, Bench->B, Bench->Matrices[Level], Count);
+      } break;
+
+      case Math_Kernel_Compose_Trs: {
+         Compose_Trs_With(Level, Bench->Translations, Bench->Rotations, Bench->Scales, Bench->Matrices[Level], Count);
+      } break;
+
+      default: {
+         Assert(0);
+      } break;
+   }
+}
+
+static float Compare_Floats(float *A, float *B, u32 Count)
+{
+   float Result = 0;
+   for(u32 Index = 0; Index < Count; ++Index)
+   {
+      // NOTE: Relative once values get big, since FMA rounds differently.
+      float Magnitude = fabsf(A[Index]) > 1 ? fabsf(A[Index]) : 1;
+      float Error = fabsf(A[Index] - B[Index]) / Magnitude;
+      if(Error > Result)
+      {
+         Result = Error;
+      }
+   }
+   return(Result);
+}
+
+static float Compare_Math_Kernel(math_benchmark *Bench, math_kernel Kernel, simd_level Level, u32 Count)
+{
+   float Result = 0;
+   if(Kernel == Math_Kernel_Transform_Points)
+   {
+      vec3_array A = Bench->Transformed[Simd_Scalar];
+      vec3_array B = Bench->Transformed[Level];
+      Result = fmaxf(Compare_Floats(A.X, B.X, Count), fmaxf(Compare_Floats(A.Y, B.Y, Count), Compare_Floats(A.Z, B.Z, Count)));
+   }
+   else
+   {
+      for(int Element = 0; Element < 16; ++Element)
+      {
+         Result = fmaxf(Result, Compare_Floats(Bench->Matrices[Simd_Scalar].E[Element], Bench->Matrices[Level].E[Element], Count));
+      }
+   }
+   return(Result);
+}
+
+// NOTE: Checks the scalar kernels against the one-off functions, which the
+// SIMD kernels are then checked against in turn.
+static bool Check_Scalar_Kernels(math_benchmark *Bench, u32 Count)
+{
+   float Error = 0;
+
+   Run_Math_Kernel(Bench, Math_Kernel_Multiply_Matrices, Simd_Scalar, Count);
+   for(u32 Index = 0; Index < Count; ++Index)
+   {
+      mat4 A, B;
+      for(int Element = 0; Element < 16; ++Element)
+      {
+         A.E[Element/4][Element%4] = Bench->A.E[Element][Index];
+         B.E[Element/4][Element%4] = Bench->B.E[Element][Index];
+      }
+      mat4 Expected = Mat4_Multiply(A, B);
+      for(int Element = 0; Element < 16; ++Element)
+      {
+         Error = fmaxf(Error, fabsf(Expected.E[Element/4][Element%4] - Bench->Matrices[Simd_Scalar].E[Element][Index]));
+      }
+   }
+
+   Run_Math_Kernel(Bench, Math_Kernel_Compose_Trs, Simd_Scalar, Count);
+   for(u32 Index = 0; Index < Count; ++Index)
+   {
+      vec3 T = {Bench->Translations.X[Index], Bench->Translations.Y[Index], Bench->Translations.Z[Index]};
+      quat R = {Bench->Rotations.X[Index], Bench->Rotations.Y[Index], Bench->Rotations.Z[Index], Bench->Rotations.W[Index]};
+      vec3 S = {Bench->Scales.X[Index], Bench->Scales.Y[Index], Bench->Scales.Z[Index]};
+
+      mat4 Expected = Mat4_From_Trs(T, R, S);
+      vec3 Point = {Bench->Points.X[Index], Bench->Points.Y[Index], Bench->Points.Z[Index]};
+      vec3 Expected_Point = Mat4_Transform_Point(Expected, Point);
+
+      // NOTE: Transform the point through the kernel's matrix too, which
+      // covers Transform_Points with a different matrix per element.
+      mat4 Actual;
+      for(int Element = 0; Element < 16; ++Element)
+      {
+         Actual.E[Element/4][Element%4] = Bench->Matrices[Simd_Scalar].E[Element][Index];
+         Error = fmaxf(Error, fabsf(Expected.E[Element/4][Element%4] - Actual.E[Element/4][Element%4]));
+      }
+
+      vec3_array In = {&Point.X, &Point.Y, &Point.Z};
+      vec3 Actual_Point;
+      vec3_array Out = {&Actual_Point.X, &Actual_Point.Y, &Actual_Point.Z};
+      Transform_Points_With(Simd_Scalar, &Actual, In, Out, 1);
+
+      Error = fmaxf(Error, fabsf(Expected_Point.X - Actual_Point.X) / 100);
+      Error = fmaxf(Error, fabsf(Expected_Point.Y - Actual_Point.Y) / 100);
+      Error = fmaxf(Error, fabsf(Expected_Point.Z - Actual_Point.Z) / 100);
+   }
+
+   bool Result = (Error <= MATH_BENCHMARK_TOLERANCE);
+   if(!Result)
+   {
+      fprintf(stderr, "Scalar kernels disagree with the reference functions (error %g).\n", Error);
+   }
+   return(Result);
+}
+
+int main(int Argument_Count, char **Arguments)
+{
+   platform_memory Memory = {0};
+   if(!Initialize_Memory(&Memory, 256*1024*1024, 0))
+   {
+      return(1);
+   }
+
+   math_benchmark Bench;
+   Initialize_Math_Benchmark(&Bench, &Memory.Permanent, MATH_BENCHMARK_MAX_BATCH);
+
+   if(!Check_Scalar_Kernels(&Bench, 1000))
+   {
+      return(1);
+   }
+
+   simd_level Max_Level = Get_Simd_Level();
+   printf("SIMD level: %s\n\n", Simd_Level_Names[Max_Level]);
+   printf("%-18s %8s", "kernel", "batch");
+   for(int Level = 0; Level <= (int)Max_Level; ++Level)
+   {
+      printf(" %9s ns", Simd_Level_Names[Level]);
+   }
+   printf(" %9s\n", "speedup");
+
+   // NOTE: Odd sizes on purpose, so the scalar tails are exercised.
+   u32 Batch_Sizes[] = {16, 257, 4099, MATH_BENCHMARK_MAX_BATCH};
+
+   bool Result = true;
+   for(int Kernel = 0; Kernel < Math_Kernel_Count; ++Kernel)
+   {
+      for(u32 Batch_Index = 0; Batch_Index < Array_Count(Batch_Sizes); ++Batch_Index)
+      {
+         u32 Count = Batch_Sizes[Batch_Index];
+         u32 Repeat_Count = MATH_BENCHMARK_ELEMENTS_PER_RUN / Count;
+
+         printf("%-18s %8u", Math_Kernel_Names[Kernel], Count);
+
+         double Nanoseconds[Simd_Level_Count] = {0};
+         for(int Level = 0; Level <= (int)Max_Level; ++Level)
+         {
+            // NOTE: Best of several runs, to keep scheduler noise out.
+            u64 Best = ~0ull;
+            for(int Run = 0; Run < MATH_BENCHMARK_RUN_COUNT; ++Run)
+            {
+               u64 Start = Get_Clock();
+               for(u32 Repeat = 0; Repeat < Repeat_Count; ++Repeat)
+               {
+                  Run_Math_Kernel(&Bench, Kernel, Level, Count);
+               }
+               u64 Elapsed = Get_Clock() - Start;
+               if(Elapsed < Best)
+               {
+                  Best = Elapsed;
+               }
+            }
+            Nanoseconds[Level] = (double)Best / ((double)Repeat_Count * Count);
+            printf(" %12.3f", Nanoseconds[Level]);
+
+            float Error = Compare_Math_Kernel(&Bench, Kernel, Level, Count);
+            if(Error > MATH_BENCHMARK_TOLERANCE)
+            {
+               fprintf(stderr, "\n%s at %s is off by %g.\n", Math_Kernel_Names[Kernel], Simd_Level_Names[Level], Error);
+               Result = false;
+            }
+         }
+         printf(" %8.2fx\n", Nanoseconds[Simd_Scalar] / Nanoseconds[Max_Level]);
+      }
+   }
+
+   return(Result ? 0 : 1);
+}
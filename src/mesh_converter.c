@@ -0,0 +1,506 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Offline converter from Wavefront OBJ to the binary mesh format in
+// mesh_format.h. Everything slow happens here, once: parsing, triangulation,
+// picking the index width and building the LOD chain. The renderer then only
+// has to map the result and upload it.
+//
+// Positions are taken from the X and Y of each "v" line, and vertex colors
+// from the optional "v x y z r g b" extension (white otherwise). Faces with
+// more than three corners are fan triangulated. Texture coordinates, normals
+// and materials are ignored, since the vertex formats have no room for them.
+// Vertices are written in the standard format unless -compact asks for half
+// float positions and 8-bit colors.
+//
+// Before writing, duplicate vertices are welded and every LOD is reordered
+// for the post-transform vertex cache, see mesh_optimizer.c. Z isn't written,
+// but it's kept around for -overdraw to sort clusters by.
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared.h"
+#include "platform.h"
+#include "mesh_format.h"
+#include "linux_platform.c"
+
+// NOTE: Coarser LODs are built by vertex clustering: positions are snapped to
+// a grid, every vertex in a cell is merged into the cell's first vertex, and
+// triangles that collapse are dropped. Each LOD halves the grid resolution,
+// and a LOD that doesn't drop at least a fifth of the previous one's
+// triangles is skipped.
+#define MESH_CONVERTER_LOD_GRID_SIZE 256
+#define MESH_CONVERTER_LOD_MIN_REDUCTION 0.8f
+#define MESH_CONVERTER_LOD_MIN_TRIANGLES 16
+
+typedef struct {
+   u32 Vertex_Count;
+   mesh_file_vertex *Vertices;
+   float *Depths;
+
+   u32 Index_Count;
+   u32 *Indices;
+
+   vec2 Bounds_Min;
+   vec2 Bounds_Max;
+
+   u32 Lod_Count;
+   mesh_file_lod Lods[MESH_FILE_MAX_LODS];
+} converter_mesh;
+
+#include "mesh_optimizer.c"
+
+static char *Skip_Spaces(char *At)
+{
+   while(*At == ' ' || *At == '\t')
+   {
+      At++;
+   }
+   return(At);
+}
+
+static bool Is_Obj_Command(char *Line, char *Command)
+{
+   size Length = strlen(Command);
+   bool Result = (strncmp(Line, Command, Length) == 0 && (Line[Length] == ' ' || Line[Length] == '\t'));
+   return(Result);
+}
+
+// NOTE: Resolves an OBJ vertex reference, which is 1-based, or relative to the
+// end of the list so far when negative. Returns false for anything out of
+// range.
+static bool Resolve_Obj_Index(long Reference, u32 Vertex_Count, u32 *Index)
+{
+   bool Result = false;
+   if(Reference > 0 && (u64)Reference <= Vertex_Count)
+   {
+      *Index = (u32)(Reference - 1);
+      Result = true;
+   }
+   else if(Reference < 0 && (u64)-Reference <= Vertex_Count)
+   {
+      *Index = (u32)(Vertex_Count + Reference);
+      Result = true;
+   }
+   return(Result);
+}
+
+static bool Load_Obj_Mesh(arena *Arena, char *Path, converter_mesh *Mesh)
+{
+   bool Result = false;
+
+   char *Contents = Read_Entire_File(Arena, Path, 0);
+   if(!Contents)
+   {
+      fprintf(stderr, "Failed to read %s.\n", Path);
+      return(Result);
+   }
+
+   // NOTE: The first pass only counts, so the arrays can be sized exactly.
+   u32 Vertex_Capacity = 0;
+   u64 Index_Capacity = 0;
+   for(char *Line = Contents; *Line;)
+   {
+      char *End = Line;
+      while(*End && *End != '\n')
+      {
+         End++;
+      }
+
+      if(Is_Obj_Command(Line, "v"))
+      {
+         Vertex_Capacity++;
+      }
+      else if(Is_Obj_Command(Line, "f"))
+      {
+         u32 Corner_Count = 0;
+         for(char *At = Skip_Spaces(Line + 1); At < End && *At != '\r';)
+         {
+            Corner_Count++;
+            while(At < End && *At != ' ' && *At != '\t' && *At != '\r')
+            {
+               At++;
+            }
+            At = Skip_Spaces(At);
+         }
+         if(Corner_Count >= 3)
+         {
+            Index_Capacity += 3*(Corner_Count - 2);
+         }
+      }
+
+      Line = (*End) ? End + 1 : End;
+   }
+
+   if(Index_Capacity > 0xFFFFFFFF)
+   {
+      fprintf(stderr, "%s has too many faces.\n", Path);
+      return(Result);
+   }
+
+   Mesh->Vertices = Push_Array(Arena, Vertex_Capacity, mesh_file_vertex);
+   Mesh->Depths = Push_Array(Arena, Vertex_Capacity, float);
+   Mesh->Indices = Push_Array(Arena, Index_Capacity, u32);
+   Mesh->Vertex_Count = 0;
+   Mesh->Index_Count = 0;
+
+   Result = true;
+   u32 Line_Number = 1;
+   for(char *Line = Contents; Result && *Line; ++Line_Number)
+   {
+      char *End = Line;
+      while(*End && *End != '\n')
+      {
+         End++;
+      }
+      char Terminator = *End;
+      *End = 0;
+
+      if(Is_Obj_Command(Line, "v"))
+      {
+         float Values[6] = {0, 0, 0, 1, 1, 1};
+         int Value_Count = sscanf(Line + 1, "%f %f %f %f %f %f", Values+0, Values+1, Values+2, Values+3, Values+4, Values+5);
+         if(Value_Count >= 2)
+         {
+            Mesh->Depths[Mesh->Vertex_Count] = Values[2];
+            mesh_file_vertex *Vertex = Mesh->Vertices + Mesh->Vertex_Count++;
+            Vertex->Position = (vec2){Values[0], Values[1]};
+            Vertex->Color = (vec4){Values[3], Values[4], Values[5], 1};
+         }
+         else
+         {
+            fprintf(stderr, "%s:%u: Malformed vertex.\n", Path, Line_Number);
+            Result = false;
+         }
+      }
+      else if(Is_Obj_Command(Line, "f"))
+      {
+         u32 First = 0;
+         u32 Previous = 0;
+         u32 Corner_Count = 0;
+
+         char *At = Line + 1;
+         while(Result)
+         {
+            // NOTE: Only the position reference matters, so anything after a
+            // slash ("v/vt/vn", "v//vn") is skipped.
+            char *Next;
+            long Reference = strtol(At, &Next, 10);
+            if(Next == At)
+            {
+               break;
+            }
+            At = Next;
+            while(*At && *At != ' ' && *At != '\t')
+            {
+               At++;
+            }
+
+            u32 Index;
+            if(Resolve_Obj_Index(Reference, Mesh->Vertex_Count, &Index))
+            {
+               if(Corner_Count >= 2)
+               {
+                  Mesh->Indices[Mesh->Index_Count++] = First;
+                  Mesh->Indices[Mesh->Index_Count++] = Previous;
+                  Mesh->Indices[Mesh->Index_Count++] = Index;
+               }
+               else if(Corner_Count == 0)
+               {
+                  First = Index;
+               }
+               Previous = Index;
+               Corner_Count++;
+            }
+            else
+            {
+               fprintf(stderr, "%s:%u: Face references a missing vertex.\n", Path, Line_Number);
+               Result = false;
+            }
+         }
+      }
+
+      *End = Terminator;
+      Line = (*End) ? End + 1 : End;
+   }
+
+   if(Result && (Mesh->Vertex_Count == 0 || Mesh->Index_Count == 0))
+   {
+      fprintf(stderr, "%s has no triangles.\n", Path);
+      Result = false;
+   }
+
+   return(Result);
+}
+
+static void Compute_Mesh_Bounds(converter_mesh *Mesh)
+{
+   Mesh->Bounds_Min = Mesh->Bounds_Max = Mesh->Vertices[0].Position;
+   for(u32 Index = 1; Index < Mesh->Vertex_Count; ++Index)
+   {
+      vec2 Position = Mesh->Vertices[Index].Position;
+      Mesh->Bounds_Min.X = fminf(Mesh->Bounds_Min.X, Position.X);
+      Mesh->Bounds_Min.Y = fminf(Mesh->Bounds_Min.Y, Position.Y);
+      Mesh->Bounds_Max.X = fmaxf(Mesh->Bounds_Max.X, Position.X);
+      Mesh->Bounds_Max.Y = fmaxf(Mesh->Bounds_Max.Y, Position.Y);
+   }
+}
+
+// NOTE: Appends the clustered version of LOD 0 for a Grid_Size x Grid_Size
+// grid, and returns its index count. The index array must have room for
+// another full copy of LOD 0.
+static u32 Append_Clustered_Lod(arena *Arena, converter_mesh *Mesh, u32 Grid_Size)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   u32 Cell_Count = Grid_Size*Grid_Size;
+   u32 *Cell_Vertices = Push_Array(Arena, Cell_Count, u32);
+   memset(Cell_Vertices, 0xFF, Cell_Count*sizeof(u32));
+
+   u32 *Remap = Push_Array(Arena, Mesh->Vertex_Count, u32);
+
+   float Extent_X = fmaxf(Mesh->Bounds_Max.X - Mesh->Bounds_Min.X, 1e-20f);
+   float Extent_Y = fmaxf(Mesh->Bounds_Max.Y - Mesh->Bounds_Min.Y, 1e-20f);
+   for(u32 Index = 0; Index < Mesh->Vertex_Count; ++Index)
+   {
+      vec2 Position = Mesh->Vertices[Index].Position;
+      u32 Cell_X = (u32)((Position.X - Mesh->Bounds_Min.X) / Extent_X * (float)Grid_Size);
+      u32 Cell_Y = (u32)((Position.Y - Mesh->Bounds_Min.Y) / Extent_Y * (float)Grid_Size);
+      if(Cell_X >= Grid_Size) Cell_X = Grid_Size - 1;
+      if(Cell_Y >= Grid_Size) Cell_Y = Grid_Size - 1;
+
+      u32 *Cell = Cell_Vertices + Cell_Y*Grid_Size + Cell_X;
+      if(*Cell == 0xFFFFFFFF)
+      {
+         *Cell = Index;
+      }
+      Remap[Index] = *Cell;
+   }
+
+   mesh_file_lod *Base = Mesh->Lods + 0;
+   u32 *Source = Mesh->Indices + Base->First_Index;
+   u32 *Dest = Mesh->Indices + Mesh->Index_Count;
+   u32 Result = 0;
+   for(u32 Index = 0; Index < Base->Index_Count; Index += 3)
+   {
+      u32 A = Remap[Source[Index + 0]];
+      u32 B = Remap[Source[Index + 1]];
+      u32 C = Remap[Source[Index + 2]];
+      if(A != B && B != C && C != A)
+      {
+         Dest[Result++] = A;
+         Dest[Result++] = B;
+         Dest[Result++] = C;
+      }
+   }
+
+   End_Temporary_Memory(Temporary);
+   return(Result);
+}
+
+static void Build_Mesh_Lods(arena *Arena, converter_mesh *Mesh)
+{
+   // NOTE: Room for every LOD, none of which can be bigger than LOD 0.
+   u32 Base_Count = Mesh->Index_Count;
+   u32 *Indices = Push_Array(Arena, (size)Base_Count*MESH_FILE_MAX_LODS, u32);
+   memcpy(Indices, Mesh->Indices, Base_Count*sizeof(u32));
+   Mesh->Indices = Indices;
+
+   Mesh->Lod_Count = 1;
+   Mesh->Lods[0].First_Index = 0;
+   Mesh->Lods[0].Index_Count = Base_Count;
+
+   u32 Previous_Count = Base_Count;
+   for(u32 Grid_Size = MESH_CONVERTER_LOD_GRID_SIZE; Grid_Size >= 2 && Mesh->Lod_Count < MESH_FILE_MAX_LODS; Grid_Size /= 2)
+   {
+      if(Previous_Count/3 <= MESH_CONVERTER_LOD_MIN_TRIANGLES)
+      {
+         break;
+      }
+
+      u32 Count = Append_Clustered_Lod(Arena, Mesh, Grid_Size);
+      if(Count == 0)
+      {
+         break;
+      }
+      else if((float)Count <= MESH_CONVERTER_LOD_MIN_REDUCTION*(float)Previous_Count)
+      {
+         mesh_file_lod *Lod = Mesh->Lods + Mesh->Lod_Count++;
+         Lod->First_Index = Mesh->Index_Count;
+         Lod->Index_Count = Count;
+
+         Mesh->Index_Count += Count;
+         Previous_Count = Count;
+      }
+   }
+}
+
+static bool Write_Mesh_File(arena *Arena, char *Path, converter_mesh *Mesh, mesh_vertex_format Vertex_Format)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   u32 Index_Size = (Mesh->Vertex_Count <= 0x10000) ? sizeof(u16) : sizeof(u32);
+   u32 Vertex_Stride = Mesh_Vertex_Strides[Vertex_Format];
+
+   mesh_file_header Header = {0};
+   Header.Magic = MESH_FILE_MAGIC;
+   Header.Version = MESH_FILE_VERSION;
+   Header.Vertex_Format = Vertex_Format;
+   Header.Vertex_Stride = Vertex_Stride;
+   Header.Vertex_Count = Mesh->Vertex_Count;
+   Header.Vertex_Offset = Align_Mesh_File_Offset(sizeof(mesh_file_header));
+   Header.Index_Size = Index_Size;
+   Header.Index_Count = Mesh->Index_Count;
+   Header.Index_Offset = Align_Mesh_File_Offset(Header.Vertex_Offset + (u64)Mesh->Vertex_Count*Vertex_Stride);
+   Header.Bounds_Min = Mesh->Bounds_Min;
+   Header.Bounds_Max = Mesh->Bounds_Max;
+   Header.Lod_Count = Mesh->Lod_Count;
+   memcpy(Header.Lods, Mesh->Lods, sizeof(Header.Lods));
+
+   size File_Size = Header.Index_Offset + (u64)Mesh->Index_Count*Index_Size;
+   u8 *File = Push_Size(Arena, File_Size);
+
+   memcpy(File, &Header, sizeof(Header));
+   if(Vertex_Format == Mesh_Vertex_Format_Compact)
+   {
+      mesh_file_compact_vertex *Vertices = (mesh_file_compact_vertex *)(File + Header.Vertex_Offset);
+      for(u32 Index = 0; Index < Mesh->Vertex_Count; ++Index)
+      {
+         mesh_file_vertex *Source = Mesh->Vertices + Index;
+         Vertices[Index].Position[0] = Float_To_Half(Source->Position.X);
+         Vertices[Index].Position[1] = Float_To_Half(Source->Position.Y);
+         Vertices[Index].Color[0] = Pack_Unorm8(Source->Color.R);
+         Vertices[Index].Color[1] = Pack_Unorm8(Source->Color.G);
+         Vertices[Index].Color[2] = Pack_Unorm8(Source->Color.B);
+         Vertices[Index].Color[3] = Pack_Unorm8(Source->Color.A);
+      }
+   }
+   else
+   {
+      memcpy(File + Header.Vertex_Offset, Mesh->Vertices, Mesh->Vertex_Count*sizeof(mesh_file_vertex));
+   }
+   if(Index_Size == sizeof(u16))
+   {
+      u16 *Indices = (u16 *)(File + Header.Index_Offset);
+      for(u32 Index = 0; Index < Mesh->Index_Count; ++Index)
+      {
+         Indices[Index] = (u16)Mesh->Indices[Index];
+      }
+   }
+   else
+   {
+      memcpy(File + Header.Index_Offset, Mesh->Indices, Mesh->Index_Count*sizeof(u32));
+   }
+
+   Assert(Validate_Mesh_File((mesh_file_header *)File, File_Size));
+   bool Result = Write_Entire_File(Path, File, File_Size);
+   if(Result)
+   {
+      printf("Wrote %s: %u vertices of %u bytes, %u-bit indices, %td bytes.\n", Path, Mesh->Vertex_Count, Vertex_Stride, Index_Size*8, File_Size);
+   }
+   else
+   {
+      fprintf(stderr, "Failed to write %s.\n", Path);
+   }
+
+   End_Temporary_Memory(Temporary);
+   return(Result);
+}
+
+int main(int Argument_Count, char **Arguments)
+{
+   char *Program = Arguments[0];
+   mesh_vertex_format Vertex_Format = Mesh_Vertex_Format_Standard;
+   bool Sort_For_Overdraw = false;
+   while(Argument_Count > 1 && Arguments[1][0] == '-')
+   {
+      if(strcmp(Arguments[1], "-compact") == 0)
+      {
+         Vertex_Format = Mesh_Vertex_Format_Compact;
+      }
+      else if(strcmp(Arguments[1], "-overdraw") == 0)
+      {
+         Sort_For_Overdraw = true;
+      }
+      else
+      {
+         break;
+      }
+      Arguments++;
+      Argument_Count--;
+   }
+
+   if(Argument_Count != 3)
+   {
+      fprintf(stderr, "Usage: %s [-compact] [-overdraw] input.obj output.mesh\n", Program);
+      return(1);
+   }
+
+   // NOTE: The reservation is only committed as it's touched, so it can be
+   // sized for big scans without costing anything for small ones.
+   platform_memory Memory = {0};
+   if(!Initialize_Memory(&Memory, 4ll*1024*1024*1024, 0))
+   {
+      return(1);
+   }
+   arena *Arena = &Memory.Permanent;
+
+   converter_mesh Mesh = {0};
+   if(!Load_Obj_Mesh(Arena, Arguments[1], &Mesh))
+   {
+      return(1);
+   }
+
+   u32 Loaded_Count = Mesh.Vertex_Count;
+   u32 Welded_Count = Weld_Mesh_Vertices(Arena, &Mesh);
+   printf("Welded %u duplicate vertices, %u -> %u.\n", Welded_Count, Loaded_Count, Mesh.Vertex_Count);
+   if(Mesh.Index_Count == 0)
+   {
+      fprintf(stderr, "%s has only degenerate triangles.\n", Arguments[1]);
+      return(1);
+   }
+
+   Compute_Mesh_Bounds(&Mesh);
+   Build_Mesh_Lods(Arena, &Mesh);
+   for(u32 Lod_Index = 0; Lod_Index < Mesh.Lod_Count; ++Lod_Index)
+   {
+      mesh_file_lod *Lod = Mesh.Lods + Lod_Index;
+      u32 *Indices = Mesh.Indices + Lod->First_Index;
+
+      temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+      u32 *Original = Push_Array(Arena, Lod->Index_Count, u32);
+      memcpy(Original, Indices, Lod->Index_Count*sizeof(u32));
+
+      vertex_cache_stats Before = Analyze_Vertex_Cache(Arena, Indices, Lod->Index_Count, Mesh.Vertex_Count);
+      Optimize_Vertex_Cache(Arena, Indices, Lod->Index_Count, Mesh.Vertex_Count);
+      if(Sort_For_Overdraw)
+      {
+         Optimize_Overdraw(Arena, &Mesh, Indices, Lod->Index_Count);
+      }
+      vertex_cache_stats After = Analyze_Vertex_Cache(Arena, Indices, Lod->Index_Count, Mesh.Vertex_Count);
+
+      // NOTE: Tiny LODs can already be in a better order than Tipsify finds,
+      // in which case they're left alone.
+      if(After.Acmr > Before.Acmr)
+      {
+         memcpy(Indices, Original, Lod->Index_Count*sizeof(u32));
+         After = Before;
+      }
+      End_Temporary_Memory(Temporary);
+
+      printf("LOD %u: %u triangles, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+             Lod_Index, Lod->Index_Count/3, Before.Acmr, After.Acmr, Before.Atvr, After.Atvr);
+   }
+
+   // NOTE: Renumbering after the triangle order is final keeps the cache
+   // results intact, and LOD 0 comes first so it gets the best fetch order.
+   Optimize_Vertex_Fetch(Arena, &Mesh);
+   Compute_Mesh_Bounds(&Mesh);
+
+   bool Result = Write_Mesh_File(Arena, Arguments[2], &Mesh, Vertex_Format);
+   return(Result ? 0 : 1);
+}
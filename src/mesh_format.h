@@ -0,0 +1,147 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Binary mesh files, as written by mesh_converter.c and loaded by the
+// renderer. The layout is exactly what the GPU wants, so loading is a mapping
+// and two buffer uploads with no parse step:
+//
+//    mesh_file_header
+//    vertex blob (Vertex_Count vertices in Vertex_Format)
+//    index blob (Index_Count indices of Index_Size bytes, all LODs)
+//
+// Both blobs start on a MESH_FILE_ALIGNMENT boundary, and every offset is
+// from the start of the file. The LOD table slices the index blob: each LOD
+// is a contiguous run of indices into the shared vertex blob, ordered from
+// full detail down. Bounds are the 2D bounding box of the vertex positions.
+//
+// Bump MESH_FILE_VERSION for any change to this layout or to the vertex
+// structs. Files with a different version are rejected, not converted.
+#define MESH_FILE_MAGIC 0x4853454D // NOTE: "MESH"
+#define MESH_FILE_VERSION 2
+#define MESH_FILE_ALIGNMENT 64
+#define MESH_FILE_MAX_LODS 8
+
+// NOTE: Each format must match one of the renderer's vertex layouts byte for
+// byte. Compact vertices are a third the size of standard ones: half float
+// positions, which are exact for integers up to 2048 and keep 11 significant
+// bits beyond that, and 8-bit normalized colors.
+typedef enum {
+   Mesh_Vertex_Format_Standard,
+   Mesh_Vertex_Format_Compact,
+
+   Mesh_Vertex_Format_Count,
+} mesh_vertex_format;
+
+typedef struct {
+   vec2 Position;
+   vec4 Color;
+} mesh_file_vertex;
+
+typedef struct {
+   u16 Position[2];
+   u8 Color[4];
+} mesh_file_compact_vertex;
+
+static u32 Mesh_Vertex_Strides[Mesh_Vertex_Format_Count] =
+{
+   [Mesh_Vertex_Format_Standard] = sizeof(mesh_file_vertex),
+   [Mesh_Vertex_Format_Compact] = sizeof(mesh_file_compact_vertex),
+};
+
+typedef struct {
+   u32 First_Index;
+   u32 Index_Count;
+} mesh_file_lod;
+
+typedef struct {
+   u32 Magic;
+   u32 Version;
+
+   u32 Vertex_Format; // NOTE: A mesh_vertex_format.
+   u32 Vertex_Stride;
+   u32 Vertex_Count;
+   u32 Index_Size; // NOTE: 2 or 4 bytes.
+   u32 Index_Count;
+   u32 Lod_Count;
+   u64 Vertex_Offset;
+   u64 Index_Offset;
+
+   vec2 Bounds_Min;
+   vec2 Bounds_Max;
+
+   mesh_file_lod Lods[MESH_FILE_MAX_LODS];
+} mesh_file_header;
+
+static inline u64 Align_Mesh_File_Offset(u64 Offset)
+{
+   u64 Result = (Offset + (MESH_FILE_ALIGNMENT - 1)) & ~(u64)(MESH_FILE_ALIGNMENT - 1);
+   return(Result);
+}
+
+// NOTE: Checks whether a blob of Count elements of Stride bytes at Offset lies
+// inside the file. Written so that no sum or product can wrap, whatever the
+// header says.
+static inline bool Mesh_File_Blob_Fits(u64 Offset, u32 Count, u32 Stride, u64 File_Size)
+{
+   bool Result = (Offset <= File_Size &&
+                  (u64)Count*Stride <= File_Size - Offset);
+   return(Result);
+}
+
+// NOTE: Checks everything the loader relies on before it touches the blobs,
+// so a truncated or corrupt file is rejected rather than read out of bounds.
+// That includes every index, which must name a vertex in the vertex blob, so
+// this walks the whole index blob and belongs on a background thread.
+static bool Validate_Mesh_File(mesh_file_header *Header, u64 File_Size)
+{
+   bool Result = false;
+
+   if(File_Size >= sizeof(mesh_file_header) &&
+      Header->Magic == MESH_FILE_MAGIC &&
+      Header->Version == MESH_FILE_VERSION &&
+      Header->Vertex_Format < Mesh_Vertex_Format_Count &&
+      Header->Vertex_Stride == Mesh_Vertex_Strides[Header->Vertex_Format] &&
+      (Header->Index_Size == 2 || Header->Index_Size == 4) &&
+      Header->Lod_Count >= 1 && Header->Lod_Count <= MESH_FILE_MAX_LODS &&
+      (Header->Vertex_Offset % MESH_FILE_ALIGNMENT) == 0 &&
+      (Header->Index_Offset % MESH_FILE_ALIGNMENT) == 0)
+   {
+      // NOTE: Once the index blob is known to fit, Index_Offset <= File_Size
+      // bounds Vertex_End, so computing it can't wrap either.
+      Result = (Header->Vertex_Offset >= sizeof(mesh_file_header) &&
+                Mesh_File_Blob_Fits(Header->Vertex_Offset, Header->Vertex_Count, Header->Vertex_Stride, File_Size) &&
+                Mesh_File_Blob_Fits(Header->Index_Offset, Header->Index_Count, Header->Index_Size, File_Size) &&
+                Header->Vertex_Offset + (u64)Header->Vertex_Count*Header->Vertex_Stride <= Header->Index_Offset);
+
+      for(u32 Lod_Index = 0; Result && Lod_Index < Header->Lod_Count; ++Lod_Index)
+      {
+         mesh_file_lod *Lod = Header->Lods + Lod_Index;
+         Result = ((u64)Lod->First_Index + Lod->Index_Count <= Header->Index_Count);
+      }
+
+      if(Result)
+      {
+         u8 *Indices = (u8 *)Header + Header->Index_Offset;
+         u32 Max_Index = 0;
+         if(Header->Index_Size == 2)
+         {
+            for(u32 Index = 0; Index < Header->Index_Count; ++Index)
+            {
+               u32 Value = ((u16 *)Indices)[Index];
+               Max_Index = (Value > Max_Index) ? Value : Max_Index;
+            }
+         }
+         else
+         {
+            for(u32 Index = 0; Index < Header->Index_Count; ++Index)
+            {
+               u32 Value = ((u32 *)Indices)[Index];
+               Max_Index = (Value > Max_Index) ? Value : Max_Index;
+            }
+         }
+
+         Result = (Header->Index_Count == 0 || Max_Index < Header->Vertex_Count);
+      }
+   }
+
+   return(Result);
+}
@@ -0,0 +1,423 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Mesh processing for the converter, run once per mesh before it's
+// written out:
+//
+//    Weld_Mesh_Vertices merges vertices the GPU can't tell apart.
+//    Optimize_Vertex_Cache reorders each LOD's triangles with Tipsify (Sander,
+//    Nehab and Barczak 2007), so the post-transform cache hits more often.
+//    Optimize_Overdraw optionally splits the result into clusters and sorts
+//    them so outward facing ones draw first.
+//    Optimize_Vertex_Fetch renumbers vertices in the order the index buffer
+//    first uses them, so vertex fetch walks memory forwards.
+//
+// Cache behaviour is measured against a FIFO cache of
+// MESH_OPTIMIZER_CACHE_SIZE entries: ACMR is misses per triangle (0.5 is the
+// ideal for big regular grids, 3 the worst case), and ATVR is misses per
+// referenced vertex (1 is ideal).
+#define MESH_OPTIMIZER_CACHE_SIZE 16
+
+typedef struct {
+   float Acmr;
+   float Atvr;
+} vertex_cache_stats;
+
+static vertex_cache_stats Analyze_Vertex_Cache(arena *Arena, u32 *Indices, u32 Index_Count, u32 Vertex_Count)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   // NOTE: A vertex is cached if it missed within the last cache size misses.
+   // Timestamps start at 1 so that zero means never seen.
+   u32 *Cache_Time = Push_Array(Arena, Vertex_Count, u32);
+   memset(Cache_Time, 0, Vertex_Count*sizeof(u32));
+
+   u32 Time = 1;
+   u32 Miss_Count = 0;
+   u32 Unique_Count = 0;
+   for(u32 Index = 0; Index < Index_Count; ++Index)
+   {
+      u32 Vertex = Indices[Index];
+      if(Cache_Time[Vertex] == 0)
+      {
+         Unique_Count++;
+      }
+      if(Cache_Time[Vertex] == 0 || Time - Cache_Time[Vertex] > MESH_OPTIMIZER_CACHE_SIZE)
+      {
+         Cache_Time[Vertex] = Time++;
+         Miss_Count++;
+      }
+   }
+
+   vertex_cache_stats Result = {0};
+   if(Index_Count > 0)
+   {
+      Result.Acmr = (float)Miss_Count / (float)(Index_Count/3);
+      Result.Atvr = (float)Miss_Count / (float)Unique_Count;
+   }
+
+   End_Temporary_Memory(Temporary);
+   return(Result);
+}
+
+// NOTE: Welds by exact bit pattern, which is all that matters once the data
+// is on the GPU. Triangles that collapse in the process are dropped. Depths
+// follow their vertices; the first one wins for welded duplicates.
+static u32 Weld_Mesh_Vertices(arena *Arena, converter_mesh *Mesh)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   u32 Table_Size = 1;
+   while(Table_Size < 2*Mesh->Vertex_Count)
+   {
+      Table_Size *= 2;
+   }
+   u32 *Table = Push_Array(Arena, Table_Size, u32);
+   memset(Table, 0xFF, Table_Size*sizeof(u32));
+
+   u32 *Remap = Push_Array(Arena, Mesh->Vertex_Count, u32);
+   u32 Welded_Count = 0;
+   for(u32 Index = 0; Index < Mesh->Vertex_Count; ++Index)
+   {
+      mesh_file_vertex *Vertex = Mesh->Vertices + Index;
+      u32 Slot = (u32)Hash_Bytes(HASH_SEED, Vertex, sizeof(*Vertex)) & (Table_Size - 1);
+      while(Table[Slot] != 0xFFFFFFFF && memcmp(Mesh->Vertices + Remap[Table[Slot]], Vertex, sizeof(*Vertex)) != 0)
+      {
+         Slot = (Slot + 1) & (Table_Size - 1);
+      }
+
+      if(Table[Slot] == 0xFFFFFFFF)
+      {
+         // NOTE: Vertices are compacted in place, which is safe since the
+         // write index never passes the read index.
+         Table[Slot] = Index;
+         Remap[Index] = Welded_Count;
+         Mesh->Vertices[Welded_Count] = *Vertex;
+         Mesh->Depths[Welded_Count] = Mesh->Depths[Index];
+         Welded_Count++;
+      }
+      else
+      {
+         Remap[Index] = Remap[Table[Slot]];
+      }
+   }
+
+   u32 Index_Count = 0;
+   for(u32 Index = 0; Index < Mesh->Index_Count; Index += 3)
+   {
+      u32 A = Remap[Mesh->Indices[Index + 0]];
+      u32 B = Remap[Mesh->Indices[Index + 1]];
+      u32 C = Remap[Mesh->Indices[Index + 2]];
+      if(A != B && B != C && C != A)
+      {
+         Mesh->Indices[Index_Count++] = A;
+         Mesh->Indices[Index_Count++] = B;
+         Mesh->Indices[Index_Count++] = C;
+      }
+   }
+
+   u32 Result = Mesh->Vertex_Count - Welded_Count;
+   Mesh->Vertex_Count = Welded_Count;
+   Mesh->Index_Count = Index_Count;
+
+   End_Temporary_Memory(Temporary);
+   return(Result);
+}
+
+static u32 Skip_Tipsify_Dead_End(u32 *Live, u32 *Dead_End, u32 *Dead_End_Count, u32 *Cursor, u32 Vertex_Count)
+{
+   u32 Result = 0xFFFFFFFF;
+
+   // NOTE: Recently emitted vertices are the likeliest to still be cached,
+   // so those are tried first, and only then the next vertex in input order.
+   while(*Dead_End_Count > 0)
+   {
+      u32 Vertex = Dead_End[--(*Dead_End_Count)];
+      if(Live[Vertex] > 0)
+      {
+         Result = Vertex;
+         break;
+      }
+   }
+
+   while(Result == 0xFFFFFFFF && *Cursor < Vertex_Count)
+   {
+      if(Live[*Cursor] > 0)
+      {
+         Result = *Cursor;
+      }
+      (*Cursor)++;
+   }
+
+   return(Result);
+}
+
+// NOTE: Tipsify emits every remaining triangle around a fanning vertex, then
+// moves on to whichever vertex of those triangles will still be in the cache
+// once its own remaining triangles are emitted, preferring the oldest. When
+// no such vertex exists it falls back to the dead end stack.
+static void Optimize_Vertex_Cache(arena *Arena, u32 *Indices, u32 Index_Count, u32 Vertex_Count)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   u32 Triangle_Count = Index_Count / 3;
+   u32 *Live = Push_Array(Arena, Vertex_Count, u32);
+   u32 *Offsets = Push_Array(Arena, Vertex_Count + 1, u32);
+   u32 *Adjacency = Push_Array(Arena, Index_Count, u32);
+   u32 *Cache_Time = Push_Array(Arena, Vertex_Count, u32);
+   u8 *Emitted = Push_Array(Arena, Triangle_Count, u8);
+   u32 *Dead_End = Push_Array(Arena, Index_Count, u32);
+   u32 *Output = Push_Array(Arena, Index_Count, u32);
+
+   memset(Live, 0, Vertex_Count*sizeof(u32));
+   memset(Cache_Time, 0, Vertex_Count*sizeof(u32));
+   memset(Emitted, 0, Triangle_Count);
+
+   for(u32 Index = 0; Index < Index_Count; ++Index)
+   {
+      Live[Indices[Index]]++;
+   }
+
+   Offsets[0] = 0;
+   for(u32 Vertex = 0; Vertex < Vertex_Count; ++Vertex)
+   {
+      Offsets[Vertex + 1] = Offsets[Vertex] + Live[Vertex];
+   }
+
+   // NOTE: Cache_Time doubles as the fill cursor while building adjacency.
+   for(u32 Index = 0; Index < Index_Count; ++Index)
+   {
+      u32 Vertex = Indices[Index];
+      Adjacency[Offsets[Vertex] + Cache_Time[Vertex]++] = Index / 3;
+   }
+   memset(Cache_Time, 0, Vertex_Count*sizeof(u32));
+
+   u32 Time = MESH_OPTIMIZER_CACHE_SIZE + 1;
+   u32 Output_Count = 0;
+   u32 Dead_End_Count = 0;
+   u32 Cursor = 0;
+
+   u32 Fan = Skip_Tipsify_Dead_End(Live, Dead_End, &Dead_End_Count, &Cursor, Vertex_Count);
+   while(Fan != 0xFFFFFFFF)
+   {
+      u32 Candidates_Begin = Dead_End_Count;
+      for(u32 Adjacent = Offsets[Fan]; Adjacent < Offsets[Fan + 1]; ++Adjacent)
+      {
+         u32 Triangle = Adjacency[Adjacent];
+         if(!Emitted[Triangle])
+         {
+            for(u32 Corner = 0; Corner < 3; ++Corner)
+            {
+               u32 Vertex = Indices[3*Triangle + Corner];
+               Output[Output_Count++] = Vertex;
+               Dead_End[Dead_End_Count++] = Vertex;
+               Live[Vertex]--;
+               if(Time - Cache_Time[Vertex] > MESH_OPTIMIZER_CACHE_SIZE)
+               {
+                  Cache_Time[Vertex] = Time++;
+               }
+            }
+            Emitted[Triangle] = 1;
+         }
+      }
+
+      u32 Best = 0xFFFFFFFF;
+      s64 Best_Priority = -1;
+      for(u32 Candidate = Candidates_Begin; Candidate < Dead_End_Count; ++Candidate)
+      {
+         u32 Vertex = Dead_End[Candidate];
+         if(Live[Vertex] > 0)
+         {
+            s64 Priority = 0;
+            if(Time - Cache_Time[Vertex] + 2*Live[Vertex] <= MESH_OPTIMIZER_CACHE_SIZE)
+            {
+               Priority = Time - Cache_Time[Vertex];
+            }
+            if(Priority > Best_Priority)
+            {
+               Best_Priority = Priority;
+               Best = Vertex;
+            }
+         }
+      }
+
+      if(Best == 0xFFFFFFFF)
+      {
+         Best = Skip_Tipsify_Dead_End(Live, Dead_End, &Dead_End_Count, &Cursor, Vertex_Count);
+      }
+      Fan = Best;
+   }
+
+   Assert(Output_Count == Triangle_Count*3);
+   memcpy(Indices, Output, Output_Count*sizeof(u32));
+
+   End_Temporary_Memory(Temporary);
+}
+
+typedef struct {
+   u32 First_Triangle;
+   u32 Triangle_Count;
+   float Sort_Key;
+} overdraw_cluster;
+
+static int Compare_Overdraw_Clusters(const void *A, const void *B)
+{
+   overdraw_cluster *Left = (overdraw_cluster *)A;
+   overdraw_cluster *Right = (overdraw_cluster *)B;
+
+   // NOTE: Highest key first, falling back to the original order so the
+   // result doesn't depend on the qsort implementation.
+   int Result = (Left->Sort_Key < Right->Sort_Key) - (Left->Sort_Key > Right->Sort_Key);
+   if(Result == 0)
+   {
+      Result = (Left->First_Triangle > Right->First_Triangle) - (Left->First_Triangle < Right->First_Triangle);
+   }
+   return(Result);
+}
+
+static vec3 Get_Mesh_Vertex_Position(converter_mesh *Mesh, u32 Vertex)
+{
+   vec3 Result = {Mesh->Vertices[Vertex].Position.X, Mesh->Vertices[Vertex].Position.Y, Mesh->Depths[Vertex]};
+   return(Result);
+}
+
+// NOTE: Expects cache optimized input. Clusters end wherever all three
+// vertices of a triangle miss the cache, since Tipsify has just jumped
+// somewhere new and reordering there costs little locality. Clusters facing
+// away from the mesh center, which are the likeliest to occlude the rest, are
+// moved to the front. Flat meshes have no facing to go by and keep their
+// order.
+static void Optimize_Overdraw(arena *Arena, converter_mesh *Mesh, u32 *Indices, u32 Index_Count)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   u32 Triangle_Count = Index_Count / 3;
+   overdraw_cluster *Clusters = Push_Array(Arena, Triangle_Count, overdraw_cluster);
+   u32 *Cache_Time = Push_Array(Arena, Mesh->Vertex_Count, u32);
+   memset(Cache_Time, 0, Mesh->Vertex_Count*sizeof(u32));
+
+   u32 Cluster_Count = 0;
+   u32 Time = MESH_OPTIMIZER_CACHE_SIZE + 1;
+   for(u32 Triangle = 0; Triangle < Triangle_Count; ++Triangle)
+   {
+      u32 Miss_Count = 0;
+      for(u32 Corner = 0; Corner < 3; ++Corner)
+      {
+         u32 Vertex = Indices[3*Triangle + Corner];
+         if(Time - Cache_Time[Vertex] > MESH_OPTIMIZER_CACHE_SIZE)
+         {
+            Cache_Time[Vertex] = Time++;
+            Miss_Count++;
+         }
+      }
+
+      if(Cluster_Count == 0 || Miss_Count == 3)
+      {
+         overdraw_cluster *Cluster = Clusters + Cluster_Count++;
+         Cluster->First_Triangle = Triangle;
+         Cluster->Triangle_Count = 0;
+      }
+      Clusters[Cluster_Count - 1].Triangle_Count++;
+   }
+
+   vec3 *Centroids = Push_Array(Arena, Cluster_Count, vec3);
+   vec3 *Normals = Push_Array(Arena, Cluster_Count, vec3);
+   vec3 Mesh_Centroid = {0};
+   float Mesh_Area = 0;
+   for(u32 Cluster_Index = 0; Cluster_Index < Cluster_Count; ++Cluster_Index)
+   {
+      overdraw_cluster *Cluster = Clusters + Cluster_Index;
+      vec3 Centroid = {0};
+      vec3 Normal = {0};
+      float Area = 0;
+      for(u32 Triangle = Cluster->First_Triangle; Triangle < Cluster->First_Triangle + Cluster->Triangle_Count; ++Triangle)
+      {
+         vec3 A = Get_Mesh_Vertex_Position(Mesh, Indices[3*Triangle + 0]);
+         vec3 B = Get_Mesh_Vertex_Position(Mesh, Indices[3*Triangle + 1]);
+         vec3 C = Get_Mesh_Vertex_Position(Mesh, Indices[3*Triangle + 2]);
+
+         vec3 AB = {B.X - A.X, B.Y - A.Y, B.Z - A.Z};
+         vec3 AC = {C.X - A.X, C.Y - A.Y, C.Z - A.Z};
+         vec3 Cross = {AB.Y*AC.Z - AB.Z*AC.Y, AB.Z*AC.X - AB.X*AC.Z, AB.X*AC.Y - AB.Y*AC.X};
+         float Triangle_Area = 0.5f*sqrtf(Cross.X*Cross.X + Cross.Y*Cross.Y + Cross.Z*Cross.Z);
+
+         Normal.X += Cross.X;
+         Normal.Y += Cross.Y;
+         Normal.Z += Cross.Z;
+         Centroid.X += Triangle_Area*(A.X + B.X + C.X)/3.0f;
+         Centroid.Y += Triangle_Area*(A.Y + B.Y + C.Y)/3.0f;
+         Centroid.Z += Triangle_Area*(A.Z + B.Z + C.Z)/3.0f;
+         Area += Triangle_Area;
+      }
+
+      Mesh_Centroid.X += Centroid.X;
+      Mesh_Centroid.Y += Centroid.Y;
+      Mesh_Centroid.Z += Centroid.Z;
+      Mesh_Area += Area;
+
+      float Scale = (Area > 0) ? 1.0f / Area : 0.0f;
+      Centroids[Cluster_Index] = (vec3){Centroid.X*Scale, Centroid.Y*Scale, Centroid.Z*Scale};
+
+      float Length = sqrtf(Normal.X*Normal.X + Normal.Y*Normal.Y + Normal.Z*Normal.Z);
+      float Normal_Scale = (Length > 0) ? 1.0f / Length : 0.0f;
+      Normals[Cluster_Index] = (vec3){Normal.X*Normal_Scale, Normal.Y*Normal_Scale, Normal.Z*Normal_Scale};
+   }
+
+   float Mesh_Scale = (Mesh_Area > 0) ? 1.0f / Mesh_Area : 0.0f;
+   Mesh_Centroid = (vec3){Mesh_Centroid.X*Mesh_Scale, Mesh_Centroid.Y*Mesh_Scale, Mesh_Centroid.Z*Mesh_Scale};
+
+   for(u32 Cluster_Index = 0; Cluster_Index < Cluster_Count; ++Cluster_Index)
+   {
+      vec3 Centroid = Centroids[Cluster_Index];
+      vec3 Normal = Normals[Cluster_Index];
+      Clusters[Cluster_Index].Sort_Key = ((Centroid.X - Mesh_Centroid.X)*Normal.X +
+                                          (Centroid.Y - Mesh_Centroid.Y)*Normal.Y +
+                                          (Centroid.Z - Mesh_Centroid.Z)*Normal.Z);
+   }
+
+   qsort(Clusters, Cluster_Count, sizeof(overdraw_cluster), Compare_Overdraw_Clusters);
+
+   u32 *Output = Push_Array(Arena, Index_Count, u32);
+   u32 Output_Count = 0;
+   for(u32 Cluster_Index = 0; Cluster_Index < Cluster_Count; ++Cluster_Index)
+   {
+      overdraw_cluster *Cluster = Clusters + Cluster_Index;
+      u32 Count = Cluster->Triangle_Count*3;
+      memcpy(Output + Output_Count, Indices + Cluster->First_Triangle*3, Count*sizeof(u32));
+      Output_Count += Count;
+   }
+   memcpy(Indices, Output, Output_Count*sizeof(u32));
+
+   End_Temporary_Memory(Temporary);
+}
+
+// NOTE: Vertices no index refers to are dropped along the way.
+static void Optimize_Vertex_Fetch(arena *Arena, converter_mesh *Mesh)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   u32 *Remap = Push_Array(Arena, Mesh->Vertex_Count, u32);
+   memset(Remap, 0xFF, Mesh->Vertex_Count*sizeof(u32));
+
+   mesh_file_vertex *Vertices = Push_Array(Arena, Mesh->Vertex_Count, mesh_file_vertex);
+   float *Depths = Push_Array(Arena, Mesh->Vertex_Count, float);
+
+   u32 Vertex_Count = 0;
+   for(u32 Index = 0; Index < Mesh->Index_Count; ++Index)
+   {
+      u32 Vertex = Mesh->Indices[Index];
+      if(Remap[Vertex] == 0xFFFFFFFF)
+      {
+         Remap[Vertex] = Vertex_Count;
+         Vertices[Vertex_Count] = Mesh->Vertices[Vertex];
+         Depths[Vertex_Count] = Mesh->Depths[Vertex];
+         Vertex_Count++;
+      }
+      Mesh->Indices[Index] = Remap[Vertex];
+   }
+
+   memcpy(Mesh->Vertices, Vertices, Vertex_Count*sizeof(mesh_file_vertex));
+   memcpy(Mesh->Depths, Depths, Vertex_Count*sizeof(float));
+   Mesh->Vertex_Count = Vertex_Count;
+
+   End_Temporary_Memory(Temporary);
+}
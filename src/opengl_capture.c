@@ -0,0 +1,1025 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Capture mode. Every wrapper below makes the real call first, so the
+// result is known by the time it's recorded, and the defines at the bottom
+// of the file redirect the rest of the renderer through them.
+
+#if OPENGL_CAPTURE_ENABLED
+static opengl_capture Opengl_Capture;
+
+static bool Is_Opengl_Capture_Active(void)
+{
+   return(Opengl_Capture.Active);
+}
+
+static void Begin_Opengl_Capture_Record(opengl_call Call, u64 *Arguments, u32 Argument_Count, u64 Payload_Size)
+{
+   opengl_capture *Capture = &Opengl_Capture;
+
+   // NOTE: The driver sees GL calls in the order the main thread makes
+   // them, and so does the trace.
+   Assert(Get_Thread_Index() == 0);
+   Assert(Payload_Size <= 0xFFFFFFFF);
+
+   opengl_capture_record Record = {0};
+   Record.Call = (u16)Call;
+   Record.Argument_Count = (u16)Argument_Count;
+   Record.Payload_Size = (u32)Payload_Size;
+
+   fwrite(&Record, sizeof(Record), 1, Capture->File);
+   fwrite(Arguments, sizeof(u64), Argument_Count, Capture->File);
+
+   Capture->Payload_Size = Payload_Size;
+   Capture->Record_Count++;
+   Capture->Bytes_Written += sizeof(Record) + Argument_Count*sizeof(u64);
+}
+
+static void Append_Opengl_Capture_Payload(void *Data, u64 Size)
+{
+   fwrite(Data, 1, Size, Opengl_Capture.File);
+}
+
+static void End_Opengl_Capture_Record(void)
+{
+   opengl_capture *Capture = &Opengl_Capture;
+
+   u64 Padded_Size = (Capture->Payload_Size + 7) & ~7ull;
+   u64 Zero = 0;
+   fwrite(&Zero, 1, Padded_Size - Capture->Payload_Size, Capture->File);
+
+   Capture->Bytes_Written += Padded_Size;
+}
+
+static void Record_Opengl_Call(opengl_call Call, u64 *Arguments, u32 Argument_Count, const void *Payload, u64 Payload_Size)
+{
+   Begin_Opengl_Capture_Record(Call, Arguments, Argument_Count, Payload_Size);
+   if(Payload_Size > 0)
+   {
+      Append_Opengl_Capture_Payload((void *)Payload, Payload_Size);
+   }
+   End_Opengl_Capture_Record();
+}
+
+#define RECORD_OPENGL_CALL(Call, Payload, Payload_Size, ...)                           \
+   do                                                                                  \
+   {                                                                                   \
+      if(Opengl_Capture.Active)                                                        \
+      {                                                                                \
+         u64 Capture_Arguments[] = {__VA_ARGS__};                                      \
+         Record_Opengl_Call(Call, Capture_Arguments, Array_Count(Capture_Arguments), Payload, Payload_Size); \
+      }                                                                                \
+   } while(0)
+
+#define CAPTURE_POINTER(Pointer) ((u64)(uintptr_t)(Pointer))
+
+static GLuint Get_Opengl_Capture_Binding(GLenum Target)
+{
+   GLuint Result = 0;
+   opengl_capture *Capture = &Opengl_Capture;
+   for(u32 Index = 0; Index < Capture->Binding_Count; ++Index)
+   {
+      if(Capture->Bindings[Index].Target == Target)
+      {
+         Result = Capture->Bindings[Index].Buffer;
+         break;
+      }
+   }
+   return(Result);
+}
+
+static opengl_capture_mapping *Get_Opengl_Capture_Mapping(GLuint Buffer)
+{
+   opengl_capture_mapping *Result = 0;
+   opengl_capture *Capture = &Opengl_Capture;
+   for(u32 Index = 0; Index < Capture->Mapping_Count; ++Index)
+   {
+      if(Capture->Mappings[Index].Buffer == Buffer)
+      {
+         Result = Capture->Mappings + Index;
+         break;
+      }
+   }
+   return(Result);
+}
+
+static void Record_Opengl_Mapped_Write(GLuint Buffer, u8 *Pointer, GLintptr Offset, GLsizeiptr Length)
+{
+   RECORD_OPENGL_CALL(Opengl_Call_Write_Mapped, Pointer + Offset, Length, Buffer, Offset, Length);
+}
+
+static u64 Get_Opengl_Capture_Sync(GLsync Sync)
+{
+   u64 Result = OPENGL_CAPTURE_MAX_SYNCS;
+   for(u64 Index = 0; Index < OPENGL_CAPTURE_MAX_SYNCS; ++Index)
+   {
+      if(Opengl_Capture.Syncs[Index] == Sync)
+      {
+         Result = Index;
+         break;
+      }
+   }
+
+   // NOTE: Fences made before the capture began can't be referred to.
+   Assert(!Opengl_Capture.Active || Result < OPENGL_CAPTURE_MAX_SYNCS);
+   return(Result);
+}
+
+static void Record_Opengl_Names(opengl_call Call, GLsizei Count, const GLuint *Names)
+{
+   RECORD_OPENGL_CALL(Call, Names, Count*sizeof(GLuint), Count);
+}
+
+static void Capture_glActiveTexture(GLenum Texture)
+{
+   glActiveTexture(Texture);
+   RECORD_OPENGL_CALL(Opengl_Call_glActiveTexture, 0, 0, Texture);
+}
+
+static void Capture_glAttachShader(GLuint Program, GLuint Shader)
+{
+   glAttachShader(Program, Shader);
+   RECORD_OPENGL_CALL(Opengl_Call_glAttachShader, 0, 0, Program, Shader);
+}
+
+static void Capture_glBeginQuery(GLenum Target, GLuint Query)
+{
+   glBeginQuery(Target, Query);
+   RECORD_OPENGL_CALL(Opengl_Call_glBeginQuery, 0, 0, Target, Query);
+}
+
+static void Set_Opengl_Capture_Binding(GLenum Target, GLuint Buffer)
+{
+   if(Opengl_Capture.Active)
+   {
+      opengl_capture *Capture = &Opengl_Capture;
+      u32 Index = 0;
+      while(Index < Capture->Binding_Count && Capture->Bindings[Index].Target != Target)
+      {
+         Index++;
+      }
+      if(Index == Capture->Binding_Count)
+      {
+         Assert(Capture->Binding_Count < OPENGL_CAPTURE_MAX_TARGETS);
+         Capture->Bindings[Capture->Binding_Count++].Target = Target;
+      }
+      Capture->Bindings[Index].Buffer = Buffer;
+   }
+}
+
+static void Capture_glBindBuffer(GLenum Target, GLuint Buffer)
+{
+   glBindBuffer(Target, Buffer);
+   Set_Opengl_Capture_Binding(Target, Buffer);
+   RECORD_OPENGL_CALL(Opengl_Call_glBindBuffer, 0, 0, Target, Buffer);
+}
+
+// NOTE: Binding a range also replaces the target's generic binding.
+static void Capture_glBindBufferRange(GLenum Target, GLuint Index, GLuint Buffer, GLintptr Offset, GLsizeiptr Size)
+{
+   glBindBufferRange(Target, Index, Buffer, Offset, Size);
+   Set_Opengl_Capture_Binding(Target, Buffer);
+   RECORD_OPENGL_CALL(Opengl_Call_glBindBufferRange, 0, 0, Target, Index, Buffer, Offset, Size);
+}
+
+static void Capture_glBindFramebuffer(GLenum Target, GLuint Framebuffer)
+{
+   glBindFramebuffer(Target, Framebuffer);
+   RECORD_OPENGL_CALL(Opengl_Call_glBindFramebuffer, 0, 0, Target, Framebuffer);
+}
+
+static void Capture_glBindRenderbuffer(GLenum Target, GLuint Renderbuffer)
+{
+   glBindRenderbuffer(Target, Renderbuffer);
+   RECORD_OPENGL_CALL(Opengl_Call_glBindRenderbuffer, 0, 0, Target, Renderbuffer);
+}
+
+static void Capture_glBindTexture(GLenum Target, GLuint Texture)
+{
+   glBindTexture(Target, Texture);
+   RECORD_OPENGL_CALL(Opengl_Call_glBindTexture, 0, 0, Target, Texture);
+}
+
+static void Capture_glBindVertexArray(GLuint Array)
+{
+   glBindVertexArray(Array);
+   RECORD_OPENGL_CALL(Opengl_Call_glBindVertexArray, 0, 0, Array);
+}
+
+static void Capture_glBlendFunc(GLenum Source, GLenum Dest)
+{
+   glBlendFunc(Source, Dest);
+   RECORD_OPENGL_CALL(Opengl_Call_glBlendFunc, 0, 0, Source, Dest);
+}
+
+static void Capture_glBufferData(GLenum Target, GLsizeiptr Size, const GLvoid *Data, GLenum Usage)
+{
+   glBufferData(Target, Size, Data, Usage);
+   RECORD_OPENGL_CALL(Opengl_Call_glBufferData, Data, (Data) ? Size : 0, Target, Size, Usage);
+}
+
+static void Capture_glBufferStorage(GLenum Target, GLsizeiptr Size, const void *Data, GLbitfield Flags)
+{
+   glBufferStorage(Target, Size, Data, Flags);
+   RECORD_OPENGL_CALL(Opengl_Call_glBufferStorage, Data, (Data) ? Size : 0, Target, Size, Flags);
+}
+
+static void Capture_glBufferSubData(GLenum Target, GLintptr Offset, GLsizeiptr Size, const void *Data)
+{
+   glBufferSubData(Target, Offset, Size, Data);
+   RECORD_OPENGL_CALL(Opengl_Call_glBufferSubData, Data, Size, Target, Offset, Size);
+}
+
+static GLenum Capture_glCheckFramebufferStatus(GLenum Target)
+{
+   GLenum Result = glCheckFramebufferStatus(Target);
+   RECORD_OPENGL_CALL(Opengl_Call_glCheckFramebufferStatus, 0, 0, Target);
+   return(Result);
+}
+
+static void Capture_glClear(GLbitfield Mask)
+{
+   glClear(Mask);
+   RECORD_OPENGL_CALL(Opengl_Call_glClear, 0, 0, Mask);
+}
+
+static void Capture_glClearColor(GLfloat R, GLfloat G, GLfloat B, GLfloat A)
+{
+   glClearColor(R, G, B, A);
+   RECORD_OPENGL_CALL(Opengl_Call_glClearColor, 0, 0, Opengl_Capture_Float(R), Opengl_Capture_Float(G), Opengl_Capture_Float(B), Opengl_Capture_Float(A));
+}
+
+static GLenum Capture_glClientWaitSync(GLsync Sync, GLbitfield Flags, GLuint64 Timeout)
+{
+   GLenum Result = glClientWaitSync(Sync, Flags, Timeout);
+   RECORD_OPENGL_CALL(Opengl_Call_glClientWaitSync, 0, 0, Get_Opengl_Capture_Sync(Sync), Flags, Timeout);
+   return(Result);
+}
+
+static void Capture_glCompileShader(GLuint Shader)
+{
+   glCompileShader(Shader);
+   RECORD_OPENGL_CALL(Opengl_Call_glCompileShader, 0, 0, Shader);
+}
+
+static GLuint Capture_glCreateProgram(void)
+{
+   GLuint Result = glCreateProgram();
+   RECORD_OPENGL_CALL(Opengl_Call_glCreateProgram, 0, 0, Result);
+   return(Result);
+}
+
+static GLuint Capture_glCreateShader(GLenum Type)
+{
+   GLuint Result = glCreateShader(Type);
+   RECORD_OPENGL_CALL(Opengl_Call_glCreateShader, 0, 0, Type, Result);
+   return(Result);
+}
+
+static void Capture_glCullFace(GLenum Face)
+{
+   glCullFace(Face);
+   RECORD_OPENGL_CALL(Opengl_Call_glCullFace, 0, 0, Face);
+}
+
+static void Capture_glDeleteBuffers(GLsizei Count, const GLuint *Buffers)
+{
+   glDeleteBuffers(Count, Buffers);
+   if(Opengl_Capture.Active)
+   {
+      // NOTE: Deleting a buffer unmaps it, and unbinds it from every target.
+      opengl_capture *Capture = &Opengl_Capture;
+      for(GLsizei Index = 0; Index < Count; ++Index)
+      {
+         opengl_capture_mapping *Mapping = Get_Opengl_Capture_Mapping(Buffers[Index]);
+         if(Mapping)
+         {
+            *Mapping = Capture->Mappings[--Capture->Mapping_Count];
+         }
+         for(u32 Binding = 0; Binding < Capture->Binding_Count; ++Binding)
+         {
+            if(Capture->Bindings[Binding].Buffer == Buffers[Index])
+            {
+               Capture->Bindings[Binding].Buffer = 0;
+            }
+         }
+      }
+   }
+   Record_Opengl_Names(Opengl_Call_glDeleteBuffers, Count, Buffers);
+}
+
+static void Capture_glDeleteFramebuffers(GLsizei Count, const GLuint *Framebuffers)
+{
+   glDeleteFramebuffers(Count, Framebuffers);
+   Record_Opengl_Names(Opengl_Call_glDeleteFramebuffers, Count, Framebuffers);
+}
+
+static void Capture_glDeleteProgram(GLuint Program)
+{
+   glDeleteProgram(Program);
+   RECORD_OPENGL_CALL(Opengl_Call_glDeleteProgram, 0, 0, Program);
+}
+
+static void Capture_glDeleteQueries(GLsizei Count, const GLuint *Queries)
+{
+   glDeleteQueries(Count, Queries);
+   Record_Opengl_Names(Opengl_Call_glDeleteQueries, Count, Queries);
+}
+
+static void Capture_glDeleteRenderbuffers(GLsizei Count, const GLuint *Renderbuffers)
+{
+   glDeleteRenderbuffers(Count, Renderbuffers);
+   Record_Opengl_Names(Opengl_Call_glDeleteRenderbuffers, Count, Renderbuffers);
+}
+
+static void Capture_glDeleteShader(GLuint Shader)
+{
+   glDeleteShader(Shader);
+   RECORD_OPENGL_CALL(Opengl_Call_glDeleteShader, 0, 0, Shader);
+}
+
+static void Capture_glDeleteSync(GLsync Sync)
+{
+   glDeleteSync(Sync);
+   if(Opengl_Capture.Active)
+   {
+      u64 Id = Get_Opengl_Capture_Sync(Sync);
+      Opengl_Capture.Syncs[Id] = 0;
+      RECORD_OPENGL_CALL(Opengl_Call_glDeleteSync, 0, 0, Id);
+   }
+}
+
+static void Capture_glDeleteTextures(GLsizei Count, const GLuint *Textures)
+{
+   glDeleteTextures(Count, Textures);
+   Record_Opengl_Names(Opengl_Call_glDeleteTextures, Count, Textures);
+}
+
+static void Capture_glDeleteVertexArrays(GLsizei Count, const GLuint *Arrays)
+{
+   glDeleteVertexArrays(Count, Arrays);
+   Record_Opengl_Names(Opengl_Call_glDeleteVertexArrays, Count, Arrays);
+}
+
+static void Capture_glDepthFunc(GLenum Function)
+{
+   glDepthFunc(Function);
+   RECORD_OPENGL_CALL(Opengl_Call_glDepthFunc, 0, 0, Function);
+}
+
+static void Capture_glDepthMask(GLboolean Flag)
+{
+   glDepthMask(Flag);
+   RECORD_OPENGL_CALL(Opengl_Call_glDepthMask, 0, 0, Flag);
+}
+
+static void Capture_glDetachShader(GLuint Program, GLuint Shader)
+{
+   glDetachShader(Program, Shader);
+   RECORD_OPENGL_CALL(Opengl_Call_glDetachShader, 0, 0, Program, Shader);
+}
+
+static void Capture_glDisable(GLenum Capability)
+{
+   glDisable(Capability);
+   RECORD_OPENGL_CALL(Opengl_Call_glDisable, 0, 0, Capability);
+}
+
+static void Capture_glDrawArrays(GLenum Mode, GLint First, GLsizei Count)
+{
+   glDrawArrays(Mode, First, Count);
+   RECORD_OPENGL_CALL(Opengl_Call_glDrawArrays, 0, 0, Mode, First, Count);
+}
+
+static void Capture_glDrawArraysInstanced(GLenum Mode, GLint First, GLsizei Count, GLsizei Instance_Count)
+{
+   glDrawArraysInstanced(Mode, First, Count, Instance_Count);
+   RECORD_OPENGL_CALL(Opengl_Call_glDrawArraysInstanced, 0, 0, Mode, First, Count, Instance_Count);
+}
+
+// NOTE: Index pointers are always offsets into the bound element buffer.
+static void Capture_glDrawElements(GLenum Mode, GLsizei Count, GLenum Type, const GLvoid *Indices)
+{
+   glDrawElements(Mode, Count, Type, Indices);
+   RECORD_OPENGL_CALL(Opengl_Call_glDrawElements, 0, 0, Mode, Count, Type, CAPTURE_POINTER(Indices));
+}
+
+static void Capture_glDrawElementsBaseVertex(GLenum Mode, GLsizei Count, GLenum Type, const void *Indices, GLint Base_Vertex)
+{
+   glDrawElementsBaseVertex(Mode, Count, Type, Indices, Base_Vertex);
+   RECORD_OPENGL_CALL(Opengl_Call_glDrawElementsBaseVertex, 0, 0, Mode, Count, Type, CAPTURE_POINTER(Indices), Base_Vertex);
+}
+
+static void Capture_glDrawElementsInstanced(GLenum Mode, GLsizei Count, GLenum Type, const void *Indices, GLsizei Instance_Count)
+{
+   glDrawElementsInstanced(Mode, Count, Type, Indices, Instance_Count);
+   RECORD_OPENGL_CALL(Opengl_Call_glDrawElementsInstanced, 0, 0, Mode, Count, Type, CAPTURE_POINTER(Indices), Instance_Count);
+}
+
+static void Capture_glEnable(GLenum Capability)
+{
+   glEnable(Capability);
+   RECORD_OPENGL_CALL(Opengl_Call_glEnable, 0, 0, Capability);
+}
+
+static void Capture_glEnableVertexAttribArray(GLuint Index)
+{
+   glEnableVertexAttribArray(Index);
+   RECORD_OPENGL_CALL(Opengl_Call_glEnableVertexAttribArray, 0, 0, Index);
+}
+
+static void Capture_glEndQuery(GLenum Target)
+{
+   glEndQuery(Target);
+   RECORD_OPENGL_CALL(Opengl_Call_glEndQuery, 0, 0, Target);
+}
+
+static GLsync Capture_glFenceSync(GLenum Condition, GLbitfield Flags)
+{
+   GLsync Result = glFenceSync(Condition, Flags);
+   if(Opengl_Capture.Active)
+   {
+      u64 Id = Get_Opengl_Capture_Sync(0);
+      Opengl_Capture.Syncs[Id] = Result;
+      RECORD_OPENGL_CALL(Opengl_Call_glFenceSync, 0, 0, Condition, Flags, Id);
+   }
+   return(Result);
+}
+
+static void Capture_glFinish(void)
+{
+   glFinish();
+   if(Opengl_Capture.Active)
+   {
+      Record_Opengl_Call(Opengl_Call_glFinish, 0, 0, 0, 0);
+   }
+}
+
+static void Capture_glFlush(void)
+{
+   glFlush();
+   if(Opengl_Capture.Active)
+   {
+      Record_Opengl_Call(Opengl_Call_glFlush, 0, 0, 0, 0);
+   }
+}
+
+static void Capture_glFlushMappedBufferRange(GLenum Target, GLintptr Offset, GLsizeiptr Length)
+{
+   if(Opengl_Capture.Active)
+   {
+      GLuint Buffer = Get_Opengl_Capture_Binding(Target);
+      opengl_capture_mapping *Mapping = Get_Opengl_Capture_Mapping(Buffer);
+      Assert(Mapping);
+      Record_Opengl_Mapped_Write(Buffer, Mapping->Pointer, Offset, Length);
+   }
+   glFlushMappedBufferRange(Target, Offset, Length);
+   RECORD_OPENGL_CALL(Opengl_Call_glFlushMappedBufferRange, 0, 0, Target, Offset, Length);
+}
+
+static void Capture_glFramebufferRenderbuffer(GLenum Target, GLenum Attachment, GLenum Renderbuffer_Target, GLuint Renderbuffer)
+{
+   glFramebufferRenderbuffer(Target, Attachment, Renderbuffer_Target, Renderbuffer);
+   RECORD_OPENGL_CALL(Opengl_Call_glFramebufferRenderbuffer, 0, 0, Target, Attachment, Renderbuffer_Target, Renderbuffer);
+}
+
+static void Capture_glFramebufferTextureLayer(GLenum Target, GLenum Attachment, GLuint Texture, GLint Level, GLint Layer)
+{
+   glFramebufferTextureLayer(Target, Attachment, Texture, Level, Layer);
+   RECORD_OPENGL_CALL(Opengl_Call_glFramebufferTextureLayer, 0, 0, Target, Attachment, Texture, Level, Layer);
+}
+
+static void Capture_glGenBuffers(GLsizei Count, GLuint *Buffers)
+{
+   glGenBuffers(Count, Buffers);
+   Record_Opengl_Names(Opengl_Call_glGenBuffers, Count, Buffers);
+}
+
+static void Capture_glGenFramebuffers(GLsizei Count, GLuint *Framebuffers)
+{
+   glGenFramebuffers(Count, Framebuffers);
+   Record_Opengl_Names(Opengl_Call_glGenFramebuffers, Count, Framebuffers);
+}
+
+static void Capture_glGenQueries(GLsizei Count, GLuint *Queries)
+{
+   glGenQueries(Count, Queries);
+   Record_Opengl_Names(Opengl_Call_glGenQueries, Count, Queries);
+}
+
+static void Capture_glGenRenderbuffers(GLsizei Count, GLuint *Renderbuffers)
+{
+   glGenRenderbuffers(Count, Renderbuffers);
+   Record_Opengl_Names(Opengl_Call_glGenRenderbuffers, Count, Renderbuffers);
+}
+
+static void Capture_glGenTextures(GLsizei Count, GLuint *Textures)
+{
+   glGenTextures(Count, Textures);
+   Record_Opengl_Names(Opengl_Call_glGenTextures, Count, Textures);
+}
+
+static void Capture_glGenVertexArrays(GLsizei Count, GLuint *Arrays)
+{
+   glGenVertexArrays(Count, Arrays);
+   Record_Opengl_Names(Opengl_Call_glGenVertexArrays, Count, Arrays);
+}
+
+static void Capture_glGenerateMipmap(GLenum Target)
+{
+   glGenerateMipmap(Target);
+   RECORD_OPENGL_CALL(Opengl_Call_glGenerateMipmap, 0, 0, Target);
+}
+
+// NOTE: Queries are recorded too, since the driver may do real work for
+// them, but the replay throws their results away.
+static void Capture_glGetBufferSubData(GLenum Target, GLintptr Offset, GLsizeiptr Size, void *Data)
+{
+   glGetBufferSubData(Target, Offset, Size, Data);
+   RECORD_OPENGL_CALL(Opengl_Call_glGetBufferSubData, 0, 0, Target, Offset, Size);
+}
+
+static GLenum Capture_glGetError(void)
+{
+   GLenum Result = glGetError();
+   if(Opengl_Capture.Active)
+   {
+      Record_Opengl_Call(Opengl_Call_glGetError, 0, 0, 0, 0);
+   }
+   return(Result);
+}
+
+static void Capture_glGetIntegerv(GLenum Name, GLint *Data)
+{
+   glGetIntegerv(Name, Data);
+   RECORD_OPENGL_CALL(Opengl_Call_glGetIntegerv, 0, 0, Name);
+}
+
+static void Capture_glGetProgramBinary(GLuint Program, GLsizei Buffer_Size, GLsizei *Length, GLenum *Format, void *Binary)
+{
+   glGetProgramBinary(Program, Buffer_Size, Length, Format, Binary);
+   RECORD_OPENGL_CALL(Opengl_Call_glGetProgramBinary, 0, 0, Program, Buffer_Size);
+}
+
+static void Capture_glGetProgramInfoLog(GLuint Program, GLsizei Buffer_Size, GLsizei *Length, GLchar *Log)
+{
+   glGetProgramInfoLog(Program, Buffer_Size, Length, Log);
+   RECORD_OPENGL_CALL(Opengl_Call_glGetProgramInfoLog, 0, 0, Program, Buffer_Size);
+}
+
+static void Capture_glGetProgramiv(GLuint Program, GLenum Name, GLint *Parameters)
+{
+   glGetProgramiv(Program, Name, Parameters);
+   RECORD_OPENGL_CALL(Opengl_Call_glGetProgramiv, 0, 0, Program, Name);
+}
+
+static void Capture_glGetQueryObjectiv(GLuint Query, GLenum Name, GLint *Parameters)
+{
+   glGetQueryObjectiv(Query, Name, Parameters);
+   RECORD_OPENGL_CALL(Opengl_Call_glGetQueryObjectiv, 0, 0, Query, Name);
+}
+
+static void Capture_glGetQueryObjectui64v(GLuint Query, GLenum Name, GLuint64 *Parameters)
+{
+   glGetQueryObjectui64v(Query, Name, Parameters);
+   RECORD_OPENGL_CALL(Opengl_Call_glGetQueryObjectui64v, 0, 0, Query, Name);
+}
+
+static void Capture_glGetShaderInfoLog(GLuint Shader, GLsizei Buffer_Size, GLsizei *Length, GLchar *Log)
+{
+   glGetShaderInfoLog(Shader, Buffer_Size, Length, Log);
+   RECORD_OPENGL_CALL(Opengl_Call_glGetShaderInfoLog, 0, 0, Shader, Buffer_Size);
+}
+
+static void Capture_glGetShaderiv(GLuint Shader, GLenum Name, GLint *Parameters)
+{
+   glGetShaderiv(Shader, Name, Parameters);
+   RECORD_OPENGL_CALL(Opengl_Call_glGetShaderiv, 0, 0, Shader, Name);
+}
+
+static const GLubyte *Capture_glGetString(GLenum Name)
+{
+   const GLubyte *Result = glGetString(Name);
+   RECORD_OPENGL_CALL(Opengl_Call_glGetString, 0, 0, Name);
+   return(Result);
+}
+
+static const GLubyte *Capture_glGetStringi(GLenum Name, GLuint Index)
+{
+   const GLubyte *Result = glGetStringi(Name, Index);
+   RECORD_OPENGL_CALL(Opengl_Call_glGetStringi, 0, 0, Name, Index);
+   return(Result);
+}
+
+static GLuint Capture_glGetUniformBlockIndex(GLuint Program, const GLchar *Name)
+{
+   GLuint Result = glGetUniformBlockIndex(Program, Name);
+   RECORD_OPENGL_CALL(Opengl_Call_glGetUniformBlockIndex, Name, strlen(Name) + 1, Program, Result);
+   return(Result);
+}
+
+static GLint Capture_glGetUniformLocation(GLuint Program, const GLchar *Name)
+{
+   GLint Result = glGetUniformLocation(Program, Name);
+   RECORD_OPENGL_CALL(Opengl_Call_glGetUniformLocation, Name, strlen(Name) + 1, Program, (u64)(s64)Result);
+   return(Result);
+}
+
+static void Capture_glLinkProgram(GLuint Program)
+{
+   glLinkProgram(Program);
+   RECORD_OPENGL_CALL(Opengl_Call_glLinkProgram, 0, 0, Program);
+}
+
+static void *Capture_glMapBufferRange(GLenum Target, GLintptr Offset, GLsizeiptr Length, GLbitfield Access)
+{
+   void *Result = glMapBufferRange(Target, Offset, Length, Access);
+   if(Opengl_Capture.Active && Result)
+   {
+      opengl_capture *Capture = &Opengl_Capture;
+      Assert(Capture->Mapping_Count < OPENGL_CAPTURE_MAX_MAPPINGS);
+
+      opengl_capture_mapping *Mapping = Capture->Mappings + Capture->Mapping_Count++;
+      Mapping->Buffer = Get_Opengl_Capture_Binding(Target);
+      Mapping->Pointer = Result;
+      Mapping->Length = Length;
+      Mapping->Access = Access;
+
+      // NOTE: Nothing ever flushes a coherent mapping, so its writes would
+      // never make it into the trace.
+      Assert(!(Access & GL_MAP_WRITE_BIT) || !(Access & GL_MAP_PERSISTENT_BIT));
+   }
+   RECORD_OPENGL_CALL(Opengl_Call_glMapBufferRange, 0, 0, Target, Offset, Length, Access);
+   return(Result);
+}
+
+static void Capture_glMaxShaderCompilerThreadsKHR(GLuint Count)
+{
+   glMaxShaderCompilerThreadsKHR(Count);
+   RECORD_OPENGL_CALL(Opengl_Call_glMaxShaderCompilerThreadsKHR, 0, 0, Count);
+}
+
+// NOTE: The commands always come from the bound indirect buffer.
+static void Capture_glMultiDrawElementsIndirect(GLenum Mode, GLenum Type, const void *Indirect, GLsizei Draw_Count, GLsizei Stride)
+{
+   glMultiDrawElementsIndirect(Mode, Type, Indirect, Draw_Count, Stride);
+   RECORD_OPENGL_CALL(Opengl_Call_glMultiDrawElementsIndirect, 0, 0, Mode, Type, CAPTURE_POINTER(Indirect), Draw_Count, Stride);
+}
+
+static void Capture_glProgramBinary(GLuint Program, GLenum Format, const void *Binary, GLsizei Length)
+{
+   glProgramBinary(Program, Format, Binary, Length);
+   RECORD_OPENGL_CALL(Opengl_Call_glProgramBinary, Binary, Length, Program, Format, Length);
+}
+
+static void Capture_glProgramParameteri(GLuint Program, GLenum Name, GLint Value)
+{
+   glProgramParameteri(Program, Name, Value);
+   RECORD_OPENGL_CALL(Opengl_Call_glProgramParameteri, 0, 0, Program, Name, Value);
+}
+
+// NOTE: Reads into client memory go to scratch memory on replay, so only a
+// read into a pack buffer keeps its pointer.
+static void Capture_glReadPixels(GLint X, GLint Y, GLsizei Width, GLsizei Height, GLenum Format, GLenum Type, GLvoid *Pixels)
+{
+   glReadPixels(X, Y, Width, Height, Format, Type, Pixels);
+   if(Opengl_Capture.Active)
+   {
+      Assert(Format == GL_RGBA && Type == GL_UNSIGNED_BYTE);
+      bool Pack_Buffer = (Get_Opengl_Capture_Binding(GL_PIXEL_PACK_BUFFER) != 0);
+      RECORD_OPENGL_CALL(Opengl_Call_glReadPixels, 0, 0, X, Y, Width, Height, Format, Type, CAPTURE_POINTER(Pixels), Pack_Buffer);
+   }
+}
+
+static void Capture_glRenderbufferStorage(GLenum Target, GLenum Format, GLsizei Width, GLsizei Height)
+{
+   glRenderbufferStorage(Target, Format, Width, Height);
+   RECORD_OPENGL_CALL(Opengl_Call_glRenderbufferStorage, 0, 0, Target, Format, Width, Height);
+}
+
+static void Capture_glScissor(GLint X, GLint Y, GLsizei Width, GLsizei Height)
+{
+   glScissor(X, Y, Width, Height);
+   RECORD_OPENGL_CALL(Opengl_Call_glScissor, 0, 0, X, Y, Width, Height);
+}
+
+// NOTE: The strings are recorded as one, which compiles the same.
+static void Capture_glShaderSource(GLuint Shader, GLsizei Count, const GLchar **Strings, const GLint *Lengths)
+{
+   glShaderSource(Shader, Count, Strings, Lengths);
+   if(Opengl_Capture.Active)
+   {
+      u64 Total_Length = 0;
+      for(GLsizei Index = 0; Index < Count; ++Index)
+      {
+         Total_Length += (Lengths && Lengths[Index] >= 0) ? (u64)Lengths[Index] : strlen(Strings[Index]);
+      }
+
+      u64 Arguments[] = {Shader};
+      Begin_Opengl_Capture_Record(Opengl_Call_glShaderSource, Arguments, Array_Count(Arguments), Total_Length);
+      for(GLsizei Index = 0; Index < Count; ++Index)
+      {
+         u64 Length = (Lengths && Lengths[Index] >= 0) ? (u64)Lengths[Index] : strlen(Strings[Index]);
+         Append_Opengl_Capture_Payload((void *)Strings[Index], Length);
+      }
+      End_Opengl_Capture_Record();
+   }
+}
+
+// NOTE: Texture pixels from client memory are copied into the payload, while
+// those from a bound unpack buffer are just an offset.
+static void Record_Opengl_Pixels(opengl_call Call, u64 *Arguments, u32 Argument_Count, GLenum Format, GLenum Type, GLsizei Width, GLsizei Height, GLsizei Depth, const void *Pixels)
+{
+   u64 Payload_Size = 0;
+   if(Pixels && !Get_Opengl_Capture_Binding(GL_PIXEL_UNPACK_BUFFER))
+   {
+      Assert((Format == GL_RGBA || Format == GL_RED) && Type == GL_UNSIGNED_BYTE);
+      Payload_Size = Get_Opengl_Capture_Pixels_Size(Format, Width, Height, Depth);
+   }
+   Record_Opengl_Call(Call, Arguments, Argument_Count, Pixels, Payload_Size);
+}
+
+static void Capture_glTexImage3D(GLenum Target, GLint Level, GLint Internal_Format, GLsizei Width, GLsizei Height, GLsizei Depth, GLint Border, GLenum Format, GLenum Type, const GLvoid *Pixels)
+{
+   glTexImage3D(Target, Level, Internal_Format, Width, Height, Depth, Border, Format, Type, Pixels);
+   if(Opengl_Capture.Active)
+   {
+      u64 Arguments[] = {Target, Level, Internal_Format, Width, Height, Depth, Border, Format, Type, CAPTURE_POINTER(Pixels)};
+      Record_Opengl_Pixels(Opengl_Call_glTexImage3D, Arguments, Array_Count(Arguments), Format, Type, Width, Height, Depth, Pixels);
+   }
+}
+
+static void Capture_glTexParameteri(GLenum Target, GLenum Name, GLint Value)
+{
+   glTexParameteri(Target, Name, Value);
+   RECORD_OPENGL_CALL(Opengl_Call_glTexParameteri, 0, 0, Target, Name, Value);
+}
+
+static void Capture_glTexSubImage3D(GLenum Target, GLint Level, GLint X, GLint Y, GLint Z, GLsizei Width, GLsizei Height, GLsizei Depth, GLenum Format, GLenum Type, const GLvoid *Pixels)
+{
+   glTexSubImage3D(Target, Level, X, Y, Z, Width, Height, Depth, Format, Type, Pixels);
+   if(Opengl_Capture.Active)
+   {
+      u64 Arguments[] = {Target, Level, X, Y, Z, Width, Height, Depth, Format, Type, CAPTURE_POINTER(Pixels)};
+      Record_Opengl_Pixels(Opengl_Call_glTexSubImage3D, Arguments, Array_Count(Arguments), Format, Type, Width, Height, Depth, Pixels);
+   }
+}
+
+static void Capture_glUniform1ui(GLint Location, GLuint Value)
+{
+   glUniform1ui(Location, Value);
+   RECORD_OPENGL_CALL(Opengl_Call_glUniform1ui, 0, 0, (u64)(s64)Location, Value);
+}
+
+static void Capture_glUniform2f(GLint Location, GLfloat X, GLfloat Y)
+{
+   glUniform2f(Location, X, Y);
+   RECORD_OPENGL_CALL(Opengl_Call_glUniform2f, 0, 0, (u64)(s64)Location, Opengl_Capture_Float(X), Opengl_Capture_Float(Y));
+}
+
+static void Capture_glUniform4f(GLint Location, GLfloat X, GLfloat Y, GLfloat Z, GLfloat W)
+{
+   glUniform4f(Location, X, Y, Z, W);
+   RECORD_OPENGL_CALL(Opengl_Call_glUniform4f, 0, 0, (u64)(s64)Location, Opengl_Capture_Float(X), Opengl_Capture_Float(Y), Opengl_Capture_Float(Z), Opengl_Capture_Float(W));
+}
+
+static void Capture_glUniformBlockBinding(GLuint Program, GLuint Block_Index, GLuint Binding)
+{
+   glUniformBlockBinding(Program, Block_Index, Binding);
+   RECORD_OPENGL_CALL(Opengl_Call_glUniformBlockBinding, 0, 0, Program, Block_Index, Binding);
+}
+
+static GLboolean Capture_glUnmapBuffer(GLenum Target)
+{
+   if(Opengl_Capture.Active)
+   {
+      opengl_capture *Capture = &Opengl_Capture;
+      GLuint Buffer = Get_Opengl_Capture_Binding(Target);
+      opengl_capture_mapping *Mapping = Get_Opengl_Capture_Mapping(Buffer);
+      Assert(Mapping);
+
+      // NOTE: Explicitly flushed ranges were recorded as they were flushed.
+      if((Mapping->Access & GL_MAP_WRITE_BIT) && !(Mapping->Access & GL_MAP_FLUSH_EXPLICIT_BIT))
+      {
+         Record_Opengl_Mapped_Write(Buffer, Mapping->Pointer, 0, Mapping->Length);
+      }
+      *Mapping = Capture->Mappings[--Capture->Mapping_Count];
+   }
+
+   GLboolean Result = glUnmapBuffer(Target);
+   RECORD_OPENGL_CALL(Opengl_Call_glUnmapBuffer, 0, 0, Target);
+   return(Result);
+}
+
+static void Capture_glUseProgram(GLuint Program)
+{
+   glUseProgram(Program);
+   RECORD_OPENGL_CALL(Opengl_Call_glUseProgram, 0, 0, Program);
+}
+
+static void Capture_glVertexAttribDivisor(GLuint Index, GLuint Divisor)
+{
+   glVertexAttribDivisor(Index, Divisor);
+   RECORD_OPENGL_CALL(Opengl_Call_glVertexAttribDivisor, 0, 0, Index, Divisor);
+}
+
+// NOTE: Attribute pointers are always offsets into the bound array buffer.
+static void Capture_glVertexAttribIPointer(GLuint Index, GLint Component_Count, GLenum Type, GLsizei Stride, const void *Pointer)
+{
+   glVertexAttribIPointer(Index, Component_Count, Type, Stride, Pointer);
+   RECORD_OPENGL_CALL(Opengl_Call_glVertexAttribIPointer, 0, 0, Index, Component_Count, Type, Stride, CAPTURE_POINTER(Pointer));
+}
+
+static void Capture_glVertexAttribPointer(GLuint Index, GLint Component_Count, GLenum Type, GLboolean Normalized, GLsizei Stride, const GLvoid *Pointer)
+{
+   glVertexAttribPointer(Index, Component_Count, Type, Normalized, Stride, Pointer);
+   RECORD_OPENGL_CALL(Opengl_Call_glVertexAttribPointer, 0, 0, Index, Component_Count, Type, Normalized, Stride, CAPTURE_POINTER(Pointer));
+}
+
+static void Capture_glViewport(GLint X, GLint Y, GLsizei Width, GLsizei Height)
+{
+   glViewport(X, Y, Width, Height);
+   RECORD_OPENGL_CALL(Opengl_Call_glViewport, 0, 0, X, Y, Width, Height);
+}
+
+static BEGIN_OPENGL_CAPTURE(Begin_Opengl_Capture)
+{
+   bool Result = false;
+
+   opengl_capture *Capture = &Opengl_Capture;
+   Assert(!Capture->Active);
+
+   opengl_capture Zero = {0};
+   *Capture = Zero;
+
+   Capture->Width = Width;
+   Capture->Height = Height;
+   Capture->File = fopen(Path, "wb");
+   if(Capture->File)
+   {
+      // NOTE: Only a placeholder, rewritten with the final counts when the
+      // capture ends.
+      opengl_capture_header Header = {0};
+      fwrite(&Header, sizeof(Header), 1, Capture->File);
+
+      Capture->Bytes_Written = sizeof(Header);
+      Capture->Active = true;
+      Result = true;
+   }
+   else
+   {
+      fprintf(stderr, "Failed to open %s for writing.\n", Path);
+   }
+
+   return(Result);
+}
+
+static END_OPENGL_CAPTURE(End_Opengl_Capture)
+{
+   opengl_capture *Capture = &Opengl_Capture;
+   if(Capture->Active)
+   {
+      opengl_capture_header Header = {0};
+      Header.Magic = OPENGL_CAPTURE_MAGIC;
+      Header.Version = OPENGL_CAPTURE_VERSION;
+      Header.Width = Capture->Width;
+      Header.Height = Capture->Height;
+      Header.Frame_Count = Capture->Frame_Count;
+      Header.Record_Count = Capture->Record_Count;
+      fseek(Capture->File, 0, SEEK_SET);
+      fwrite(&Header, sizeof(Header), 1, Capture->File);
+
+      if(fclose(Capture->File) == 0)
+      {
+         printf("Captured %u frames: %llu GL calls, %.2f MB\n", Capture->Frame_Count,
+                (unsigned long long)Capture->Record_Count, (double)Capture->Bytes_Written / (1024.0*1024.0));
+      }
+      else
+      {
+         fprintf(stderr, "Failed to finish writing the capture.\n");
+      }
+      Capture->File = 0;
+      Capture->Active = false;
+   }
+}
+
+static void Mark_Opengl_Capture_Frame(void)
+{
+   if(Opengl_Capture.Active)
+   {
+      Record_Opengl_Call(Opengl_Call_Begin_Frame, 0, 0, 0, 0);
+      Opengl_Capture.Frame_Count++;
+   }
+}
+
+#define glActiveTexture Capture_glActiveTexture
+#define glAttachShader Capture_glAttachShader
+#define glBeginQuery Capture_glBeginQuery
+#define glBindBuffer Capture_glBindBuffer
+#define glBindBufferRange Capture_glBindBufferRange
+#define glBindFramebuffer Capture_glBindFramebuffer
+#define glBindRenderbuffer Capture_glBindRenderbuffer
+#define glBindTexture Capture_glBindTexture
+#define glBindVertexArray Capture_glBindVertexArray
+#define glBlendFunc Capture_glBlendFunc
+#define glBufferData Capture_glBufferData
+#define glBufferStorage Capture_glBufferStorage
+#define glBufferSubData Capture_glBufferSubData
+#define glCheckFramebufferStatus Capture_glCheckFramebufferStatus
+#define glClear Capture_glClear
+#define glClearColor Capture_glClearColor
+#define glClientWaitSync Capture_glClientWaitSync
+#define glCompileShader Capture_glCompileShader
+#define glCreateProgram Capture_glCreateProgram
+#define glCreateShader Capture_glCreateShader
+#define glCullFace Capture_glCullFace
+#define glDeleteBuffers Capture_glDeleteBuffers
+#define glDeleteFramebuffers Capture_glDeleteFramebuffers
+#define glDeleteProgram Capture_glDeleteProgram
+#define glDeleteQueries Capture_glDeleteQueries
+#define glDeleteRenderbuffers Capture_glDeleteRenderbuffers
+#define glDeleteShader Capture_glDeleteShader
+#define glDeleteSync Capture_glDeleteSync
+#define glDeleteTextures Capture_glDeleteTextures
+#define glDeleteVertexArrays Capture_glDeleteVertexArrays
+#define glDepthFunc Capture_glDepthFunc
+#define glDepthMask Capture_glDepthMask
+#define glDetachShader Capture_glDetachShader
+#define glDisable Capture_glDisable
+#define glDrawArrays Capture_glDrawArrays
+#define glDrawArraysInstanced Capture_glDrawArraysInstanced
+#define glDrawElements Capture_glDrawElements
+#define glDrawElementsBaseVertex Capture_glDrawElementsBaseVertex
+#define glDrawElementsInstanced Capture_glDrawElementsInstanced
+#define glEnable Capture_glEnable
+#define glEnableVertexAttribArray Capture_glEnableVertexAttribArray
+#define glEndQuery Capture_glEndQuery
+#define glFenceSync Capture_glFenceSync
+#define glFinish Capture_glFinish
+#define glFlush Capture_glFlush
+#define glFlushMappedBufferRange Capture_glFlushMappedBufferRange
+#define glFramebufferRenderbuffer Capture_glFramebufferRenderbuffer
+#define glFramebufferTextureLayer Capture_glFramebufferTextureLayer
+#define glGenBuffers Capture_glGenBuffers
+#define glGenFramebuffers Capture_glGenFramebuffers
+#define glGenQueries Capture_glGenQueries
+#define glGenRenderbuffers Capture_glGenRenderbuffers
+#define glGenTextures Capture_glGenTextures
+#define glGenVertexArrays Capture_glGenVertexArrays
+#define glGenerateMipmap Capture_glGenerateMipmap
+#define glGetBufferSubData Capture_glGetBufferSubData
+#define glGetError Capture_glGetError
+#define glGetIntegerv Capture_glGetIntegerv
+#define glGetProgramBinary Capture_glGetProgramBinary
+#define glGetProgramInfoLog Capture_glGetProgramInfoLog
+#define glGetProgramiv Capture_glGetProgramiv
+#define glGetQueryObjectiv Capture_glGetQueryObjectiv
+#define glGetQueryObjectui64v Capture_glGetQueryObjectui64v
+#define glGetShaderInfoLog Capture_glGetShaderInfoLog
+#define glGetShaderiv Capture_glGetShaderiv
+#define glGetString Capture_glGetString
+#define glGetStringi Capture_glGetStringi
+#define glGetUniformBlockIndex Capture_glGetUniformBlockIndex
+#define glGetUniformLocation Capture_glGetUniformLocation
+#define glLinkProgram Capture_glLinkProgram
+#define glMapBufferRange Capture_glMapBufferRange
+#define glMaxShaderCompilerThreadsKHR Capture_glMaxShaderCompilerThreadsKHR
+#define glMultiDrawElementsIndirect Capture_glMultiDrawElementsIndirect
+#define glProgramBinary Capture_glProgramBinary
+#define glProgramParameteri Capture_glProgramParameteri
+#define glReadPixels Capture_glReadPixels
+#define glRenderbufferStorage Capture_glRenderbufferStorage
+#define glScissor Capture_glScissor
+#define glShaderSource Capture_glShaderSource
+#define glTexImage3D Capture_glTexImage3D
+#define glTexParameteri Capture_glTexParameteri
+#define glTexSubImage3D Capture_glTexSubImage3D
+#define glUniform1ui Capture_glUniform1ui
+#define glUniform2f Capture_glUniform2f
+#define glUniform4f Capture_glUniform4f
+#define glUniformBlockBinding Capture_glUniformBlockBinding
+#define glUnmapBuffer Capture_glUnmapBuffer
+#define glUseProgram Capture_glUseProgram
+#define glVertexAttribDivisor Capture_glVertexAttribDivisor
+#define glVertexAttribIPointer Capture_glVertexAttribIPointer
+#define glVertexAttribPointer Capture_glVertexAttribPointer
+#define glViewport Capture_glViewport
+#else
+static bool Is_Opengl_Capture_Active(void)
+{
+   return(false);
+}
+
+static BEGIN_OPENGL_CAPTURE(Begin_Opengl_Capture)
+{
+   fprintf(stderr, "Capture isn't available, since this build has OPENGL_CAPTURE_ENABLED=0.\n");
+   return(false);
+}
+
+static END_OPENGL_CAPTURE(End_Opengl_Capture)
+{
+}
+
+static void Mark_Opengl_Capture_Frame(void)
+{
+}
+#endif
@@ -0,0 +1,168 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: GL trace format, written by the renderer's capture mode and read by
+// opengl_replay.c. A trace is a header followed by a flat stream of records,
+// one per GL call in the order the renderer made them:
+//
+//    opengl_capture_record
+//    u64 Arguments[Argument_Count]
+//    u8 Payload[Payload_Size], zero padded to a multiple of 8
+//
+// Arguments are the call's parameters in declaration order, with enums and
+// names widened to u64, floats stored as their bit pattern, and buffer
+// offsets passed as pointers stored as plain integers. Calls that return an
+// object name or a uniform location append it as one more argument, so the
+// replay can map the names its own driver hands out back onto the captured
+// ones. Fence syncs are numbered by the capture rather than stored as
+// pointers.
+//
+// Payloads hold whatever data the call reads from client memory: buffer
+// contents, shader sources, generated or deleted names. Writes through
+// mapped buffers have no call of their own, so the capture emits a
+// Write_Mapped record with the written bytes right before the flush or unmap
+// that publishes them. Begin_Frame records mark where each frame starts.
+#define OPENGL_CAPTURE_MAGIC 0x52544C47 // NOTE: "GLTR"
+#define OPENGL_CAPTURE_VERSION 1
+
+typedef struct {
+   u32 Magic;
+   u32 Version;
+   u32 Width;
+   u32 Height;
+   u32 Frame_Count; // NOTE: Patched in when the capture ends.
+   u32 Padding;
+   u64 Record_Count;
+} opengl_capture_header;
+
+typedef struct {
+   u16 Call;
+   u16 Argument_Count;
+   u32 Payload_Size;
+} opengl_capture_record;
+
+typedef enum {
+   Opengl_Call_Begin_Frame,
+   Opengl_Call_Write_Mapped,
+
+   Opengl_Call_glActiveTexture,
+   Opengl_Call_glAttachShader,
+   Opengl_Call_glBeginQuery,
+   Opengl_Call_glBindBuffer,
+   Opengl_Call_glBindFramebuffer,
+   Opengl_Call_glBindRenderbuffer,
+   Opengl_Call_glBindTexture,
+   Opengl_Call_glBindVertexArray,
+   Opengl_Call_glBlendFunc,
+   Opengl_Call_glBufferData,
+   Opengl_Call_glBufferStorage,
+   Opengl_Call_glBufferSubData,
+   Opengl_Call_glCheckFramebufferStatus,
+   Opengl_Call_glClear,
+   Opengl_Call_glClearColor,
+   Opengl_Call_glClientWaitSync,
+   Opengl_Call_glCompileShader,
+   Opengl_Call_glCreateProgram,
+   Opengl_Call_glCreateShader,
+   Opengl_Call_glCullFace,
+   Opengl_Call_glDeleteBuffers,
+   Opengl_Call_glDeleteFramebuffers,
+   Opengl_Call_glDeleteProgram,
+   Opengl_Call_glDeleteQueries,
+   Opengl_Call_glDeleteRenderbuffers,
+   Opengl_Call_glDeleteShader,
+   Opengl_Call_glDeleteSync,
+   Opengl_Call_glDeleteTextures,
+   Opengl_Call_glDeleteVertexArrays,
+   Opengl_Call_glDepthFunc,
+   Opengl_Call_glDepthMask,
+   Opengl_Call_glDetachShader,
+   Opengl_Call_glDisable,
+   Opengl_Call_glDrawArrays,
+   Opengl_Call_glDrawArraysInstanced,
+   Opengl_Call_glDrawElements,
+   Opengl_Call_glDrawElementsInstanced,
+   Opengl_Call_glEnable,
+   Opengl_Call_glEnableVertexAttribArray,
+   Opengl_Call_glEndQuery,
+   Opengl_Call_glFenceSync,
+   Opengl_Call_glFinish,
+   Opengl_Call_glFlush,
+   Opengl_Call_glFlushMappedBufferRange,
+   Opengl_Call_glFramebufferRenderbuffer,
+   Opengl_Call_glGenBuffers,
+   Opengl_Call_glGenFramebuffers,
+   Opengl_Call_glGenQueries,
+   Opengl_Call_glGenRenderbuffers,
+   Opengl_Call_glGenTextures,
+   Opengl_Call_glGenVertexArrays,
+   Opengl_Call_glGenerateMipmap,
+   Opengl_Call_glGetError,
+   Opengl_Call_glGetIntegerv,
+   Opengl_Call_glGetProgramBinary,
+   Opengl_Call_glGetProgramInfoLog,
+   Opengl_Call_glGetProgramiv,
+   Opengl_Call_glGetQueryObjectiv,
+   Opengl_Call_glGetQueryObjectui64v,
+   Opengl_Call_glGetShaderInfoLog,
+   Opengl_Call_glGetShaderiv,
+   Opengl_Call_glGetString,
+   Opengl_Call_glGetStringi,
+   Opengl_Call_glGetUniformLocation,
+   Opengl_Call_glLinkProgram,
+   Opengl_Call_glMapBufferRange,
+   Opengl_Call_glMaxShaderCompilerThreadsKHR,
+   Opengl_Call_glProgramBinary,
+   Opengl_Call_glProgramParameteri,
+   Opengl_Call_glReadPixels,
+   Opengl_Call_glRenderbufferStorage,
+   Opengl_Call_glShaderSource,
+   Opengl_Call_glTexImage3D,
+   Opengl_Call_glTexParameteri,
+   Opengl_Call_glTexSubImage3D,
+   Opengl_Call_glUniform1ui,
+   Opengl_Call_glUniform2f,
+   Opengl_Call_glUniform4f,
+   Opengl_Call_glUnmapBuffer,
+   Opengl_Call_glUseProgram,
+   Opengl_Call_glVertexAttribDivisor,
+   Opengl_Call_glVertexAttribIPointer,
+   Opengl_Call_glVertexAttribPointer,
+   Opengl_Call_glViewport,
+
+   // NOTE: Calls added since the first version go at the end, so that older
+   // traces stay readable.
+   Opengl_Call_glDrawElementsBaseVertex,
+   Opengl_Call_glMultiDrawElementsIndirect,
+   Opengl_Call_glBindBufferRange,
+   Opengl_Call_glGetUniformBlockIndex,
+   Opengl_Call_glUniformBlockBinding,
+   Opengl_Call_glGetBufferSubData,
+   Opengl_Call_glScissor,
+   Opengl_Call_glFramebufferTextureLayer,
+
+   Opengl_Call_Count,
+} opengl_call;
+
+// NOTE: Pixel payloads are only ever RGBA8 or R8, whether they come from
+// client memory or the offset into a bound pixel buffer.
+static inline u64 Get_Opengl_Capture_Pixels_Size(GLenum Format, GLsizei Width, GLsizei Height, GLsizei Depth)
+{
+   u64 Bytes_Per_Pixel = (Format == GL_RED) ? 1 : 4;
+   u64 Result = (u64)Width * (u64)Height * (u64)Depth * Bytes_Per_Pixel;
+   return(Result);
+}
+
+static inline u64 Opengl_Capture_Float(float Value)
+{
+   u32 Bits;
+   memcpy(&Bits, &Value, sizeof(Bits));
+   return(Bits);
+}
+
+static inline float Opengl_Replay_Float(u64 Value)
+{
+   u32 Bits = (u32)Value;
+   float Result;
+   memcpy(&Result, &Bits, sizeof(Result));
+   return(Result);
+}
@@ -0,0 +1,898 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Render command buffer. Commands are appended in whatever order the
+// application produces them and executed in sort key order.
+
+static void Initialize_Render_Commands(render_command_list *List, arena *Arena, arena *Frame)
+{
+   render_command *Commands = Push_Array(Arena, OPENGL_MAX_RENDER_COMMANDS, render_command);
+   render_sort_entry *Entries = Push_Array(Arena, OPENGL_MAX_RENDER_COMMANDS, render_sort_entry);
+
+   // NOTE: The permanent chunks never move, so their pointers are set once.
+   // The rest are filled in as they're claimed each frame.
+   List->Chunks = Push_Array(Arena, OPENGL_RENDER_COMMAND_MAX_CHUNKS, render_command_chunk);
+   for(u32 Chunk = 0; Chunk < OPENGL_RENDER_COMMAND_CHUNK_COUNT; ++Chunk)
+   {
+      List->Chunks[Chunk].Commands = Commands + Chunk*OPENGL_RENDER_COMMAND_CHUNK_SIZE;
+      List->Chunks[Chunk].Entries = Entries + Chunk*OPENGL_RENDER_COMMAND_CHUNK_SIZE;
+   }
+   List->Chunk_Counts = Push_Array(Arena, OPENGL_RENDER_COMMAND_MAX_CHUNKS, u32);
+   atomic_flag_clear(&List->Grow_Lock);
+   List->Frame = Frame;
+
+   List->Thread_Count = Get_Thread_Count();
+   List->Threads = Push_Array(Arena, List->Thread_Count, render_command_buffer);
+}
+
+static void Reset_Render_Commands(render_command_list *List)
+{
+   atomic_store_explicit(&List->Next_Chunk, 0, memory_order_relaxed);
+   List->Grown_Chunks = 0;
+   for(u32 Index = 0; Index < List->Thread_Count; ++Index)
+   {
+      render_command_buffer Zero = {0};
+      List->Threads[Index] = Zero;
+   }
+}
+
+static void Retire_Render_Command_Chunk(render_command_list *List, render_command_buffer *Buffer)
+{
+   if(Buffer->Has_Chunk)
+   {
+      List->Chunk_Counts[Buffer->Chunk] = Buffer->Count;
+      Buffer->Has_Chunk = false;
+   }
+}
+
+// NOTE: Backs a chunk claimed past the permanent pool with frame arena memory.
+// Returns false, leaving the chunk empty, if the frame arena can't fit it
+// along with the rest of the frame's cost for every command claimed so far,
+// permanent pool included.
+static bool Grow_Render_Commands(render_command_list *List, u32 Chunk)
+{
+   while(atomic_flag_test_and_set_explicit(&List->Grow_Lock, memory_order_acquire));
+
+   arena *Frame = List->Frame;
+   size Commands_Size = OPENGL_RENDER_COMMAND_CHUNK_SIZE*sizeof(render_command);
+   size Entries_Size = OPENGL_RENDER_COMMAND_CHUNK_SIZE*sizeof(render_sort_entry);
+   size Claimed = OPENGL_MAX_RENDER_COMMANDS + (size)(List->Grown_Chunks + 1)*OPENGL_RENDER_COMMAND_CHUNK_SIZE;
+   size Needed = (Commands_Size + Entries_Size + Claimed*OPENGL_RENDER_COMMAND_FRAME_COST +
+                  OPENGL_RENDER_COMMAND_FRAME_RESERVE + 32); // NOTE: Worst case alignment.
+
+   bool Result = (Frame->Size - Frame->Used >= Needed);
+   if(Result)
+   {
+      List->Chunks[Chunk].Commands = Push_Size(Frame, Commands_Size);
+      List->Chunks[Chunk].Entries = Push_Size(Frame, Entries_Size);
+      List->Grown_Chunks++;
+   }
+   else
+   {
+      List->Chunk_Counts[Chunk] = 0;
+   }
+
+   atomic_flag_clear_explicit(&List->Grow_Lock, memory_order_release);
+   return(Result);
+}
+
+static u64 Make_Render_Key(render_pass Pass, opengl_material Material, float Depth)
+{
+   // NOTE: Program bits are offset by one so that commands without a material
+   // (clears, viewports) sort ahead of every draw in their pass.
+   u64 Program = (u64)Material.Program + 1;
+   Assert(Program <= RENDER_KEY_PROGRAM_MASK);
+   Assert(Material.Texture <= RENDER_KEY_TEXTURE_MASK);
+
+   if(Depth < 0.0f) Depth = 0.0f;
+   if(Depth > 1.0f) Depth = 1.0f;
+   u64 Quantized_Depth = (u64)(Depth * (float)RENDER_KEY_DEPTH_MASK);
+
+   u64 Result = (((u64)Pass << RENDER_KEY_PASS_SHIFT) |
+                 (Program << RENDER_KEY_PROGRAM_SHIFT) |
+                 ((u64)Material.Texture << RENDER_KEY_TEXTURE_SHIFT) |
+                 (Quantized_Depth << RENDER_KEY_DEPTH_SHIFT));
+   return(Result);
+}
+
+static render_command *Push_Render_Command(opengl_context *GL, render_command_type Type, u64 Key)
+{
+   render_command_list *List = &GL->Commands;
+
+   u32 Thread_Index = Get_Thread_Index();
+   Assert(Thread_Index < List->Thread_Count);
+   render_command_buffer *Buffer = List->Threads + Thread_Index;
+
+   if(!Buffer->Has_Chunk || Buffer->Count == OPENGL_RENDER_COMMAND_CHUNK_SIZE)
+   {
+      Retire_Render_Command_Chunk(List, Buffer);
+
+      u32 Chunk = atomic_fetch_add_explicit(&List->Next_Chunk, 1, memory_order_relaxed);
+      if(Chunk < OPENGL_RENDER_COMMAND_CHUNK_COUNT ||
+         (Chunk < OPENGL_RENDER_COMMAND_MAX_CHUNKS && Grow_Render_Commands(List, Chunk)))
+      {
+         Buffer->Has_Chunk = true;
+         Buffer->Chunk = Chunk;
+         Buffer->Count = 0;
+      }
+   }
+
+   render_command *Result = 0;
+   if(Buffer->Has_Chunk)
+   {
+      render_command_chunk *Chunk = List->Chunks + Buffer->Chunk;
+      u32 Index = Buffer->Count++;
+      Result = Chunk->Commands + Index;
+      Result->Type = Type;
+
+      Chunk->Entries[Index].Key = Key;
+      Chunk->Entries[Index].Command = Result;
+   }
+   else
+   {
+      Buffer->Overflow_Count++;
+   }
+
+   return(Result);
+}
+
+static void Push_Render_Clear(opengl_context *GL, render_pass Pass, vec4 Color)
+{
+   u64 Key = (u64)Pass << RENDER_KEY_PASS_SHIFT;
+   render_command *Command = Push_Render_Command(GL, Render_Command_Clear, Key);
+   if(Command)
+   {
+      Command->Clear.Color = Color;
+   }
+}
+
+static void Push_Render_Viewport(opengl_context *GL, render_pass Pass, int X, int Y, int Width, int Height)
+{
+   u64 Key = (u64)Pass << RENDER_KEY_PASS_SHIFT;
+   render_command *Command = Push_Render_Command(GL, Render_Command_Viewport, Key);
+   if(Command)
+   {
+      Command->Viewport.X = X;
+      Command->Viewport.Y = Y;
+      Command->Viewport.Width = Width;
+      Command->Viewport.Height = Height;
+   }
+}
+
+static void Push_Render_Mesh_Lod(opengl_context *GL, render_pass Pass, opengl_material Material, opengl_mesh *Mesh, u32 Lod, opengl_instance Instance, float Depth)
+{
+   Assert(Lod < Mesh->Lod_Count);
+
+   u64 Key = Make_Render_Key(Pass, Material, Depth);
+   render_command *Command = Push_Render_Command(GL, Render_Command_Draw_Mesh, Key);
+   if(Command)
+   {
+      Command->Material = Material;
+      Command->Draw_Mesh.Mesh = Mesh;
+      Command->Draw_Mesh.Lod = Lod;
+      Command->Draw_Mesh.Instance = Instance;
+   }
+}
+
+static void Push_Render_Mesh(opengl_context *GL, render_pass Pass, opengl_material Material, opengl_mesh *Mesh, opengl_instance Instance, float Depth)
+{
+   Push_Render_Mesh_Lod(GL, Pass, Material, Mesh, 0, Instance, Depth);
+}
+
+static void Push_Instance_Batch(opengl_context *GL, opengl_instance_batch *Batch)
+{
+   opengl_material Material = {0};
+   Material.Program = (Batch->Draw_Naive) ? GL->Per_Object_Program : GL->Instanced_Program;
+
+   u64 Key = Make_Render_Key(Render_Pass_Scene, Material, 0.0f);
+   render_command *Command = Push_Render_Command(GL, Render_Command_Draw_Instances, Key);
+   if(Command)
+   {
+      Command->Material = Material;
+      Command->Draw_Instances.Batch = Batch;
+   }
+}
+
+// NOTE: Like the other recording functions, this can be called from any
+// thread, but a batch must only be filled by one of them.
+static void Push_Indirect_Draw(opengl_indirect_batch *Batch, u32 Mesh_Handle, opengl_instance Instance)
+{
+   Assert(Mesh_Handle > 0 && Mesh_Handle <= Batch->Pool->Mesh_Count);
+
+   if(Batch->Count < Batch->Capacity)
+   {
+      opengl_pool_mesh *Mesh = Batch->Pool->Meshes + (Mesh_Handle - 1);
+
+      u32 Index = Batch->Count++;
+      opengl_draw_command *Command = Batch->Commands + Index;
+      Command->Index_Count = Mesh->Index_Count;
+      Command->Instance_Count = 1;
+      Command->First_Index = Mesh->First_Index;
+      Command->Base_Vertex = Mesh->Base_Vertex;
+      Command->Base_Instance = Index;
+
+      Batch->Instances[Index] = Instance;
+   }
+}
+
+static void Push_Indirect_Batch(opengl_context *GL, opengl_indirect_batch *Batch)
+{
+   opengl_material Material = {0};
+   Material.Program = GL->Instanced_Program;
+
+   u64 Key = Make_Render_Key(Render_Pass_Scene, Material, 0.0f);
+   render_command *Command = Push_Render_Command(GL, Render_Command_Draw_Indirect, Key);
+   if(Command)
+   {
+      Command->Material = Material;
+      Command->Draw_Indirect.Batch = Batch;
+   }
+}
+
+static void Radix_Sort_Render_Entries(render_sort_entry **Entries, render_sort_entry *Scratch, u32 Count)
+{
+   // NOTE: Least significant byte first, eight passes over the 64-bit keys.
+   // Each pass is stable, which is what keeps equal keys in push order. Passes
+   // where every key has the same byte would only copy, so they are skipped;
+   // in practice the depth and unused low bits make up most of them.
+   render_sort_entry *Source = *Entries;
+   render_sort_entry *Dest = Scratch;
+
+   for(u32 Shift = 0; Shift < 64; Shift += 8)
+   {
+      u32 Offsets[256] = {0};
+      for(u32 Index = 0; Index < Count; ++Index)
+      {
+         Offsets[(Source[Index].Key >> Shift) & 0xFF]++;
+      }
+
+      if(Offsets[(Source[0].Key >> Shift) & 0xFF] == Count)
+      {
+         continue;
+      }
+
+      u32 Total = 0;
+      for(u32 Bucket = 0; Bucket < Array_Count(Offsets); ++Bucket)
+      {
+         u32 Bucket_Count = Offsets[Bucket];
+         Offsets[Bucket] = Total;
+         Total += Bucket_Count;
+      }
+
+      for(u32 Index = 0; Index < Count; ++Index)
+      {
+         u32 Bucket = (Source[Index].Key >> Shift) & 0xFF;
+         Dest[Offsets[Bucket]++] = Source[Index];
+      }
+
+      render_sort_entry *Swap = Source;
+      Source = Dest;
+      Dest = Swap;
+   }
+
+   *Entries = Source;
+}
+
+static void Draw_Opengl_Mesh(opengl_mesh *Mesh, u32 Lod, u32 Instance_Count)
+{
+   if(Mesh->Index_Count > 0)
+   {
+      opengl_mesh_lod *Range = Mesh->Lods + Lod;
+      size Index_Size = (Mesh->Index_Type == GL_UNSIGNED_INT) ? sizeof(u32) : sizeof(u16);
+      GLvoid *Offset = (GLvoid *)(Range->First_Index*Index_Size);
+
+      if(Instance_Count > 1)
+      {
+         glDrawElementsInstanced(GL_TRIANGLES, Range->Index_Count, Mesh->Index_Type, Offset, Instance_Count);
+      }
+      else
+      {
+         glDrawElements(GL_TRIANGLES, Range->Index_Count, Mesh->Index_Type, Offset);
+      }
+   }
+   else
+   {
+      if(Instance_Count > 1)
+      {
+         glDrawArraysInstanced(GL_TRIANGLES, 0, Mesh->Vertex_Count, Instance_Count);
+      }
+      else
+      {
+         glDrawArrays(GL_TRIANGLES, 0, Mesh->Vertex_Count);
+      }
+   }
+}
+
+static void Draw_Opengl_Indirect_Batch(opengl_context *GL, opengl_indirect_batch *Batch)
+{
+   // NOTE: Uploading with glBufferData orphans last frame's storage, so this
+   // never waits on draws still reading it.
+   Bind_Opengl_Buffer(GL_ARRAY_BUFFER, Batch->Instance_Buffer);
+   glBufferData(GL_ARRAY_BUFFER, Batch->Count*sizeof(opengl_instance), Batch->Instances, GL_STREAM_DRAW);
+
+   if(GL->Capabilities.Has_Multi_Draw_Indirect && !Batch->Force_Cpu_Loop)
+   {
+      Bind_Opengl_Buffer(GL_DRAW_INDIRECT_BUFFER, Batch->Command_Buffer);
+      glBufferData(GL_DRAW_INDIRECT_BUFFER, Batch->Count*sizeof(opengl_draw_command), Batch->Commands, GL_STREAM_DRAW);
+
+      glMultiDrawElementsIndirect(GL_TRIANGLES, Batch->Pool->Index_Type, 0, Batch->Count, 0);
+      GL->Stats.Draw_Calls++;
+   }
+   else
+   {
+      for(u32 Index = 0; Index < Batch->Count; ++Index)
+      {
+         opengl_draw_command *Command = Batch->Commands + Index;
+         GLvoid *Offset = (GLvoid *)((size)Command->First_Index*Batch->Pool->Index_Size);
+
+         Bind_Opengl_Vertex_Layout(&Opengl_Instance_Layout, Batch->Instance_Buffer, (size)Command->Base_Instance*sizeof(opengl_instance));
+         glDrawElementsBaseVertex(GL_TRIANGLES, Command->Index_Count, Batch->Pool->Index_Type, Offset, Command->Base_Vertex);
+      }
+      GL->Stats.Draw_Calls += Batch->Count;
+
+      // NOTE: Put the instance attributes back where the indirect path
+      // expects them.
+      if(GL->Capabilities.Has_Multi_Draw_Indirect)
+      {
+         Bind_Opengl_Vertex_Layout(&Opengl_Instance_Layout, Batch->Instance_Buffer, 0);
+      }
+   }
+   GL->Stats.Instances += Batch->Count;
+}
+
+static void Write_Object_Uniforms(opengl_object_uniforms *Uniforms, opengl_instance *Instance)
+{
+   opengl_object_uniforms Result = {0};
+   Result.Basis[0] = Instance->Basis_X.X;
+   Result.Basis[1] = Instance->Basis_X.Y;
+   Result.Basis[2] = Instance->Basis_Y.X;
+   Result.Basis[3] = Instance->Basis_Y.Y;
+   Result.Color[0] = Instance->Color.R;
+   Result.Color[1] = Instance->Color.G;
+   Result.Color[2] = Instance->Color.B;
+   Result.Color[3] = Instance->Color.A;
+   Result.Offset[0] = Instance->Offset.X;
+   Result.Offset[1] = Instance->Offset.Y;
+   Result.Material = Instance->Material;
+
+   // NOTE: Written whole, since the stream may be write-combined memory.
+   *Uniforms = Result;
+}
+
+typedef struct {
+   size First_Range; // NOTE: Buffer offset of the first range.
+   u8 *Range; // NOTE: The range being filled.
+   u32 Count;
+   bool Full;
+} opengl_object_upload;
+
+static u32 Push_Object_Uniforms(opengl_context *GL, opengl_object_upload *Upload, opengl_instance *Instances, u32 Count)
+{
+   // NOTE: Objects are numbered in upload order. Ranges are pushed back to
+   // back with nothing in between, so object N always lives in range
+   // N / OPENGL_OBJECT_UNIFORMS_PER_RANGE counted from First_Range.
+   u32 Result = Upload->Count;
+   for(u32 Index = 0; !Upload->Full && Index < Count; ++Index)
+   {
+      u32 Slot = Upload->Count % OPENGL_OBJECT_UNIFORMS_PER_RANGE;
+      if(Slot == 0)
+      {
+         size Offset = 0;
+         Upload->Range = Push_Opengl_Stream(&GL->Uniform_Stream, GL->Object_Range_Stride, GL->Capabilities.Uniform_Buffer_Alignment, &Offset);
+         if(Upload->Count == 0)
+         {
+            Upload->First_Range = Offset;
+         }
+         Upload->Full = (Upload->Range == 0);
+      }
+
+      if(Upload->Range)
+      {
+         Write_Object_Uniforms((opengl_object_uniforms *)Upload->Range + Slot, Instances + Index);
+         Upload->Count++;
+      }
+   }
+
+   if(Upload->Full)
+   {
+      Result = OPENGL_NO_OBJECT_UNIFORMS;
+   }
+   return(Result);
+}
+
+// NOTE: Runs over the sorted commands before any of them execute and writes
+// every uniform block the frame needs, so the uniform stream can be unmapped
+// before the first draw reads from it. The stream is grown first if the frame
+// wouldn't fit. Returns false if the frame and pass blocks didn't fit, in
+// which case nothing can be drawn; objects that don't fit are marked
+// OPENGL_NO_OBJECT_UNIFORMS and skipped.
+static bool Upload_Opengl_Uniforms(opengl_context *GL, render_sort_entry *Entries, u32 Count, size *Camera_Offset, size *Pass_Offsets, size *First_Object_Range)
+{
+   opengl_stream_buffer *Stream = &GL->Uniform_Stream;
+   size Alignment = GL->Capabilities.Uniform_Buffer_Alignment;
+
+   u64 Object_Count = 0;
+   for(u32 Entry_Index = 0; Entry_Index < Count; ++Entry_Index)
+   {
+      render_command *Command = Entries[Entry_Index].Command;
+      opengl_program *Program = GL->Shaders.Programs + Command->Material.Program;
+      if(Command->Type == Render_Command_Draw_Mesh && Program->Uses_Object_Uniforms)
+      {
+         Object_Count++;
+      }
+      else if(Command->Type == Render_Command_Draw_Instances && Command->Draw_Instances.Batch->Draw_Naive)
+      {
+         Object_Count += Command->Draw_Instances.Batch->Count;
+      }
+   }
+
+   // NOTE: Each block is padded out to at most one alignment's worth.
+   u64 Range_Count = (Object_Count + OPENGL_OBJECT_UNIFORMS_PER_RANGE - 1) / OPENGL_OBJECT_UNIFORMS_PER_RANGE;
+   u64 Needed = ((1 + Render_Pass_Count)*(sizeof(opengl_pass_uniforms) + Alignment) +
+                 Range_Count*GL->Object_Range_Stride + Alignment);
+   if(Needed > OPENGL_UNIFORM_MAX_PARTITION_SIZE)
+   {
+      Needed = OPENGL_UNIFORM_MAX_PARTITION_SIZE;
+   }
+   if(Needed > (u64)Stream->Partition_Size)
+   {
+      Grow_Opengl_Stream(Stream, &GL->Capabilities, (size)Needed);
+   }
+
+   opengl_camera_uniforms *Camera = Push_Opengl_Stream(Stream, sizeof(opengl_camera_uniforms), Alignment, Camera_Offset);
+   bool Result = (Camera != 0);
+   if(Camera)
+   {
+      opengl_camera_uniforms Camera_Uniforms = {{GL->Camera_Scale.X, GL->Camera_Scale.Y, GL->Camera_Offset.X, GL->Camera_Offset.Y}};
+      *Camera = Camera_Uniforms;
+      GL->Stats.Uniform_Blocks++;
+   }
+
+   for(u32 Pass = 0; Result && Pass < Render_Pass_Count; ++Pass)
+   {
+      opengl_pass_uniforms *Uniforms = Push_Opengl_Stream(Stream, sizeof(opengl_pass_uniforms), Alignment, Pass_Offsets + Pass);
+      Result = (Uniforms != 0);
+      if(Uniforms)
+      {
+         // NOTE: The overlay is drawn in clip space, on top of the camera.
+         opengl_pass_uniforms Pass_Uniforms = {0};
+         Pass_Uniforms.Tint[0] = Pass_Uniforms.Tint[1] = Pass_Uniforms.Tint[2] = Pass_Uniforms.Tint[3] = 1.0f;
+         Pass_Uniforms.Uses_Camera = (Pass != Render_Pass_Overlay);
+         *Uniforms = Pass_Uniforms;
+         GL->Stats.Uniform_Blocks++;
+      }
+   }
+
+   opengl_object_upload Upload = {0};
+   for(u32 Entry_Index = 0; Result && Entry_Index < Count; ++Entry_Index)
+   {
+      render_command *Command = Entries[Entry_Index].Command;
+      opengl_program *Program = GL->Shaders.Programs + Command->Material.Program;
+      if(Command->Type == Render_Command_Draw_Mesh)
+      {
+         Command->Draw_Mesh.Uniform_Object = ((Program->Uses_Object_Uniforms) ?
+                                              Push_Object_Uniforms(GL, &Upload, &Command->Draw_Mesh.Instance, 1) :
+                                              OPENGL_NO_OBJECT_UNIFORMS);
+      }
+      else if(Command->Type == Render_Command_Draw_Instances)
+      {
+         opengl_instance_batch *Batch = Command->Draw_Instances.Batch;
+         Command->Draw_Instances.Uniform_Object = ((Batch->Draw_Naive) ?
+                                                   Push_Object_Uniforms(GL, &Upload, Batch->Instances, Batch->Count) :
+                                                   OPENGL_NO_OBJECT_UNIFORMS);
+      }
+   }
+   *First_Object_Range = Upload.First_Range;
+   GL->Stats.Uniform_Blocks += Upload.Count;
+
+   End_Opengl_Stream(Stream);
+
+   return(Result);
+}
+
+static void Select_Object_Uniforms(opengl_context *GL, opengl_program *Program, size First_Range, u32 Object)
+{
+   // NOTE: The range bind is elided for all but the first object in each.
+   u32 Range = Object / OPENGL_OBJECT_UNIFORMS_PER_RANGE;
+   size Range_Size = OPENGL_OBJECT_UNIFORMS_PER_RANGE*sizeof(opengl_object_uniforms);
+   Bind_Opengl_Uniform_Range(Uniform_Block_Object, GL->Uniform_Stream.Buffer, First_Range + Range*GL->Object_Range_Stride, Range_Size);
+   glUniform1ui(Program->Object_Index_Location, Object % OPENGL_OBJECT_UNIFORMS_PER_RANGE);
+}
+
+static void Apply_Render_Pass_State(u32 Pass)
+{
+   // NOTE: Fixed function state is a property of the pass rather than of each
+   // material for now. The scene is opaque 2D geometry in submission order, and
+   // the overlay is alpha blended on top of it.
+   switch(Pass)
+   {
+      case Render_Pass_Scene:
+      {
+         Set_Opengl_Blend(false, GL_ONE, GL_ZERO);
+      } break;
+
+      case Render_Pass_Overlay:
+      {
+         Set_Opengl_Blend(true, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+      } break;
+   }
+   Set_Opengl_Depth(false, false, GL_LESS);
+   Set_Opengl_Cull(false, GL_BACK);
+}
+
+// NOTE: Recording is over by the time a backend executes, so the chunks still
+// open can be retired and every chunk's entries gathered into one array,
+// pushed onto Arena and sorted. Both can be done more than once per frame.
+static render_sort_entry *Sort_Render_Commands(render_command_list *List, arena *Arena, u32 *Count, u32 *Dropped)
+{
+   u32 Overflow_Count = 0;
+   for(u32 Index = 0; Index < List->Thread_Count; ++Index)
+   {
+      Retire_Render_Command_Chunk(List, List->Threads + Index);
+      Overflow_Count += List->Threads[Index].Overflow_Count;
+   }
+
+   u32 Chunk_Count = atomic_load_explicit(&List->Next_Chunk, memory_order_relaxed);
+   if(Chunk_Count > OPENGL_RENDER_COMMAND_MAX_CHUNKS)
+   {
+      Chunk_Count = OPENGL_RENDER_COMMAND_MAX_CHUNKS;
+   }
+
+   u32 Entry_Count = 0;
+   for(u32 Chunk = 0; Chunk < Chunk_Count; ++Chunk)
+   {
+      Entry_Count += List->Chunk_Counts[Chunk];
+   }
+
+   // NOTE: Commands the frame arena can't cover are dropped here rather than
+   // overflowing it. Growing leaves room for everything it hands out, so this
+   // only catches frame arena pushed elsewhere during the frame.
+   size Free = Arena->Size - Arena->Used;
+   size Reserve = OPENGL_RENDER_COMMAND_FRAME_RESERVE + 64; // NOTE: Worst case alignment.
+   u64 Capacity = (Free > Reserve) ? (Free - Reserve) / OPENGL_RENDER_COMMAND_FRAME_COST : 0;
+   if(Entry_Count > Capacity)
+   {
+      Overflow_Count += Entry_Count - (u32)Capacity;
+      Entry_Count = (u32)Capacity;
+   }
+
+   render_sort_entry *Result = 0;
+   if(Entry_Count > 0)
+   {
+      Result = Push_Array(Arena, Entry_Count, render_sort_entry);
+      render_sort_entry *Scratch = Push_Array(Arena, Entry_Count, render_sort_entry);
+
+      render_sort_entry *Merged = Result;
+      u32 Remaining = Entry_Count;
+      for(u32 Chunk = 0; Remaining > 0 && Chunk < Chunk_Count; ++Chunk)
+      {
+         u32 Chunk_Size = List->Chunk_Counts[Chunk];
+         if(Chunk_Size > Remaining) Chunk_Size = Remaining;
+         memcpy(Merged, List->Chunks[Chunk].Entries, Chunk_Size*sizeof(render_sort_entry));
+         Merged += Chunk_Size;
+         Remaining -= Chunk_Size;
+      }
+
+      Radix_Sort_Render_Entries(&Result, Scratch, Entry_Count);
+   }
+
+   *Count = Entry_Count;
+   *Dropped = Overflow_Count;
+   return(Result);
+}
+
+// NOTE: Ends the vertex stream and queues its draw, which goes in one go on
+// top of the scene. Only the first call in a frame does anything.
+static void End_Render_Recording(opengl_context *GL)
+{
+   if(GL->Vertex_Stream.Mapped)
+   {
+      End_Opengl_Stream(&GL->Vertex_Stream);
+      if(GL->Stream_Vertex_Count > 0)
+      {
+         opengl_material Material = {0};
+         Material.Program = GL->Basic_Program;
+
+         u64 Key = Make_Render_Key(Render_Pass_Overlay, Material, 0.0f);
+         render_command *Command = Push_Render_Command(GL, Render_Command_Draw_Stream, Key);
+         if(Command)
+         {
+            Command->Material = Material;
+            Command->Draw_Stream.Vertex_Base = GL->Stream_Vertex_Base;
+            Command->Draw_Stream.Vertex_Count = GL->Stream_Vertex_Count;
+         }
+      }
+   }
+
+   opengl_text *Text = &GL->Text;
+   if(Text->Stream.Mapped)
+   {
+      End_Opengl_Stream(&Text->Stream);
+      Flush_Opengl_Text_Atlas(GL);
+      if(Text->Glyph_Count > 0)
+      {
+         opengl_material Material = {0};
+         Material.Program = GL->Text_Program;
+         Material.Texture = Text->Atlas;
+
+         u64 Key = Make_Render_Key(Render_Pass_Overlay, Material, 0.0f);
+         render_command *Command = Push_Render_Command(GL, Render_Command_Draw_Text, Key);
+         if(Command)
+         {
+            Command->Material = Material;
+            Command->Draw_Text.Glyph_Base = Text->Glyph_Base;
+            Command->Draw_Text.Glyph_Count = Text->Glyph_Count;
+         }
+      }
+   }
+}
+
+// NOTE: What the render passes of one frame execute from, once the commands
+// are sorted, culled against damage and have their uniforms uploaded. Entries
+// are sorted by pass first, so each pass is a contiguous range of them.
+typedef struct {
+   opengl_context *GL;
+   render_sort_entry *Entries;
+   opengl_damage_box *Boxes;
+   u32 Pass_First[Render_Pass_Count + 1];
+
+   bool Scissored;
+   opengl_damage_box Scissor_Box;
+
+   size Pass_Offsets[Render_Pass_Count];
+   size First_Object_Range;
+} render_command_frame;
+
+static void Execute_Render_Pass(render_command_frame *Frame, render_pass Pass)
+{
+   opengl_context *GL = Frame->GL;
+   render_sort_entry *Entries = Frame->Entries;
+   GLuint Uniform_Buffer = GL->Uniform_Stream.Buffer;
+
+   // NOTE: State goes through the shadow state cache, so the executor can ask
+   // for what each command needs without checking what's already bound.
+   opengl_program *Current_Program = 0;
+   bool Pass_Applied = false;
+
+   // NOTE: The scissor is left alone unless damage tracking is on.
+   opengl_damage *Damage = &GL->Damage;
+   if(Damage->Enabled)
+   {
+      opengl_rect *Scissor = &Damage->Scissor;
+      Set_Opengl_Scissor(Frame->Scissored, Scissor->X, Scissor->Y, Scissor->Width, Scissor->Height);
+   }
+
+   for(u32 Entry_Index = Frame->Pass_First[Pass]; Entry_Index < Frame->Pass_First[Pass + 1]; ++Entry_Index)
+   {
+      render_sort_entry *Entry = Entries + Entry_Index;
+      render_command *Command = Entry->Command;
+
+      if(Frame->Scissored && Command->Type != Render_Command_Viewport &&
+         !Opengl_Damage_Boxes_Overlap(Frame->Boxes[Entry_Index], Frame->Scissor_Box))
+      {
+         GL->Stats.Commands_Skipped++;
+         continue;
+      }
+
+      if(!Pass_Applied)
+      {
+         Apply_Render_Pass_State(Pass);
+         Bind_Opengl_Uniform_Range(Uniform_Block_Pass, Uniform_Buffer, Frame->Pass_Offsets[Pass], sizeof(opengl_pass_uniforms));
+         Pass_Applied = true;
+      }
+
+      GLuint VAO = 0;
+      switch(Command->Type)
+      {
+         case Render_Command_Clear: break;
+         case Render_Command_Viewport: break;
+         case Render_Command_Draw_Mesh: VAO = Command->Draw_Mesh.Mesh->VAO; break;
+         case Render_Command_Draw_Instances: VAO = Command->Draw_Instances.Batch->VAO; break;
+         case Render_Command_Draw_Indirect: VAO = (Command->Draw_Indirect.Batch->Count > 0) ? Command->Draw_Indirect.Batch->VAO : 0; break;
+         case Render_Command_Draw_Stream: VAO = GL->Stream_VAO; break;
+         case Render_Command_Draw_Text: VAO = GL->Text.VAO; break;
+      }
+
+      if(VAO)
+      {
+         Current_Program = GL->Shaders.Programs + Command->Material.Program;
+         Use_Opengl_Program(Current_Program->Program);
+         Bind_Opengl_Texture(0, GL_TEXTURE_2D_ARRAY, Command->Material.Texture);
+         Bind_Opengl_Vertex_Array(VAO);
+      }
+
+      switch(Command->Type)
+      {
+         case Render_Command_Clear:
+         {
+            Set_Opengl_Clear_Color(Command->Clear.Color);
+            glClear(GL_COLOR_BUFFER_BIT);
+         } break;
+
+         case Render_Command_Viewport:
+         {
+            render_command_viewport *Viewport = &Command->Viewport;
+            Set_Opengl_Viewport(Viewport->X, Viewport->Y, Viewport->Width, Viewport->Height);
+         } break;
+
+         case Render_Command_Draw_Mesh:
+         {
+            // NOTE: A draw whose block didn't fit in the uniform stream is
+            // dropped rather than drawn with another object's uniforms.
+            u32 Object = Command->Draw_Mesh.Uniform_Object;
+            if(!Current_Program->Uses_Object_Uniforms || Object != OPENGL_NO_OBJECT_UNIFORMS)
+            {
+               if(Current_Program->Uses_Object_Uniforms)
+               {
+                  Select_Object_Uniforms(GL, Current_Program, Frame->First_Object_Range, Object);
+               }
+               Draw_Opengl_Mesh(Command->Draw_Mesh.Mesh, Command->Draw_Mesh.Lod, 1);
+
+               GL->Stats.Draw_Calls++;
+               GL->Stats.Instances++;
+            }
+            else
+            {
+               GL->Stats.Commands_Dropped++;
+            }
+         } break;
+
+         case Render_Command_Draw_Instances:
+         {
+            opengl_instance_batch *Batch = Command->Draw_Instances.Batch;
+            if(!Batch->Draw_Naive)
+            {
+               Draw_Opengl_Mesh(Batch->Mesh, 0, Batch->Count);
+               GL->Stats.Draw_Calls++;
+               GL->Stats.Instances += Batch->Count;
+            }
+            else if(Command->Draw_Instances.Uniform_Object != OPENGL_NO_OBJECT_UNIFORMS)
+            {
+               u32 First_Object = Command->Draw_Instances.Uniform_Object;
+               for(u32 Index = 0; Index < Batch->Count; ++Index)
+               {
+                  Select_Object_Uniforms(GL, Current_Program, Frame->First_Object_Range, First_Object + Index);
+                  Draw_Opengl_Mesh(Batch->Mesh, 0, 1);
+               }
+               GL->Stats.Draw_Calls += Batch->Count;
+               GL->Stats.Instances += Batch->Count;
+            }
+            else
+            {
+               GL->Stats.Commands_Dropped++;
+            }
+         } break;
+
+         case Render_Command_Draw_Indirect:
+         {
+            if(Command->Draw_Indirect.Batch->Count > 0)
+            {
+               Draw_Opengl_Indirect_Batch(GL, Command->Draw_Indirect.Batch);
+            }
+         } break;
+
+         case Render_Command_Draw_Stream:
+         {
+            // NOTE: The stream VAO's attribute offsets move with the stream
+            // partition, so they are respecified for every stream draw.
+            size Base = Command->Draw_Stream.Vertex_Base;
+            Bind_Opengl_Vertex_Layout(Opengl_Vertex_Layouts + Mesh_Vertex_Format_Standard, GL->Vertex_Stream.Buffer, Base);
+
+            glDrawArrays(GL_TRIANGLES, 0, Command->Draw_Stream.Vertex_Count);
+            GL->Stats.Draw_Calls++;
+         } break;
+
+         case Render_Command_Draw_Text:
+         {
+            // NOTE: Glyphs are positioned in pixels, so the program is told
+            // the size of the viewport they're drawn into.
+            size Base = Command->Draw_Text.Glyph_Base;
+            Bind_Opengl_Vertex_Layout(&Opengl_Text_Layout, GL->Text.Stream.Buffer, Base);
+
+            GLint *Viewport = Opengl_State.Viewport;
+            if(Viewport[2] > 0 && Viewport[3] > 0)
+            {
+               glUniform2f(Current_Program->Pixel_Scale_Location, 2.0f / (float)Viewport[2], 2.0f / (float)Viewport[3]);
+               glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, Command->Draw_Text.Glyph_Count);
+               GL->Stats.Draw_Calls++;
+            }
+         } break;
+      }
+   }
+
+   if(Frame->Scissored)
+   {
+      Set_Opengl_Scissor(false, 0, 0, 0, 0);
+   }
+}
+
+static OPENGL_GRAPH_PASS(Execute_Scene_Pass)
+{
+   Execute_Render_Pass((render_command_frame *)Data, Render_Pass_Scene);
+}
+
+static OPENGL_GRAPH_PASS(Execute_Overlay_Pass)
+{
+   Execute_Render_Pass((render_command_frame *)Data, Render_Pass_Overlay);
+}
+
+static void Execute_Render_Commands(opengl_context *GL)
+{
+   arena *Frame = &GL->Memory->Frame;
+   temporary_memory Scratch_Memory = Begin_Temporary_Memory(Frame);
+
+   u32 Count = 0;
+   u32 Dropped = 0;
+   render_sort_entry *Entries = Sort_Render_Commands(&GL->Commands, Frame, &Count, &Dropped);
+   GL->Stats.Commands_Submitted = Count;
+   GL->Stats.Commands_Dropped += Dropped;
+
+   // NOTE: Damage is worked out before anything is drawn, so that commands
+   // entirely outside the scissor can be skipped. A frame that changed
+   // nothing skips them all. Damage only sees render commands, so a graph
+   // with passes of its own is redrawn in full.
+   opengl_damage *Damage = &GL->Damage;
+   opengl_graph *Graph = &GL->Graph;
+   opengl_damage_box *Boxes = 0;
+   opengl_damage_box Scissor_Box = {0};
+   if(Damage->Enabled)
+   {
+      if(Graph->Pass_Count > 1 || Graph->Passes[Graph->Scene_Pass].Target != OPENGL_GRAPH_BACKBUFFER)
+      {
+         Damage->Reset = true;
+      }
+
+      Boxes = Track_Opengl_Damage(GL, Entries, Count, Frame);
+      if(!Damage->Full && Damage->Rect_Count == 0)
+      {
+         GL->Stats.Commands_Skipped = Count;
+         Count = 0;
+      }
+
+      opengl_rect *Scissor = &Damage->Scissor;
+      Scissor_Box = (opengl_damage_box){Scissor->X, Scissor->Y, Scissor->X + Scissor->Width, Scissor->Y + Scissor->Height};
+   }
+
+   // NOTE: Without commands to draw the scene and overlay passes are empty,
+   // but the graph still runs, since its other passes (and the transients they
+   // keep alive) don't depend on there being any.
+   size Camera_Offset = 0;
+   render_command_frame Commands = {0};
+   if(Count == 0)
+   {
+      End_Opengl_Stream(&GL->Uniform_Stream);
+   }
+   else if(Upload_Opengl_Uniforms(GL, Entries, Count, &Camera_Offset, Commands.Pass_Offsets, &Commands.First_Object_Range))
+   {
+      Bind_Opengl_Uniform_Range(Uniform_Block_Camera, GL->Uniform_Stream.Buffer, Camera_Offset, sizeof(opengl_camera_uniforms));
+   }
+   else
+   {
+      fprintf(stderr, "Uniform stream is full, dropping the frame's commands.\n");
+      GL->Stats.Commands_Dropped += Count;
+      Damage->Reset = true;
+      Count = 0;
+   }
+
+   Commands.GL = GL;
+   Commands.Entries = Entries;
+   Commands.Boxes = Boxes;
+   Commands.Scissored = (Damage->Enabled && !Damage->Full);
+   Commands.Scissor_Box = Scissor_Box;
+
+   u32 Entry_Index = 0;
+   for(u32 Pass = 0; Pass <= Render_Pass_Count; ++Pass)
+   {
+      while(Entry_Index < Count && ((Entries[Entry_Index].Key >> RENDER_KEY_PASS_SHIFT) & RENDER_KEY_PASS_MASK) < Pass)
+      {
+         Entry_Index++;
+      }
+      Commands.Pass_First[Pass] = Entry_Index;
+   }
+
+   Graph->Passes[Graph->Scene_Pass].Data = &Commands;
+   Add_Opengl_Graph_Pass(GL, "overlay", OPENGL_GRAPH_BACKBUFFER, Execute_Overlay_Pass, &Commands);
+   Compile_Opengl_Graph(GL);
+   Execute_Opengl_Graph(GL);
+
+   End_Temporary_Memory(Scratch_Memory);
+}
@@ -0,0 +1,308 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Frustum culling. Everything here runs on the CPU; the only tie to GL
+// is that the results go to the renderer's frame stats and profiler, which is
+// also why culling is done from the main thread.
+
+static aabb_array Push_Cull_Boxes(arena *Arena, u32 Count)
+{
+   aabb_array Result;
+   Result.Center.X = Push_Array(Arena, Count, float);
+   Result.Center.Y = Push_Array(Arena, Count, float);
+   Result.Center.Z = Push_Array(Arena, Count, float);
+   Result.Extent.X = Push_Array(Arena, Count, float);
+   Result.Extent.Y = Push_Array(Arena, Count, float);
+   Result.Extent.Z = Push_Array(Arena, Count, float);
+   return(Result);
+}
+
+static void Initialize_Opengl_Cull_Set(opengl_cull_set *Set, arena *Arena, u32 Capacity, cull_mode Mode)
+{
+   opengl_cull_set Zero = {0};
+   *Set = Zero;
+   Set->Mode = Mode;
+   Set->Capacity = Capacity;
+
+   if(Mode == Cull_Mode_Spheres)
+   {
+      Set->Spheres.X = Push_Array(Arena, Capacity, float);
+      Set->Spheres.Y = Push_Array(Arena, Capacity, float);
+      Set->Spheres.Z = Push_Array(Arena, Capacity, float);
+      Set->Spheres.Radius = Push_Array(Arena, Capacity, float);
+   }
+   else
+   {
+      Set->Boxes = Push_Cull_Boxes(Arena, Capacity);
+   }
+
+   if(Mode == Cull_Mode_Bvh)
+   {
+      Set->Bvh_Boxes = Push_Cull_Boxes(Arena, Capacity);
+      Set->Bvh_Objects = Push_Array(Arena, Capacity, u32);
+      Set->Nodes = Push_Array(Arena, 2*Capacity, opengl_bvh_node);
+   }
+
+   Set->Visible = Push_Array(Arena, Capacity, u32);
+}
+
+// NOTE: Returns the object's index, which is what shows up in the visible
+// list. Sphere sets bound the box with its circumscribed sphere.
+static u32 Add_Opengl_Cull_Object(opengl_cull_set *Set, vec3 Center, vec3 Extent)
+{
+   Assert(Set->Count < Set->Capacity);
+   u32 Result = Set->Count++;
+
+   if(Set->Mode == Cull_Mode_Spheres)
+   {
+      Set->Spheres.X[Result] = Center.X;
+      Set->Spheres.Y[Result] = Center.Y;
+      Set->Spheres.Z[Result] = Center.Z;
+      Set->Spheres.Radius[Result] = sqrtf(Extent.X*Extent.X + Extent.Y*Extent.Y + Extent.Z*Extent.Z);
+   }
+   else
+   {
+      Set->Boxes.Center.X[Result] = Center.X;
+      Set->Boxes.Center.Y[Result] = Center.Y;
+      Set->Boxes.Center.Z[Result] = Center.Z;
+      Set->Boxes.Extent.X[Result] = Extent.X;
+      Set->Boxes.Extent.Y[Result] = Extent.Y;
+      Set->Boxes.Extent.Z[Result] = Extent.Z;
+   }
+   Set->Bvh_Built = false;
+
+   return(Result);
+}
+
+static void Clear_Opengl_Cull_Set(opengl_cull_set *Set)
+{
+   Set->Count = 0;
+   Set->Visible_Count = 0;
+   Set->Bvh_Built = false;
+}
+
+static float Get_Vec3_Axis(vec3 V, int Axis)
+{
+   float Result = (Axis == 0) ? V.X : (Axis == 1) ? V.Y : V.Z;
+   return(Result);
+}
+
+static void Build_Opengl_Bvh_Node(opengl_cull_set *Set, u32 Node_Index, u32 First, u32 Count, u32 Depth)
+{
+   aabb_array Boxes = Set->Boxes;
+   u32 *Objects = Set->Bvh_Objects;
+
+   vec3 Min = {INFINITY, INFINITY, INFINITY};
+   vec3 Max = {-INFINITY, -INFINITY, -INFINITY};
+   vec3 Centroid_Min = Min;
+   vec3 Centroid_Max = Max;
+   for(u32 Index = First; Index < First + Count; ++Index)
+   {
+      u32 Object = Objects[Index];
+      vec3 Center = {Boxes.Center.X[Object], Boxes.Center.Y[Object], Boxes.Center.Z[Object]};
+      vec3 Extent = {Boxes.Extent.X[Object], Boxes.Extent.Y[Object], Boxes.Extent.Z[Object]};
+
+      Min.X = fminf(Min.X, Center.X - Extent.X);
+      Min.Y = fminf(Min.Y, Center.Y - Extent.Y);
+      Min.Z = fminf(Min.Z, Center.Z - Extent.Z);
+      Max.X = fmaxf(Max.X, Center.X + Extent.X);
+      Max.Y = fmaxf(Max.Y, Center.Y + Extent.Y);
+      Max.Z = fmaxf(Max.Z, Center.Z + Extent.Z);
+
+      Centroid_Min.X = fminf(Centroid_Min.X, Center.X);
+      Centroid_Min.Y = fminf(Centroid_Min.Y, Center.Y);
+      Centroid_Min.Z = fminf(Centroid_Min.Z, Center.Z);
+      Centroid_Max.X = fmaxf(Centroid_Max.X, Center.X);
+      Centroid_Max.Y = fmaxf(Centroid_Max.Y, Center.Y);
+      Centroid_Max.Z = fmaxf(Centroid_Max.Z, Center.Z);
+   }
+
+   opengl_bvh_node *Node = Set->Nodes + Node_Index;
+   Node->Center.X = 0.5f*(Min.X + Max.X);
+   Node->Center.Y = 0.5f*(Min.Y + Max.Y);
+   Node->Center.Z = 0.5f*(Min.Z + Max.Z);
+   Node->Extent.X = 0.5f*(Max.X - Min.X);
+   Node->Extent.Y = 0.5f*(Max.Y - Min.Y);
+   Node->Extent.Z = 0.5f*(Max.Z - Min.Z);
+
+   // NOTE: The traversal stack is only so deep, so a pathological set gets
+   // oversized leaves rather than a deeper tree.
+   if(Count <= OPENGL_CULL_BVH_LEAF_SIZE || Depth + 1 >= OPENGL_CULL_BVH_MAX_DEPTH)
+   {
+      Node->First = First;
+      Node->Count = Count;
+      return;
+   }
+
+   // NOTE: Split at the middle of the centroid bounds along their longest
+   // axis. That's a single partition pass per level, and good enough for
+   // frustum tests; it falls back to splitting the count in half when every
+   // centroid lands on one side.
+   vec3 Spread = {Centroid_Max.X - Centroid_Min.X, Centroid_Max.Y - Centroid_Min.Y, Centroid_Max.Z - Centroid_Min.Z};
+   int Axis = 0;
+   if(Spread.Y > Get_Vec3_Axis(Spread, Axis)) Axis = 1;
+   if(Spread.Z > Get_Vec3_Axis(Spread, Axis)) Axis = 2;
+
+   float *Centers = (Axis == 0) ? Boxes.Center.X : (Axis == 1) ? Boxes.Center.Y : Boxes.Center.Z;
+   float Split_Position = 0.5f*(Get_Vec3_Axis(Centroid_Min, Axis) + Get_Vec3_Axis(Centroid_Max, Axis));
+
+   u32 Split = First;
+   for(u32 Index = First; Index < First + Count; ++Index)
+   {
+      if(Centers[Objects[Index]] < Split_Position)
+      {
+         u32 Swap = Objects[Split];
+         Objects[Split] = Objects[Index];
+         Objects[Index] = Swap;
+         Split++;
+      }
+   }
+
+   u32 Left_Count = Split - First;
+   if(Left_Count == 0 || Left_Count == Count)
+   {
+      Left_Count = Count / 2;
+   }
+
+   u32 Left = Set->Node_Count;
+   Set->Node_Count += 2;
+   Node->First = Left;
+   Node->Count = 0;
+
+   Build_Opengl_Bvh_Node(Set, Left, First, Left_Count, Depth + 1);
+   Build_Opengl_Bvh_Node(Set, Left + 1, First + Left_Count, Count - Left_Count, Depth + 1);
+}
+
+static void Build_Opengl_Cull_Bvh(opengl_cull_set *Set)
+{
+   Assert(Set->Mode == Cull_Mode_Bvh);
+
+   for(u32 Index = 0; Index < Set->Count; ++Index)
+   {
+      Set->Bvh_Objects[Index] = Index;
+   }
+
+   Set->Node_Count = 1;
+   if(Set->Count > 0)
+   {
+      Build_Opengl_Bvh_Node(Set, 0, 0, Set->Count, 0);
+   }
+   else
+   {
+      opengl_bvh_node Empty = {0};
+      Set->Nodes[0] = Empty;
+   }
+
+   // NOTE: Leaves are tested straight out of the reordered copy, so each one
+   // is a plain contiguous run for the SIMD kernel.
+   for(u32 Index = 0; Index < Set->Count; ++Index)
+   {
+      u32 Object = Set->Bvh_Objects[Index];
+      Set->Bvh_Boxes.Center.X[Index] = Set->Boxes.Center.X[Object];
+      Set->Bvh_Boxes.Center.Y[Index] = Set->Boxes.Center.Y[Object];
+      Set->Bvh_Boxes.Center.Z[Index] = Set->Boxes.Center.Z[Object];
+      Set->Bvh_Boxes.Extent.X[Index] = Set->Boxes.Extent.X[Object];
+      Set->Bvh_Boxes.Extent.Y[Index] = Set->Boxes.Extent.Y[Object];
+      Set->Bvh_Boxes.Extent.Z[Index] = Set->Boxes.Extent.Z[Object];
+   }
+
+   Set->Bvh_Built = true;
+}
+
+static u32 Cull_Opengl_Bvh(opengl_cull_set *Set, frustum *Frustum, u32 *Nodes_Visited)
+{
+   u32 Visible_Count = 0;
+
+   u32 Stack[OPENGL_CULL_BVH_MAX_DEPTH + 1];
+   u32 Stack_Count = 0;
+   if(Set->Count > 0)
+   {
+      Stack[Stack_Count++] = 0;
+   }
+
+   while(Stack_Count > 0)
+   {
+      opengl_bvh_node *Node = Set->Nodes + Stack[--Stack_Count];
+      (*Nodes_Visited)++;
+
+      frustum_test Test = Test_Frustum_Aabb(Frustum, Node->Center, Node->Extent);
+      if(Test == Frustum_Outside)
+      {
+         continue;
+      }
+
+      if(Node->Count == 0)
+      {
+         Stack[Stack_Count++] = Node->First + 1;
+         Stack[Stack_Count++] = Node->First;
+      }
+      else if(Test == Frustum_Inside)
+      {
+         for(u32 Index = Node->First; Index < Node->First + Node->Count; ++Index)
+         {
+            Set->Visible[Visible_Count++] = Set->Bvh_Objects[Index];
+         }
+      }
+      else
+      {
+         aabb_array Leaf = Set->Bvh_Boxes;
+         Leaf.Center.X += Node->First;
+         Leaf.Center.Y += Node->First;
+         Leaf.Center.Z += Node->First;
+         Leaf.Extent.X += Node->First;
+         Leaf.Extent.Y += Node->First;
+         Leaf.Extent.Z += Node->First;
+
+         u32 *Visible = Set->Visible + Visible_Count;
+         u32 Count = Frustum_Cull_Aabbs(Frustum, Leaf, Visible, Node->Count);
+         for(u32 Index = 0; Index < Count; ++Index)
+         {
+            Visible[Index] = Set->Bvh_Objects[Node->First + Visible[Index]];
+         }
+         Visible_Count += Count;
+      }
+   }
+
+   return(Visible_Count);
+}
+
+// NOTE: Fills Set->Visible with the indices of the objects that may be in
+// the frustum and returns how many there are. Sphere and box sets list them
+// in index order; BVH sets list them in tree order.
+static u32 Cull_Opengl_Objects(opengl_context *GL, opengl_cull_set *Set, frustum *Frustum)
+{
+   Assert(Get_Thread_Index() == 0);
+   PROFILE_BEGIN_CPU(&GL->Profiler, "Cull");
+   u64 Start = Get_Clock();
+
+   u32 Nodes_Visited = 0;
+   switch(Set->Mode)
+   {
+      case Cull_Mode_Spheres: {
+         Set->Visible_Count = Frustum_Cull_Spheres(Frustum, Set->Spheres, Set->Visible, Set->Count);
+      } break;
+
+      case Cull_Mode_Aabbs: {
+         Set->Visible_Count = Frustum_Cull_Aabbs(Frustum, Set->Boxes, Set->Visible, Set->Count);
+      } break;
+
+      case Cull_Mode_Bvh: {
+         if(!Set->Bvh_Built)
+         {
+            Build_Opengl_Cull_Bvh(Set);
+         }
+         Set->Visible_Count = Cull_Opengl_Bvh(Set, Frustum, &Nodes_Visited);
+      } break;
+
+      default: {
+         Assert(0);
+      } break;
+   }
+
+   GL->Stats.Cull_Tested += Set->Count;
+   GL->Stats.Cull_Visible += Set->Visible_Count;
+   GL->Stats.Cull_Nodes_Visited += Nodes_Visited;
+   GL->Stats.Cull_Time += Get_Clock() - Start;
+
+   PROFILE_END_CPU(&GL->Profiler, "Cull");
+   return(Set->Visible_Count);
+}
@@ -0,0 +1,557 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Damage tracking (see opengl_damage in opengl_renderer.h). Everything
+// here runs on the CPU: the executor asks Track_Opengl_Damage for every
+// command's screen bounds before it draws, and only touches GL to scissor.
+
+#define OPENGL_DAMAGE_EMPTY_BOX ((opengl_damage_box){0, 0, 0, 0})
+
+static inline u64 Mix_Opengl_Damage_Hash(u64 Signature, u64 Hash)
+{
+   u64 Result = (Signature ^ Hash) * 0x100000001b3ull;
+   return(Result);
+}
+
+static inline bool Is_Opengl_Damage_Box_Empty(opengl_damage_box Box)
+{
+   bool Result = (Box.Max_X <= Box.Min_X || Box.Max_Y <= Box.Min_Y);
+   return(Result);
+}
+
+static opengl_damage_box Union_Opengl_Damage_Boxes(opengl_damage_box A, opengl_damage_box B)
+{
+   opengl_damage_box Result = A;
+   if(Is_Opengl_Damage_Box_Empty(A))
+   {
+      Result = B;
+   }
+   else if(!Is_Opengl_Damage_Box_Empty(B))
+   {
+      if(B.Min_X < Result.Min_X) Result.Min_X = B.Min_X;
+      if(B.Min_Y < Result.Min_Y) Result.Min_Y = B.Min_Y;
+      if(B.Max_X > Result.Max_X) Result.Max_X = B.Max_X;
+      if(B.Max_Y > Result.Max_Y) Result.Max_Y = B.Max_Y;
+   }
+   return(Result);
+}
+
+static bool Opengl_Damage_Boxes_Overlap(opengl_damage_box A, opengl_damage_box B)
+{
+   bool Result = (A.Min_X < B.Max_X && B.Min_X < A.Max_X &&
+                  A.Min_Y < B.Max_Y && B.Min_Y < A.Max_Y);
+   return(Result);
+}
+
+static opengl_damage_box Get_Opengl_Viewport_Box(opengl_damage *Damage, GLint *Viewport)
+{
+   opengl_damage_box Result = {Viewport[0], Viewport[1], Viewport[0] + Viewport[2], Viewport[1] + Viewport[3]};
+   if(Result.Min_X < 0) Result.Min_X = 0;
+   if(Result.Min_Y < 0) Result.Min_Y = 0;
+   if(Result.Max_X > Damage->Width) Result.Max_X = Damage->Width;
+   if(Result.Max_Y > Damage->Height) Result.Max_Y = Damage->Height;
+   return(Result);
+}
+
+// NOTE: Maps clip space bounds to the pixels they can touch through
+// Viewport. The box is padded by a pixel, which covers rasterization rules
+// and the rounding between here and the GPU. Bounds that aren't finite
+// (NaN fails every comparison) conservatively cover the whole viewport.
+static opengl_damage_box Get_Opengl_Damage_Box(opengl_damage *Damage, GLint *Viewport, vec2 Min, vec2 Max)
+{
+   opengl_damage_box Result = Get_Opengl_Viewport_Box(Damage, Viewport);
+   if(Min.X <= Max.X && Min.Y <= Max.Y)
+   {
+      float Half_Width = 0.5f*(float)Viewport[2];
+      float Half_Height = 0.5f*(float)Viewport[3];
+      float Min_X = (float)Viewport[0] + (Min.X + 1.0f)*Half_Width - 1.0f;
+      float Min_Y = (float)Viewport[1] + (Min.Y + 1.0f)*Half_Height - 1.0f;
+      float Max_X = (float)Viewport[0] + (Max.X + 1.0f)*Half_Width + 1.0f;
+      float Max_Y = (float)Viewport[1] + (Max.Y + 1.0f)*Half_Height + 1.0f;
+
+      if(Min_X > (float)Result.Min_X) Result.Min_X = (int)floorf(fminf(Min_X, (float)Result.Max_X));
+      if(Min_Y > (float)Result.Min_Y) Result.Min_Y = (int)floorf(fminf(Min_Y, (float)Result.Max_Y));
+      if(Max_X < (float)Result.Max_X) Result.Max_X = (int)ceilf(fmaxf(Max_X, (float)Result.Min_X));
+      if(Max_Y < (float)Result.Max_Y) Result.Max_Y = (int)ceilf(fmaxf(Max_Y, (float)Result.Min_Y));
+   }
+   return(Result);
+}
+
+// NOTE: The clip space bounds of a mesh's bounding rectangle after the
+// instance transform (when the program reads one) and the camera (when the
+// pass applies it), mirroring basic.vert.
+static void Get_Opengl_Instance_Bounds(opengl_context *GL, vec2 Bounds_Min, vec2 Bounds_Max, opengl_instance *Instance,
+                                       bool Uses_Camera, vec2 *Min, vec2 *Max)
+{
+   vec2 Corners[4] =
+      {
+         {Bounds_Min.X, Bounds_Min.Y},
+         {Bounds_Max.X, Bounds_Min.Y},
+         {Bounds_Min.X, Bounds_Max.Y},
+         {Bounds_Max.X, Bounds_Max.Y},
+      };
+
+   for(int Index = 0; Index < 4; ++Index)
+   {
+      vec2 Position = Corners[Index];
+      if(Instance)
+      {
+         Position = (vec2){Instance->Offset.X + Position.X*Instance->Basis_X.X + Position.Y*Instance->Basis_Y.X,
+                           Instance->Offset.Y + Position.X*Instance->Basis_X.Y + Position.Y*Instance->Basis_Y.Y};
+      }
+      if(Uses_Camera)
+      {
+         Position = (vec2){Position.X*GL->Camera_Scale.X + GL->Camera_Offset.X,
+                           Position.Y*GL->Camera_Scale.Y + GL->Camera_Offset.Y};
+      }
+
+      if(Index == 0)
+      {
+         *Min = *Max = Position;
+      }
+      else
+      {
+         Min->X = fminf(Min->X, Position.X);
+         Min->Y = fminf(Min->Y, Position.Y);
+         Max->X = fmaxf(Max->X, Position.X);
+         Max->Y = fmaxf(Max->Y, Position.Y);
+      }
+   }
+}
+
+static void Mix_Opengl_Damage_Tiles(opengl_damage *Damage, u64 *Signatures, opengl_damage_box Box, u64 Hash)
+{
+   if(!Is_Opengl_Damage_Box_Empty(Box))
+   {
+      int Tile_X0 = Box.Min_X / OPENGL_DAMAGE_TILE_SIZE;
+      int Tile_Y0 = Box.Min_Y / OPENGL_DAMAGE_TILE_SIZE;
+      int Tile_X1 = (Box.Max_X - 1) / OPENGL_DAMAGE_TILE_SIZE;
+      int Tile_Y1 = (Box.Max_Y - 1) / OPENGL_DAMAGE_TILE_SIZE;
+      for(int Tile_Y = Tile_Y0; Tile_Y <= Tile_Y1; ++Tile_Y)
+      {
+         u64 *Row = Signatures + Tile_Y*Damage->Tiles_X;
+         for(int Tile_X = Tile_X0; Tile_X <= Tile_X1; ++Tile_X)
+         {
+            Row[Tile_X] = Mix_Opengl_Damage_Hash(Row[Tile_X], Hash);
+         }
+      }
+   }
+}
+
+static void Reset_Opengl_Damage_Streams(opengl_damage *Damage)
+{
+   if(Damage->Enabled)
+   {
+      opengl_damage_stream *Streams[] = {&Damage->Vertex_Stream, &Damage->Text_Stream};
+      for(u32 Index = 0; Index < Array_Count(Streams); ++Index)
+      {
+         opengl_damage_stream *Stream = Streams[Index];
+         memset(Stream->Signatures, 0, (size)Damage->Tiles_X*Damage->Tiles_Y*sizeof(u64));
+         Stream->Hash = HASH_SEED;
+         Stream->Box = OPENGL_DAMAGE_EMPTY_BOX;
+      }
+   }
+}
+
+// NOTE: Streams are drawn in the overlay pass, without the camera, and their
+// viewport isn't known at push time, so the whole framebuffer is assumed
+// there and the draw falls back to the combined hash if that turns out wrong.
+static void Mix_Opengl_Damage_Stream(opengl_damage *Damage, opengl_damage_stream *Stream, opengl_damage_box Box, u64 Hash)
+{
+   Mix_Opengl_Damage_Tiles(Damage, Stream->Signatures, Box, Hash);
+   Stream->Hash = Mix_Opengl_Damage_Hash(Stream->Hash, Hash);
+   Stream->Box = Union_Opengl_Damage_Boxes(Stream->Box, Box);
+}
+
+// NOTE: Called for each primitive pushed into the vertex stream.
+static void Track_Opengl_Stream_Damage(opengl_context *GL, vertex *Vertices, u32 Count)
+{
+   opengl_damage *Damage = &GL->Damage;
+   if(Damage->Enabled && Count > 0)
+   {
+      vec2 Min = Vertices[0].Position;
+      vec2 Max = Vertices[0].Position;
+      for(u32 Index = 1; Index < Count; ++Index)
+      {
+         Min.X = fminf(Min.X, Vertices[Index].Position.X);
+         Min.Y = fminf(Min.Y, Vertices[Index].Position.Y);
+         Max.X = fmaxf(Max.X, Vertices[Index].Position.X);
+         Max.Y = fmaxf(Max.Y, Vertices[Index].Position.Y);
+      }
+
+      GLint Viewport[4] = {0, 0, Damage->Width, Damage->Height};
+      opengl_damage_box Box = Get_Opengl_Damage_Box(Damage, Viewport, Min, Max);
+      u64 Hash = Hash_Bytes(HASH_SEED, Vertices, Count*sizeof(vertex));
+      Mix_Opengl_Damage_Stream(Damage, &Damage->Vertex_Stream, Box, Hash);
+   }
+}
+
+// NOTE: Called for each glyph pushed into the text stream. Glyphs are hashed
+// by codepoint rather than atlas slot, since moving a glyph to another slot
+// doesn't change a pixel.
+static void Track_Opengl_Text_Damage(opengl_context *GL, opengl_text_glyph *Glyph, u32 Codepoint)
+{
+   opengl_damage *Damage = &GL->Damage;
+   if(Damage->Enabled)
+   {
+      float Scale_X = 2.0f / (float)Damage->Width;
+      float Scale_Y = 2.0f / (float)Damage->Height;
+      vec2 Min = {Glyph->Min.X*Scale_X - 1.0f, Glyph->Min.Y*Scale_Y - 1.0f};
+      vec2 Max = {Glyph->Max.X*Scale_X - 1.0f, Glyph->Max.Y*Scale_Y - 1.0f};
+
+      GLint Viewport[4] = {0, 0, Damage->Width, Damage->Height};
+      opengl_damage_box Box = Get_Opengl_Damage_Box(Damage, Viewport, Min, Max);
+      u64 Hash = Hash_Bytes(HASH_SEED, &Codepoint, sizeof(Codepoint));
+      Hash = Hash_Bytes(Hash, Glyph, offsetof(opengl_text_glyph, Slot));
+      Mix_Opengl_Damage_Stream(Damage, &Damage->Text_Stream, Box, Hash);
+   }
+}
+
+// NOTE: Mixes a stream's primitives into the frame's signatures, tile by
+// tile when it's drawn with the viewport its pushes assumed.
+static opengl_damage_box Apply_Opengl_Damage_Stream(opengl_damage *Damage, opengl_damage_stream *Stream, GLint *Viewport, u64 Hash)
+{
+   opengl_damage_box Result;
+
+   bool Full_Viewport = (Viewport[0] == 0 && Viewport[1] == 0 &&
+                         Viewport[2] == Damage->Width && Viewport[3] == Damage->Height);
+   if(Full_Viewport)
+   {
+      u32 Tile_Count = (u32)(Damage->Tiles_X*Damage->Tiles_Y);
+      for(u32 Tile = 0; Tile < Tile_Count; ++Tile)
+      {
+         if(Stream->Signatures[Tile])
+         {
+            u64 Tile_Hash = Mix_Opengl_Damage_Hash(Hash, Stream->Signatures[Tile]);
+            Damage->Signatures[Tile] = Mix_Opengl_Damage_Hash(Damage->Signatures[Tile], Tile_Hash);
+         }
+      }
+      Result = Stream->Box;
+   }
+   else
+   {
+      Result = Get_Opengl_Viewport_Box(Damage, Viewport);
+      Mix_Opengl_Damage_Tiles(Damage, Damage->Signatures, Result, Mix_Opengl_Damage_Hash(Hash, Stream->Hash));
+   }
+
+   return(Result);
+}
+
+// NOTE: Merges the marked tiles into at most OPENGL_DAMAGE_MAX_RECTS
+// rectangles: runs along each row, grown downwards while the run below spans
+// the same columns. Anything more fragmented than that becomes one bounding
+// rectangle.
+static void Build_Opengl_Damage_Rects(opengl_damage *Damage, u8 *Tiles)
+{
+   opengl_damage_box Rects[OPENGL_DAMAGE_MAX_RECTS];
+   u32 Rect_Count = 0;
+   bool Overflow = false;
+   opengl_damage_box Bounds = OPENGL_DAMAGE_EMPTY_BOX;
+
+   for(int Tile_Y = 0; Tile_Y < Damage->Tiles_Y; ++Tile_Y)
+   {
+      u8 *Row = Tiles + Tile_Y*Damage->Tiles_X;
+      for(int Tile_X = 0; Tile_X < Damage->Tiles_X;)
+      {
+         if(!Row[Tile_X])
+         {
+            ++Tile_X;
+            continue;
+         }
+
+         opengl_damage_box Run = {Tile_X, Tile_Y, Tile_X, Tile_Y + 1};
+         while(Run.Max_X < Damage->Tiles_X && Row[Run.Max_X])
+         {
+            Run.Max_X++;
+         }
+         Tile_X = Run.Max_X;
+         Bounds = Union_Opengl_Damage_Boxes(Bounds, Run);
+
+         bool Extended = false;
+         for(u32 Index = 0; Index < Rect_Count; ++Index)
+         {
+            opengl_damage_box *Rect = Rects + Index;
+            if(Rect->Max_Y == Tile_Y && Rect->Min_X == Run.Min_X && Rect->Max_X == Run.Max_X)
+            {
+               Rect->Max_Y = Run.Max_Y;
+               Extended = true;
+               break;
+            }
+         }
+
+         if(!Extended)
+         {
+            if(Rect_Count < OPENGL_DAMAGE_MAX_RECTS)
+            {
+               Rects[Rect_Count++] = Run;
+            }
+            else
+            {
+               Overflow = true;
+            }
+         }
+      }
+   }
+
+   if(Overflow)
+   {
+      Rects[0] = Bounds;
+      Rect_Count = 1;
+   }
+
+   Damage->Rect_Count = Rect_Count;
+   for(u32 Index = 0; Index < Rect_Count; ++Index)
+   {
+      opengl_damage_box Rect = Rects[Index];
+      int Max_X = Rect.Max_X*OPENGL_DAMAGE_TILE_SIZE;
+      int Max_Y = Rect.Max_Y*OPENGL_DAMAGE_TILE_SIZE;
+      if(Max_X > Damage->Width) Max_X = Damage->Width;
+      if(Max_Y > Damage->Height) Max_Y = Damage->Height;
+
+      opengl_rect *Result = Damage->Rects + Index;
+      Result->X = Rect.Min_X*OPENGL_DAMAGE_TILE_SIZE;
+      Result->Y = Rect.Min_Y*OPENGL_DAMAGE_TILE_SIZE;
+      Result->Width = Max_X - Result->X;
+      Result->Height = Max_Y - Result->Y;
+   }
+}
+
+// NOTE: Hashes every command into the tiles it covers, in execution order,
+// and works out what has to be redrawn this frame. Returns each entry's
+// screen bounds, for the executor to skip what misses the scissor.
+// Viewport commands get an empty box, and are never skipped.
+static opengl_damage_box *Track_Opengl_Damage(opengl_context *GL, render_sort_entry *Entries, u32 Count, arena *Arena)
+{
+   opengl_damage *Damage = &GL->Damage;
+   opengl_damage_box *Result = Push_Array(Arena, Count, opengl_damage_box);
+
+   u32 Tile_Count = (u32)(Damage->Tiles_X*Damage->Tiles_Y);
+   for(u32 Tile = 0; Tile < Tile_Count; ++Tile)
+   {
+      Damage->Signatures[Tile] = HASH_SEED;
+   }
+
+   // NOTE: Whatever viewport the platform left set applies until the first
+   // viewport command.
+   GLint Viewport[4] = {0, 0, Damage->Width, Damage->Height};
+   if(Opengl_State.Viewport[2] >= 0 && Opengl_State.Viewport[3] >= 0)
+   {
+      memcpy(Viewport, Opengl_State.Viewport, sizeof(Viewport));
+   }
+   opengl_damage_box Framebuffer = {0, 0, Damage->Width, Damage->Height};
+
+   for(u32 Entry_Index = 0; Entry_Index < Count; ++Entry_Index)
+   {
+      render_sort_entry *Entry = Entries + Entry_Index;
+      render_command *Command = Entry->Command;
+      opengl_damage_box *Box = Result + Entry_Index;
+      *Box = OPENGL_DAMAGE_EMPTY_BOX;
+
+      u32 Pass = (u32)(Entry->Key >> RENDER_KEY_PASS_SHIFT) & RENDER_KEY_PASS_MASK;
+      bool Uses_Camera = (Pass != Render_Pass_Overlay);
+
+      u64 Hash = Hash_Bytes(HASH_SEED, &Entry->Key, sizeof(Entry->Key));
+      Hash = Hash_Bytes(Hash, &Command->Type, sizeof(Command->Type));
+      Hash = Hash_Bytes(Hash, Viewport, sizeof(Viewport));
+      if(Uses_Camera)
+      {
+         Hash = Hash_Bytes(Hash, &GL->Camera_Scale, sizeof(GL->Camera_Scale));
+         Hash = Hash_Bytes(Hash, &GL->Camera_Offset, sizeof(GL->Camera_Offset));
+      }
+
+      switch(Command->Type)
+      {
+         case Render_Command_Clear:
+         {
+            // NOTE: Clears ignore the viewport, but not the scissor.
+            Hash = Hash_Bytes(Hash, &Command->Clear.Color, sizeof(Command->Clear.Color));
+            *Box = Framebuffer;
+            Mix_Opengl_Damage_Tiles(Damage, Damage->Signatures, *Box, Hash);
+         } break;
+
+         case Render_Command_Viewport:
+         {
+            render_command_viewport *Command_Viewport = &Command->Viewport;
+            Viewport[0] = Command_Viewport->X;
+            Viewport[1] = Command_Viewport->Y;
+            Viewport[2] = Command_Viewport->Width;
+            Viewport[3] = Command_Viewport->Height;
+         } break;
+
+         case Render_Command_Draw_Mesh:
+         {
+            render_command_draw_mesh *Draw = &Command->Draw_Mesh;
+            opengl_program *Program = GL->Shaders.Programs + Command->Material.Program;
+            opengl_instance *Instance = (Program->Uses_Object_Uniforms) ? &Draw->Instance : 0;
+
+            Hash = Hash_Bytes(Hash, &Command->Material, sizeof(Command->Material));
+            Hash = Hash_Bytes(Hash, &Draw->Mesh, sizeof(Draw->Mesh));
+            Hash = Hash_Bytes(Hash, &Draw->Lod, sizeof(Draw->Lod));
+            if(Instance)
+            {
+               Hash = Hash_Bytes(Hash, Instance, sizeof(*Instance));
+            }
+
+            vec2 Min, Max;
+            Get_Opengl_Instance_Bounds(GL, Draw->Mesh->Bounds_Min, Draw->Mesh->Bounds_Max, Instance, Uses_Camera, &Min, &Max);
+            *Box = Get_Opengl_Damage_Box(Damage, Viewport, Min, Max);
+            Mix_Opengl_Damage_Tiles(Damage, Damage->Signatures, *Box, Hash);
+         } break;
+
+         case Render_Command_Draw_Instances:
+         {
+            // NOTE: Each instance only damages its own tiles, so one moving
+            // object doesn't repaint the whole batch.
+            opengl_instance_batch *Batch = Command->Draw_Instances.Batch;
+            Hash = Hash_Bytes(Hash, &Command->Material, sizeof(Command->Material));
+            Hash = Hash_Bytes(Hash, &Batch->Mesh, sizeof(Batch->Mesh));
+            Hash = Hash_Bytes(Hash, &Batch->Count, sizeof(Batch->Count));
+
+            for(u32 Index = 0; Index < Batch->Count; ++Index)
+            {
+               opengl_instance *Instance = Batch->Instances + Index;
+               vec2 Min, Max;
+               Get_Opengl_Instance_Bounds(GL, Batch->Mesh->Bounds_Min, Batch->Mesh->Bounds_Max, Instance, Uses_Camera, &Min, &Max);
+
+               opengl_damage_box Instance_Box = Get_Opengl_Damage_Box(Damage, Viewport, Min, Max);
+               Mix_Opengl_Damage_Tiles(Damage, Damage->Signatures, Instance_Box, Hash_Bytes(Hash, Instance, sizeof(*Instance)));
+               *Box = Union_Opengl_Damage_Boxes(*Box, Instance_Box);
+            }
+         } break;
+
+         case Render_Command_Draw_Indirect:
+         {
+            // NOTE: Pooled meshes don't keep their own bounds, so every draw
+            // is bounded by the pool's.
+            opengl_indirect_batch *Batch = Command->Draw_Indirect.Batch;
+            opengl_mesh_pool *Pool = Batch->Pool;
+            Hash = Hash_Bytes(Hash, &Command->Material, sizeof(Command->Material));
+            Hash = Hash_Bytes(Hash, &Batch->Pool, sizeof(Batch->Pool));
+
+            for(u32 Index = 0; Index < Batch->Count; ++Index)
+            {
+               opengl_instance *Instance = Batch->Instances + Index;
+               vec2 Min, Max;
+               Get_Opengl_Instance_Bounds(GL, Pool->Bounds_Min, Pool->Bounds_Max, Instance, Uses_Camera, &Min, &Max);
+
+               u64 Draw_Hash = Hash_Bytes(Hash, Batch->Commands + Index, sizeof(opengl_draw_command));
+               Draw_Hash = Hash_Bytes(Draw_Hash, Instance, sizeof(*Instance));
+
+               opengl_damage_box Draw_Box = Get_Opengl_Damage_Box(Damage, Viewport, Min, Max);
+               Mix_Opengl_Damage_Tiles(Damage, Damage->Signatures, Draw_Box, Draw_Hash);
+               *Box = Union_Opengl_Damage_Boxes(*Box, Draw_Box);
+            }
+         } break;
+
+         case Render_Command_Draw_Stream:
+         {
+            Hash = Hash_Bytes(Hash, &Command->Draw_Stream.Vertex_Count, sizeof(Command->Draw_Stream.Vertex_Count));
+            *Box = Apply_Opengl_Damage_Stream(Damage, &Damage->Vertex_Stream, Viewport, Hash);
+         } break;
+
+         case Render_Command_Draw_Text:
+         {
+            Hash = Hash_Bytes(Hash, &Command->Draw_Text.Glyph_Count, sizeof(Command->Draw_Text.Glyph_Count));
+            *Box = Apply_Opengl_Damage_Stream(Damage, &Damage->Text_Stream, Viewport, Hash);
+         } break;
+      }
+   }
+
+   // NOTE: Anything the signatures can't see forces a full redraw: a resize,
+   // a back buffer of unknown age (or older than our history), assets that
+   // changed under the same handles, and frames that built programs.
+   int Age = Damage->Buffer_Age;
+   u64 Asset_Counter = (GL->Textures.Bytes_Uploaded + GL->Textures.Eviction_Count +
+                        GL->Meshes.Total_Bytes_Uploaded);
+   bool Full = (Damage->Reset || Age <= 0 || (u64)Age > Damage->Frame_Number ||
+                Asset_Counter != Damage->Asset_Counter || GL->Loading_This_Frame);
+   Damage->Reset = false;
+   Damage->Asset_Counter = Asset_Counter;
+
+   // NOTE: A back buffer Age frames old is missing every change made since,
+   // which is what gets repainted. The compositor only needs this frame's.
+   u64 Next_Frame = Damage->Frame_Number + 1;
+   u8 *Changed = Push_Array(Arena, Tile_Count, u8);
+   bool Any_Changed = false;
+   opengl_damage_box Repaint = OPENGL_DAMAGE_EMPTY_BOX;
+   for(int Tile_Y = 0; Tile_Y < Damage->Tiles_Y; ++Tile_Y)
+   {
+      for(int Tile_X = 0; Tile_X < Damage->Tiles_X; ++Tile_X)
+      {
+         u32 Tile = (u32)(Tile_Y*Damage->Tiles_X + Tile_X);
+         if(Full || Damage->Signatures[Tile] != Damage->Previous_Signatures[Tile])
+         {
+            Damage->Changed_Frames[Tile] = Next_Frame;
+            Changed[Tile] = 1;
+            Any_Changed = true;
+         }
+         if(Age > 0 && Damage->Changed_Frames[Tile] + (u64)Age > Next_Frame)
+         {
+            opengl_damage_box Tile_Box = {Tile_X, Tile_Y, Tile_X + 1, Tile_Y + 1};
+            Repaint = Union_Opengl_Damage_Boxes(Repaint, Tile_Box);
+         }
+      }
+   }
+
+   u64 *Signatures = Damage->Signatures;
+   Damage->Signatures = Damage->Previous_Signatures;
+   Damage->Previous_Signatures = Signatures;
+
+   // NOTE: A frame that changed nothing is neither drawn nor presented, so it
+   // doesn't count towards the back buffer ages either.
+   Damage->Full = Full;
+   Damage->Rect_Count = 0;
+   Damage->Scissor = (opengl_rect){0, 0, Damage->Width, Damage->Height};
+   if(Any_Changed)
+   {
+      Damage->Frame_Number = Next_Frame;
+      if(!Full)
+      {
+         Build_Opengl_Damage_Rects(Damage, Changed);
+
+         int Max_X = Repaint.Max_X*OPENGL_DAMAGE_TILE_SIZE;
+         int Max_Y = Repaint.Max_Y*OPENGL_DAMAGE_TILE_SIZE;
+         if(Max_X > Damage->Width) Max_X = Damage->Width;
+         if(Max_Y > Damage->Height) Max_Y = Damage->Height;
+         Damage->Scissor.X = Repaint.Min_X*OPENGL_DAMAGE_TILE_SIZE;
+         Damage->Scissor.Y = Repaint.Min_Y*OPENGL_DAMAGE_TILE_SIZE;
+         Damage->Scissor.Width = Max_X - Damage->Scissor.X;
+         Damage->Scissor.Height = Max_Y - Damage->Scissor.Y;
+
+         Damage->Full = (Damage->Scissor.Width == Damage->Width && Damage->Scissor.Height == Damage->Height);
+      }
+   }
+
+   GL->Stats.Damage_Full = Damage->Full;
+   GL->Stats.Damage_Rects = (Damage->Full) ? 1 : Damage->Rect_Count;
+   GL->Stats.Damage_Pixels = ((Damage->Full || Damage->Rect_Count > 0) ?
+                              (u64)Damage->Scissor.Width*Damage->Scissor.Height : 0);
+
+   return(Result);
+}
+
+static RESIZE_OPENGL_DAMAGE(Resize_Opengl_Damage)
+{
+   opengl_damage *Damage = &GL->Damage;
+   Damage->Enabled = true;
+   Damage->Width = Width;
+   Damage->Height = Height;
+   Damage->Tiles_X = (Width + OPENGL_DAMAGE_TILE_SIZE - 1) / OPENGL_DAMAGE_TILE_SIZE;
+   Damage->Tiles_Y = (Height + OPENGL_DAMAGE_TILE_SIZE - 1) / OPENGL_DAMAGE_TILE_SIZE;
+
+   // NOTE: A smaller framebuffer reuses the old tiles. Their contents don't
+   // matter, since the next frame is a full redraw.
+   u32 Tile_Count = (u32)(Damage->Tiles_X*Damage->Tiles_Y);
+   if(Tile_Count > Damage->Tile_Capacity)
+   {
+      arena *Arena = &GL->Memory->Permanent;
+      Damage->Signatures = Push_Array(Arena, Tile_Count, u64);
+      Damage->Previous_Signatures = Push_Array(Arena, Tile_Count, u64);
+      Damage->Changed_Frames = Push_Array(Arena, Tile_Count, u64);
+      Damage->Vertex_Stream.Signatures = Push_Array(Arena, Tile_Count, u64);
+      Damage->Text_Stream.Signatures = Push_Array(Arena, Tile_Count, u64);
+      Damage->Tile_Capacity = Tile_Count;
+   }
+
+   Damage->Reset = true;
+   Reset_Opengl_Damage_Streams(Damage);
+}
@@ -0,0 +1,503 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Frame graph (see opengl_graph in opengl_renderer.h). Passes and
+// transients are declared between Begin_Opengl_Frame and Render_With_Opengl,
+// which compiles and executes the graph once the render commands are sorted.
+
+static void Initialize_Opengl_Graph(opengl_context *GL)
+{
+   glGenVertexArrays(1, &GL->Graph.Fullscreen_VAO);
+}
+
+static void Begin_Opengl_Graph(opengl_graph *Graph)
+{
+   Graph->Pass_Count = 0;
+   Graph->Order_Count = 0;
+   Graph->Redirected = false;
+   Graph->Frame_Index++;
+
+   opengl_graph_resource Backbuffer = {0};
+   Backbuffer.Name = "backbuffer";
+   Backbuffer.Texture = OPENGL_GRAPH_NO_TEXTURE;
+   Graph->Resources[OPENGL_GRAPH_BACKBUFFER] = Backbuffer;
+   Graph->Resource_Count = 1;
+}
+
+static size Get_Opengl_Graph_Texel_Size(GLenum Format)
+{
+   size Result = 0;
+   switch(Format)
+   {
+      case GL_R8: Result = 1; break;
+      case GL_RGBA8: Result = 4; break;
+      case GL_RGBA16F: Result = 8; break;
+      default: Assert(!"Unsupported transient format."); break;
+   }
+   return(Result);
+}
+
+static u32 Add_Opengl_Graph_Texture(opengl_context *GL, char *Name, int Width, int Height, GLenum Format)
+{
+   opengl_graph *Graph = &GL->Graph;
+   Assert(Graph->Resource_Count < OPENGL_GRAPH_MAX_RESOURCES);
+   Assert(Width > 0 && Height > 0 && Get_Opengl_Graph_Texel_Size(Format) > 0);
+
+   u32 Result = Graph->Resource_Count++;
+   opengl_graph_resource *Resource = Graph->Resources + Result;
+   opengl_graph_resource Zero = {0};
+   *Resource = Zero;
+   Resource->Name = Name;
+   Resource->Width = Width;
+   Resource->Height = Height;
+   Resource->Format = Format;
+   Resource->Texture = OPENGL_GRAPH_NO_TEXTURE;
+   return(Result);
+}
+
+static u32 Add_Opengl_Graph_Pass(opengl_context *GL, char *Name, u32 Target, opengl_graph_pass_function *Function, void *Data)
+{
+   opengl_graph *Graph = &GL->Graph;
+   Assert(Graph->Pass_Count < OPENGL_GRAPH_MAX_PASSES);
+   Assert(Target < Graph->Resource_Count);
+
+   u32 Result = Graph->Pass_Count++;
+   opengl_graph_pass *Pass = Graph->Passes + Result;
+   opengl_graph_pass Zero = {0};
+   *Pass = Zero;
+   Pass->Name = Name;
+   Pass->Function = Function;
+   Pass->Data = Data;
+   Pass->Target = Target;
+   return(Result);
+}
+
+// NOTE: The backbuffer can't be read, and a pass can't read its own target.
+static void Read_Opengl_Graph_Texture(opengl_context *GL, u32 Pass_Index, u32 Resource)
+{
+   opengl_graph *Graph = &GL->Graph;
+   Assert(Pass_Index < Graph->Pass_Count);
+   Assert(Resource != OPENGL_GRAPH_BACKBUFFER && Resource < Graph->Resource_Count);
+
+   opengl_graph_pass *Pass = Graph->Passes + Pass_Index;
+   Assert(Pass->Read_Count < OPENGL_GRAPH_MAX_READS && Pass->Target != Resource);
+   Pass->Reads[Pass->Read_Count++] = Resource;
+}
+
+// NOTE: Points the scene render pass at a transient, for passes declared
+// after it to read from.
+static void Set_Opengl_Scene_Target(opengl_context *GL, u32 Resource)
+{
+   opengl_graph *Graph = &GL->Graph;
+   Assert(Resource < Graph->Resource_Count);
+   Graph->Passes[Graph->Scene_Pass].Target = Resource;
+}
+
+static bool Opengl_Graph_Pass_Reads(opengl_graph_pass *Pass, u32 Resource)
+{
+   bool Result = false;
+   for(u32 Index = 0; Index < Pass->Read_Count; ++Index)
+   {
+      Result |= (Pass->Reads[Index] == Resource);
+   }
+   return(Result);
+}
+
+static void Cull_Opengl_Graph(opengl_graph *Graph)
+{
+   // NOTE: Passes drawing into the backbuffer are the roots, and the writers
+   // of anything a live pass reads are live too. Readers may be declared
+   // before writers, so this goes round until nothing changes.
+   bool Needed[OPENGL_GRAPH_MAX_RESOURCES] = {0};
+   Needed[OPENGL_GRAPH_BACKBUFFER] = true;
+
+   bool Changed = true;
+   while(Changed)
+   {
+      Changed = false;
+      for(u32 Index = 0; Index < Graph->Pass_Count; ++Index)
+      {
+         opengl_graph_pass *Pass = Graph->Passes + Index;
+         if(!Pass->Live && Needed[Pass->Target])
+         {
+            Pass->Live = true;
+            for(u32 Read = 0; Read < Pass->Read_Count; ++Read)
+            {
+               Needed[Pass->Reads[Read]] = true;
+            }
+            Changed = true;
+         }
+      }
+   }
+}
+
+static void Order_Opengl_Graph(opengl_graph *Graph)
+{
+   // NOTE: A pass waits on every earlier writer of its target and on every
+   // writer of what it reads. Of the passes that are ready, the one declared
+   // first goes next, so a graph declared in a valid order runs as declared.
+   u32 Depends[OPENGL_GRAPH_MAX_PASSES] = {0};
+   u32 Live_Mask = 0;
+   for(u32 Index = 0; Index < Graph->Pass_Count; ++Index)
+   {
+      opengl_graph_pass *Pass = Graph->Passes + Index;
+      if(Pass->Live)
+      {
+         Live_Mask |= 1u << Index;
+         for(u32 Other_Index = 0; Other_Index < Graph->Pass_Count; ++Other_Index)
+         {
+            opengl_graph_pass *Other = Graph->Passes + Other_Index;
+            if(Other->Live && Other_Index != Index &&
+               ((Other->Target == Pass->Target && Other_Index < Index) || Opengl_Graph_Pass_Reads(Pass, Other->Target)))
+            {
+               Depends[Index] |= 1u << Other_Index;
+            }
+         }
+      }
+   }
+
+   u32 Done_Mask = 0;
+   Graph->Order_Count = 0;
+   while(Done_Mask != Live_Mask)
+   {
+      u32 Next = OPENGL_GRAPH_MAX_PASSES;
+      for(u32 Index = 0; Index < Graph->Pass_Count && Next == OPENGL_GRAPH_MAX_PASSES; ++Index)
+      {
+         u32 Bit = 1u << Index;
+         if((Live_Mask & Bit) && !(Done_Mask & Bit) && (Depends[Index] & ~Done_Mask) == 0)
+         {
+            Next = Index;
+         }
+      }
+
+      if(Next == OPENGL_GRAPH_MAX_PASSES)
+      {
+         fprintf(stderr, "Frame graph has a cycle, dropping %u passes.\n", Graph->Pass_Count - Graph->Order_Count);
+         break;
+      }
+
+      Done_Mask |= 1u << Next;
+      Graph->Order[Graph->Order_Count++] = Next;
+   }
+}
+
+// NOTE: Returns the index of a pooled texture matching the resource that no
+// live transient holds, creating one if there's none.
+static u32 Acquire_Opengl_Graph_Texture(opengl_graph *Graph, opengl_graph_resource *Resource)
+{
+   u32 Result = OPENGL_GRAPH_NO_TEXTURE;
+   u32 Free_Slot = OPENGL_GRAPH_NO_TEXTURE;
+   for(u32 Index = 0; Index < Graph->Texture_Count && Result == OPENGL_GRAPH_NO_TEXTURE; ++Index)
+   {
+      opengl_graph_texture *Texture = Graph->Textures + Index;
+      if(!Texture->Texture)
+      {
+         if(Free_Slot == OPENGL_GRAPH_NO_TEXTURE)
+         {
+            Free_Slot = Index;
+         }
+      }
+      else if(!Texture->Assigned && Texture->Width == Resource->Width &&
+              Texture->Height == Resource->Height && Texture->Format == Resource->Format)
+      {
+         Result = Index;
+      }
+   }
+
+   if(Result == OPENGL_GRAPH_NO_TEXTURE)
+   {
+      if(Free_Slot == OPENGL_GRAPH_NO_TEXTURE && Graph->Texture_Count < OPENGL_GRAPH_MAX_TEXTURES)
+      {
+         Free_Slot = Graph->Texture_Count++;
+      }
+
+      if(Free_Slot != OPENGL_GRAPH_NO_TEXTURE)
+      {
+         opengl_graph_texture *Texture = Graph->Textures + Free_Slot;
+         opengl_graph_texture Zero = {0};
+         *Texture = Zero;
+         Texture->Width = Resource->Width;
+         Texture->Height = Resource->Height;
+         Texture->Format = Resource->Format;
+         Texture->Bytes = (size)Resource->Width*(size)Resource->Height*Get_Opengl_Graph_Texel_Size(Resource->Format);
+
+         // NOTE: Single layer arrays, like every other texture the renderer
+         // samples, so they can share texture unit 0 with materials.
+         GLenum Pixel_Format = (Resource->Format == GL_R8) ? GL_RED : GL_RGBA;
+         glGenTextures(1, &Texture->Texture);
+         Bind_Opengl_Buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+         Bind_Opengl_Texture(0, GL_TEXTURE_2D_ARRAY, Texture->Texture);
+         glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, Resource->Format, Resource->Width, Resource->Height, 1, 0, Pixel_Format, GL_UNSIGNED_BYTE, 0);
+         glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+         glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+         glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+         glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+         glGenFramebuffers(1, &Texture->Framebuffer);
+         Bind_Opengl_Framebuffer(Texture->Framebuffer);
+         glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, Texture->Texture, 0, 0);
+         if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+         {
+            fprintf(stderr, "Transient framebuffer for %s is incomplete.\n", Resource->Name);
+         }
+         GL_CHECK;
+
+         Graph->Pool_Bytes += Texture->Bytes;
+         Graph->Textures_Created++;
+         Result = Free_Slot;
+      }
+      else
+      {
+         fprintf(stderr, "Transient texture pool is full, %s can't be drawn.\n", Resource->Name);
+      }
+   }
+
+   if(Result != OPENGL_GRAPH_NO_TEXTURE)
+   {
+      Graph->Textures[Result].Assigned = true;
+      Graph->Textures[Result].Last_Used_Frame = Graph->Frame_Index;
+   }
+   return(Result);
+}
+
+static void Compile_Opengl_Graph(opengl_context *GL)
+{
+   opengl_graph *Graph = &GL->Graph;
+
+   Cull_Opengl_Graph(Graph);
+   Order_Opengl_Graph(Graph);
+
+   for(u32 Index = 1; Index < Graph->Resource_Count; ++Index)
+   {
+      opengl_graph_resource *Resource = Graph->Resources + Index;
+      Resource->First_Use = OPENGL_GRAPH_MAX_PASSES;
+      Resource->Last_Use = 0;
+      GL->Stats.Naive_Transient_Bytes += (u64)Resource->Width*(u64)Resource->Height*Get_Opengl_Graph_Texel_Size(Resource->Format);
+   }
+
+   for(u32 Position = 0; Position < Graph->Order_Count; ++Position)
+   {
+      opengl_graph_pass *Pass = Graph->Passes + Graph->Order[Position];
+      for(u32 Read = 0; Read <= Pass->Read_Count; ++Read)
+      {
+         u32 Resource_Index = (Read < Pass->Read_Count) ? Pass->Reads[Read] : Pass->Target;
+         opengl_graph_resource *Resource = Graph->Resources + Resource_Index;
+         if(Resource_Index != OPENGL_GRAPH_BACKBUFFER)
+         {
+            if(Resource->First_Use == OPENGL_GRAPH_MAX_PASSES)
+            {
+               Assert(Resource_Index == Pass->Target); // NOTE: Read before it was written.
+               Resource->First_Use = Position;
+               Graph->Redirected = true;
+            }
+            Resource->Last_Use = Position;
+         }
+      }
+   }
+
+   // NOTE: Transients are drawn with their own framebuffer and viewport
+   // bound, so the platform's have to be known to go back to them. They
+   // normally are, and are only asked for after an invalidation.
+   if(Graph->Redirected)
+   {
+      if(Opengl_State.Framebuffer == OPENGL_STATE_UNKNOWN)
+      {
+         GLint Framebuffer = 0;
+         glGetIntegerv(GL_FRAMEBUFFER_BINDING, &Framebuffer);
+         Opengl_State.Framebuffer = (GLuint)Framebuffer;
+      }
+      if(Opengl_State.Viewport[2] < 0)
+      {
+         glGetIntegerv(GL_VIEWPORT, Opengl_State.Viewport);
+      }
+      Graph->Backbuffer = Opengl_State.Framebuffer;
+      memcpy(Graph->Backbuffer_Viewport, Opengl_State.Viewport, sizeof(Graph->Backbuffer_Viewport));
+   }
+
+   // NOTE: Walks the passes in order, assigning a pooled texture to each
+   // transient at its first use and handing it back after its last, so that
+   // later transients can alias it.
+   for(u32 Index = 0; Index < Graph->Texture_Count; ++Index)
+   {
+      Graph->Textures[Index].Assigned = false;
+   }
+
+   size Live_Bytes = 0;
+   size Peak_Bytes = 0;
+   for(u32 Position = 0; Position < Graph->Order_Count; ++Position)
+   {
+      for(u32 Index = 1; Index < Graph->Resource_Count; ++Index)
+      {
+         opengl_graph_resource *Resource = Graph->Resources + Index;
+         if(Resource->First_Use == Position)
+         {
+            Resource->Texture = Acquire_Opengl_Graph_Texture(Graph, Resource);
+            if(Resource->Texture != OPENGL_GRAPH_NO_TEXTURE)
+            {
+               Live_Bytes += Graph->Textures[Resource->Texture].Bytes;
+            }
+         }
+      }
+
+      if(Live_Bytes > Peak_Bytes)
+      {
+         Peak_Bytes = Live_Bytes;
+      }
+
+      for(u32 Index = 1; Index < Graph->Resource_Count; ++Index)
+      {
+         opengl_graph_resource *Resource = Graph->Resources + Index;
+         if(Resource->Last_Use == Position && Resource->Texture != OPENGL_GRAPH_NO_TEXTURE)
+         {
+            Graph->Textures[Resource->Texture].Assigned = false;
+            Live_Bytes -= Graph->Textures[Resource->Texture].Bytes;
+         }
+      }
+   }
+
+   // NOTE: Textures no frame has asked for in a while go back to the driver.
+   u32 Deleted_Count = 0;
+   for(u32 Index = 0; Index < Graph->Texture_Count; ++Index)
+   {
+      opengl_graph_texture *Texture = Graph->Textures + Index;
+      if(Texture->Texture)
+      {
+         if(Texture->Last_Used_Frame + OPENGL_GRAPH_TEXTURE_LIFETIME <= Graph->Frame_Index)
+         {
+            glDeleteFramebuffers(1, &Texture->Framebuffer);
+            glDeleteTextures(1, &Texture->Texture);
+            Graph->Pool_Bytes -= Texture->Bytes;
+
+            opengl_graph_texture Zero = {0};
+            *Texture = Zero;
+            Deleted_Count++;
+         }
+         else if(Texture->Last_Used_Frame == Graph->Frame_Index)
+         {
+            GL->Stats.Transient_Textures++;
+         }
+      }
+   }
+   if(Deleted_Count > 0)
+   {
+      Graph->Textures_Deleted += Deleted_Count;
+      Invalidate_Opengl_State();
+   }
+
+   GL->Stats.Graph_Passes = Graph->Order_Count;
+   GL->Stats.Graph_Passes_Culled = Graph->Pass_Count - Graph->Order_Count;
+   GL->Stats.Transient_Bytes = Peak_Bytes;
+}
+
+static void Execute_Opengl_Graph(opengl_context *GL)
+{
+   opengl_graph *Graph = &GL->Graph;
+   for(u32 Position = 0; Position < Graph->Order_Count; ++Position)
+   {
+      opengl_graph_pass *Pass = Graph->Passes + Graph->Order[Position];
+
+      bool Ready = true;
+      GLuint Inputs[OPENGL_GRAPH_MAX_READS] = {0};
+      for(u32 Read = 0; Read < Pass->Read_Count; ++Read)
+      {
+         u32 Texture = Graph->Resources[Pass->Reads[Read]].Texture;
+         Ready &= (Texture != OPENGL_GRAPH_NO_TEXTURE);
+         Inputs[Read] = (Ready) ? Graph->Textures[Texture].Texture : 0;
+      }
+
+      if(Pass->Target == OPENGL_GRAPH_BACKBUFFER)
+      {
+         if(Graph->Redirected)
+         {
+            GLint *Viewport = Graph->Backbuffer_Viewport;
+            Bind_Opengl_Framebuffer(Graph->Backbuffer);
+            Set_Opengl_Viewport(Viewport[0], Viewport[1], Viewport[2], Viewport[3]);
+         }
+      }
+      else
+      {
+         u32 Texture_Index = Graph->Resources[Pass->Target].Texture;
+         Ready &= (Texture_Index != OPENGL_GRAPH_NO_TEXTURE);
+         if(Ready)
+         {
+            // NOTE: Whatever an earlier pass left on unit 0 could be the
+            // texture this one draws into.
+            opengl_graph_texture *Texture = Graph->Textures + Texture_Index;
+            Bind_Opengl_Texture(0, GL_TEXTURE_2D_ARRAY, 0);
+            Bind_Opengl_Framebuffer(Texture->Framebuffer);
+            Set_Opengl_Viewport(0, 0, Texture->Width, Texture->Height);
+         }
+      }
+
+      if(Ready)
+      {
+         Pass->Function(Pass->Data, Inputs);
+      }
+   }
+}
+
+// NOTE: Bloom, the one post effect so far. The scene is drawn into a
+// transient, its bright parts are extracted at half resolution and blurred
+// separably, and the composite copies the scene into the backbuffer and adds
+// the blur on top. A zero intensity leaves the blur unread, and the graph
+// culls its passes.
+typedef struct {
+   opengl_context *GL;
+   u32 Program;
+   float Intensity; // NOTE: Scales every input after the first.
+} opengl_post_pass;
+
+static OPENGL_GRAPH_PASS(Execute_Opengl_Post_Pass)
+{
+   opengl_post_pass *Post = (opengl_post_pass *)Data;
+   opengl_context *GL = Post->GL;
+
+   // NOTE: The first input replaces the target, and the rest are added on.
+   opengl_program *Program = GL->Shaders.Programs + Post->Program;
+   Use_Opengl_Program(Program->Program);
+   Bind_Opengl_Vertex_Array(GL->Graph.Fullscreen_VAO);
+   Set_Opengl_Depth(false, false, GL_LESS);
+   Set_Opengl_Cull(false, GL_BACK);
+
+   for(u32 Index = 0; Index < OPENGL_GRAPH_MAX_READS && Inputs[Index]; ++Index)
+   {
+      float Tint = (Index == 0) ? 1.0f : Post->Intensity;
+      Set_Opengl_Blend(Index > 0, GL_ONE, GL_ONE);
+      Bind_Opengl_Texture(0, GL_TEXTURE_2D_ARRAY, Inputs[Index]);
+      glUniform4f(Program->Tint_Location, Tint, Tint, Tint, 1.0f);
+      glDrawArrays(GL_TRIANGLES, 0, 3);
+      GL->Stats.Draw_Calls++;
+   }
+}
+
+static void Add_Opengl_Bloom(opengl_context *GL, int Width, int Height, float Intensity)
+{
+   arena *Frame = &GL->Memory->Frame;
+   int Half_Width = (Width > 1) ? Width / 2 : 1;
+   int Half_Height = (Height > 1) ? Height / 2 : 1;
+
+   u32 Scene = Add_Opengl_Graph_Texture(GL, "scene", Width, Height, GL_RGBA8);
+   u32 Bright = Add_Opengl_Graph_Texture(GL, "bloom bright", Half_Width, Half_Height, GL_RGBA8);
+   u32 Blur_X = Add_Opengl_Graph_Texture(GL, "bloom blur x", Half_Width, Half_Height, GL_RGBA8);
+   u32 Blur_Y = Add_Opengl_Graph_Texture(GL, "bloom blur y", Half_Width, Half_Height, GL_RGBA8);
+   Set_Opengl_Scene_Target(GL, Scene);
+
+   u32 Programs[] = {GL->Post_Bright_Program, GL->Post_Blur_X_Program, GL->Post_Blur_Y_Program, GL->Post_Copy_Program};
+   char *Names[] = {"bloom bright", "bloom blur x", "bloom blur y", "bloom composite"};
+   u32 Targets[] = {Bright, Blur_X, Blur_Y, OPENGL_GRAPH_BACKBUFFER};
+   u32 Sources[] = {Scene, Bright, Blur_X, Scene};
+
+   for(u32 Index = 0; Index < Array_Count(Programs); ++Index)
+   {
+      opengl_post_pass *Post = Push_Struct(Frame, opengl_post_pass);
+      Post->GL = GL;
+      Post->Program = Programs[Index];
+      Post->Intensity = Intensity;
+
+      u32 Pass = Add_Opengl_Graph_Pass(GL, Names[Index], Targets[Index], Execute_Opengl_Post_Pass, Post);
+      Read_Opengl_Graph_Texture(GL, Pass, Sources[Index]);
+      if(Targets[Index] == OPENGL_GRAPH_BACKBUFFER && Intensity > 0.0f)
+      {
+         Read_Opengl_Graph_Texture(GL, Pass, Blur_Y);
+      }
+   }
+}
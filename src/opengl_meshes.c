@@ -0,0 +1,259 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Mesh streaming. Mesh files are mapped and validated on the background
+// thread, uploaded from the mapping by the main thread under a per-frame byte
+// budget, and unmapped on the background thread again. Handles returned by
+// Load_Opengl_Mesh are indices into the loader's asset table, plus one.
+
+_Static_assert(sizeof(vertex) == sizeof(mesh_file_vertex), "Mesh files must store renderer vertices.");
+_Static_assert(sizeof(compact_vertex) == sizeof(mesh_file_compact_vertex), "Mesh files must store renderer vertices.");
+
+static JOB_FUNCTION(Load_Mesh_Asset_Job)
+{
+   opengl_mesh_asset *Asset = Data;
+
+   u32 State = Mesh_Asset_Failed;
+   size Size = 0;
+   u8 *Mapping = Map_Entire_File(Asset->Path, &Size);
+   if(Mapping)
+   {
+      mesh_file_header *Header = (mesh_file_header *)Mapping;
+      if(Validate_Mesh_File(Header, Size))
+      {
+         Asset->Mapping = Mapping;
+         Asset->Mapping_Size = Size;
+         Asset->Header = Header;
+         State = Mesh_Asset_Mapped;
+      }
+      else
+      {
+         fprintf(stderr, "Mesh file %s is invalid or was written by another version.\n", Asset->Path);
+         Unmap_Entire_File(Mapping, Size);
+      }
+   }
+   else
+   {
+      fprintf(stderr, "Failed to load mesh file %s.\n", Asset->Path);
+   }
+
+   atomic_store_explicit(&Asset->State, State, memory_order_release);
+   Wake_Main_Thread();
+}
+
+static JOB_FUNCTION(Unmap_Mesh_Asset_Job)
+{
+   opengl_mesh_asset *Asset = Data;
+   Unmap_Entire_File(Asset->Mapping, Asset->Mapping_Size);
+}
+
+static u32 Load_Opengl_Mesh(opengl_context *GL, char *Path)
+{
+   u32 Result = 0;
+
+   opengl_mesh_loader *Loader = &GL->Meshes;
+   if(Loader->Asset_Count < OPENGL_MAX_MESH_ASSETS && strlen(Path) < OPENGL_MESH_ASSET_PATH_SIZE)
+   {
+      opengl_mesh_asset *Asset = Loader->Assets + Loader->Asset_Count++;
+      strcpy(Asset->Path, Path);
+      Asset->Request_Time = Get_Clock();
+      atomic_store(&Asset->State, Mesh_Asset_Loading);
+
+      Start_Background_Job(Load_Mesh_Asset_Job, Asset, &Loader->Pending);
+      Result = Loader->Asset_Count;
+   }
+   else
+   {
+      fprintf(stderr, "Failed to queue mesh file %s.\n", Path);
+   }
+
+   return(Result);
+}
+
+// NOTE: Returns 0 until the mesh is fully uploaded, and forever if it failed
+// to load.
+static opengl_mesh *Get_Opengl_Mesh(opengl_context *GL, u32 Handle)
+{
+   opengl_mesh *Result = 0;
+
+   opengl_mesh_loader *Loader = &GL->Meshes;
+   if(Handle > 0 && Handle <= Loader->Asset_Count)
+   {
+      opengl_mesh_asset *Asset = Loader->Assets + (Handle - 1);
+      if(atomic_load_explicit(&Asset->State, memory_order_relaxed) == Mesh_Asset_Resident)
+      {
+         Result = &Asset->Mesh;
+      }
+   }
+
+   return(Result);
+}
+
+static bool Has_Pending_Opengl_Meshes(opengl_context *GL)
+{
+   bool Result = false;
+
+   opengl_mesh_loader *Loader = &GL->Meshes;
+   for(u32 Index = 0; !Result && Index < Loader->Asset_Count; ++Index)
+   {
+      u32 State = atomic_load_explicit(&Loader->Assets[Index].State, memory_order_relaxed);
+      Result = (State == Mesh_Asset_Loading || State == Mesh_Asset_Mapped);
+   }
+
+   return(Result);
+}
+
+// NOTE: Uploads up to Budget more bytes of a mapped asset, vertices first,
+// and returns how many bytes it uploaded.
+static u64 Upload_Opengl_Mesh_Asset(opengl_mesh_asset *Asset, u64 Budget)
+{
+   mesh_file_header *Header = Asset->Header;
+   opengl_mesh *Mesh = &Asset->Mesh;
+
+   u64 Vertex_Size = (u64)Header->Vertex_Count * Header->Vertex_Stride;
+   u64 Index_Size = (u64)Header->Index_Count * Header->Index_Size;
+
+   // NOTE: Uploads go through the copy write target, since unlike the element
+   // array binding it isn't part of any VAO's state.
+   if(!Mesh->VBO)
+   {
+      glGenBuffers(1, &Mesh->VBO);
+      glBindBuffer(GL_COPY_WRITE_BUFFER, Mesh->VBO);
+      glBufferData(GL_COPY_WRITE_BUFFER, Vertex_Size, 0, GL_STATIC_DRAW);
+
+      if(Index_Size > 0)
+      {
+         glGenBuffers(1, &Mesh->EBO);
+         glBindBuffer(GL_COPY_WRITE_BUFFER, Mesh->EBO);
+         glBufferData(GL_COPY_WRITE_BUFFER, Index_Size, 0, GL_STATIC_DRAW);
+      }
+   }
+
+   u64 Result = 0;
+   while(Result < Budget && Asset->Bytes_Uploaded < Vertex_Size + Index_Size)
+   {
+      GLuint Buffer;
+      u64 Buffer_Offset;
+      u64 Source_Offset;
+      u64 Available;
+      if(Asset->Bytes_Uploaded < Vertex_Size)
+      {
+         Buffer = Mesh->VBO;
+         Buffer_Offset = Asset->Bytes_Uploaded;
+         Source_Offset = Header->Vertex_Offset + Buffer_Offset;
+         Available = Vertex_Size - Buffer_Offset;
+      }
+      else
+      {
+         Buffer = Mesh->EBO;
+         Buffer_Offset = Asset->Bytes_Uploaded - Vertex_Size;
+         Source_Offset = Header->Index_Offset + Buffer_Offset;
+         Available = Index_Size - Buffer_Offset;
+      }
+
+      u64 Upload_Size = Budget - Result;
+      if(Upload_Size > Available)
+      {
+         Upload_Size = Available;
+      }
+
+      glBindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+      glBufferSubData(GL_COPY_WRITE_BUFFER, Buffer_Offset, Upload_Size, Asset->Mapping + Source_Offset);
+
+      Asset->Bytes_Uploaded += Upload_Size;
+      Result += Upload_Size;
+   }
+   glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+   return(Result);
+}
+
+static void Finish_Opengl_Mesh_Asset(opengl_mesh_loader *Loader, opengl_mesh_asset *Asset)
+{
+   mesh_file_header *Header = Asset->Header;
+   opengl_mesh *Mesh = &Asset->Mesh;
+
+   Mesh->Index_Type = (Header->Index_Size == 4) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+   Mesh->Layout = Opengl_Vertex_Layouts + Header->Vertex_Format;
+   Mesh->Vertex_Count = Header->Vertex_Count;
+   Mesh->Index_Count = Header->Index_Count;
+   Mesh->Bounds_Min = Header->Bounds_Min;
+   Mesh->Bounds_Max = Header->Bounds_Max;
+
+   Mesh->Lod_Count = Header->Lod_Count;
+   for(u32 Lod_Index = 0; Lod_Index < Header->Lod_Count; ++Lod_Index)
+   {
+      Mesh->Lods[Lod_Index].First_Index = Header->Lods[Lod_Index].First_Index;
+      Mesh->Lods[Lod_Index].Index_Count = Header->Lods[Lod_Index].Index_Count;
+   }
+
+   glGenVertexArrays(1, &Mesh->VAO);
+   Bind_Opengl_Vertex_Array(Mesh->VAO);
+   Bind_Opengl_Mesh_Attributes(Mesh);
+   Bind_Opengl_Vertex_Array(0);
+
+   // NOTE: Nothing reads the mapping past this point, so it goes back to the
+   // background thread rather than paying for the munmap here.
+   Asset->Header = 0;
+   Asset->Resident_Time = Get_Clock();
+   atomic_store(&Asset->State, Mesh_Asset_Resident);
+   Start_Background_Job(Unmap_Mesh_Asset_Job, Asset, &Loader->Pending);
+}
+
+static void Update_Opengl_Meshes(opengl_context *GL)
+{
+   opengl_mesh_loader *Loader = &GL->Meshes;
+   Loader->Frame_Bytes_Uploaded = 0;
+
+   // NOTE: Assets are uploaded in the order they were requested, so a big
+   // mesh at the front holds back the ones behind it rather than every mesh
+   // trickling in at once.
+   for(u32 Index = 0; Index < Loader->Asset_Count; ++Index)
+   {
+      u64 Budget = Loader->Upload_Budget - Loader->Frame_Bytes_Uploaded;
+      if(Budget == 0)
+      {
+         break;
+      }
+
+      opengl_mesh_asset *Asset = Loader->Assets + Index;
+      if(atomic_load_explicit(&Asset->State, memory_order_acquire) == Mesh_Asset_Mapped)
+      {
+         Loader->Frame_Bytes_Uploaded += Upload_Opengl_Mesh_Asset(Asset, Budget);
+
+         mesh_file_header *Header = Asset->Header;
+         u64 Total_Size = (u64)Header->Vertex_Count*Header->Vertex_Stride + (u64)Header->Index_Count*Header->Index_Size;
+         if(Asset->Bytes_Uploaded == Total_Size)
+         {
+            Finish_Opengl_Mesh_Asset(Loader, Asset);
+         }
+      }
+   }
+
+   Loader->Total_Bytes_Uploaded += Loader->Frame_Bytes_Uploaded;
+}
+
+static void Destroy_Opengl_Meshes(opengl_context *GL)
+{
+   opengl_mesh_loader *Loader = &GL->Meshes;
+   Wait_For_Jobs(&Loader->Pending);
+
+   for(u32 Index = 0; Index < Loader->Asset_Count; ++Index)
+   {
+      opengl_mesh_asset *Asset = Loader->Assets + Index;
+      if(atomic_load(&Asset->State) == Mesh_Asset_Mapped)
+      {
+         Unmap_Entire_File(Asset->Mapping, Asset->Mapping_Size);
+      }
+
+      opengl_mesh *Mesh = &Asset->Mesh;
+      glDeleteVertexArrays(1, &Mesh->VAO);
+      glDeleteBuffers(1, &Mesh->VBO);
+      glDeleteBuffers(1, &Mesh->EBO);
+   }
+   Invalidate_Opengl_State();
+
+   u64 Upload_Budget = Loader->Upload_Budget;
+   opengl_mesh_loader Zero = {0};
+   *Loader = Zero;
+   Loader->Upload_Budget = Upload_Budget;
+}
@@ -1,5 +1,8 @@
 /* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
 
+// NOTE: Comes first, so that every GL call below goes through the capture.
+#include "opengl_capture.c"
+
 static char *Opengl_Error_Names[] =
 {
    [GL_NO_ERROR]          = "GL_NO_ERROR",
@@ -24,63 +27,1125 @@ static inline void Check_For_Opengl_Errors(char *Path, int Line)
    }
 }
 
-static INITIALIZE_OPENGL(Initialize_Opengl)
+#if PROFILER_ENABLED
+static profile_scope *Get_Profile_Scope(profiler *Profiler, char *Name, bool Is_Gpu)
+{
+   profile_scope *Result = 0;
+
+   // NOTE: Scope names are expected to be string literals, so the pointer
+   // comparison almost always hits before we fall back to strcmp.
+   for(int Index = 0; Index < Profiler->Scope_Count; ++Index)
+   {
+      profile_scope *Scope = Profiler->Scopes + Index;
+      if(Scope->Is_Gpu == Is_Gpu && (Scope->Name == Name || strcmp(Scope->Name, Name) == 0))
+      {
+         Result = Scope;
+         break;
+      }
+   }
+
+   if(!Result && Profiler->Scope_Count < PROFILER_MAX_SCOPES)
+   {
+      Result = Profiler->Scopes + Profiler->Scope_Count++;
+      Result->Name = Name;
+      Result->Is_Gpu = Is_Gpu;
+      if(Is_Gpu)
+      {
+         glGenQueries(PROFILER_QUERY_LATENCY, Result->Queries);
+      }
+   }
+
+   return(Result);
+}
+
+static void Record_Profile_Sample(profile_scope *Scope, float Milliseconds)
+{
+   Scope->Samples[Scope->Sample_Count % PROFILER_MAX_SAMPLES] = Milliseconds;
+   Scope->Sample_Count++;
+}
+
+static void Collect_Gpu_Profile_Queries(profiler *Profiler, bool Reusing_Slot, u32 Slot)
+{
+   for(int Index = 0; Index < Profiler->Scope_Count; ++Index)
+   {
+      profile_scope *Scope = Profiler->Scopes + Index;
+      if(Scope->Is_Gpu)
+      {
+         for(u32 Query_Index = 0; Query_Index < PROFILER_QUERY_LATENCY; ++Query_Index)
+         {
+            if(Scope->Query_Pending[Query_Index])
+            {
+               GLint Available = 0;
+               glGetQueryObjectiv(Scope->Queries[Query_Index], GL_QUERY_RESULT_AVAILABLE, &Available);
+               if(Available)
+               {
+                  GLuint64 Nanoseconds = 0;
+                  glGetQueryObjectui64v(Scope->Queries[Query_Index], GL_QUERY_RESULT, &Nanoseconds);
+                  // NOTE: Some drivers (llvmpipe, at least) report garbage
+                  // for the first query that covers real work. Nothing can
+                  // take longer than the profiler has been alive, so treat
+                  // those results as dropped.
+                  if(Nanoseconds <= Get_Clock() - Profiler->Start_Time)
+                  {
+                     Record_Profile_Sample(Scope, (float)((double)Nanoseconds / 1e6));
+                  }
+                  else
+                  {
+                     Scope->Dropped_Query_Count++;
+                  }
+                  Scope->Query_Pending[Query_Index] = false;
+               }
+               else if(Reusing_Slot && Query_Index == Slot)
+               {
+                  // NOTE: The GPU is more than a full ring behind. Rather than
+                  // wait, drop the sample; the count shows up in the report.
+                  Scope->Query_Pending[Query_Index] = false;
+                  Scope->Dropped_Query_Count++;
+               }
+            }
+         }
+      }
+   }
+}
+
+static void Begin_Profiler_Frame(profiler *Profiler)
+{
+   if(Profiler->Frame_Index == 0)
+   {
+      Profiler->Start_Time = Get_Clock();
+   }
+
+   u32 Slot = Profiler->Frame_Index % PROFILER_QUERY_LATENCY;
+   Collect_Gpu_Profile_Queries(Profiler, true, Slot);
+
+   Profiler->Frame_Begin_Time = Get_Clock();
+}
+
+static void End_Profiler_Frame(profiler *Profiler)
+{
+   u64 Frame_End_Time = Get_Clock();
+
+   profile_scope *Frame_Scope = Get_Profile_Scope(Profiler, "Frame", false);
+   if(Frame_Scope)
+   {
+      Record_Profile_Sample(Frame_Scope, (float)((double)(Frame_End_Time - Profiler->Frame_Begin_Time) / 1e6));
+   }
+
+   // NOTE: CPU scopes may be entered several times per frame, so they
+   // accumulate and are only sampled once here.
+   for(int Index = 0; Index < Profiler->Scope_Count; ++Index)
+   {
+      profile_scope *Scope = Profiler->Scopes + Index;
+      if(!Scope->Is_Gpu && Scope->Used_This_Frame)
+      {
+         Assert(!Scope->Active);
+         Record_Profile_Sample(Scope, (float)((double)Scope->Frame_Elapsed / 1e6));
+      }
+      Scope->Frame_Elapsed = 0;
+      Scope->Used_This_Frame = false;
+   }
+
+   Profiler->Frame_Index++;
+}
+
+static void Begin_Profile_Scope(profiler *Profiler, char *Name, bool Is_Gpu)
+{
+   profile_scope *Scope = Get_Profile_Scope(Profiler, Name, Is_Gpu);
+   if(Scope)
+   {
+      Assert(!Scope->Active);
+      Scope->Active = true;
+
+      if(Is_Gpu)
+      {
+         // NOTE: Only one GL_TIME_ELAPSED query can be active at a time, so
+         // GPU scopes can't nest, and each may only be used once per frame.
+         Assert(!Profiler->Gpu_Scope_Active);
+         Assert(!Scope->Used_This_Frame);
+         Profiler->Gpu_Scope_Active = true;
+
+         u32 Slot = Profiler->Frame_Index % PROFILER_QUERY_LATENCY;
+         glBeginQuery(GL_TIME_ELAPSED, Scope->Queries[Slot]);
+      }
+      else
+      {
+         Scope->Begin_Time = Get_Clock();
+      }
+      Scope->Used_This_Frame = true;
+   }
+}
+
+static void End_Profile_Scope(profiler *Profiler, char *Name, bool Is_Gpu)
+{
+   profile_scope *Scope = Get_Profile_Scope(Profiler, Name, Is_Gpu);
+   if(Scope)
+   {
+      Assert(Scope->Active);
+      Scope->Active = false;
+
+      if(Is_Gpu)
+      {
+         glEndQuery(GL_TIME_ELAPSED);
+         Profiler->Gpu_Scope_Active = false;
+
+         u32 Slot = Profiler->Frame_Index % PROFILER_QUERY_LATENCY;
+         Scope->Query_Pending[Slot] = true;
+      }
+      else
+      {
+         Scope->Frame_Elapsed += Get_Clock() - Scope->Begin_Time;
+      }
+   }
+}
+
+static int Compare_Profile_Samples(const void *A, const void *B)
+{
+   float Left = *(float *)A;
+   float Right = *(float *)B;
+
+   int Result = (Left > Right) - (Left < Right);
+   return(Result);
+}
+
+static void Write_Profiler_Report(profiler *Profiler, char *Path)
+{
+   // NOTE: Whatever the GPU has finished by now is still worth reporting.
+   Collect_Gpu_Profile_Queries(Profiler, false, 0);
+
+   FILE *File = fopen(Path, "w");
+   if(File)
+   {
+      fprintf(File, "scope,type,frames,min_ms,avg_ms,p99_ms,max_ms,dropped\n");
+
+      static float Sorted[PROFILER_MAX_SAMPLES];
+      for(int Index = 0; Index < Profiler->Scope_Count; ++Index)
+      {
+         profile_scope *Scope = Profiler->Scopes + Index;
+
+         // NOTE: Statistics cover the most recent PROFILER_MAX_SAMPLES frames.
+         u32 Count = Scope->Sample_Count;
+         if(Count > PROFILER_MAX_SAMPLES)
+         {
+            Count = PROFILER_MAX_SAMPLES;
+         }
+
+         if(Count > 0)
+         {
+            double Total = 0;
+            for(u32 Sample_Index = 0; Sample_Index < Count; ++Sample_Index)
+            {
+               Sorted[Sample_Index] = Scope->Samples[Sample_Index];
+               Total += Scope->Samples[Sample_Index];
+            }
+            qsort(Sorted, Count, sizeof(Sorted[0]), Compare_Profile_Samples);
+
+            u32 P99_Index = (u32)((Count * 99 + 99) / 100) - 1;
+            fprintf(File, "%s,%s,%u,%.4f,%.4f,%.4f,%.4f,%u\n",
+                    Scope->Name, (Scope->Is_Gpu) ? "gpu" : "cpu", Scope->Sample_Count,
+                    Sorted[0], Total / Count, Sorted[P99_Index], Sorted[Count - 1],
+                    Scope->Dropped_Query_Count);
+         }
+      }
+
+      fclose(File);
+   }
+   else
+   {
+      fprintf(stderr, "Failed to open profiler report %s.\n", Path);
+   }
+}
+
+static void Destroy_Profiler(profiler *Profiler)
+{
+   for(int Index = 0; Index < Profiler->Scope_Count; ++Index)
+   {
+      profile_scope *Scope = Profiler->Scopes + Index;
+      if(Scope->Is_Gpu)
+      {
+         glDeleteQueries(PROFILER_QUERY_LATENCY, Scope->Queries);
+      }
+   }
+   Profiler->Scope_Count = 0;
+}
+#endif
+
+static bool Opengl_Has_Extension(char *Name)
+{
+   bool Result = false;
+
+   GLint Extension_Count = 0;
+   glGetIntegerv(GL_NUM_EXTENSIONS, &Extension_Count);
+   for(GLint Index = 0; Index < Extension_Count; ++Index)
+   {
+      const char *Extension = (const char *)glGetStringi(GL_EXTENSIONS, Index);
+      if(Extension && strcmp(Extension, Name) == 0)
+      {
+         Result = true;
+         break;
+      }
+   }
+
+   return(Result);
+}
+
+static void Query_Opengl_Capabilities(opengl_capabilities *Capabilities)
+{
+   glGetIntegerv(GL_MAJOR_VERSION, &Capabilities->Major_Version);
+   glGetIntegerv(GL_MINOR_VERSION, &Capabilities->Minor_Version);
+
+   glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &Capabilities->Uniform_Buffer_Alignment);
+
+   int Version = Capabilities->Major_Version*10 + Capabilities->Minor_Version;
+   Capabilities->Has_Buffer_Storage = (Version >= 44 || Opengl_Has_Extension("GL_ARB_buffer_storage"));
+
+   // NOTE: Indirect commands only honor Base_Instance with ARB_base_instance.
+   Capabilities->Has_Multi_Draw_Indirect = (Version >= 43 ||
+                                            (Opengl_Has_Extension("GL_ARB_multi_draw_indirect") &&
+                                             (Version >= 42 || Opengl_Has_Extension("GL_ARB_base_instance"))));
+
+   // NOTE: Writes through a coherent mapping are never flushed, so the
+   // capture wouldn't see them.
+   if(Is_Opengl_Capture_Active())
+   {
+      Capabilities->Has_Buffer_Storage = false;
+   }
+}
+
+static opengl_state Opengl_State;
+
+static void Invalidate_Opengl_State(void)
+{
+   opengl_state *State = &Opengl_State;
+
+   u32 Calls_Issued = State->Calls_Issued;
+   u32 Calls_Elided = State->Calls_Elided;
+
+   // NOTE: Every name and enum becomes OPENGL_STATE_UNKNOWN (and the viewport
+   // -1), none of which the renderer ever asks for, so the next request for
+   // each one goes through.
+   memset(State, 0xFF, sizeof(*State));
+   State->Clear_Color_Known = false;
+
+   State->Calls_Issued = Calls_Issued;
+   State->Calls_Elided = Calls_Elided;
+}
+
+static bool Opengl_State_Changed(bool Changed)
+{
+   if(Changed)
+   {
+      Opengl_State.Calls_Issued++;
+   }
+   else
+   {
+      Opengl_State.Calls_Elided++;
+   }
+   return(Changed);
+}
+
+static void Use_Opengl_Program(GLuint Program)
+{
+   if(Opengl_State_Changed(Opengl_State.Program != Program))
+   {
+      glUseProgram(Program);
+      Opengl_State.Program = Program;
+   }
+}
+
+static void Bind_Opengl_Vertex_Array(GLuint Vertex_Array)
+{
+   if(Opengl_State_Changed(Opengl_State.Vertex_Array != Vertex_Array))
+   {
+      glBindVertexArray(Vertex_Array);
+      Opengl_State.Vertex_Array = Vertex_Array;
+   }
+}
+
+static void Bind_Opengl_Framebuffer(GLuint Framebuffer)
+{
+   if(Opengl_State_Changed(Opengl_State.Framebuffer != Framebuffer))
+   {
+      glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer);
+      Opengl_State.Framebuffer = Framebuffer;
+   }
+}
+
+static void Bind_Opengl_Buffer(GLenum Target, GLuint Buffer)
+{
+   opengl_buffer_slot Slot = Opengl_Buffer_Count;
+   switch(Target)
+   {
+      case GL_ARRAY_BUFFER: Slot = Opengl_Buffer_Array; break;
+      case GL_PIXEL_PACK_BUFFER: Slot = Opengl_Buffer_Pixel_Pack; break;
+      case GL_PIXEL_UNPACK_BUFFER: Slot = Opengl_Buffer_Pixel_Unpack; break;
+      case GL_UNIFORM_BUFFER: Slot = Opengl_Buffer_Uniform; break;
+      case GL_DRAW_INDIRECT_BUFFER: Slot = Opengl_Buffer_Draw_Indirect; break;
+   }
+
+   if(Slot == Opengl_Buffer_Count)
+   {
+      // NOTE: Untracked targets always go through.
+      Opengl_State.Calls_Issued++;
+      glBindBuffer(Target, Buffer);
+   }
+   else if(Opengl_State_Changed(Opengl_State.Buffers[Slot] != Buffer))
+   {
+      glBindBuffer(Target, Buffer);
+      Opengl_State.Buffers[Slot] = Buffer;
+   }
+}
+
+static void Bind_Opengl_Uniform_Range(u32 Binding, GLuint Buffer, size Offset, size Size)
+{
+   // NOTE: Each binding point is only ever given blocks of one size, so the
+   // size isn't tracked.
+   Assert(Binding < OPENGL_MAX_UNIFORM_BINDINGS);
+   if(Opengl_State_Changed(Opengl_State.Uniform_Buffers[Binding] != Buffer || Opengl_State.Uniform_Offsets[Binding] != Offset))
+   {
+      glBindBufferRange(GL_UNIFORM_BUFFER, Binding, Buffer, Offset, Size);
+      Opengl_State.Uniform_Buffers[Binding] = Buffer;
+      Opengl_State.Uniform_Offsets[Binding] = Offset;
+
+      // NOTE: Binding a range replaces the generic binding as well.
+      Opengl_State.Buffers[Opengl_Buffer_Uniform] = Buffer;
+   }
+}
+
+static void Bind_Opengl_Texture(u32 Unit, GLenum Target, GLuint Texture)
+{
+   // NOTE: Each unit is assumed to be used with a single target.
+   Assert(Unit < OPENGL_MAX_TEXTURE_UNITS);
+
+   if(Opengl_State.Textures[Unit] != Texture)
+   {
+      if(Opengl_State_Changed(Opengl_State.Active_Texture != GL_TEXTURE0 + Unit))
+      {
+         glActiveTexture(GL_TEXTURE0 + Unit);
+         Opengl_State.Active_Texture = GL_TEXTURE0 + Unit;
+      }
+   }
+
+   if(Opengl_State_Changed(Opengl_State.Textures[Unit] != Texture))
+   {
+      glBindTexture(Target, Texture);
+      Opengl_State.Textures[Unit] = Texture;
+   }
+}
+
+static void Set_Opengl_Capability(GLenum Capability, GLuint *Current, bool Enabled)
+{
+   if(Opengl_State_Changed(*Current != (GLuint)Enabled))
+   {
+      if(Enabled)
+      {
+         glEnable(Capability);
+      }
+      else
+      {
+         glDisable(Capability);
+      }
+      *Current = Enabled;
+   }
+}
+
+static void Set_Opengl_Blend(bool Enabled, GLenum Source, GLenum Dest)
+{
+   opengl_state *State = &Opengl_State;
+   Set_Opengl_Capability(GL_BLEND, &State->Blend_Enabled, Enabled);
+
+   // NOTE: The blend function is left alone while blending is off.
+   if(Enabled && Opengl_State_Changed(State->Blend_Source != Source || State->Blend_Dest != Dest))
+   {
+      glBlendFunc(Source, Dest);
+      State->Blend_Source = Source;
+      State->Blend_Dest = Dest;
+   }
+}
+
+static void Set_Opengl_Depth(bool Test_Enabled, bool Write_Enabled, GLenum Function)
+{
+   opengl_state *State = &Opengl_State;
+   Set_Opengl_Capability(GL_DEPTH_TEST, &State->Depth_Test_Enabled, Test_Enabled);
+
+   if(Opengl_State_Changed(State->Depth_Write_Enabled != (GLuint)Write_Enabled))
+   {
+      glDepthMask(Write_Enabled ? GL_TRUE : GL_FALSE);
+      State->Depth_Write_Enabled = Write_Enabled;
+   }
+
+   if(Test_Enabled && Opengl_State_Changed(State->Depth_Function != Function))
+   {
+      glDepthFunc(Function);
+      State->Depth_Function = Function;
+   }
+}
+
+static void Set_Opengl_Cull(bool Enabled, GLenum Face)
+{
+   opengl_state *State = &Opengl_State;
+   Set_Opengl_Capability(GL_CULL_FACE, &State->Cull_Enabled, Enabled);
+
+   if(Enabled && Opengl_State_Changed(State->Cull_Face != Face))
+   {
+      glCullFace(Face);
+      State->Cull_Face = Face;
+   }
+}
+
+static void Set_Opengl_Viewport(GLint X, GLint Y, GLint Width, GLint Height)
+{
+   GLint *Viewport = Opengl_State.Viewport;
+   if(Opengl_State_Changed(Viewport[0] != X || Viewport[1] != Y || Viewport[2] != Width || Viewport[3] != Height))
+   {
+      glViewport(X, Y, Width, Height);
+      Viewport[0] = X;
+      Viewport[1] = Y;
+      Viewport[2] = Width;
+      Viewport[3] = Height;
+   }
+}
+
+static void Set_Opengl_Scissor(bool Enabled, GLint X, GLint Y, GLint Width, GLint Height)
+{
+   opengl_state *State = &Opengl_State;
+   Set_Opengl_Capability(GL_SCISSOR_TEST, &State->Scissor_Enabled, Enabled);
+
+   // NOTE: Like the blend function, the box is left alone while it's off.
+   GLint *Scissor = State->Scissor;
+   if(Enabled && Opengl_State_Changed(Scissor[0] != X || Scissor[1] != Y || Scissor[2] != Width || Scissor[3] != Height))
+   {
+      glScissor(X, Y, Width, Height);
+      Scissor[0] = X;
+      Scissor[1] = Y;
+      Scissor[2] = Width;
+      Scissor[3] = Height;
+   }
+}
+
+static void Set_Opengl_Clear_Color(vec4 Color)
+{
+   opengl_state *State = &Opengl_State;
+   vec4 Current = State->Clear_Color;
+
+   bool Changed = (!State->Clear_Color_Known ||
+                   Current.R != Color.R || Current.G != Color.G ||
+                   Current.B != Color.B || Current.A != Color.A);
+
+   if(Opengl_State_Changed(Changed))
+   {
+      glClearColor(Color.R, Color.G, Color.B, Color.A);
+      State->Clear_Color = Color;
+      State->Clear_Color_Known = true;
+   }
+}
+
+static void Initialize_Opengl_Stream(opengl_stream_buffer *Stream, opengl_capabilities *Capabilities, GLenum Target, size Partition_Size)
+{
+   Stream->Target = Target;
+   Stream->Partition_Size = Partition_Size;
+   Stream->Persistent = Capabilities->Has_Buffer_Storage;
+
+   size Total_Size = Partition_Size * OPENGL_STREAM_PARTITION_COUNT;
+
+   glGenBuffers(1, &Stream->Buffer);
+   Bind_Opengl_Buffer(Target, Stream->Buffer);
+   if(Stream->Persistent)
+   {
+      GLbitfield Flags = GL_MAP_WRITE_BIT|GL_MAP_PERSISTENT_BIT|GL_MAP_COHERENT_BIT;
+      glBufferStorage(Target, Total_Size, 0, Flags);
+      Stream->Persistent_Base = glMapBufferRange(Target, 0, Total_Size, Flags);
+
+      if(!Stream->Persistent_Base)
+      {
+         // NOTE: Immutable storage can't be respecified, so falling back to
+         // the unsynchronized path needs a fresh buffer.
+         fprintf(stderr, "Failed to persistently map stream buffer, falling back to unsynchronized mapping.\n");
+         glDeleteBuffers(1, &Stream->Buffer);
+         glGenBuffers(1, &Stream->Buffer);
+         Bind_Opengl_Buffer(Target, Stream->Buffer);
+         Stream->Persistent = false;
+      }
+   }
+
+   if(!Stream->Persistent)
+   {
+      glBufferData(Target, Total_Size, 0, GL_STREAM_DRAW);
+   }
+   Bind_Opengl_Buffer(Target, 0);
+
+   // NOTE: Start on the last partition so the first Begin lands on zero.
+   Stream->Partition_Index = OPENGL_STREAM_PARTITION_COUNT - 1;
+   GL_CHECK;
+}
+
+static void Destroy_Opengl_Stream(opengl_stream_buffer *Stream)
+{
+   for(int Index = 0; Index < OPENGL_STREAM_PARTITION_COUNT; ++Index)
+   {
+      if(Stream->Fences[Index])
+      {
+         glDeleteSync(Stream->Fences[Index]);
+      }
+   }
+
+   if(Stream->Persistent_Base || Stream->Mapped)
+   {
+      Bind_Opengl_Buffer(Stream->Target, Stream->Buffer);
+      glUnmapBuffer(Stream->Target);
+      Bind_Opengl_Buffer(Stream->Target, 0);
+   }
+   glDeleteBuffers(1, &Stream->Buffer);
+   Invalidate_Opengl_State();
+
+   opengl_stream_buffer Zero = {0};
+   *Stream = Zero;
+}
+
+static void Begin_Opengl_Stream(opengl_stream_buffer *Stream)
+{
+   Assert(!Stream->Mapped);
+
+   // NOTE: Everything that reads the previous partition has been submitted by
+   // now, so this is where its fence goes.
+   if(Stream->Partition_Active)
+   {
+      Stream->Fences[Stream->Partition_Index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+   }
+
+   Stream->Partition_Index = (Stream->Partition_Index + 1) % OPENGL_STREAM_PARTITION_COUNT;
+   Stream->Partition_Active = true;
+   Stream->Used = 0;
+
+   GLsync Fence = Stream->Fences[Stream->Partition_Index];
+   if(Fence)
+   {
+      GLenum Status = glClientWaitSync(Fence, 0, 0);
+      if(Status == GL_TIMEOUT_EXPIRED)
+      {
+         // NOTE: The GPU is still reading this partition from
+         // OPENGL_STREAM_PARTITION_COUNT frames ago. This is the only place
+         // the stream can ever block the CPU.
+         Stream->Fence_Wait_Count++;
+         glClientWaitSync(Fence, GL_SYNC_FLUSH_COMMANDS_BIT, ~(GLuint64)0);
+      }
+      glDeleteSync(Fence);
+      Stream->Fences[Stream->Partition_Index] = 0;
+   }
+
+   size Partition_Offset = Stream->Partition_Index * Stream->Partition_Size;
+   if(Stream->Persistent)
+   {
+      Stream->Mapped = Stream->Persistent_Base + Partition_Offset;
+   }
+   else
+   {
+      GLbitfield Flags = GL_MAP_WRITE_BIT|GL_MAP_UNSYNCHRONIZED_BIT|GL_MAP_INVALIDATE_RANGE_BIT|GL_MAP_FLUSH_EXPLICIT_BIT;
+
+      Bind_Opengl_Buffer(Stream->Target, Stream->Buffer);
+      Stream->Mapped = glMapBufferRange(Stream->Target, Partition_Offset, Stream->Partition_Size, Flags);
+
+      if(!Stream->Mapped)
+      {
+         fprintf(stderr, "Failed to map stream buffer partition.\n");
+      }
+   }
+}
+
+static void *Push_Opengl_Stream(opengl_stream_buffer *Stream, size Size, size Alignment, size *Buffer_Offset)
+{
+   void *Result = 0;
+
+   if(Stream->Mapped)
+   {
+      size Aligned = (Stream->Used + (Alignment - 1)) & ~(Alignment - 1);
+      if(Aligned + Size <= Stream->Partition_Size)
+      {
+         Result = Stream->Mapped + Aligned;
+         *Buffer_Offset = Stream->Partition_Index*Stream->Partition_Size + Aligned;
+
+         Stream->Used = Aligned + Size;
+         Stream->Bytes_Pushed += Size;
+      }
+      else
+      {
+         Stream->Overflow_Count++;
+      }
+   }
+
+   return(Result);
+}
+
+static void End_Opengl_Stream(opengl_stream_buffer *Stream)
+{
+   if(Stream->Mapped && !Stream->Persistent)
+   {
+      Bind_Opengl_Buffer(Stream->Target, Stream->Buffer);
+      if(Stream->Used > 0)
+      {
+         glFlushMappedBufferRange(Stream->Target, 0, Stream->Used);
+      }
+      glUnmapBuffer(Stream->Target);
+   }
+
+   // NOTE: With a coherent persistent mapping there's nothing to flush, but
+   // clearing the pointer catches writes after the partition is submitted.
+   Stream->Mapped = 0;
+}
+
+// NOTE: Replaces a begun stream with one whose partitions are doubled until
+// they hold at least Size bytes, and begins its first partition. Anything
+// pushed to the old partition is lost, so this has to come before the frame's
+// first push. Partitions the GPU is still reading stay alive until it's done,
+// since deleting a buffer only deletes our name for it.
+static void Grow_Opengl_Stream(opengl_stream_buffer *Stream, opengl_capabilities *Capabilities, size Size)
 {
-   GLint Shader_Status;
-   GLchar Message[256];
+   Assert(Stream->Used == 0);
+   End_Opengl_Stream(Stream);
+
+   opengl_stream_buffer Old = *Stream;
+   size Partition_Size = Stream->Partition_Size;
+   while(Partition_Size < Size)
+   {
+      Partition_Size *= 2;
+   }
 
-   // TODO: Better shader managment.
-   const GLchar *Vertex_Shader_Code = Read_Entire_File("shaders/basic.vert");
-   Assert(Vertex_Shader_Code);
+   Destroy_Opengl_Stream(Stream);
+   Initialize_Opengl_Stream(Stream, Capabilities, Old.Target, Partition_Size);
+   Stream->Bytes_Pushed = Old.Bytes_Pushed;
+   Stream->Fence_Wait_Count = Old.Fence_Wait_Count;
+   Stream->Overflow_Count = Old.Overflow_Count;
+   Begin_Opengl_Stream(Stream);
+}
+
+// NOTE: Ahead of the stream pushes below, which report their bounds to it.
+#include "opengl_damage.c"
 
-   GLuint Vertex_Shader = glCreateShader(GL_VERTEX_SHADER);
-   glShaderSource(Vertex_Shader, 1, &Vertex_Shader_Code, 0);
-   glCompileShader(Vertex_Shader);
+static vertex *Push_Vertices(opengl_context *GL, u32 Count)
+{
+   // NOTE: Unlike render commands, the vertex stream is shared, so dynamic
+   // geometry can only be pushed from the main thread.
+   Assert(Get_Thread_Index() == 0);
 
-   glGetShaderiv(Vertex_Shader, GL_COMPILE_STATUS, &Shader_Status);
-   if(!Shader_Status)
+   size Offset = 0;
+   vertex *Result = Push_Opengl_Stream(&GL->Vertex_Stream, Count*sizeof(vertex), sizeof(float), &Offset);
+   if(Result)
    {
-      glGetShaderInfoLog(Vertex_Shader, sizeof(Message), 0, Message);
-      fprintf(stderr, "%s\n", Message);
-      Assert(0);
+      if(GL->Stream_Vertex_Count == 0)
+      {
+         GL->Stream_Vertex_Base = Offset;
+      }
+      GL->Stream_Vertex_Count += Count;
    }
 
-   // TODO: Better shader managment.
-   const GLchar *Fragment_Shader_Code = Read_Entire_File("shaders/basic.frag");
-   Assert(Fragment_Shader_Code);
+   return(Result);
+}
+
+static void Push_Quad(opengl_context *GL, vec2 Min, vec2 Max, vec4 Color)
+{
+   vertex *Vertices = Push_Vertices(GL, 6);
+   if(Vertices)
+   {
+      // NOTE: Built on the stack and copied, since damage tracking reads the
+      // vertices back and the stream may be write-combined memory.
+      vertex Quad[6] =
+         {
+            {{Min.X, Min.Y}, Color},
+            {{Max.X, Min.Y}, Color},
+            {{Max.X, Max.Y}, Color},
+            {{Min.X, Min.Y}, Color},
+            {{Max.X, Max.Y}, Color},
+            {{Min.X, Max.Y}, Color},
+         };
+      memcpy(Vertices, Quad, sizeof(Quad));
+      Track_Opengl_Stream_Damage(GL, Quad, Array_Count(Quad));
+   }
+}
+
+static void Push_Line(opengl_context *GL, vec2 From, vec2 To, float Thickness, vec4 Color)
+{
+   float Delta_X = To.X - From.X;
+   float Delta_Y = To.Y - From.Y;
+   float Length = sqrtf(Delta_X*Delta_X + Delta_Y*Delta_Y);
+   if(Length > 0.0f)
+   {
+      // NOTE: Lines are expanded into quads so they share the triangle
+      // stream and its single draw call.
+      float Scale = 0.5f*Thickness / Length;
+      vec2 Normal = {-Delta_Y*Scale, Delta_X*Scale};
+
+      vertex *Vertices = Push_Vertices(GL, 6);
+      if(Vertices)
+      {
+         vertex Quad[6] =
+            {
+               {{From.X - Normal.X, From.Y - Normal.Y}, Color},
+               {{To.X - Normal.X, To.Y - Normal.Y}, Color},
+               {{To.X + Normal.X, To.Y + Normal.Y}, Color},
+               {{From.X - Normal.X, From.Y - Normal.Y}, Color},
+               {{To.X + Normal.X, To.Y + Normal.Y}, Color},
+               {{From.X + Normal.X, From.Y + Normal.Y}, Color},
+            };
+         memcpy(Vertices, Quad, sizeof(Quad));
+         Track_Opengl_Stream_Damage(GL, Quad, Array_Count(Quad));
+      }
+   }
+}
+
+#include "opengl_shaders.c"
+
+static struct
+{
+   GLenum Type;
+   GLboolean Normalized;
+   bool Integer;
+} Opengl_Vertex_Attribute_Types[Vertex_Attribute_Type_Count] =
+{
+   [Vertex_Attribute_Float32]          = {GL_FLOAT, GL_FALSE, false},
+   [Vertex_Attribute_Float16]          = {GL_HALF_FLOAT, GL_FALSE, false},
+   [Vertex_Attribute_Unorm8]           = {GL_UNSIGNED_BYTE, GL_TRUE, false},
+   [Vertex_Attribute_Snorm_10_10_10_2] = {GL_INT_2_10_10_10_REV, GL_TRUE, false},
+   [Vertex_Attribute_Uint32]           = {GL_UNSIGNED_INT, GL_FALSE, true},
+};
+
+// NOTE: Indexed by mesh_vertex_format, so mesh files pick their layout by
+// number.
+static vertex_layout Opengl_Vertex_Layouts[Mesh_Vertex_Format_Count] =
+{
+   [Mesh_Vertex_Format_Standard] =
+   {
+      "standard", sizeof(vertex), 0, 2,
+      {
+         {0, Vertex_Attribute_Float32, 2, offsetof(vertex, Position)},
+         {1, Vertex_Attribute_Float32, 4, offsetof(vertex, Color)},
+      },
+   },
+   [Mesh_Vertex_Format_Compact] =
+   {
+      "compact", sizeof(compact_vertex), 0, 2,
+      {
+         {0, Vertex_Attribute_Float16, 2, offsetof(compact_vertex, Position)},
+         {1, Vertex_Attribute_Unorm8, 4, offsetof(compact_vertex, Color)},
+      },
+   },
+};
+
+static vertex_layout Opengl_Instance_Layout =
+{
+   "instance", sizeof(opengl_instance), 1, 4,
+   {
+      {2, Vertex_Attribute_Float32, 4, offsetof(opengl_instance, Basis_X)},
+      {3, Vertex_Attribute_Float32, 4, offsetof(opengl_instance, Color)},
+      {4, Vertex_Attribute_Float32, 2, offsetof(opengl_instance, Offset)},
+      {5, Vertex_Attribute_Uint32, 1, offsetof(opengl_instance, Material)},
+   },
+};
+
+// NOTE: Points the layout's attributes at Buffer, starting Base bytes in, for
+// the currently bound VAO.
+static void Bind_Opengl_Vertex_Layout(vertex_layout *Layout, GLuint Buffer, size Base)
+{
+   Bind_Opengl_Buffer(GL_ARRAY_BUFFER, Buffer);
+   for(u32 Index = 0; Index < Layout->Attribute_Count; ++Index)
+   {
+      vertex_attribute *Attribute = Layout->Attributes + Index;
+      GLvoid *Pointer = (GLvoid *)(Base + Attribute->Offset);
+
+      GLenum Type = Opengl_Vertex_Attribute_Types[Attribute->Type].Type;
+      if(Opengl_Vertex_Attribute_Types[Attribute->Type].Integer)
+      {
+         glVertexAttribIPointer(Attribute->Location, Attribute->Component_Count, Type, Layout->Stride, Pointer);
+      }
+      else
+      {
+         GLboolean Normalized = Opengl_Vertex_Attribute_Types[Attribute->Type].Normalized;
+         glVertexAttribPointer(Attribute->Location, Attribute->Component_Count, Type, Normalized, Layout->Stride, Pointer);
+      }
+      glEnableVertexAttribArray(Attribute->Location);
+      if(Layout->Divisor)
+      {
+         glVertexAttribDivisor(Attribute->Location, Layout->Divisor);
+      }
+   }
+   Bind_Opengl_Buffer(GL_ARRAY_BUFFER, 0);
+}
+
+static void Bind_Opengl_Mesh_Attributes(opengl_mesh *Mesh)
+{
+   Bind_Opengl_Vertex_Layout(Mesh->Layout, Mesh->VBO, 0);
+
+   if(Mesh->EBO)
+   {
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Mesh->EBO);
+   }
+}
+
+static void Get_Vertex_Bounds(vertex *Vertices, u32 Vertex_Count, vec2 *Min, vec2 *Max)
+{
+   *Min = *Max = Vertices[0].Position;
+   for(u32 Index = 1; Index < Vertex_Count; ++Index)
+   {
+      vec2 Position = Vertices[Index].Position;
+      if(Position.X < Min->X) Min->X = Position.X;
+      if(Position.Y < Min->Y) Min->Y = Position.Y;
+      if(Position.X > Max->X) Max->X = Position.X;
+      if(Position.Y > Max->Y) Max->Y = Position.Y;
+   }
+}
+
+static void Initialize_Opengl_Mesh(opengl_mesh *Mesh, vertex *Vertices, u32 Vertex_Count, u16 *Indices, u32 Index_Count)
+{
+   Mesh->Index_Type = GL_UNSIGNED_SHORT;
+   Mesh->Layout = Opengl_Vertex_Layouts + Mesh_Vertex_Format_Standard;
+   Mesh->Vertex_Count = Vertex_Count;
+   Mesh->Index_Count = Index_Count;
+   Get_Vertex_Bounds(Vertices, Vertex_Count, &Mesh->Bounds_Min, &Mesh->Bounds_Max);
+
+   Mesh->Lod_Count = 1;
+   Mesh->Lods[0].First_Index = 0;
+   Mesh->Lods[0].Index_Count = Index_Count;
+
+   glGenBuffers(1, &Mesh->VBO);
+   Bind_Opengl_Buffer(GL_ARRAY_BUFFER, Mesh->VBO);
+   glBufferData(GL_ARRAY_BUFFER, Vertex_Count*sizeof(vertex), Vertices, GL_STATIC_DRAW);
+   Bind_Opengl_Buffer(GL_ARRAY_BUFFER, 0);
+
+   if(Index_Count > 0)
+   {
+      // NOTE: Unbind any VAO first, so this doesn't disturb its element array
+      // binding.
+      Bind_Opengl_Vertex_Array(0);
+      glGenBuffers(1, &Mesh->EBO);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Mesh->EBO);
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, Index_Count*sizeof(u16), Indices, GL_STATIC_DRAW);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+   }
+
+   glGenVertexArrays(1, &Mesh->VAO);
+   Bind_Opengl_Vertex_Array(Mesh->VAO);
+   Bind_Opengl_Mesh_Attributes(Mesh);
+   Bind_Opengl_Vertex_Array(0);
+}
+
+static void Destroy_Opengl_Mesh(opengl_mesh *Mesh)
+{
+   glDeleteVertexArrays(1, &Mesh->VAO);
+   glDeleteBuffers(1, &Mesh->VBO);
+   glDeleteBuffers(1, &Mesh->EBO);
+   Invalidate_Opengl_State();
+
+   opengl_mesh Zero = {0};
+   *Mesh = Zero;
+}
+
+static void Initialize_Opengl_Instance_Batch(opengl_instance_batch *Batch, opengl_mesh *Mesh, opengl_instance *Instances, u32 Count)
+{
+   Batch->Mesh = Mesh;
+   Batch->Count = Count;
+   Batch->Instances = Instances;
+
+   glGenBuffers(1, &Batch->Instance_Buffer);
+   Bind_Opengl_Buffer(GL_ARRAY_BUFFER, Batch->Instance_Buffer);
+   glBufferData(GL_ARRAY_BUFFER, Count*sizeof(opengl_instance), Instances, GL_STATIC_DRAW);
+   Bind_Opengl_Buffer(GL_ARRAY_BUFFER, 0);
+
+   glGenVertexArrays(1, &Batch->VAO);
+   Bind_Opengl_Vertex_Array(Batch->VAO);
+
+   Bind_Opengl_Mesh_Attributes(Mesh);
+   Bind_Opengl_Vertex_Layout(&Opengl_Instance_Layout, Batch->Instance_Buffer, 0);
+   Bind_Opengl_Vertex_Array(0);
+   GL_CHECK;
+}
+
+static void Update_Opengl_Instance_Batch(opengl_instance_batch *Batch, u32 First, u32 Count)
+{
+   Assert(First + Count <= Batch->Count);
+
+   Bind_Opengl_Buffer(GL_ARRAY_BUFFER, Batch->Instance_Buffer);
+   glBufferSubData(GL_ARRAY_BUFFER, First*sizeof(opengl_instance), Count*sizeof(opengl_instance), Batch->Instances + First);
+}
+
+static void Destroy_Opengl_Instance_Batch(opengl_instance_batch *Batch)
+{
+   glDeleteVertexArrays(1, &Batch->VAO);
+   glDeleteBuffers(1, &Batch->Instance_Buffer);
+   Invalidate_Opengl_State();
+
+   opengl_instance_batch Zero = {0};
+   *Batch = Zero;
+}
+
+static void Initialize_Opengl_Mesh_Pool(opengl_mesh_pool *Pool, vertex_layout *Layout, GLenum Index_Type, u32 Vertex_Capacity, u32 Index_Capacity)
+{
+   Assert(Index_Type == GL_UNSIGNED_SHORT || Index_Type == GL_UNSIGNED_INT);
+   Pool->Layout = Layout;
+   Pool->Index_Type = Index_Type;
+   Pool->Index_Size = (Index_Type == GL_UNSIGNED_INT) ? sizeof(u32) : sizeof(u16);
+   Pool->Vertex_Capacity = Vertex_Capacity;
+   Pool->Index_Capacity = Index_Capacity;
+
+   glGenBuffers(1, &Pool->VBO);
+   Bind_Opengl_Buffer(GL_ARRAY_BUFFER, Pool->VBO);
+   glBufferData(GL_ARRAY_BUFFER, (size)Vertex_Capacity*Layout->Stride, 0, GL_STATIC_DRAW);
+   Bind_Opengl_Buffer(GL_ARRAY_BUFFER, 0);
+
+   Bind_Opengl_Vertex_Array(0);
+   glGenBuffers(1, &Pool->EBO);
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Pool->EBO);
+   glBufferData(GL_ELEMENT_ARRAY_BUFFER, (size)Index_Capacity*Pool->Index_Size, 0, GL_STATIC_DRAW);
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
 
-   GLuint Fragment_Shader = glCreateShader(GL_FRAGMENT_SHADER);
-   glShaderSource(Fragment_Shader, 1, &Fragment_Shader_Code, 0);
-   glCompileShader(Fragment_Shader);
+// NOTE: Copies Vertex_Count vertices laid out as Layout and Index_Count indices
+// of Index_Type into the pool. Bounds cover the vertex positions, since the
+// pool can't read them out of an arbitrary layout. Returns a handle for
+// Push_Indirect_Draw, or 0 when the mesh doesn't match the pool or the pool is
+// full.
+static u32 Add_Opengl_Pool_Mesh(opengl_mesh_pool *Pool, vertex_layout *Layout, void *Vertices, u32 Vertex_Count,
+                                GLenum Index_Type, void *Indices, u32 Index_Count, vec2 Bounds_Min, vec2 Bounds_Max)
+{
+   u32 Result = 0;
 
-   glGetShaderiv(Fragment_Shader, GL_COMPILE_STATUS, &Shader_Status);
-   if(!Shader_Status)
+   if(Layout != Pool->Layout || Index_Type != Pool->Index_Type)
    {
-      glGetShaderInfoLog(Fragment_Shader, sizeof(Message), 0, Message);
-      fprintf(stderr, "%s\n", Message);
-      Assert(0);
+      fprintf(stderr, "Mesh with %s vertices and %u-bit indices doesn't match a pool of %s vertices and %u-bit indices.\n",
+              Layout->Name, (Index_Type == GL_UNSIGNED_INT) ? 32 : 16, Pool->Layout->Name, Pool->Index_Size*8);
    }
+   else if(Pool->Mesh_Count < OPENGL_MESH_POOL_MAX_MESHES &&
+           Vertex_Count <= Pool->Vertex_Capacity - Pool->Vertex_Count &&
+           Index_Count <= Pool->Index_Capacity - Pool->Index_Count)
+   {
+      opengl_pool_mesh *Mesh = Pool->Meshes + Pool->Mesh_Count++;
+      Mesh->First_Index = Pool->Index_Count;
+      Mesh->Index_Count = Index_Count;
+      Mesh->Base_Vertex = (s32)Pool->Vertex_Count;
+      Mesh->Vertex_Count = Vertex_Count;
+
+      if(Pool->Vertex_Count == 0)
+      {
+         Pool->Bounds_Min = Bounds_Min;
+         Pool->Bounds_Max = Bounds_Max;
+      }
+      if(Bounds_Min.X < Pool->Bounds_Min.X) Pool->Bounds_Min.X = Bounds_Min.X;
+      if(Bounds_Min.Y < Pool->Bounds_Min.Y) Pool->Bounds_Min.Y = Bounds_Min.Y;
+      if(Bounds_Max.X > Pool->Bounds_Max.X) Pool->Bounds_Max.X = Bounds_Max.X;
+      if(Bounds_Max.Y > Pool->Bounds_Max.Y) Pool->Bounds_Max.Y = Bounds_Max.Y;
+
+      size Stride = Layout->Stride;
+      Bind_Opengl_Buffer(GL_ARRAY_BUFFER, Pool->VBO);
+      glBufferSubData(GL_ARRAY_BUFFER, Pool->Vertex_Count*Stride, Vertex_Count*Stride, Vertices);
+      Bind_Opengl_Buffer(GL_ARRAY_BUFFER, 0);
 
-   GL->Shader_Program = glCreateProgram();
-   glAttachShader(GL->Shader_Program, Vertex_Shader);
-   glAttachShader(GL->Shader_Program, Fragment_Shader);
-   glLinkProgram(GL->Shader_Program);
+      size Index_Size = Pool->Index_Size;
+      Bind_Opengl_Vertex_Array(0);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Pool->EBO);
+      glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, Pool->Index_Count*Index_Size, Index_Count*Index_Size, Indices);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-   glGetProgramiv(GL->Shader_Program, GL_LINK_STATUS, &Shader_Status);
-   if(!Shader_Status)
+      Pool->Vertex_Count += Vertex_Count;
+      Pool->Index_Count += Index_Count;
+      Result = Pool->Mesh_Count;
+   }
+   else
    {
-      glGetProgramInfoLog(GL->Shader_Program, sizeof(Message), 0, Message);
-      fprintf(stderr, "%s\n", Message);
-      Assert(0);
+      fprintf(stderr, "Mesh pool is full (%u meshes, %u vertices, %u indices).\n",
+              Pool->Mesh_Count, Pool->Vertex_Count, Pool->Index_Count);
    }
 
-   glDeleteShader(Vertex_Shader);
-   glDeleteShader(Fragment_Shader);
+   return(Result);
+}
+
+// NOTE: Adds the full detail LOD of a validated mesh file, straight from its
+// mapping.
+static u32 Add_Opengl_Pool_Mesh_File(opengl_mesh_pool *Pool, mesh_file_header *Header)
+{
+   u8 *File = (u8 *)Header;
+   mesh_file_lod *Lod = Header->Lods + 0;
+   GLenum Index_Type = (Header->Index_Size == 4) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+
+   u32 Result = Add_Opengl_Pool_Mesh(Pool, Opengl_Vertex_Layouts + Header->Vertex_Format,
+                                     File + Header->Vertex_Offset, Header->Vertex_Count,
+                                     Index_Type, File + Header->Index_Offset + (size)Lod->First_Index*Header->Index_Size,
+                                     Lod->Index_Count, Header->Bounds_Min, Header->Bounds_Max);
+   return(Result);
+}
+
+static void Destroy_Opengl_Mesh_Pool(opengl_mesh_pool *Pool)
+{
+   glDeleteBuffers(1, &Pool->VBO);
+   glDeleteBuffers(1, &Pool->EBO);
+   Invalidate_Opengl_State();
+
+   opengl_mesh_pool Zero = {0};
+   *Pool = Zero;
+}
+
+static void Initialize_Opengl_Indirect_Batch(opengl_indirect_batch *Batch, opengl_mesh_pool *Pool, arena *Arena, u32 Capacity)
+{
+   Batch->Pool = Pool;
+   Batch->Capacity = Capacity;
+   Batch->Commands = Push_Array(Arena, Capacity, opengl_draw_command);
+   Batch->Instances = Push_Array(Arena, Capacity, opengl_instance);
+
+   glGenBuffers(1, &Batch->Command_Buffer);
+   glGenBuffers(1, &Batch->Instance_Buffer);
+
+   glGenVertexArrays(1, &Batch->VAO);
+   Bind_Opengl_Vertex_Array(Batch->VAO);
+   Bind_Opengl_Vertex_Layout(Pool->Layout, Pool->VBO, 0);
+   Bind_Opengl_Vertex_Layout(&Opengl_Instance_Layout, Batch->Instance_Buffer, 0);
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, Pool->EBO);
+   Bind_Opengl_Vertex_Array(0);
+   GL_CHECK;
+}
+
+static void Reset_Opengl_Indirect_Batch(opengl_indirect_batch *Batch)
+{
+   Batch->Count = 0;
+}
+
+static void Destroy_Opengl_Indirect_Batch(opengl_indirect_batch *Batch)
+{
+   glDeleteVertexArrays(1, &Batch->VAO);
+   glDeleteBuffers(1, &Batch->Command_Buffer);
+   glDeleteBuffers(1, &Batch->Instance_Buffer);
+   Invalidate_Opengl_State();
+
+   opengl_indirect_batch Zero = {0};
+   *Batch = Zero;
+}
+
+#include "opengl_meshes.c"
+#include "opengl_textures.c"
+#include "opengl_text.c"
+#include "opengl_culling.c"
+#include "opengl_graph.c"
+#include "opengl_commands.c"
+
+static INITIALIZE_OPENGL(Initialize_Opengl)
+{
+   GL->Memory = Memory;
+
+   // NOTE: Nothing is assumed about the state the platform left behind.
+   Invalidate_Opengl_State();
+   Query_Opengl_Capabilities(&GL->Capabilities);
+
+   Initialize_Opengl_Program_Cache(&GL->Program_Cache);
+   Initialize_Opengl_Shaders(GL);
+
+   GL->Basic_Program = Add_Opengl_Program(GL, "shaders/basic.vert", "shaders/basic.frag", 0);
+   GL->Instanced_Program = Add_Opengl_Program(GL, "shaders/basic.vert", "shaders/basic.frag", "#define INSTANCED 1\n");
+   GL->Per_Object_Program = Add_Opengl_Program(GL, "shaders/basic.vert", "shaders/basic.frag", "#define PER_OBJECT 1\n");
+   GL->Textured_Program = Add_Opengl_Program(GL, "shaders/basic.vert", "shaders/basic.frag", "#define PER_OBJECT 1\n#define TEXTURED 1\n");
+   GL->Text_Program = Add_Opengl_Program(GL, "shaders/text.vert", "shaders/text.frag", 0);
+   GL->Post_Copy_Program = Add_Opengl_Program(GL, "shaders/post.vert", "shaders/post.frag", 0);
+   GL->Post_Bright_Program = Add_Opengl_Program(GL, "shaders/post.vert", "shaders/post.frag", "#define BRIGHT 1\n");
+   GL->Post_Blur_X_Program = Add_Opengl_Program(GL, "shaders/post.vert", "shaders/post.frag", "#define BLUR_X 1\n");
+   GL->Post_Blur_Y_Program = Add_Opengl_Program(GL, "shaders/post.vert", "shaders/post.frag", "#define BLUR_Y 1\n");
 
-   typedef struct {
-      vec2 Position;
-      vec4 Color;
-   } vertex;
+   // NOTE: The first frame needs every program, so startup waits for all of
+   // them. Later rebuilds are picked up by Begin_Opengl_Frame when ready.
+   Update_Opengl_Shaders(GL, true);
 
    vertex Vertices[] =
       {
@@ -88,34 +1153,256 @@ static INITIALIZE_OPENGL(Initialize_Opengl)
          {{+0.5f, -0.5f}, {0, 1, 1, 1}},
          {{+0.0f, +0.5f}, {1, 0, 1, 1}},
       };
+   Initialize_Opengl_Mesh(&GL->Triangle_Mesh, Vertices, Array_Count(Vertices), 0, 0);
 
-   glGenBuffers(1, &GL->VBO);
-   glBindBuffer(GL_ARRAY_BUFFER, GL->VBO);
-   glBufferData(GL_ARRAY_BUFFER, sizeof(Vertices), Vertices, GL_STATIC_DRAW);
+   vertex Quad_Vertices[] =
+      {
+         {{-0.5f, -0.5f}, {1, 1, 1, 1}},
+         {{+0.5f, -0.5f}, {1, 1, 1, 1}},
+         {{+0.5f, +0.5f}, {1, 1, 1, 1}},
+         {{-0.5f, +0.5f}, {1, 1, 1, 1}},
+      };
+   u16 Quad_Indices[] = {0, 1, 2, 0, 2, 3};
+   Initialize_Opengl_Mesh(&GL->Quad_Mesh, Quad_Vertices, Array_Count(Quad_Vertices), Quad_Indices, Array_Count(Quad_Indices));
+
+   Initialize_Render_Commands(&GL->Commands, &Memory->Permanent, &Memory->Frame);
+   GL->Meshes.Upload_Budget = OPENGL_MESH_UPLOAD_BUDGET;
+   Initialize_Opengl_Textures(GL);
+   Initialize_Opengl_Text(GL);
+   Initialize_Opengl_Graph(GL);
+
+   // NOTE: The stream VAO's attribute offsets move with the stream partition,
+   // so they are respecified by each stream draw command.
+   Initialize_Opengl_Stream(&GL->Vertex_Stream, &GL->Capabilities, GL_ARRAY_BUFFER, OPENGL_STREAM_PARTITION_SIZE);
 
-   glGenVertexArrays(1, &GL->VAO);
-   glBindVertexArray(GL->VAO);
+   glGenVertexArrays(1, &GL->Stream_VAO);
+   Bind_Opengl_Vertex_Array(GL->Stream_VAO);
+   Bind_Opengl_Vertex_Layout(Opengl_Vertex_Layouts + Mesh_Vertex_Format_Standard, GL->Vertex_Stream.Buffer, 0);
+   Bind_Opengl_Vertex_Array(0);
 
-   glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(vertex), 0);
-   glEnableVertexAttribArray(0);
-   glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(vertex), (GLvoid *)sizeof(vec2));
-   glEnableVertexAttribArray(1);
+   // NOTE: Stream pushes align with a mask, which GL's alignment (a power of
+   // two on every driver we know of) allows.
+   size Alignment = GL->Capabilities.Uniform_Buffer_Alignment;
+   Assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0);
+   size Range_Size = OPENGL_OBJECT_UNIFORMS_PER_RANGE*sizeof(opengl_object_uniforms);
+   GL->Object_Range_Stride = (Range_Size + (Alignment - 1)) & ~(Alignment - 1);
+   Initialize_Opengl_Stream(&GL->Uniform_Stream, &GL->Capabilities, GL_UNIFORM_BUFFER, OPENGL_UNIFORM_PARTITION_SIZE);
 
-   glBindBuffer(GL_ARRAY_BUFFER, 0);
-   glBindVertexArray(0);
+   GL->Camera_Scale = (vec2){1, 1};
+   GL->Camera_Offset = (vec2){0, 0};
+}
+
+static BEGIN_OPENGL_FRAME(Begin_Opengl_Frame)
+{
+   Mark_Opengl_Capture_Frame();
+
+   GL->Loading_This_Frame = false;
+   Update_Opengl_Shaders(GL, false);
+
+   Update_Opengl_Meshes(GL);
+   Update_Opengl_Textures(GL);
+
+   Begin_Opengl_Stream(&GL->Vertex_Stream);
+   Begin_Opengl_Stream(&GL->Uniform_Stream);
+   GL->Stream_Vertex_Base = 0;
+   GL->Stream_Vertex_Count = 0;
+   Begin_Opengl_Text(GL);
+   Reset_Opengl_Damage_Streams(&GL->Damage);
+   Reset_Render_Commands(&GL->Commands);
+
+   Begin_Opengl_Graph(&GL->Graph);
+   GL->Graph.Scene_Pass = Add_Opengl_Graph_Pass(GL, "scene", OPENGL_GRAPH_BACKBUFFER, Execute_Scene_Pass, 0);
+
+   opengl_frame_stats Zero_Stats = {0};
+   GL->Stats = Zero_Stats;
+   Opengl_State.Calls_Issued = 0;
+   Opengl_State.Calls_Elided = 0;
 }
 
 static RESIZE_OPENGL(Resize_Opengl)
 {
-   glViewport(0, 0, Width, Height);
+   Set_Opengl_Viewport(0, 0, Width, Height);
 }
 
 static RENDER_WITH_OPENGL(Render_With_Opengl)
 {
-   glClearColor(0.0f, 0.0f, 1.0f, 1.0f);
-   glClear(GL_COLOR_BUFFER_BIT);
+   PROFILE_BEGIN_GPU(&GL->Profiler, "Render");
+
+   End_Render_Recording(GL);
+   Execute_Render_Commands(GL);
+
+   GL->Stats.State_Calls_Issued = Opengl_State.Calls_Issued;
+   GL->Stats.State_Calls_Elided = Opengl_State.Calls_Elided;
+
+   PROFILE_END_GPU(&GL->Profiler, "Render");
+}
+
+static INITIALIZE_OPENGL_OFFSCREEN(Initialize_Opengl_Offscreen)
+{
+   bool Result = false;
+
+   Offscreen->Width = Width;
+   Offscreen->Height = Height;
+
+   glGenRenderbuffers(1, &Offscreen->Color_Renderbuffer);
+   glBindRenderbuffer(GL_RENDERBUFFER, Offscreen->Color_Renderbuffer);
+   glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, Width, Height);
+
+   glGenRenderbuffers(1, &Offscreen->Depth_Renderbuffer);
+   glBindRenderbuffer(GL_RENDERBUFFER, Offscreen->Depth_Renderbuffer);
+   glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, Width, Height);
+   glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+   glGenFramebuffers(1, &Offscreen->Framebuffer);
+   Bind_Opengl_Framebuffer(Offscreen->Framebuffer);
+   glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, Offscreen->Color_Renderbuffer);
+   glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, Offscreen->Depth_Renderbuffer);
+
+   if(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)
+   {
+      Result = true;
+   }
+   else
+   {
+      fprintf(stderr, "Offscreen framebuffer is incomplete.\n");
+   }
+   GL_CHECK;
+
+   // NOTE: The offscreen target is left bound, since its only purpose is to
+   // stand in for the default framebuffer.
+   return(Result);
+}
+
+static DESTROY_OPENGL_OFFSCREEN(Destroy_Opengl_Offscreen)
+{
+   Bind_Opengl_Framebuffer(0);
+   glDeleteFramebuffers(1, &Offscreen->Framebuffer);
+   glDeleteRenderbuffers(1, &Offscreen->Color_Renderbuffer);
+   glDeleteRenderbuffers(1, &Offscreen->Depth_Renderbuffer);
+
+   opengl_offscreen Zero = {0};
+   *Offscreen = Zero;
+}
+
+static INITIALIZE_OPENGL_READBACK(Initialize_Opengl_Readback)
+{
+   Readback->Width = Width;
+   Readback->Height = Height;
+
+   size Frame_Size = (size)Width * (size)Height * 4;
+
+   glGenBuffers(OPENGL_READBACK_RING_COUNT, Readback->Pixel_Buffers);
+   for(int Index = 0; Index < OPENGL_READBACK_RING_COUNT; ++Index)
+   {
+      Bind_Opengl_Buffer(GL_PIXEL_PACK_BUFFER, Readback->Pixel_Buffers[Index]);
+      glBufferData(GL_PIXEL_PACK_BUFFER, Frame_Size, 0, GL_STREAM_READ);
+   }
+   Bind_Opengl_Buffer(GL_PIXEL_PACK_BUFFER, 0);
+   GL_CHECK;
+}
+
+static DESTROY_OPENGL_READBACK(Destroy_Opengl_Readback)
+{
+   if(Readback->Mapped)
+   {
+      Unmap_Opengl_Readback(Readback);
+   }
+   for(int Index = 0; Index < OPENGL_READBACK_RING_COUNT; ++Index)
+   {
+      if(Readback->Fences[Index])
+      {
+         glDeleteSync(Readback->Fences[Index]);
+      }
+   }
+   glDeleteBuffers(OPENGL_READBACK_RING_COUNT, Readback->Pixel_Buffers);
+
+   opengl_readback Zero = {0};
+   *Readback = Zero;
+}
+
+static QUEUE_OPENGL_READBACK(Queue_Opengl_Readback)
+{
+   bool Result = false;
+
+   if(Readback->Pending_Count < OPENGL_READBACK_RING_COUNT)
+   {
+      u32 Index = Readback->Write_Index;
+
+      // NOTE: With a pack buffer bound, glReadPixels only records the copy and
+      // returns immediately. The fence tells us when the copy has landed.
+      Bind_Opengl_Buffer(GL_PIXEL_PACK_BUFFER, Readback->Pixel_Buffers[Index]);
+      glReadPixels(0, 0, Readback->Width, Readback->Height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+      Bind_Opengl_Buffer(GL_PIXEL_PACK_BUFFER, 0);
+
+      Readback->Fences[Index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      Readback->Frame_Indices[Index] = Frame_Index;
+
+      Readback->Write_Index = (Index + 1) % OPENGL_READBACK_RING_COUNT;
+      Readback->Pending_Count++;
+
+      Result = true;
+   }
+
+   return(Result);
+}
+
+static MAP_OPENGL_READBACK(Map_Opengl_Readback)
+{
+   bool Result = false;
+
+   Assert(!Readback->Mapped);
+   if(Readback->Pending_Count > 0)
+   {
+      u32 Index = Readback->Read_Index;
+
+      GLbitfield Flags = (Wait) ? GL_SYNC_FLUSH_COMMANDS_BIT : 0;
+      GLuint64 Timeout = (Wait) ? ~(GLuint64)0 : 0;
+
+      GLenum Status = glClientWaitSync(Readback->Fences[Index], Flags, Timeout);
+      if(Status == GL_ALREADY_SIGNALED || Status == GL_CONDITION_SATISFIED)
+      {
+         size Frame_Size = (size)Readback->Width * (size)Readback->Height * 4;
+
+         Bind_Opengl_Buffer(GL_PIXEL_PACK_BUFFER, Readback->Pixel_Buffers[Index]);
+         Frame->Pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, Frame_Size, GL_MAP_READ_BIT);
+         Frame->Frame_Index = Readback->Frame_Indices[Index];
+         Frame->Width = Readback->Width;
+         Frame->Height = Readback->Height;
+
+         if(Frame->Pixels)
+         {
+            Readback->Mapped = true;
+            Result = true;
+         }
+         else
+         {
+            Bind_Opengl_Buffer(GL_PIXEL_PACK_BUFFER, 0);
+            fprintf(stderr, "Failed to map readback buffer.\n");
+         }
+      }
+      else if(Status == GL_WAIT_FAILED)
+      {
+         fprintf(stderr, "Failed to wait on readback fence.\n");
+      }
+   }
+
+   return(Result);
+}
+
+static UNMAP_OPENGL_READBACK(Unmap_Opengl_Readback)
+{
+   Assert(Readback->Mapped);
+
+   u32 Index = Readback->Read_Index;
+
+   Bind_Opengl_Buffer(GL_PIXEL_PACK_BUFFER, Readback->Pixel_Buffers[Index]);
+   glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+   Bind_Opengl_Buffer(GL_PIXEL_PACK_BUFFER, 0);
+
+   glDeleteSync(Readback->Fences[Index]);
+   Readback->Fences[Index] = 0;
 
-   glUseProgram(GL->Shader_Program);
-   glBindVertexArray(GL->VAO);
-   glDrawArrays(GL_TRIANGLES, 0, 3);
+   Readback->Read_Index = (Index + 1) % OPENGL_READBACK_RING_COUNT;
+   Readback->Pending_Count--;
+   Readback->Mapped = false;
 }
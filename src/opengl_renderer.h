@@ -2,13 +2,1171 @@
 
 // NOTE: Renderer API.
 
+// NOTE: The profiler records named CPU scopes (timed with the platform clock)
+// and GPU scopes (GL_TIME_ELAPSED queries). GPU queries are kept in a ring that
+// is PROFILER_QUERY_LATENCY frames deep, and results are only collected once
+// the driver reports them available, so profiling never stalls the pipeline.
+// Building with PROFILER_ENABLED=0 compiles every PROFILE_* macro away.
+#ifndef PROFILER_ENABLED
+#   define PROFILER_ENABLED 0
+#endif
+
+#define PROFILER_MAX_SCOPES 32
+#define PROFILER_MAX_SAMPLES 1024
+#define PROFILER_QUERY_LATENCY 4
+
+typedef struct {
+   char *Name;
+   bool Is_Gpu;
+   bool Active;
+
+   u64 Begin_Time;
+   u64 Frame_Elapsed;
+   bool Used_This_Frame;
+
+   GLuint Queries[PROFILER_QUERY_LATENCY];
+   bool Query_Pending[PROFILER_QUERY_LATENCY];
+   u32 Dropped_Query_Count;
+
+   u32 Sample_Count;
+   float Samples[PROFILER_MAX_SAMPLES]; // NOTE: Milliseconds, wrapping.
+} profile_scope;
+
+typedef struct {
+   u64 Frame_Index;
+   u64 Start_Time;
+   u64 Frame_Begin_Time;
+   bool Gpu_Scope_Active;
+
+   int Scope_Count;
+   profile_scope Scopes[PROFILER_MAX_SCOPES];
+} profiler;
+
+typedef struct {
+   int Major_Version;
+   int Minor_Version;
+   bool Has_Buffer_Storage;
+   bool Has_Multi_Draw_Indirect;
+   GLint Uniform_Buffer_Alignment;
+} opengl_capabilities;
+
+// NOTE: The renderer binds and sets state only through a shadow copy of what
+// it last told the driver, and calls that wouldn't change anything never
+// reach GL. Any state touched behind its back (or objects deleted while
+// bound, which GL unbinds implicitly) must be followed by
+// Invalidate_Opengl_State, after which the next call for each piece of state
+// is issued unconditionally. The element array binding belongs to the VAO,
+// so it isn't tracked here.
+#define OPENGL_STATE_UNKNOWN 0xFFFFFFFF
+#define OPENGL_MAX_TEXTURE_UNITS 16
+#define OPENGL_MAX_UNIFORM_BINDINGS 4
+
+typedef enum {
+   Opengl_Buffer_Array,
+   Opengl_Buffer_Pixel_Pack,
+   Opengl_Buffer_Pixel_Unpack,
+   Opengl_Buffer_Uniform,
+   Opengl_Buffer_Draw_Indirect,
+
+   Opengl_Buffer_Count,
+} opengl_buffer_slot;
+
+typedef struct {
+   GLuint Program;
+   GLuint Vertex_Array;
+   GLuint Framebuffer;
+   GLuint Buffers[Opengl_Buffer_Count];
+
+   GLenum Active_Texture;
+   GLuint Textures[OPENGL_MAX_TEXTURE_UNITS];
+
+   // NOTE: Ranges bound to each uniform block binding point.
+   GLuint Uniform_Buffers[OPENGL_MAX_UNIFORM_BINDINGS];
+   size Uniform_Offsets[OPENGL_MAX_UNIFORM_BINDINGS];
+
+   GLuint Blend_Enabled;
+   GLenum Blend_Source;
+   GLenum Blend_Dest;
+
+   GLuint Depth_Test_Enabled;
+   GLuint Depth_Write_Enabled;
+   GLenum Depth_Function;
+
+   GLuint Cull_Enabled;
+   GLenum Cull_Face;
+
+   GLint Viewport[4];
+   GLuint Scissor_Enabled;
+   GLint Scissor[4];
+   vec4 Clear_Color;
+   bool Clear_Color_Known;
+
+   u32 Calls_Issued;
+   u32 Calls_Elided;
+} opengl_state;
+
+// NOTE: Capture mode records every GL call the renderer makes into a trace
+// (see opengl_capture.h) that opengl_replay.c plays back without the app.
+// Each GL entry point is redirected through a wrapper that forwards the call
+// and then appends a record, so a capture has to begin before the renderer
+// makes its first call. Building with OPENGL_CAPTURE_ENABLED=0 compiles the
+// wrappers out entirely.
+//
+// The capture mirrors just enough GL state to know what a call reads: the
+// buffer bound to each target, the live mappings, and the live fences. While
+// capturing, the renderer skips persistent mapping and the program binary
+// cache, since writes that are never flushed and driver specific binaries
+// can't be replayed.
+#ifndef OPENGL_CAPTURE_ENABLED
+#   define OPENGL_CAPTURE_ENABLED 0
+#endif
+
+#define OPENGL_CAPTURE_MAX_TARGETS 16
+#define OPENGL_CAPTURE_MAX_MAPPINGS 32
+#define OPENGL_CAPTURE_MAX_SYNCS 64
+
+typedef struct {
+   GLenum Target;
+   GLuint Buffer;
+} opengl_capture_binding;
+
+typedef struct {
+   GLuint Buffer;
+   u8 *Pointer;
+   GLsizeiptr Length;
+   GLbitfield Access;
+} opengl_capture_mapping;
+
+typedef struct {
+   bool Active;
+   FILE *File;
+   u64 Payload_Size; // NOTE: Of the record being written.
+   int Width;
+   int Height;
+
+   u32 Frame_Count;
+   u64 Record_Count;
+   u64 Bytes_Written;
+
+   u32 Binding_Count;
+   opengl_capture_binding Bindings[OPENGL_CAPTURE_MAX_TARGETS];
+   u32 Mapping_Count;
+   opengl_capture_mapping Mappings[OPENGL_CAPTURE_MAX_MAPPINGS];
+   GLsync Syncs[OPENGL_CAPTURE_MAX_SYNCS]; // NOTE: Indexed by capture ID.
+} opengl_capture;
+
+// NOTE: A stream buffer is one GL buffer split into OPENGL_STREAM_PARTITION_COUNT
+// partitions that are written round-robin, one per frame. A fence is placed
+// behind the draws of each partition, so by the time we come back around to
+// it the GPU is (almost always) done, and we never pay for the driver
+// orphaning or synchronizing the buffer. When glBufferStorage is available
+// the whole buffer stays persistently mapped; otherwise each partition is
+// mapped with GL_MAP_UNSYNCHRONIZED_BIT for the duration of a frame.
+#define OPENGL_STREAM_PARTITION_COUNT 3
+#define OPENGL_STREAM_PARTITION_SIZE (8*1024*1024)
+
+typedef struct {
+   GLuint Buffer;
+   GLenum Target;
+   size Partition_Size;
+   bool Persistent;
+
+   u8 *Persistent_Base;
+   u8 *Mapped;
+   size Used;
+
+   u32 Partition_Index;
+   bool Partition_Active;
+   GLsync Fences[OPENGL_STREAM_PARTITION_COUNT];
+
+   u64 Bytes_Pushed;
+   u32 Fence_Wait_Count;
+   u32 Overflow_Count;
+} opengl_stream_buffer;
+
+// NOTE: Uniform data lives in std140 blocks that every program shares (see
+// OPENGL_SHADER_SHARED_PATH). Each frame suballocates its blocks from a
+// uniform stream buffer, the same fenced ring of partitions as the vertex
+// stream, and binds them with glBindBufferRange, so all of a frame's uniforms
+// reach the GPU in one upload instead of four glUniform calls per draw.
+//
+// Range offsets have to be multiples of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+// (up to 256 bytes), and rebinding a range for every draw is slow on some
+// drivers (llvmpipe flushes its vertex pipeline each time), so per-object
+// data is packed into ranges of OPENGL_OBJECT_UNIFORMS_PER_RANGE objects
+// instead. A range stays bound for that many draws, and each draw only sets
+// its index within it.
+//
+// A frame's blocks all go in one partition. When a frame needs more room
+// than a partition has (a big naive batch, say), the stream is recreated with
+// partitions doubled in size, up to OPENGL_UNIFORM_MAX_PARTITION_SIZE, before
+// anything is pushed. Only objects past that limit are dropped.
+#define OPENGL_UNIFORM_PARTITION_SIZE (8*1024*1024)
+#define OPENGL_UNIFORM_MAX_PARTITION_SIZE (128*1024*1024)
+#define OPENGL_OBJECT_UNIFORMS_PER_RANGE 256 // NOTE: Also in the shared source.
+#define OPENGL_NO_OBJECT_UNIFORMS 0xFFFFFFFF
+
+typedef enum {
+   Uniform_Block_Camera,
+   Uniform_Block_Pass,
+   Uniform_Block_Object,
+
+   Uniform_Block_Count,
+} uniform_block;
+
+// NOTE: These mirror the blocks in the shared shader source, member for
+// member, with std140's padding written out. Object uniforms are an array
+// element, so their size is also the array stride.
+typedef struct {
+   float Transform[4]; // NOTE: Scale in XY, translation in ZW.
+} opengl_camera_uniforms;
+
+typedef struct {
+   float Tint[4];
+   u32 Uses_Camera;
+   u32 Padding[3];
+} opengl_pass_uniforms;
+
+typedef struct {
+   float Basis[4]; // NOTE: Basis X in XY, basis Y in ZW.
+   float Color[4];
+   float Offset[2];
+   u32 Material;
+   u32 Padding;
+} opengl_object_uniforms;
+
+// NOTE: Vertex layouts describe how a buffer's bytes map onto shader
+// attribute locations, and Bind_Opengl_Vertex_Layout turns one into the
+// matching glVertexAttrib*Pointer calls, so VAO setup is driven by a table
+// rather than written out by hand for every vertex type. A layout with a
+// nonzero Divisor steps once per instance instead of once per vertex.
+//
+// Packed types trade precision for bandwidth: Float16 for positions and
+// texture coordinates, Unorm8 for colors, and Snorm_10_10_10_2 (always four
+// components in one u32) for normals. Uint32 attributes are read as integers
+// by the shader, not converted to float.
+#define OPENGL_MAX_VERTEX_ATTRIBUTES 8
+
+typedef enum {
+   Vertex_Attribute_Float32,
+   Vertex_Attribute_Float16,
+   Vertex_Attribute_Unorm8,
+   Vertex_Attribute_Snorm_10_10_10_2,
+   Vertex_Attribute_Uint32,
+
+   Vertex_Attribute_Type_Count,
+} vertex_attribute_type;
+
+typedef struct {
+   u32 Location;
+   vertex_attribute_type Type;
+   u32 Component_Count;
+   u32 Offset;
+} vertex_attribute;
+
+typedef struct {
+   char *Name;
+   u32 Stride;
+   u32 Divisor;
+   u32 Attribute_Count;
+   vertex_attribute Attributes[OPENGL_MAX_VERTEX_ATTRIBUTES];
+} vertex_layout;
+
+// NOTE: The standard vertex, used for meshes built in code and for dynamic
+// geometry. Compact vertices hold the same attributes in a third the space.
 typedef struct {
+   vec2 Position;
+   vec4 Color;
+} vertex;
+
+typedef struct {
+   u16 Position[2]; // NOTE: Half floats.
+   u8 Color[4];
+} compact_vertex;
+
+typedef struct {
+   u32 First_Index;
+   u32 Index_Count;
+} opengl_mesh_lod;
+
+typedef struct {
+   GLuint VAO;
    GLuint VBO;
+   GLuint EBO;
+   GLenum Index_Type; // NOTE: GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+   vertex_layout *Layout;
+   u32 Vertex_Count;
+   u32 Index_Count; // NOTE: Zero for non-indexed meshes.
+
+   vec2 Bounds_Min;
+   vec2 Bounds_Max;
+
+   // NOTE: Slices of the index buffer, from full detail down. Meshes built in
+   // code have a single LOD covering every index.
+   u32 Lod_Count;
+   opengl_mesh_lod Lods[MESH_FILE_MAX_LODS];
+} opengl_mesh;
+
+// NOTE: Mesh files (see mesh_format.h) are streamed in without stalling the
+// render loop. Load_Opengl_Mesh only queues the file: the background thread
+// maps it, reads it in and validates the header, and Begin_Opengl_Frame then
+// uploads mapped meshes straight out of the mapping, at most Upload_Budget
+// bytes per frame, so a large scene is spread over as many frames as it
+// takes. A mesh that doesn't fit the budget is uploaded piecewise across
+// frames. Once resident the mapping is handed back to the background thread
+// to unmap.
+#define OPENGL_MAX_MESH_ASSETS 64
+#define OPENGL_MESH_ASSET_PATH_SIZE 128
+#define OPENGL_MESH_UPLOAD_BUDGET (4*1024*1024)
+
+typedef enum {
+   Mesh_Asset_Unused,
+   Mesh_Asset_Loading,
+   Mesh_Asset_Mapped,
+   Mesh_Asset_Resident,
+   Mesh_Asset_Failed,
+} mesh_asset_state;
+
+typedef struct {
+   // NOTE: Loading -> Mapped and Loading -> Failed are published by the
+   // background thread; the main thread owns every other transition.
+   _Atomic u32 State;
+   char Path[OPENGL_MESH_ASSET_PATH_SIZE];
+
+   u8 *Mapping;
+   size Mapping_Size;
+   mesh_file_header *Header; // NOTE: Points into Mapping.
+   u64 Bytes_Uploaded;
+
+   u64 Request_Time;
+   u64 Resident_Time;
+   opengl_mesh Mesh;
+} opengl_mesh_asset;
+
+typedef struct {
+   u32 Asset_Count;
+   opengl_mesh_asset Assets[OPENGL_MAX_MESH_ASSETS];
+
+   u64 Upload_Budget;
+   u64 Frame_Bytes_Uploaded;
+   u64 Total_Bytes_Uploaded;
+
+   // NOTE: Background jobs (loads and unmaps) still in flight.
+   job_counter Pending;
+} opengl_mesh_loader;
+
+// NOTE: Instances are drawn with one glDraw*Instanced call per batch. The
+// transform is a 2D affine: Basis_X and Basis_Y are the transformed axes
+// (uploaded together as one vec4 attribute), and Offset is the translation.
+// Material indexes a tint in the shader.
+typedef struct {
+   vec2 Basis_X;
+   vec2 Basis_Y;
+   vec4 Color;
+   vec2 Offset;
+   u32 Material;
+   u32 Padding;
+} opengl_instance;
+
+typedef struct {
+   GLuint VAO;
+   GLuint Instance_Buffer;
+   opengl_mesh *Mesh;
+
+   u32 Count;
+   opengl_instance *Instances; // NOTE: CPU copy, used by the naive path.
+
+   // NOTE: Draw one object at a time with uniforms instead. Only useful for
+   // comparing against the instanced path.
+   bool Draw_Naive;
+} opengl_instance_batch;
+
+// NOTE: A mesh pool packs the vertices and indices of many meshes into one
+// shared pair of buffers, so that drawing a different mesh needs no state
+// change. Every mesh in a pool shares the vertex layout and index type the
+// pool was created with, and meshes that don't match are rejected. Indices are
+// relative to their own mesh, which is placed in the vertex buffer with a base
+// vertex. Meshes are added as raw vertex and index bytes, so they can come
+// straight from a mapped mesh file as well as from code.
+//
+// Draws of pooled meshes are gathered into an indirect batch: one
+// DrawElementsIndirectCommand and one instance per draw, where the command's
+// Base_Instance picks the instance. The executor uploads both arrays and
+// submits the whole batch with a single glMultiDrawElementsIndirect. Drivers
+// without ARB_multi_draw_indirect (or ARB_base_instance, which it relies on)
+// get the same commands walked on the CPU instead, one glDrawElementsBaseVertex
+// per draw with the instance attributes pointed at that draw's instance.
+#define OPENGL_MESH_POOL_MAX_MESHES 256
+
+typedef struct {
+   u32 Index_Count;
+   u32 Instance_Count;
+   u32 First_Index;
+   s32 Base_Vertex;
+   u32 Base_Instance;
+} opengl_draw_command; // NOTE: GL's DrawElementsIndirectCommand.
+
+typedef struct {
+   u32 First_Index;
+   u32 Index_Count;
+   s32 Base_Vertex;
+   u32 Vertex_Count;
+} opengl_pool_mesh;
+
+typedef struct {
+   GLuint VBO;
+   GLuint EBO;
+   vertex_layout *Layout;
+   GLenum Index_Type; // NOTE: GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+   u32 Index_Size;
+   u32 Vertex_Capacity;
+   u32 Index_Capacity;
+   u32 Vertex_Count;
+   u32 Index_Count;
+
+   u32 Mesh_Count;
+   opengl_pool_mesh Meshes[OPENGL_MESH_POOL_MAX_MESHES];
+
+   // NOTE: Covers every mesh in the pool, for damage tracking.
+   vec2 Bounds_Min;
+   vec2 Bounds_Max;
+} opengl_mesh_pool;
+
+typedef struct {
    GLuint VAO;
-   GLuint Shader_Program;
+   GLuint Command_Buffer;
+   GLuint Instance_Buffer;
+   opengl_mesh_pool *Pool;
+
+   // NOTE: Refilled every frame, from Reset_Opengl_Indirect_Batch on.
+   u32 Capacity;
+   u32 Count;
+   opengl_draw_command *Commands;
+   opengl_instance *Instances;
+
+   // NOTE: Walk the commands on the CPU even when multi-draw indirect is
+   // available. Only useful for comparing the two paths.
+   bool Force_Cpu_Loop;
+} opengl_indirect_batch;
+
+// NOTE: Textures are packed into GL_TEXTURE_2D_ARRAYs, one per image size,
+// so every texture of a size shares one binding and differs only by layer. A
+// material's Texture is the array, and the layer travels with the draw (in
+// the instance's Material field for TEXTURED programs).
+//
+// Nothing is uploaded synchronously. Images are decoded on the background
+// thread straight into one of a small ring of pixel unpack buffers. Once a
+// buffer is filled, Begin_Opengl_Frame issues a glTexSubImage3D from it,
+// which returns without waiting for the copy, and a fence hands the buffer
+// back to the ring when the GPU is done with it. The background thread builds
+// each image's mip chain too, and every level is copied into just the new
+// layer, so an upload never touches the other layers of its array.
+//
+// Resident textures are kept under Budget bytes (mips included). When an
+// upload would go over it, or its array is out of layers, the least recently
+// used texture is evicted. Its handle stays valid, and using it again
+// queues a reload.
+#define OPENGL_MAX_TEXTURES 256
+#define OPENGL_MAX_TEXTURE_ARRAYS 8
+#define OPENGL_TEXTURE_ARRAY_LAYERS 64
+#define OPENGL_TEXTURE_PATH_SIZE 128
+#define OPENGL_TEXTURE_UPLOAD_SLOTS 4
+#define OPENGL_TEXTURE_UPLOAD_SLOT_SIZE (4*1024*1024)
+#define OPENGL_TEXTURE_BUDGET (64*1024*1024)
+
+typedef enum {
+   Texture_Queued,
+   Texture_Loading,
+   Texture_Resident,
+   Texture_Evicted,
+   Texture_Failed,
+} texture_state;
+
+typedef enum {
+   Texture_Upload_Free,
+   Texture_Upload_Filling,
+   Texture_Upload_Filled,
+   Texture_Upload_Failed,
+   Texture_Upload_Copying,
+} texture_upload_state;
+
+typedef struct {
+   char Path[OPENGL_TEXTURE_PATH_SIZE];
+   texture_state State;
+
+   u32 Array;
+   u32 Layer;
+   u64 Size; // NOTE: Resident bytes, mips included.
+   u64 Last_Used_Frame;
+} opengl_texture;
+
+typedef struct {
+   GLuint Texture;
+   u32 Width;
+   u32 Height;
+   u32 Mip_Count;
+
+   u64 Used_Layers; // NOTE: One bit per layer.
+   u64 Last_Used_Frame;
+} opengl_texture_array;
+
+typedef struct {
+   // NOTE: Filling -> Filled and Filling -> Failed are published by the
+   // background thread; the main thread owns every other transition.
+   _Atomic u32 State;
+   GLuint Buffer;
+   u8 *Mapped;
+   GLsync Fence;
+
+   u32 Texture; // NOTE: Index of the texture being loaded.
+   char *Path;
+   u8 *Scratch;
+   u32 Width;
+   u32 Height;
+} opengl_texture_upload;
+
+typedef struct {
+   bool Persistent;
+   u64 Frame_Index;
+   u64 Budget;
+   u64 Resident_Bytes;
+
+   u32 Texture_Count;
+   opengl_texture Textures[OPENGL_MAX_TEXTURES];
+
+   u32 Array_Count;
+   opengl_texture_array Arrays[OPENGL_MAX_TEXTURE_ARRAYS];
+
+   opengl_texture_upload Uploads[OPENGL_TEXTURE_UPLOAD_SLOTS];
+   job_counter Pending;
+
+   u64 Bytes_Uploaded;
+   u32 Upload_Count;
+   u32 Eviction_Count;
+} opengl_texture_manager;
+
+// NOTE: Text is drawn from a single channel atlas of signed distance fields,
+// so one rasterization of a glyph serves every size. Glyphs come from a 5x7
+// bitmap font built into the renderer (printable ASCII; anything else draws
+// as '?'), and are rasterized on first use into a free cell of the atlas.
+// When the atlas is full the least recently used glyph is evicted, unless it
+// was used this frame, in which case the new glyph is dropped instead.
+// Changed atlas rows are uploaded once per frame.
+//
+// Push_Text writes one record per glyph into a stream of its own, and the
+// whole frame's text is a single instanced draw of four-vertex strips in the
+// overlay pass, expanded from those records by text.vert. Positions are in
+// pixels from the bottom left of the viewport.
+#define OPENGL_TEXT_ATLAS_SIZE 512
+#define OPENGL_TEXT_CELL_SIZE 32
+#define OPENGL_TEXT_ATLAS_COLUMNS (OPENGL_TEXT_ATLAS_SIZE / OPENGL_TEXT_CELL_SIZE) // NOTE: Also in text.vert.
+#define OPENGL_TEXT_MAX_SLOTS (OPENGL_TEXT_ATLAS_COLUMNS*OPENGL_TEXT_ATLAS_COLUMNS)
+#define OPENGL_TEXT_NO_SLOT 0xFFFF
+#define OPENGL_TEXT_FIRST_CODEPOINT 32
+#define OPENGL_TEXT_CODEPOINT_COUNT 95
+#define OPENGL_TEXT_PARTITION_SIZE (4*1024*1024)
+
+typedef struct {
+   vec2 Min; // NOTE: Pixels, covering the glyph's whole atlas cell.
+   vec2 Max;
+   u8 Color[4];
+   u32 Slot;
+} opengl_text_glyph;
+
+typedef struct {
+   u16 Codepoint;
+   u16 Previous; // NOTE: Towards the most recently used.
+   u16 Next;
+   u64 Last_Used_Frame;
+} opengl_text_slot;
+
+typedef struct {
+   GLuint Atlas; // NOTE: A one layer texture array, so it binds like any material.
+   u8 *Atlas_Pixels;
+   u32 Dirty_Min_Y;
+   u32 Dirty_Max_Y; // NOTE: Exclusive. Nothing is dirty when equal to Min.
+
+   // NOTE: Slots can be limited below OPENGL_TEXT_MAX_SLOTS, which is only
+   // useful for exercising eviction.
+   u32 Slot_Count;
+   u32 Used_Slot_Count;
+   u16 Most_Recent;
+   u16 Least_Recent;
+   u16 Codepoint_Slots[OPENGL_TEXT_CODEPOINT_COUNT];
+   opengl_text_slot Slots[OPENGL_TEXT_MAX_SLOTS];
+   u64 Frame_Index;
+
+   opengl_stream_buffer Stream;
+   GLuint VAO;
+   size Glyph_Base;
+   u32 Glyph_Count;
+
+   u64 Hit_Count;
+   u64 Miss_Count;
+   u64 Eviction_Count;
+   u64 Drop_Count;
+   u64 Bytes_Uploaded;
+} opengl_text;
+
+// NOTE: Application code doesn't draw directly. It pushes render commands
+// into a linear buffer during the frame, each tagged with a 64-bit sort key,
+// and Render_With_Opengl radix sorts the keys and executes the commands in
+// key order. From the most significant bit down the key packs the pass, the
+// program, the texture and a quantized depth, so sorting groups draws by the
+// state they need and orders each group front to back.
+//
+// Every job system thread records into chunks of its own, claimed from a
+// shared pool with a single atomic add, so commands can be pushed from jobs
+// without any other synchronization; the chunks are merged before sorting.
+// Commands with equal keys keep their push order within a thread, but the
+// order between threads depends on which thread ran which job, so draws whose
+// relative order matters need distinct keys.
+//
+// The first OPENGL_MAX_RENDER_COMMANDS commands live in storage of their own.
+// Chunks claimed past that are pushed onto the frame arena (under a spin lock,
+// since any thread can claim one), so a busy frame grows into the frame arena
+// rather than dropping commands. Nothing else may push onto the frame arena
+// while jobs are recording.
+//
+// Every recorded command also costs OPENGL_RENDER_COMMAND_FRAME_COST bytes of
+// frame arena later in the frame (two sort entries and a damage box), and
+// OPENGL_RENDER_COMMAND_FRAME_RESERVE is kept free beyond that for the small
+// pushes that follow. Commands past what the arena can cover are dropped, by
+// Sort_Render_Commands if not already when recording, and never overflow it.
+#define OPENGL_MAX_RENDER_COMMANDS (64*1024)
+#define OPENGL_RENDER_COMMAND_CHUNK_SIZE 512
+#define OPENGL_RENDER_COMMAND_CHUNK_COUNT (OPENGL_MAX_RENDER_COMMANDS / OPENGL_RENDER_COMMAND_CHUNK_SIZE)
+#define OPENGL_RENDER_COMMAND_MAX_CHUNKS 8192
+#define OPENGL_RENDER_COMMAND_FRAME_COST (2*sizeof(render_sort_entry) + sizeof(opengl_damage_box))
+#define OPENGL_RENDER_COMMAND_FRAME_RESERVE (256*1024)
+
+#define RENDER_KEY_PASS_SHIFT 60
+#define RENDER_KEY_PROGRAM_SHIFT 52
+#define RENDER_KEY_TEXTURE_SHIFT 32
+#define RENDER_KEY_DEPTH_SHIFT 8
+
+#define RENDER_KEY_PASS_MASK 0xF
+#define RENDER_KEY_PROGRAM_MASK 0xFF
+#define RENDER_KEY_TEXTURE_MASK 0xFFFFF
+#define RENDER_KEY_DEPTH_MASK 0xFFFFFF
+
+typedef enum {
+   Render_Pass_Scene,
+   Render_Pass_Overlay,
+
+   Render_Pass_Count,
+} render_pass;
+
+typedef enum {
+   Render_Command_Clear,
+   Render_Command_Viewport,
+   Render_Command_Draw_Mesh,
+   Render_Command_Draw_Instances,
+   Render_Command_Draw_Indirect,
+   Render_Command_Draw_Stream,
+   Render_Command_Draw_Text,
+} render_command_type;
+
+// NOTE: A material is the state a draw needs bound. It lives in the sort key
+// rather than in its own command, since a separate "set material" command
+// would be reordered away from the draws it was meant for. Setting the
+// material is done by the executor whenever the key's program or texture bits
+// change.
+typedef struct {
+   u32 Program; // NOTE: A shader manager handle.
+   GLuint Texture; // NOTE: A texture array, or zero for untextured materials.
+} opengl_material;
+
+typedef struct {
+   vec4 Color;
+} render_command_clear;
+
+typedef struct {
+   int X;
+   int Y;
+   int Width;
+   int Height;
+} render_command_viewport;
+
+typedef struct {
+   opengl_mesh *Mesh;
+   u32 Lod;
+   opengl_instance Instance; // NOTE: Only read by PER_OBJECT programs.
+   u32 Uniform_Object; // NOTE: Assigned at execution; see Upload_Opengl_Uniforms.
+} render_command_draw_mesh;
+
+typedef struct {
+   opengl_instance_batch *Batch;
+   u32 Uniform_Object; // NOTE: The first of Count, for naive batches only.
+} render_command_draw_instances;
+
+typedef struct {
+   opengl_indirect_batch *Batch;
+} render_command_draw_indirect;
+
+typedef struct {
+   size Vertex_Base;
+   u32 Vertex_Count;
+} render_command_draw_stream;
+
+typedef struct {
+   size Glyph_Base;
+   u32 Glyph_Count;
+} render_command_draw_text;
+
+typedef struct {
+   render_command_type Type;
+   opengl_material Material;
+   union
+   {
+      render_command_clear Clear;
+      render_command_viewport Viewport;
+      render_command_draw_mesh Draw_Mesh;
+      render_command_draw_instances Draw_Instances;
+      render_command_draw_indirect Draw_Indirect;
+      render_command_draw_stream Draw_Stream;
+      render_command_draw_text Draw_Text;
+   };
+} render_command;
+
+typedef struct {
+   u64 Key;
+   render_command *Command;
+} render_sort_entry;
+
+typedef struct {
+   bool Has_Chunk;
+   u32 Chunk;
+   u32 Count; // NOTE: Commands in the current chunk.
+   u32 Overflow_Count;
+
+   // NOTE: Pads the struct to a cache line, so threads recording side by side
+   // never write to the same line.
+   u8 Padding[48];
+} render_command_buffer;
+
+typedef struct {
+   render_command *Commands;
+   render_sort_entry *Entries;
+} render_command_chunk;
+
+typedef struct {
+   render_command_chunk *Chunks;
+   u32 *Chunk_Counts; // NOTE: Written when a chunk is retired.
+   _Atomic u32 Next_Chunk;
+   atomic_flag Grow_Lock;
+   u32 Grown_Chunks; // NOTE: Guarded by Grow_Lock.
+   arena *Frame;
+
+   u32 Thread_Count;
+   render_command_buffer *Threads;
+} render_command_list;
+
+typedef struct {
+   u32 Commands_Submitted;
+   u32 Commands_Dropped;
+   u32 State_Calls_Issued;
+   u32 State_Calls_Elided;
+   u32 Draw_Calls;
+   u64 Instances;
+   u32 Uniform_Blocks;
+
+   // NOTE: Glyphs pushed this frame, and how many had to be rasterized.
+   u32 Glyphs;
+   u32 Glyph_Misses;
+
+   // NOTE: Accumulated over every Cull_Opengl_Objects call this frame.
+   u32 Cull_Tested;
+   u32 Cull_Visible;
+   u32 Cull_Nodes_Visited;
+   u64 Cull_Time;
+
+   // NOTE: Only filled in while damage tracking is enabled.
+   bool Damage_Full;
+   u32 Damage_Rects;
+   u64 Damage_Pixels;
+   u32 Commands_Skipped;
+
+   // NOTE: Transient_Bytes is the peak of what the graph's transients held at
+   // once after aliasing, and Naive_Transient_Bytes what one texture for each
+   // declared transient would have taken.
+   u32 Graph_Passes;
+   u32 Graph_Passes_Culled;
+   u32 Transient_Textures;
+   u64 Transient_Bytes;
+   u64 Naive_Transient_Bytes;
+} opengl_frame_stats;
+
+// NOTE: Damage tracking lets a mostly static frame redraw only what changed.
+// The framebuffer is divided into tiles, and every command the executor runs
+// mixes a hash of everything that decides its output (material, mesh,
+// instance, camera, viewport) into the signature of each tile its
+// conservative screen bounds touch, in execution order. A tile whose
+// signature differs from the last frame's has changed.
+//
+// Which tiles need repainting depends on how old the back buffer's contents
+// are, which the platform reports in Buffer_Age (as in EGL_EXT_buffer_age; 0
+// means unknown). Drawing is scissored to the bounding box of every tile
+// changed within that many frames, and commands entirely outside it are
+// skipped. Rects lists only the tiles changed this frame, for the
+// compositor's benefit. Anything the signatures can't see (a resize, assets
+// that finished loading, an unknown buffer age) redraws the whole frame.
+//
+// The hashes stand in for the pixels, so a collision could miss a change,
+// but at 64 bits per tile that isn't a practical concern.
+#define OPENGL_DAMAGE_TILE_SIZE 32
+#define OPENGL_DAMAGE_MAX_RECTS 16
+
+typedef struct {
+   int X; // NOTE: From the bottom left, like glScissor and EGL damage rects.
+   int Y;
+   int Width;
+   int Height;
+} opengl_rect;
+
+typedef struct {
+   int Min_X; // NOTE: Pixels, with the maximum exclusive. Empty when Max <= Min.
+   int Min_Y;
+   int Max_X;
+   int Max_Y;
+} opengl_damage_box;
+
+// NOTE: Primitives pushed into a stream this frame, mixed in by its draw.
+// Their positions are only known at push time.
+typedef struct {
+   u64 *Signatures;
+   u64 Hash;
+   opengl_damage_box Box;
+} opengl_damage_stream;
+
+typedef struct {
+   bool Enabled;
+   int Width;
+   int Height;
+   int Tiles_X;
+   int Tiles_Y;
+   u32 Tile_Capacity;
+
+   u64 *Signatures;
+   u64 *Previous_Signatures;
+   u64 *Changed_Frames; // NOTE: The frame each tile last changed in.
+
+   opengl_damage_stream Vertex_Stream;
+   opengl_damage_stream Text_Stream;
+
+   u64 Frame_Number;
+   bool Reset;
+   u64 Asset_Counter; // NOTE: Moves whenever textures or meshes change.
+
+   // NOTE: Set by the platform before Render_With_Opengl.
+   int Buffer_Age;
+
+   // NOTE: Results of the last Render_With_Opengl. Nothing changed when
+   // Full is false and Rect_Count is zero, and nothing was drawn.
+   bool Full;
+   u32 Rect_Count;
+   opengl_rect Rects[OPENGL_DAMAGE_MAX_RECTS];
+   opengl_rect Scissor;
+} opengl_damage;
+
+// NOTE: Frame graph. Render_With_Opengl executes a small graph of passes that
+// is declared anew every frame: each pass renders into one target and
+// declares the resources it reads, and the graph culls the passes nothing
+// depends on, orders the rest by their dependencies and runs them. The scene
+// and overlay render passes are always in it. With nothing else declared the
+// graph is just those two, drawing straight into whatever framebuffer the
+// platform bound (resource OPENGL_GRAPH_BACKBUFFER).
+//
+// Every other resource is a transient texture, which only exists between the
+// first and last pass that use it. Transients are assigned from a pool when
+// the graph compiles, and two whose lifetimes don't overlap share a pooled
+// texture if they have the same size and format, so the pool only ever holds
+// the peak of what is live at once. GL can't alias storage between textures
+// of different formats, so a matching description is as far as aliasing
+// goes. Pooled textures and their framebuffers live across frames and are
+// deleted after OPENGL_GRAPH_TEXTURE_LIFETIME frames unused, so steady state
+// frames create nothing.
+//
+// A transient's contents are undefined until a pass writes it, and a pass
+// writing one must cover all of it. The writers of a resource run in the
+// order they were declared, and its readers after all of them. Passes that
+// don't lead to the backbuffer are culled.
+#define OPENGL_GRAPH_MAX_PASSES 32
+#define OPENGL_GRAPH_MAX_RESOURCES 32
+#define OPENGL_GRAPH_MAX_READS 4
+#define OPENGL_GRAPH_MAX_TEXTURES 16
+#define OPENGL_GRAPH_TEXTURE_LIFETIME 120
+#define OPENGL_GRAPH_BACKBUFFER 0
+#define OPENGL_GRAPH_NO_TEXTURE 0xFFFFFFFF
+
+// NOTE: Called with the target bound and the viewport covering it. Inputs
+// holds the texture behind each of the pass's reads, in the order they were
+// declared. Fixed function state is the pass's own to set.
+#define OPENGL_GRAPH_PASS(Name) void Name(void *Data, GLuint *Inputs)
+typedef OPENGL_GRAPH_PASS(opengl_graph_pass_function);
+
+typedef struct {
+   char *Name;
+   int Width;
+   int Height;
+   GLenum Format;
+
+   // NOTE: Filled in when the graph compiles. Lifetimes are positions in the
+   // execution order.
+   u32 First_Use;
+   u32 Last_Use;
+   u32 Texture;
+} opengl_graph_resource;
+
+typedef struct {
+   char *Name;
+   opengl_graph_pass_function *Function;
+   void *Data;
+
+   u32 Target;
+   u32 Read_Count;
+   u32 Reads[OPENGL_GRAPH_MAX_READS];
+
+   bool Live; // NOTE: Cleared for passes that were culled.
+} opengl_graph_pass;
+
+typedef struct {
+   GLuint Texture; // NOTE: Zero for a free pool slot.
+   GLuint Framebuffer;
+   int Width;
+   int Height;
+   GLenum Format;
+   size Bytes;
+
+   bool Assigned; // NOTE: Held by a live transient while the graph compiles.
+   u64 Last_Used_Frame;
+} opengl_graph_texture;
+
+typedef struct {
+   u32 Pass_Count;
+   opengl_graph_pass Passes[OPENGL_GRAPH_MAX_PASSES];
+   u32 Resource_Count;
+   opengl_graph_resource Resources[OPENGL_GRAPH_MAX_RESOURCES];
+
+   u32 Order_Count;
+   u32 Order[OPENGL_GRAPH_MAX_PASSES];
+
+   // NOTE: The scene pass is declared by Begin_Opengl_Frame, so that it's
+   // the first writer of whatever it draws into, and the overlay pass by
+   // Render_With_Opengl, so that it's the last.
+   u32 Scene_Pass;
+
+   // NOTE: Set when a live pass draws into a transient, in which case the
+   // platform's framebuffer and viewport are looked up when the graph
+   // compiles and rebound for every pass that draws into them.
+   bool Redirected;
+   GLuint Backbuffer;
+   GLint Backbuffer_Viewport[4];
+
+   u64 Frame_Index;
+   u32 Texture_Count;
+   opengl_graph_texture Textures[OPENGL_GRAPH_MAX_TEXTURES];
+   size Pool_Bytes;
+   u32 Textures_Created;
+   u32 Textures_Deleted;
+
+   GLuint Fullscreen_VAO; // NOTE: Empty, fullscreen draws need no attributes.
+} opengl_graph;
+
+// NOTE: Culling keeps object bounds in structure-of-arrays form and runs the
+// SIMD frustum kernels from shared_math.h over them, producing a compact list
+// of visible object indices to record draws from. Sets are owned by the
+// caller and filled with Add_Opengl_Cull_Object.
+//
+// Sphere and box sets test every object every frame, which is the right call
+// for anything that moves. Large static sets can build a BVH once instead:
+// objects are reordered so that every node covers a contiguous range, nodes
+// entirely inside the frustum emit their range without any tests, and only
+// the leaves straddling its planes fall through to the SIMD box test.
+#define OPENGL_CULL_BVH_LEAF_SIZE 32
+#define OPENGL_CULL_BVH_MAX_DEPTH 64
+
+typedef enum {
+   Cull_Mode_Spheres,
+   Cull_Mode_Aabbs,
+   Cull_Mode_Bvh,
+} cull_mode;
+
+typedef struct {
+   vec3 Center;
+   vec3 Extent;
+   u32 First; // NOTE: Leaves: first object, in BVH order. Interior: left child.
+   u32 Count; // NOTE: Objects under the node; zero marks an interior node.
+} opengl_bvh_node;
+
+typedef struct {
+   cull_mode Mode;
+   u32 Count;
+   u32 Capacity;
+
+   sphere_array Spheres;
+   aabb_array Boxes;
+
+   // NOTE: Only for Cull_Mode_Bvh. Bvh_Boxes holds the boxes in BVH order,
+   // and Bvh_Objects maps each back to its index in Boxes. Adding objects
+   // invalidates the tree, and the next cull rebuilds it.
+   bool Bvh_Built;
+   aabb_array Bvh_Boxes;
+   u32 *Bvh_Objects;
+   u32 Node_Count;
+   opengl_bvh_node *Nodes;
+
+   u32 Visible_Count;
+   u32 *Visible;
+} opengl_cull_set;
+
+// NOTE: Linked programs are cached on disk with glGetProgramBinary, keyed by a
+// hash of their sources, defines and the driver identity. Loading falls back
+// to a full compile whenever the key doesn't match or the driver rejects the
+// binary.
+#define OPENGL_PROGRAM_CACHE_DIRECTORY "cache"
+#define OPENGL_PROGRAM_CACHE_MAGIC 0x48435250 // NOTE: "PRCH"
+#define OPENGL_PROGRAM_CACHE_VERSION 1
+
+typedef struct {
+   u32 Magic;
+   u32 Version;
+   u64 Key;
+   u32 Binary_Format;
+   u32 Binary_Size;
+} opengl_program_cache_header;
+
+typedef struct {
+   bool Enabled;
+   u64 Driver_Hash;
+
+   u32 Hit_Count;
+   u32 Miss_Count;
+   u64 Hit_Time;
+   u64 Miss_Time;
+} opengl_program_cache;
+
+#define OPENGL_SHADER_DIRECTORY "shaders"
+#define OPENGL_SHADER_SHARED_PATH "shaders/uniforms.glsl"
+#define OPENGL_MAX_PROGRAMS 32
+
+typedef struct {
+   char *Vertex_Path;
+   char *Fragment_Path;
+   char *Defines;
+
+   GLuint Program; // NOTE: The live program, replaced only between frames.
+
+   // NOTE: Resolved whenever Program is replaced.
+   bool Uses_Object_Uniforms;
+   GLint Object_Index_Location;
+   GLint Pixel_Scale_Location; // NOTE: Only in programs that position in pixels.
+   GLint Tint_Location; // NOTE: Only in post-processing programs.
+
+   bool Dirty;
+   bool Building;
+   GLuint Pending_Program;
+   GLuint Pending_Shaders[2];
+   u64 Pending_Key;
+   u64 Build_Start;
+   char Cache_Path[64];
+} opengl_program;
+
+typedef struct {
+   bool Has_Parallel_Compile;
+   bool Watching;
+   u32 Reload_Count;
+
+   u32 Program_Count;
+   opengl_program Programs[OPENGL_MAX_PROGRAMS];
+} opengl_shader_manager;
+
+typedef struct {
+   opengl_mesh Triangle_Mesh;
+   opengl_mesh Quad_Mesh;
+
+   u32 Basic_Program;
+   u32 Instanced_Program;
+   u32 Per_Object_Program;
+   u32 Textured_Program;
+   u32 Text_Program;
+   u32 Post_Copy_Program;
+   u32 Post_Bright_Program;
+   u32 Post_Blur_X_Program;
+   u32 Post_Blur_Y_Program;
+
+   platform_memory *Memory;
+   opengl_capabilities Capabilities;
+   opengl_program_cache Program_Cache;
+   opengl_shader_manager Shaders;
+
+   // NOTE: Set when this frame read files or built programs, which exempts it
+   // from the platform's steady state checks.
+   bool Loading_This_Frame;
+
+   // NOTE: Dynamic geometry pushed with Push_Quad/Push_Line is written
+   // straight into the stream buffer and drawn after the static scene.
+   opengl_stream_buffer Vertex_Stream;
+   GLuint Stream_VAO;
+   size Stream_Vertex_Base;
+   u32 Stream_Vertex_Count;
+
+   opengl_stream_buffer Uniform_Stream;
+   size Object_Range_Stride;
+
+   // NOTE: Applied to every pass but the overlay. Identity by default.
+   vec2 Camera_Scale;
+   vec2 Camera_Offset;
+
+   render_command_list Commands;
+   opengl_frame_stats Stats;
+   opengl_damage Damage;
+   opengl_graph Graph;
+
+   opengl_mesh_loader Meshes;
+   opengl_texture_manager Textures;
+   opengl_text Text;
+
+#if PROFILER_ENABLED
+   profiler Profiler;
+#endif
 } opengl_context;
 
-#define INITIALIZE_OPENGL(Name) void Name(opengl_context *GL)
+// NOTE: Offscreen rendering is used by platforms that have no window system
+// framebuffer to draw into (e.g. headless EGL). The readback ring copies
+// finished frames into pixel buffer objects so the CPU can map them a few
+// frames later, instead of stalling on glReadPixels.
+#define OPENGL_READBACK_RING_COUNT 3
+
+typedef struct {
+   GLuint Framebuffer;
+   GLuint Color_Renderbuffer;
+   GLuint Depth_Renderbuffer;
+   int Width;
+   int Height;
+} opengl_offscreen;
+
+typedef struct {
+   GLuint Pixel_Buffers[OPENGL_READBACK_RING_COUNT];
+   GLsync Fences[OPENGL_READBACK_RING_COUNT];
+   u64 Frame_Indices[OPENGL_READBACK_RING_COUNT];
+
+   int Width;
+   int Height;
+   u32 Write_Index;
+   u32 Read_Index;
+   u32 Pending_Count;
+   bool Mapped;
+} opengl_readback;
+
+typedef struct {
+   u8 *Pixels; // NOTE: RGBA8, bottom-up rows.
+   u64 Frame_Index;
+   int Width;
+   int Height;
+} opengl_readback_frame;
+
+#define INITIALIZE_OPENGL(Name) void Name(opengl_context *GL, platform_memory *Memory)
 static INITIALIZE_OPENGL(Initialize_Opengl);
 
 #define RESIZE_OPENGL(Name) void Name(int Width, int Height)
@@ -17,6 +1175,72 @@ static RESIZE_OPENGL(Resize_Opengl);
 #define RENDER_WITH_OPENGL(Name) void Name(opengl_context *GL)
 static RENDER_WITH_OPENGL(Render_With_Opengl);
 
+// NOTE: Turns damage tracking on (it's off by default), and must be called
+// again whenever the framebuffer changes size. The next frame is redrawn in
+// full.
+#define RESIZE_OPENGL_DAMAGE(Name) void Name(opengl_context *GL, int Width, int Height)
+static RESIZE_OPENGL_DAMAGE(Resize_Opengl_Damage);
+
+// NOTE: Render commands and dynamic geometry for the current frame must be
+// pushed between Begin_Opengl_Frame and Render_With_Opengl.
+#define BEGIN_OPENGL_FRAME(Name) void Name(opengl_context *GL)
+static BEGIN_OPENGL_FRAME(Begin_Opengl_Frame);
+
+#define INITIALIZE_OPENGL_OFFSCREEN(Name) bool Name(opengl_offscreen *Offscreen, int Width, int Height)
+static INITIALIZE_OPENGL_OFFSCREEN(Initialize_Opengl_Offscreen);
+
+#define DESTROY_OPENGL_OFFSCREEN(Name) void Name(opengl_offscreen *Offscreen)
+static DESTROY_OPENGL_OFFSCREEN(Destroy_Opengl_Offscreen);
+
+#define INITIALIZE_OPENGL_READBACK(Name) void Name(opengl_readback *Readback, int Width, int Height)
+static INITIALIZE_OPENGL_READBACK(Initialize_Opengl_Readback);
+
+#define DESTROY_OPENGL_READBACK(Name) void Name(opengl_readback *Readback)
+static DESTROY_OPENGL_READBACK(Destroy_Opengl_Readback);
+
+// NOTE: Queue_Opengl_Readback copies the currently bound read framebuffer into
+// the next slot of the ring. It returns false if the ring is full, in which
+// case the caller must retire a frame with Map/Unmap first.
+#define QUEUE_OPENGL_READBACK(Name) bool Name(opengl_readback *Readback, u64 Frame_Index)
+static QUEUE_OPENGL_READBACK(Queue_Opengl_Readback);
+
+// NOTE: Map_Opengl_Readback returns the oldest pending frame if its copy has
+// completed. When Wait is false it never blocks, and returns false instead.
+#define MAP_OPENGL_READBACK(Name) bool Name(opengl_readback *Readback, opengl_readback_frame *Frame, bool Wait)
+static MAP_OPENGL_READBACK(Map_Opengl_Readback);
+
+#define UNMAP_OPENGL_READBACK(Name) void Name(opengl_readback *Readback)
+static UNMAP_OPENGL_READBACK(Unmap_Opengl_Readback);
+
+// NOTE: Begin_Opengl_Capture must be called before any other renderer
+// function, including the offscreen and readback setup. Width and Height
+// only tell the replay how big a default framebuffer to stand in with.
+#define BEGIN_OPENGL_CAPTURE(Name) bool Name(char *Path, int Width, int Height)
+static BEGIN_OPENGL_CAPTURE(Begin_Opengl_Capture);
+
+#define END_OPENGL_CAPTURE(Name) void Name(void)
+static END_OPENGL_CAPTURE(End_Opengl_Capture);
+
+#if PROFILER_ENABLED
+#   define PROFILE_BEGIN_FRAME(Profiler) Begin_Profiler_Frame(Profiler)
+#   define PROFILE_END_FRAME(Profiler) End_Profiler_Frame(Profiler)
+#   define PROFILE_BEGIN_CPU(Profiler, Name) Begin_Profile_Scope(Profiler, Name, false)
+#   define PROFILE_END_CPU(Profiler, Name) End_Profile_Scope(Profiler, Name, false)
+#   define PROFILE_BEGIN_GPU(Profiler, Name) Begin_Profile_Scope(Profiler, Name, true)
+#   define PROFILE_END_GPU(Profiler, Name) End_Profile_Scope(Profiler, Name, true)
+#   define PROFILE_WRITE_REPORT(Profiler, Path) Write_Profiler_Report(Profiler, Path)
+#   define PROFILE_DESTROY(Profiler) Destroy_Profiler(Profiler)
+#else
+#   define PROFILE_BEGIN_FRAME(Profiler)
+#   define PROFILE_END_FRAME(Profiler)
+#   define PROFILE_BEGIN_CPU(Profiler, Name)
+#   define PROFILE_END_CPU(Profiler, Name)
+#   define PROFILE_BEGIN_GPU(Profiler, Name)
+#   define PROFILE_END_GPU(Profiler, Name)
+#   define PROFILE_WRITE_REPORT(Profiler, Path)
+#   define PROFILE_DESTROY(Profiler)
+#endif
+
 // NOTE: We want to support platforms like Windows, where gl functions beyond a
 // few basics from OpenGL version 1 will be unavailable by default. For now, we
 // just forward declare them here, and let the platforms GetProcAddress them as
@@ -42,3 +1266,53 @@ void glEnableVertexAttribArray(GLuint);
 void glGenVertexArrays(GLsizei, GLuint *);
 void glBindVertexArray(GLuint);
 void glDrawArrays(GLenum, GLint, GLsizei);
+void glDeleteBuffers(GLsizei, const GLuint *);
+void glGenFramebuffers(GLsizei, GLuint *);
+void glDeleteFramebuffers(GLsizei, const GLuint *);
+void glBindFramebuffer(GLenum, GLuint);
+GLenum glCheckFramebufferStatus(GLenum);
+void glGenRenderbuffers(GLsizei, GLuint *);
+void glDeleteRenderbuffers(GLsizei, const GLuint *);
+void glBindRenderbuffer(GLenum, GLuint);
+void glRenderbufferStorage(GLenum, GLenum, GLsizei, GLsizei);
+void glFramebufferRenderbuffer(GLenum, GLenum, GLenum, GLuint);
+void *glMapBufferRange(GLenum, GLintptr, GLsizeiptr, GLbitfield);
+GLboolean glUnmapBuffer(GLenum);
+GLsync glFenceSync(GLenum, GLbitfield);
+GLenum glClientWaitSync(GLsync, GLbitfield, GLuint64);
+void glDeleteSync(GLsync);
+void glGenQueries(GLsizei, GLuint *);
+void glDeleteQueries(GLsizei, const GLuint *);
+void glBeginQuery(GLenum, GLuint);
+void glEndQuery(GLenum);
+void glGetQueryObjectiv(GLuint, GLenum, GLint *);
+void glGetQueryObjectui64v(GLuint, GLenum, GLuint64 *);
+const GLubyte *glGetStringi(GLenum, GLuint);
+void glBufferStorage(GLenum, GLsizeiptr, const void *, GLbitfield);
+void glFlushMappedBufferRange(GLenum, GLintptr, GLsizeiptr);
+void glDeleteProgram(GLuint);
+void glDetachShader(GLuint, GLuint);
+void glProgramParameteri(GLuint, GLenum, GLint);
+void glGetProgramBinary(GLuint, GLsizei, GLsizei *, GLenum *, void *);
+void glProgramBinary(GLuint, GLenum, const void *, GLsizei);
+void glMaxShaderCompilerThreadsKHR(GLuint);
+void glDeleteVertexArrays(GLsizei, const GLuint *);
+void glBufferSubData(GLenum, GLintptr, GLsizeiptr, const void *);
+void glVertexAttribIPointer(GLuint, GLint, GLenum, GLsizei, const void *);
+void glVertexAttribDivisor(GLuint, GLuint);
+void glDrawArraysInstanced(GLenum, GLint, GLsizei, GLsizei);
+void glDrawElementsInstanced(GLenum, GLsizei, GLenum, const void *, GLsizei);
+void glDrawElementsBaseVertex(GLenum, GLsizei, GLenum, const void *, GLint);
+void glMultiDrawElementsIndirect(GLenum, GLenum, const void *, GLsizei, GLsizei);
+GLint glGetUniformLocation(GLuint, const GLchar *);
+void glUniform2f(GLint, GLfloat, GLfloat);
+void glUniform4f(GLint, GLfloat, GLfloat, GLfloat, GLfloat);
+void glUniform1ui(GLint, GLuint);
+GLuint glGetUniformBlockIndex(GLuint, const GLchar *);
+void glUniformBlockBinding(GLuint, GLuint, GLuint);
+void glBindBufferRange(GLenum, GLuint, GLuint, GLintptr, GLsizeiptr);
+void glTexImage3D(GLenum, GLint, GLint, GLsizei, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid *);
+void glTexSubImage3D(GLenum, GLint, GLint, GLint, GLint, GLsizei, GLsizei, GLsizei, GLenum, GLenum, const GLvoid *);
+void glGenerateMipmap(GLenum);
+void glGetBufferSubData(GLenum, GLintptr, GLsizeiptr, void *);
+void glFramebufferTextureLayer(GLenum, GLenum, GLuint, GLint, GLint);
@@ -0,0 +1,932 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Standalone replay for traces written by the renderer's capture mode
+// (see opengl_capture.h). It needs no app, no compositor and no assets:
+// everything the renderer fed GL is in the trace, so a frame captured once can
+// be replayed against any driver or build and timed in isolation.
+//
+// Calls are replayed back to back as fast as the driver takes them, in a
+// headless EGL context with a pbuffer standing in for the default
+// framebuffer. Object names, uniform locations and fences are whatever this
+// driver hands out, mapped back onto the captured ones as the calls that
+// created them are replayed. Data read back through mapped buffers is
+// checksummed the same way as opengl_renderer_headless does it, so a headless
+// capture made with -readback should replay to the same checksum.
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared.h"
+#include "platform.h"
+#include "mesh_format.h"
+#include "opengl_capture.h"
+#include "opengl_renderer.h"
+#include "linux_platform.c"
+
+// NOTE: Captured names index straight into these tables, which is fine since
+// drivers hand out small, densely packed names.
+#define OPENGL_REPLAY_MAX_NAMES 65536
+#define OPENGL_REPLAY_MAX_PROGRAMS 1024
+#define OPENGL_REPLAY_MAX_LOCATIONS 2048 // NOTE: Mesa counts block members too, so locations run high.
+#define OPENGL_REPLAY_MAX_BLOCKS 8
+#define OPENGL_REPLAY_MAX_ARGUMENTS 16
+
+typedef enum {
+   Replay_Names_Buffer,
+   Replay_Names_Texture,
+   Replay_Names_Vertex_Array,
+   Replay_Names_Framebuffer,
+   Replay_Names_Renderbuffer,
+   Replay_Names_Query,
+   Replay_Names_Program, // NOTE: Shaders share the program namespace.
+
+   Replay_Names_Count,
+} replay_names;
+
+typedef struct {
+   EGLDisplay Opengl_Display;
+   EGLContext Opengl_Context;
+   EGLSurface Opengl_Surface;
+
+   arena *Arena;
+   GLuint *Names[Replay_Names_Count];
+   u8 **Mappings; // NOTE: By captured buffer name.
+   GLsync Syncs[OPENGL_CAPTURE_MAX_SYNCS];
+
+   u32 Binding_Count;
+   opengl_capture_binding Bindings[OPENGL_CAPTURE_MAX_TARGETS]; // NOTE: Captured names.
+
+   GLuint Program; // NOTE: Captured name.
+   GLint *Locations; // NOTE: By captured program, then captured location.
+   GLuint *Block_Indices; // NOTE: By captured program, then captured index.
+
+   u64 Call_Counts[Opengl_Call_Count];
+   u32 Failed_Map_Count;
+   u64 Checksum;
+   u32 Readback_Count;
+} replay_context;
+
+static char *Opengl_Call_Names[Opengl_Call_Count] =
+{
+   [Opengl_Call_Begin_Frame] = "Begin_Frame",
+   [Opengl_Call_Write_Mapped] = "Write_Mapped",
+
+   [Opengl_Call_glActiveTexture] = "glActiveTexture",
+   [Opengl_Call_glAttachShader] = "glAttachShader",
+   [Opengl_Call_glBeginQuery] = "glBeginQuery",
+   [Opengl_Call_glBindBuffer] = "glBindBuffer",
+   [Opengl_Call_glBindBufferRange] = "glBindBufferRange",
+   [Opengl_Call_glBindFramebuffer] = "glBindFramebuffer",
+   [Opengl_Call_glBindRenderbuffer] = "glBindRenderbuffer",
+   [Opengl_Call_glBindTexture] = "glBindTexture",
+   [Opengl_Call_glBindVertexArray] = "glBindVertexArray",
+   [Opengl_Call_glBlendFunc] = "glBlendFunc",
+   [Opengl_Call_glBufferData] = "glBufferData",
+   [Opengl_Call_glBufferStorage] = "glBufferStorage",
+   [Opengl_Call_glBufferSubData] = "glBufferSubData",
+   [Opengl_Call_glCheckFramebufferStatus] = "glCheckFramebufferStatus",
+   [Opengl_Call_glClear] = "glClear",
+   [Opengl_Call_glClearColor] = "glClearColor",
+   [Opengl_Call_glClientWaitSync] = "glClientWaitSync",
+   [Opengl_Call_glCompileShader] = "glCompileShader",
+   [Opengl_Call_glCreateProgram] = "glCreateProgram",
+   [Opengl_Call_glCreateShader] = "glCreateShader",
+   [Opengl_Call_glCullFace] = "glCullFace",
+   [Opengl_Call_glDeleteBuffers] = "glDeleteBuffers",
+   [Opengl_Call_glDeleteFramebuffers] = "glDeleteFramebuffers",
+   [Opengl_Call_glDeleteProgram] = "glDeleteProgram",
+   [Opengl_Call_glDeleteQueries] = "glDeleteQueries",
+   [Opengl_Call_glDeleteRenderbuffers] = "glDeleteRenderbuffers",
+   [Opengl_Call_glDeleteShader] = "glDeleteShader",
+   [Opengl_Call_glDeleteSync] = "glDeleteSync",
+   [Opengl_Call_glDeleteTextures] = "glDeleteTextures",
+   [Opengl_Call_glDeleteVertexArrays] = "glDeleteVertexArrays",
+   [Opengl_Call_glDepthFunc] = "glDepthFunc",
+   [Opengl_Call_glDepthMask] = "glDepthMask",
+   [Opengl_Call_glDetachShader] = "glDetachShader",
+   [Opengl_Call_glDisable] = "glDisable",
+   [Opengl_Call_glDrawArrays] = "glDrawArrays",
+   [Opengl_Call_glDrawArraysInstanced] = "glDrawArraysInstanced",
+   [Opengl_Call_glDrawElements] = "glDrawElements",
+   [Opengl_Call_glDrawElementsBaseVertex] = "glDrawElementsBaseVertex",
+   [Opengl_Call_glDrawElementsInstanced] = "glDrawElementsInstanced",
+   [Opengl_Call_glEnable] = "glEnable",
+   [Opengl_Call_glEnableVertexAttribArray] = "glEnableVertexAttribArray",
+   [Opengl_Call_glEndQuery] = "glEndQuery",
+   [Opengl_Call_glFenceSync] = "glFenceSync",
+   [Opengl_Call_glFinish] = "glFinish",
+   [Opengl_Call_glFlush] = "glFlush",
+   [Opengl_Call_glFlushMappedBufferRange] = "glFlushMappedBufferRange",
+   [Opengl_Call_glFramebufferRenderbuffer] = "glFramebufferRenderbuffer",
+   [Opengl_Call_glFramebufferTextureLayer] = "glFramebufferTextureLayer",
+   [Opengl_Call_glGenBuffers] = "glGenBuffers",
+   [Opengl_Call_glGenFramebuffers] = "glGenFramebuffers",
+   [Opengl_Call_glGenQueries] = "glGenQueries",
+   [Opengl_Call_glGenRenderbuffers] = "glGenRenderbuffers",
+   [Opengl_Call_glGenTextures] = "glGenTextures",
+   [Opengl_Call_glGenVertexArrays] = "glGenVertexArrays",
+   [Opengl_Call_glGenerateMipmap] = "glGenerateMipmap",
+   [Opengl_Call_glGetBufferSubData] = "glGetBufferSubData",
+   [Opengl_Call_glGetError] = "glGetError",
+   [Opengl_Call_glGetIntegerv] = "glGetIntegerv",
+   [Opengl_Call_glGetProgramBinary] = "glGetProgramBinary",
+   [Opengl_Call_glGetProgramInfoLog] = "glGetProgramInfoLog",
+   [Opengl_Call_glGetProgramiv] = "glGetProgramiv",
+   [Opengl_Call_glGetQueryObjectiv] = "glGetQueryObjectiv",
+   [Opengl_Call_glGetQueryObjectui64v] = "glGetQueryObjectui64v",
+   [Opengl_Call_glGetShaderInfoLog] = "glGetShaderInfoLog",
+   [Opengl_Call_glGetShaderiv] = "glGetShaderiv",
+   [Opengl_Call_glGetString] = "glGetString",
+   [Opengl_Call_glGetStringi] = "glGetStringi",
+   [Opengl_Call_glGetUniformBlockIndex] = "glGetUniformBlockIndex",
+   [Opengl_Call_glGetUniformLocation] = "glGetUniformLocation",
+   [Opengl_Call_glLinkProgram] = "glLinkProgram",
+   [Opengl_Call_glMapBufferRange] = "glMapBufferRange",
+   [Opengl_Call_glMaxShaderCompilerThreadsKHR] = "glMaxShaderCompilerThreadsKHR",
+   [Opengl_Call_glMultiDrawElementsIndirect] = "glMultiDrawElementsIndirect",
+   [Opengl_Call_glProgramBinary] = "glProgramBinary",
+   [Opengl_Call_glProgramParameteri] = "glProgramParameteri",
+   [Opengl_Call_glReadPixels] = "glReadPixels",
+   [Opengl_Call_glRenderbufferStorage] = "glRenderbufferStorage",
+   [Opengl_Call_glScissor] = "glScissor",
+   [Opengl_Call_glShaderSource] = "glShaderSource",
+   [Opengl_Call_glTexImage3D] = "glTexImage3D",
+   [Opengl_Call_glTexParameteri] = "glTexParameteri",
+   [Opengl_Call_glTexSubImage3D] = "glTexSubImage3D",
+   [Opengl_Call_glUniform1ui] = "glUniform1ui",
+   [Opengl_Call_glUniform2f] = "glUniform2f",
+   [Opengl_Call_glUniform4f] = "glUniform4f",
+   [Opengl_Call_glUniformBlockBinding] = "glUniformBlockBinding",
+   [Opengl_Call_glUnmapBuffer] = "glUnmapBuffer",
+   [Opengl_Call_glUseProgram] = "glUseProgram",
+   [Opengl_Call_glVertexAttribDivisor] = "glVertexAttribDivisor",
+   [Opengl_Call_glVertexAttribIPointer] = "glVertexAttribIPointer",
+   [Opengl_Call_glVertexAttribPointer] = "glVertexAttribPointer",
+   [Opengl_Call_glViewport] = "glViewport",
+};
+
+static bool Initialize_Replay_Egl(replay_context *Replay, int Width, int Height)
+{
+   bool Result = false;
+
+   EGLint Configuration_Attributes[] =
+      {
+         EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+         EGL_RED_SIZE, 8,
+         EGL_GREEN_SIZE, 8,
+         EGL_BLUE_SIZE, 8,
+         EGL_ALPHA_SIZE, 8,
+         EGL_DEPTH_SIZE, 24,
+         EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+         EGL_NONE,
+      };
+
+   EGLint Context_Attributes[] =
+      {
+         EGL_CONTEXT_MAJOR_VERSION, 3,
+         EGL_CONTEXT_MINOR_VERSION, 3,
+         EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+         EGL_NONE,
+      };
+
+   // NOTE: Unlike the headless app, the replay always wants a pbuffer, since
+   // traces from a windowed app draw to the default framebuffer.
+   EGLint Pbuffer_Attributes[] =
+      {
+         EGL_WIDTH, Width,
+         EGL_HEIGHT, Height,
+         EGL_NONE,
+      };
+
+   const char *Client_Extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+   if(Client_Extensions && strstr(Client_Extensions, "EGL_MESA_platform_surfaceless"))
+   {
+      PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT =
+         (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+      if(eglGetPlatformDisplayEXT)
+      {
+         Replay->Opengl_Display = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, 0);
+      }
+   }
+   if(Replay->Opengl_Display == EGL_NO_DISPLAY)
+   {
+      Replay->Opengl_Display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+   }
+
+   EGLConfig Configuration;
+   EGLint Configuration_Count = 0;
+   if(Replay->Opengl_Display == EGL_NO_DISPLAY || !eglInitialize(Replay->Opengl_Display, 0, 0))
+   {
+      fprintf(stderr, "EGL failed to initialize.\n");
+   }
+   else if(!eglBindAPI(EGL_OPENGL_API) ||
+           !eglChooseConfig(Replay->Opengl_Display, Configuration_Attributes, &Configuration, 1, &Configuration_Count) ||
+           Configuration_Count == 0)
+   {
+      fprintf(stderr, "EGL failed to choose a configuration.\n");
+   }
+   else
+   {
+      Replay->Opengl_Context = eglCreateContext(Replay->Opengl_Display, Configuration, EGL_NO_CONTEXT, Context_Attributes);
+      Replay->Opengl_Surface = eglCreatePbufferSurface(Replay->Opengl_Display, Configuration, Pbuffer_Attributes);
+      if(Replay->Opengl_Context == EGL_NO_CONTEXT || Replay->Opengl_Surface == EGL_NO_SURFACE)
+      {
+         fprintf(stderr, "EGL failed to create a context and pbuffer.\n");
+      }
+      else if(!eglMakeCurrent(Replay->Opengl_Display, Replay->Opengl_Surface, Replay->Opengl_Surface, Replay->Opengl_Context))
+      {
+         fprintf(stderr, "EGL failed to make the OpenGL context current.\n");
+      }
+      else
+      {
+         Result = true;
+      }
+   }
+
+   return(Result);
+}
+
+static void Destroy_Replay_Egl(replay_context *Replay)
+{
+   if(Replay->Opengl_Display != EGL_NO_DISPLAY)
+   {
+      eglMakeCurrent(Replay->Opengl_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+      if(Replay->Opengl_Surface != EGL_NO_SURFACE)
+      {
+         eglDestroySurface(Replay->Opengl_Display, Replay->Opengl_Surface);
+      }
+      if(Replay->Opengl_Context != EGL_NO_CONTEXT)
+      {
+         eglDestroyContext(Replay->Opengl_Display, Replay->Opengl_Context);
+      }
+      eglTerminate(Replay->Opengl_Display);
+   }
+}
+
+static GLuint Get_Replay_Name(replay_context *Replay, replay_names Names, u64 Captured)
+{
+   Assert(Captured < OPENGL_REPLAY_MAX_NAMES);
+   GLuint Result = Replay->Names[Names][Captured];
+   return(Result);
+}
+
+static void Set_Replay_Name(replay_context *Replay, replay_names Names, u64 Captured, GLuint Name)
+{
+   Assert(Captured < OPENGL_REPLAY_MAX_NAMES);
+   Replay->Names[Names][Captured] = Name;
+}
+
+static GLuint Get_Replay_Binding(replay_context *Replay, GLenum Target)
+{
+   GLuint Result = 0;
+   for(u32 Index = 0; Index < Replay->Binding_Count; ++Index)
+   {
+      if(Replay->Bindings[Index].Target == Target)
+      {
+         Result = Replay->Bindings[Index].Buffer;
+         break;
+      }
+   }
+   return(Result);
+}
+
+static void Set_Replay_Binding(replay_context *Replay, GLenum Target, GLuint Captured)
+{
+   u32 Index = 0;
+   while(Index < Replay->Binding_Count && Replay->Bindings[Index].Target != Target)
+   {
+      Index++;
+   }
+   if(Index == Replay->Binding_Count)
+   {
+      Assert(Replay->Binding_Count < OPENGL_CAPTURE_MAX_TARGETS);
+      Replay->Bindings[Replay->Binding_Count++].Target = Target;
+   }
+   Replay->Bindings[Index].Buffer = Captured;
+}
+
+static GLint Get_Replay_Location(replay_context *Replay, u64 Captured)
+{
+   GLint Result = -1;
+   GLint Location = (GLint)(s64)Captured;
+   if(Location >= 0)
+   {
+      Assert(Replay->Program < OPENGL_REPLAY_MAX_PROGRAMS && Location < OPENGL_REPLAY_MAX_LOCATIONS);
+      Result = Replay->Locations[Replay->Program*OPENGL_REPLAY_MAX_LOCATIONS + Location];
+   }
+   return(Result);
+}
+
+static void Generate_Replay_Names(replay_context *Replay, replay_names Names, opengl_call Call, GLsizei Count, GLuint *Captured)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Replay->Arena);
+
+   GLuint *Generated = Push_Array(Replay->Arena, Count, GLuint);
+   switch(Call)
+   {
+      case Opengl_Call_glGenBuffers: glGenBuffers(Count, Generated); break;
+      case Opengl_Call_glGenFramebuffers: glGenFramebuffers(Count, Generated); break;
+      case Opengl_Call_glGenQueries: glGenQueries(Count, Generated); break;
+      case Opengl_Call_glGenRenderbuffers: glGenRenderbuffers(Count, Generated); break;
+      case Opengl_Call_glGenTextures: glGenTextures(Count, Generated); break;
+      case Opengl_Call_glGenVertexArrays: glGenVertexArrays(Count, Generated); break;
+      default: Assert(!"Not a glGen* call."); break;
+   }
+
+   for(GLsizei Index = 0; Index < Count; ++Index)
+   {
+      Set_Replay_Name(Replay, Names, Captured[Index], Generated[Index]);
+   }
+
+   End_Temporary_Memory(Temporary);
+}
+
+static void Delete_Replay_Names(replay_context *Replay, replay_names Names, opengl_call Call, GLsizei Count, GLuint *Captured)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Replay->Arena);
+
+   GLuint *Deleted = Push_Array(Replay->Arena, Count, GLuint);
+   for(GLsizei Index = 0; Index < Count; ++Index)
+   {
+      Deleted[Index] = Get_Replay_Name(Replay, Names, Captured[Index]);
+      Set_Replay_Name(Replay, Names, Captured[Index], 0);
+      if(Names == Replay_Names_Buffer)
+      {
+         Replay->Mappings[Captured[Index]] = 0;
+      }
+   }
+
+   switch(Call)
+   {
+      case Opengl_Call_glDeleteBuffers: glDeleteBuffers(Count, Deleted); break;
+      case Opengl_Call_glDeleteFramebuffers: glDeleteFramebuffers(Count, Deleted); break;
+      case Opengl_Call_glDeleteQueries: glDeleteQueries(Count, Deleted); break;
+      case Opengl_Call_glDeleteRenderbuffers: glDeleteRenderbuffers(Count, Deleted); break;
+      case Opengl_Call_glDeleteTextures: glDeleteTextures(Count, Deleted); break;
+      case Opengl_Call_glDeleteVertexArrays: glDeleteVertexArrays(Count, Deleted); break;
+      default: Assert(!"Not a glDelete* call."); break;
+   }
+
+   End_Temporary_Memory(Temporary);
+}
+
+static void Replay_Opengl_Call(replay_context *Replay, opengl_call Call, u64 *A, u8 *Payload, u32 Payload_Size)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Replay->Arena);
+
+   switch(Call)
+   {
+      case Opengl_Call_Begin_Frame: break;
+
+      case Opengl_Call_Write_Mapped:
+      {
+         Assert(A[0] < OPENGL_REPLAY_MAX_NAMES);
+         u8 *Mapping = Replay->Mappings[A[0]];
+         if(Mapping)
+         {
+            memcpy(Mapping + A[1], Payload, A[2]);
+         }
+      } break;
+
+      case Opengl_Call_glActiveTexture: glActiveTexture((GLenum)A[0]); break;
+      case Opengl_Call_glAttachShader: glAttachShader(Get_Replay_Name(Replay, Replay_Names_Program, A[0]), Get_Replay_Name(Replay, Replay_Names_Program, A[1])); break;
+      case Opengl_Call_glBeginQuery: glBeginQuery((GLenum)A[0], Get_Replay_Name(Replay, Replay_Names_Query, A[1])); break;
+
+      case Opengl_Call_glBindBuffer:
+      {
+         Set_Replay_Binding(Replay, (GLenum)A[0], (GLuint)A[1]);
+         glBindBuffer((GLenum)A[0], Get_Replay_Name(Replay, Replay_Names_Buffer, A[1]));
+      } break;
+
+      case Opengl_Call_glBindBufferRange:
+      {
+         Set_Replay_Binding(Replay, (GLenum)A[0], (GLuint)A[2]);
+         glBindBufferRange((GLenum)A[0], (GLuint)A[1], Get_Replay_Name(Replay, Replay_Names_Buffer, A[2]), (GLintptr)A[3], (GLsizeiptr)A[4]);
+      } break;
+
+      case Opengl_Call_glBindFramebuffer: glBindFramebuffer((GLenum)A[0], Get_Replay_Name(Replay, Replay_Names_Framebuffer, A[1])); break;
+      case Opengl_Call_glBindRenderbuffer: glBindRenderbuffer((GLenum)A[0], Get_Replay_Name(Replay, Replay_Names_Renderbuffer, A[1])); break;
+      case Opengl_Call_glBindTexture: glBindTexture((GLenum)A[0], Get_Replay_Name(Replay, Replay_Names_Texture, A[1])); break;
+      case Opengl_Call_glBindVertexArray: glBindVertexArray(Get_Replay_Name(Replay, Replay_Names_Vertex_Array, A[0])); break;
+      case Opengl_Call_glBlendFunc: glBlendFunc((GLenum)A[0], (GLenum)A[1]); break;
+      case Opengl_Call_glBufferData: glBufferData((GLenum)A[0], (GLsizeiptr)A[1], (Payload_Size) ? Payload : 0, (GLenum)A[2]); break;
+      case Opengl_Call_glBufferStorage: glBufferStorage((GLenum)A[0], (GLsizeiptr)A[1], (Payload_Size) ? Payload : 0, (GLbitfield)A[2]); break;
+      case Opengl_Call_glBufferSubData: glBufferSubData((GLenum)A[0], (GLintptr)A[1], (GLsizeiptr)A[2], Payload); break;
+      case Opengl_Call_glCheckFramebufferStatus: glCheckFramebufferStatus((GLenum)A[0]); break;
+      case Opengl_Call_glClear: glClear((GLbitfield)A[0]); break;
+      case Opengl_Call_glClearColor: glClearColor(Opengl_Replay_Float(A[0]), Opengl_Replay_Float(A[1]), Opengl_Replay_Float(A[2]), Opengl_Replay_Float(A[3])); break;
+
+      case Opengl_Call_glClientWaitSync:
+      {
+         Assert(A[0] < OPENGL_CAPTURE_MAX_SYNCS);
+         glClientWaitSync(Replay->Syncs[A[0]], (GLbitfield)A[1], A[2]);
+      } break;
+
+      case Opengl_Call_glCompileShader: glCompileShader(Get_Replay_Name(Replay, Replay_Names_Program, A[0])); break;
+      case Opengl_Call_glCreateProgram: Set_Replay_Name(Replay, Replay_Names_Program, A[0], glCreateProgram()); break;
+      case Opengl_Call_glCreateShader: Set_Replay_Name(Replay, Replay_Names_Program, A[1], glCreateShader((GLenum)A[0])); break;
+      case Opengl_Call_glCullFace: glCullFace((GLenum)A[0]); break;
+      case Opengl_Call_glDeleteBuffers: Delete_Replay_Names(Replay, Replay_Names_Buffer, Call, (GLsizei)A[0], (GLuint *)Payload); break;
+      case Opengl_Call_glDeleteFramebuffers: Delete_Replay_Names(Replay, Replay_Names_Framebuffer, Call, (GLsizei)A[0], (GLuint *)Payload); break;
+
+      case Opengl_Call_glDeleteProgram:
+      case Opengl_Call_glDeleteShader:
+      {
+         GLuint Name = Get_Replay_Name(Replay, Replay_Names_Program, A[0]);
+         if(Call == Opengl_Call_glDeleteProgram)
+         {
+            glDeleteProgram(Name);
+         }
+         else
+         {
+            glDeleteShader(Name);
+         }
+         Set_Replay_Name(Replay, Replay_Names_Program, A[0], 0);
+      } break;
+
+      case Opengl_Call_glDeleteQueries: Delete_Replay_Names(Replay, Replay_Names_Query, Call, (GLsizei)A[0], (GLuint *)Payload); break;
+      case Opengl_Call_glDeleteRenderbuffers: Delete_Replay_Names(Replay, Replay_Names_Renderbuffer, Call, (GLsizei)A[0], (GLuint *)Payload); break;
+
+      case Opengl_Call_glDeleteSync:
+      {
+         Assert(A[0] < OPENGL_CAPTURE_MAX_SYNCS);
+         glDeleteSync(Replay->Syncs[A[0]]);
+         Replay->Syncs[A[0]] = 0;
+      } break;
+
+      case Opengl_Call_glDeleteTextures: Delete_Replay_Names(Replay, Replay_Names_Texture, Call, (GLsizei)A[0], (GLuint *)Payload); break;
+      case Opengl_Call_glDeleteVertexArrays: Delete_Replay_Names(Replay, Replay_Names_Vertex_Array, Call, (GLsizei)A[0], (GLuint *)Payload); break;
+      case Opengl_Call_glDepthFunc: glDepthFunc((GLenum)A[0]); break;
+      case Opengl_Call_glDepthMask: glDepthMask((GLboolean)A[0]); break;
+      case Opengl_Call_glDetachShader: glDetachShader(Get_Replay_Name(Replay, Replay_Names_Program, A[0]), Get_Replay_Name(Replay, Replay_Names_Program, A[1])); break;
+      case Opengl_Call_glDisable: glDisable((GLenum)A[0]); break;
+      case Opengl_Call_glDrawArrays: glDrawArrays((GLenum)A[0], (GLint)A[1], (GLsizei)A[2]); break;
+      case Opengl_Call_glDrawArraysInstanced: glDrawArraysInstanced((GLenum)A[0], (GLint)A[1], (GLsizei)A[2], (GLsizei)A[3]); break;
+      case Opengl_Call_glDrawElements: glDrawElements((GLenum)A[0], (GLsizei)A[1], (GLenum)A[2], (void *)(uintptr_t)A[3]); break;
+      case Opengl_Call_glDrawElementsBaseVertex: glDrawElementsBaseVertex((GLenum)A[0], (GLsizei)A[1], (GLenum)A[2], (void *)(uintptr_t)A[3], (GLint)A[4]); break;
+      case Opengl_Call_glDrawElementsInstanced: glDrawElementsInstanced((GLenum)A[0], (GLsizei)A[1], (GLenum)A[2], (void *)(uintptr_t)A[3], (GLsizei)A[4]); break;
+      case Opengl_Call_glEnable: glEnable((GLenum)A[0]); break;
+      case Opengl_Call_glEnableVertexAttribArray: glEnableVertexAttribArray((GLuint)A[0]); break;
+      case Opengl_Call_glEndQuery: glEndQuery((GLenum)A[0]); break;
+
+      case Opengl_Call_glFenceSync:
+      {
+         Assert(A[2] < OPENGL_CAPTURE_MAX_SYNCS);
+         Replay->Syncs[A[2]] = glFenceSync((GLenum)A[0], (GLbitfield)A[1]);
+      } break;
+
+      case Opengl_Call_glFinish: glFinish(); break;
+      case Opengl_Call_glFlush: glFlush(); break;
+      case Opengl_Call_glFlushMappedBufferRange: glFlushMappedBufferRange((GLenum)A[0], (GLintptr)A[1], (GLsizeiptr)A[2]); break;
+      case Opengl_Call_glFramebufferRenderbuffer: glFramebufferRenderbuffer((GLenum)A[0], (GLenum)A[1], (GLenum)A[2], Get_Replay_Name(Replay, Replay_Names_Renderbuffer, A[3])); break;
+      case Opengl_Call_glFramebufferTextureLayer: glFramebufferTextureLayer((GLenum)A[0], (GLenum)A[1], Get_Replay_Name(Replay, Replay_Names_Texture, A[2]), (GLint)A[3], (GLint)A[4]); break;
+      case Opengl_Call_glGenBuffers: Generate_Replay_Names(Replay, Replay_Names_Buffer, Call, (GLsizei)A[0], (GLuint *)Payload); break;
+      case Opengl_Call_glGenFramebuffers: Generate_Replay_Names(Replay, Replay_Names_Framebuffer, Call, (GLsizei)A[0], (GLuint *)Payload); break;
+      case Opengl_Call_glGenQueries: Generate_Replay_Names(Replay, Replay_Names_Query, Call, (GLsizei)A[0], (GLuint *)Payload); break;
+      case Opengl_Call_glGenRenderbuffers: Generate_Replay_Names(Replay, Replay_Names_Renderbuffer, Call, (GLsizei)A[0], (GLuint *)Payload); break;
+      case Opengl_Call_glGenTextures: Generate_Replay_Names(Replay, Replay_Names_Texture, Call, (GLsizei)A[0], (GLuint *)Payload); break;
+      case Opengl_Call_glGenVertexArrays: Generate_Replay_Names(Replay, Replay_Names_Vertex_Array, Call, (GLsizei)A[0], (GLuint *)Payload); break;
+      case Opengl_Call_glGenerateMipmap: glGenerateMipmap((GLenum)A[0]); break;
+
+      // NOTE: Queries go to scratch memory. None of them reads more than a
+      // handful of values, except the logs and binaries, which say how much.
+      case Opengl_Call_glGetBufferSubData:
+      {
+         temporary_memory Temporary = Begin_Temporary_Memory(Replay->Arena);
+         void *Data = Push_Size(Replay->Arena, (size)A[2]);
+         glGetBufferSubData((GLenum)A[0], (GLintptr)A[1], (GLsizeiptr)A[2], Data);
+         End_Temporary_Memory(Temporary);
+      } break;
+
+      case Opengl_Call_glGetError: glGetError(); break;
+
+      case Opengl_Call_glGetIntegerv:
+      {
+         GLint Values[16];
+         glGetIntegerv((GLenum)A[0], Values);
+      } break;
+
+      case Opengl_Call_glGetProgramBinary:
+      {
+         GLsizei Length;
+         GLenum Format;
+         void *Binary = Push_Size(Replay->Arena, (size)A[1]);
+         glGetProgramBinary(Get_Replay_Name(Replay, Replay_Names_Program, A[0]), (GLsizei)A[1], &Length, &Format, Binary);
+      } break;
+
+      case Opengl_Call_glGetProgramInfoLog:
+      case Opengl_Call_glGetShaderInfoLog:
+      {
+         GLchar *Log = Push_Size(Replay->Arena, (size)A[1]);
+         GLuint Name = Get_Replay_Name(Replay, Replay_Names_Program, A[0]);
+         if(Call == Opengl_Call_glGetProgramInfoLog)
+         {
+            glGetProgramInfoLog(Name, (GLsizei)A[1], 0, Log);
+         }
+         else
+         {
+            glGetShaderInfoLog(Name, (GLsizei)A[1], 0, Log);
+         }
+      } break;
+
+      case Opengl_Call_glGetProgramiv:
+      {
+         GLint Value;
+         glGetProgramiv(Get_Replay_Name(Replay, Replay_Names_Program, A[0]), (GLenum)A[1], &Value);
+      } break;
+
+      case Opengl_Call_glGetQueryObjectiv:
+      {
+         GLint Value;
+         glGetQueryObjectiv(Get_Replay_Name(Replay, Replay_Names_Query, A[0]), (GLenum)A[1], &Value);
+      } break;
+
+      case Opengl_Call_glGetQueryObjectui64v:
+      {
+         GLuint64 Value;
+         glGetQueryObjectui64v(Get_Replay_Name(Replay, Replay_Names_Query, A[0]), (GLenum)A[1], &Value);
+      } break;
+
+      case Opengl_Call_glGetShaderiv:
+      {
+         GLint Value;
+         glGetShaderiv(Get_Replay_Name(Replay, Replay_Names_Program, A[0]), (GLenum)A[1], &Value);
+      } break;
+
+      case Opengl_Call_glGetString: glGetString((GLenum)A[0]); break;
+      case Opengl_Call_glGetStringi: glGetStringi((GLenum)A[0], (GLuint)A[1]); break;
+
+      case Opengl_Call_glGetUniformLocation:
+      {
+         GLint Location = glGetUniformLocation(Get_Replay_Name(Replay, Replay_Names_Program, A[0]), (GLchar *)Payload);
+         GLint Captured = (GLint)(s64)A[1];
+         if(Captured >= 0)
+         {
+            Assert(A[0] < OPENGL_REPLAY_MAX_PROGRAMS && Captured < OPENGL_REPLAY_MAX_LOCATIONS);
+            Replay->Locations[A[0]*OPENGL_REPLAY_MAX_LOCATIONS + Captured] = Location;
+         }
+      } break;
+
+      case Opengl_Call_glGetUniformBlockIndex:
+      {
+         GLuint Block_Index = glGetUniformBlockIndex(Get_Replay_Name(Replay, Replay_Names_Program, A[0]), (GLchar *)Payload);
+         GLuint Captured = (GLuint)A[1];
+         if(Captured != GL_INVALID_INDEX)
+         {
+            Assert(A[0] < OPENGL_REPLAY_MAX_PROGRAMS && Captured < OPENGL_REPLAY_MAX_BLOCKS);
+            Replay->Block_Indices[A[0]*OPENGL_REPLAY_MAX_BLOCKS + Captured] = Block_Index;
+         }
+      } break;
+
+      case Opengl_Call_glLinkProgram: glLinkProgram(Get_Replay_Name(Replay, Replay_Names_Program, A[0])); break;
+
+      case Opengl_Call_glMapBufferRange:
+      {
+         GLuint Captured = Get_Replay_Binding(Replay, (GLenum)A[0]);
+         u8 *Mapping = glMapBufferRange((GLenum)A[0], (GLintptr)A[1], (GLsizeiptr)A[2], (GLbitfield)A[3]);
+         if(!Mapping)
+         {
+            Replay->Failed_Map_Count++;
+         }
+         else if(A[3] & GL_MAP_READ_BIT)
+         {
+            // NOTE: Same as Consume_Readback_Frame in main_headless.c.
+            u64 Hash = 0;
+            u32 *Pixels = (u32 *)Mapping;
+            for(u64 Index = 0; Index < A[2] / 4; ++Index)
+            {
+               Hash = (Hash * 31) + Pixels[Index];
+            }
+            Replay->Checksum += Hash;
+            Replay->Readback_Count++;
+         }
+         Replay->Mappings[Captured] = Mapping;
+      } break;
+
+      case Opengl_Call_glMaxShaderCompilerThreadsKHR: glMaxShaderCompilerThreadsKHR((GLuint)A[0]); break;
+      case Opengl_Call_glMultiDrawElementsIndirect: glMultiDrawElementsIndirect((GLenum)A[0], (GLenum)A[1], (void *)(uintptr_t)A[2], (GLsizei)A[3], (GLsizei)A[4]); break;
+      case Opengl_Call_glProgramBinary: glProgramBinary(Get_Replay_Name(Replay, Replay_Names_Program, A[0]), (GLenum)A[1], Payload, (GLsizei)A[2]); break;
+      case Opengl_Call_glProgramParameteri: glProgramParameteri(Get_Replay_Name(Replay, Replay_Names_Program, A[0]), (GLenum)A[1], (GLint)A[2]); break;
+
+      case Opengl_Call_glReadPixels:
+      {
+         void *Pixels = (void *)(uintptr_t)A[6];
+         if(!A[7])
+         {
+            Pixels = Push_Size(Replay->Arena, Get_Opengl_Capture_Pixels_Size((GLenum)A[4], (GLsizei)A[2], (GLsizei)A[3], 1));
+         }
+         glReadPixels((GLint)A[0], (GLint)A[1], (GLsizei)A[2], (GLsizei)A[3], (GLenum)A[4], (GLenum)A[5], Pixels);
+      } break;
+
+      case Opengl_Call_glRenderbufferStorage: glRenderbufferStorage((GLenum)A[0], (GLenum)A[1], (GLsizei)A[2], (GLsizei)A[3]); break;
+      case Opengl_Call_glScissor: glScissor((GLint)A[0], (GLint)A[1], (GLsizei)A[2], (GLsizei)A[3]); break;
+
+      case Opengl_Call_glShaderSource:
+      {
+         const GLchar *Source = (GLchar *)Payload;
+         GLint Length = (GLint)Payload_Size;
+         glShaderSource(Get_Replay_Name(Replay, Replay_Names_Program, A[0]), 1, &Source, &Length);
+      } break;
+
+      case Opengl_Call_glTexImage3D:
+      {
+         void *Pixels = (Payload_Size) ? Payload : (void *)(uintptr_t)A[9];
+         glTexImage3D((GLenum)A[0], (GLint)A[1], (GLint)A[2], (GLsizei)A[3], (GLsizei)A[4], (GLsizei)A[5], (GLint)A[6], (GLenum)A[7], (GLenum)A[8], Pixels);
+      } break;
+
+      case Opengl_Call_glTexParameteri: glTexParameteri((GLenum)A[0], (GLenum)A[1], (GLint)A[2]); break;
+
+      case Opengl_Call_glTexSubImage3D:
+      {
+         void *Pixels = (Payload_Size) ? Payload : (void *)(uintptr_t)A[10];
+         glTexSubImage3D((GLenum)A[0], (GLint)A[1], (GLint)A[2], (GLint)A[3], (GLint)A[4], (GLsizei)A[5], (GLsizei)A[6], (GLsizei)A[7], (GLenum)A[8], (GLenum)A[9], Pixels);
+      } break;
+
+      case Opengl_Call_glUniformBlockBinding:
+      {
+         Assert(A[0] < OPENGL_REPLAY_MAX_PROGRAMS && A[1] < OPENGL_REPLAY_MAX_BLOCKS);
+         GLuint Block_Index = Replay->Block_Indices[A[0]*OPENGL_REPLAY_MAX_BLOCKS + A[1]];
+         glUniformBlockBinding(Get_Replay_Name(Replay, Replay_Names_Program, A[0]), Block_Index, (GLuint)A[2]);
+      } break;
+
+      case Opengl_Call_glUniform1ui: glUniform1ui(Get_Replay_Location(Replay, A[0]), (GLuint)A[1]); break;
+      case Opengl_Call_glUniform2f: glUniform2f(Get_Replay_Location(Replay, A[0]), Opengl_Replay_Float(A[1]), Opengl_Replay_Float(A[2])); break;
+      case Opengl_Call_glUniform4f: glUniform4f(Get_Replay_Location(Replay, A[0]), Opengl_Replay_Float(A[1]), Opengl_Replay_Float(A[2]), Opengl_Replay_Float(A[3]), Opengl_Replay_Float(A[4])); break;
+
+      case Opengl_Call_glUnmapBuffer:
+      {
+         Replay->Mappings[Get_Replay_Binding(Replay, (GLenum)A[0])] = 0;
+         glUnmapBuffer((GLenum)A[0]);
+      } break;
+
+      case Opengl_Call_glUseProgram:
+      {
+         Replay->Program = (GLuint)A[0];
+         glUseProgram(Get_Replay_Name(Replay, Replay_Names_Program, A[0]));
+      } break;
+
+      case Opengl_Call_glVertexAttribDivisor: glVertexAttribDivisor((GLuint)A[0], (GLuint)A[1]); break;
+      case Opengl_Call_glVertexAttribIPointer: glVertexAttribIPointer((GLuint)A[0], (GLint)A[1], (GLenum)A[2], (GLsizei)A[3], (void *)(uintptr_t)A[4]); break;
+      case Opengl_Call_glVertexAttribPointer: glVertexAttribPointer((GLuint)A[0], (GLint)A[1], (GLenum)A[2], (GLboolean)A[3], (GLsizei)A[4], (void *)(uintptr_t)A[5]); break;
+      case Opengl_Call_glViewport: glViewport((GLint)A[0], (GLint)A[1], (GLsizei)A[2], (GLsizei)A[3]); break;
+
+      case Opengl_Call_Count: Assert(!"Invalid call."); break;
+   }
+
+   End_Temporary_Memory(Temporary);
+}
+
+static int Compare_Frame_Times(const void *A, const void *B)
+{
+   u64 Left = *(u64 *)A;
+   u64 Right = *(u64 *)B;
+   int Result = (Left > Right) - (Left < Right);
+   return(Result);
+}
+
+static void Print_Usage(char *Program)
+{
+   fprintf(stderr, "Usage: %s [-finish] [-per-frame] trace.gltrace\n", Program);
+}
+
+int main(int Argument_Count, char **Arguments)
+{
+   char *Path = 0;
+   bool Finish_Frames = false;
+   bool Print_Frames = false;
+   for(int Index = 1; Index < Argument_Count; ++Index)
+   {
+      if(strcmp(Arguments[Index], "-finish") == 0)
+      {
+         Finish_Frames = true;
+      }
+      else if(strcmp(Arguments[Index], "-per-frame") == 0)
+      {
+         Print_Frames = true;
+      }
+      else if(!Path && Arguments[Index][0] != '-')
+      {
+         Path = Arguments[Index];
+      }
+      else
+      {
+         Path = 0;
+         break;
+      }
+   }
+
+   if(!Path)
+   {
+      Print_Usage(Arguments[0]);
+      return(1);
+   }
+
+   size File_Size = 0;
+   u8 *File = Map_Entire_File(Path, &File_Size);
+   if(!File)
+   {
+      fprintf(stderr, "Failed to read %s.\n", Path);
+      return(1);
+   }
+
+   opengl_capture_header *Header = (opengl_capture_header *)File;
+   if((size)sizeof(*Header) > File_Size || Header->Magic != OPENGL_CAPTURE_MAGIC || Header->Version != OPENGL_CAPTURE_VERSION)
+   {
+      fprintf(stderr, "%s isn't a version %d GL trace.\n", Path, OPENGL_CAPTURE_VERSION);
+      return(1);
+   }
+
+   platform_memory Memory = {0};
+   if(!Initialize_Memory(&Memory, 256*1024*1024, 0))
+   {
+      return(1);
+   }
+
+   replay_context Replay = {0};
+   Replay.Opengl_Display = EGL_NO_DISPLAY;
+   Replay.Opengl_Context = EGL_NO_CONTEXT;
+   Replay.Opengl_Surface = EGL_NO_SURFACE;
+   Replay.Arena = &Memory.Permanent;
+
+   for(int Names = 0; Names < Replay_Names_Count; ++Names)
+   {
+      Replay.Names[Names] = Push_Array(Replay.Arena, OPENGL_REPLAY_MAX_NAMES, GLuint);
+      memset(Replay.Names[Names], 0, OPENGL_REPLAY_MAX_NAMES*sizeof(GLuint));
+   }
+   Replay.Mappings = Push_Array(Replay.Arena, OPENGL_REPLAY_MAX_NAMES, u8 *);
+   memset(Replay.Mappings, 0, OPENGL_REPLAY_MAX_NAMES*sizeof(u8 *));
+
+   u32 Location_Count = OPENGL_REPLAY_MAX_PROGRAMS*OPENGL_REPLAY_MAX_LOCATIONS;
+   Replay.Locations = Push_Array(Replay.Arena, Location_Count, GLint);
+   memset(Replay.Locations, 0xFF, Location_Count*sizeof(GLint));
+
+   u32 Block_Count = OPENGL_REPLAY_MAX_PROGRAMS*OPENGL_REPLAY_MAX_BLOCKS;
+   Replay.Block_Indices = Push_Array(Replay.Arena, Block_Count, GLuint);
+   memset(Replay.Block_Indices, 0xFF, Block_Count*sizeof(GLuint));
+
+   u32 Frame_Count = Header->Frame_Count;
+   u64 *Frame_Times = Push_Array(Replay.Arena, Frame_Count + 1, u64);
+
+   if(!Initialize_Replay_Egl(&Replay, (int)Header->Width, (int)Header->Height))
+   {
+      Destroy_Replay_Egl(&Replay);
+      return(1);
+   }
+
+   printf("Replaying %s: %u frames, %llu calls, %.2f MB, %ux%u on %s\n", Path, Frame_Count,
+          (unsigned long long)Header->Record_Count, (double)File_Size / (1024.0*1024.0),
+          Header->Width, Header->Height, glGetString(GL_RENDERER));
+
+   // NOTE: Everything before the first frame marker is setup, and each frame
+   // runs until the next marker, or the end of the trace for the last one.
+   bool Valid = true;
+   u32 Frame_Index = 0;
+   u64 Start = Get_Clock();
+   u64 Setup_Time = 0;
+   u64 Frame_Start = Start;
+
+   u8 *At = File + sizeof(*Header);
+   u8 *End = File + File_Size;
+   while(At < End)
+   {
+      opengl_capture_record *Record = (opengl_capture_record *)At;
+      if(At + sizeof(*Record) > End)
+      {
+         Valid = false;
+         break;
+      }
+
+      u8 *Payload = At + sizeof(*Record) + Record->Argument_Count*sizeof(u64);
+      u8 *Next = Payload + ((Record->Payload_Size + 7) & ~7ull);
+      if(Next > End || Record->Call >= Opengl_Call_Count || Record->Argument_Count > OPENGL_REPLAY_MAX_ARGUMENTS)
+      {
+         Valid = false;
+         break;
+      }
+
+      // NOTE: Copied out, so that a short record reads zeroes rather than
+      // running into the next one.
+      u64 Record_Arguments[OPENGL_REPLAY_MAX_ARGUMENTS] = {0};
+      memcpy(Record_Arguments, At + sizeof(*Record), Record->Argument_Count*sizeof(u64));
+
+      if(Record->Call == Opengl_Call_Begin_Frame)
+      {
+         if(Finish_Frames)
+         {
+            glFinish();
+         }
+
+         u64 Now = Get_Clock();
+         if(Frame_Index == 0)
+         {
+            Setup_Time = Now - Start;
+         }
+         else if(Frame_Index <= Frame_Count)
+         {
+            Frame_Times[Frame_Index - 1] = Now - Frame_Start;
+         }
+         Frame_Start = Now;
+         Frame_Index++;
+      }
+
+      Replay_Opengl_Call(&Replay, (opengl_call)Record->Call, Record_Arguments, Payload, Record->Payload_Size);
+      Replay.Call_Counts[Record->Call]++;
+      At = Next;
+   }
+
+   glFinish();
+   u64 Now = Get_Clock();
+   if(Frame_Index > 0 && Frame_Index <= Frame_Count)
+   {
+      Frame_Times[Frame_Index - 1] = Now - Frame_Start;
+   }
+   double Elapsed = (double)(Now - Start) / 1e9;
+
+   if(!Valid)
+   {
+      fprintf(stderr, "%s is truncated or corrupt; replay stopped %td bytes in.\n", Path, At - File);
+   }
+   if(Frame_Index != Frame_Count)
+   {
+      fprintf(stderr, "Trace has %u frame markers, but its header says %u.\n", Frame_Index, Frame_Count);
+      Frame_Count = (Frame_Index < Frame_Count) ? Frame_Index : Frame_Count;
+   }
+
+   if(Print_Frames)
+   {
+      for(u32 Index = 0; Index < Frame_Count; ++Index)
+      {
+         printf("Frame %u: %.3f ms\n", Index, (double)Frame_Times[Index] / 1e6);
+      }
+   }
+
+   printf("Replayed in %.3fs (%s): setup %.3f ms\n", Elapsed,
+          (Finish_Frames) ? "finishing every frame" : "back to back", (double)Setup_Time / 1e6);
+
+   if(Frame_Count > 0)
+   {
+      u64 Total = 0;
+      for(u32 Index = 0; Index < Frame_Count; ++Index)
+      {
+         Total += Frame_Times[Index];
+      }
+      qsort(Frame_Times, Frame_Count, sizeof(u64), Compare_Frame_Times);
+
+      double Mean = (double)Total / 1e6 / Frame_Count;
+      printf("Frames: %.3f ms mean (%.2f frames/s), min %.3f, median %.3f, p95 %.3f, p99 %.3f, max %.3f ms\n",
+             Mean, 1000.0 / Mean,
+             (double)Frame_Times[0] / 1e6,
+             (double)Frame_Times[Frame_Count / 2] / 1e6,
+             (double)Frame_Times[(Frame_Count*95) / 100] / 1e6,
+             (double)Frame_Times[(Frame_Count*99) / 100] / 1e6,
+             (double)Frame_Times[Frame_Count - 1] / 1e6);
+   }
+
+   // NOTE: The busiest calls, which is usually where a regression shows up.
+   printf("Calls:");
+   for(int Rank = 0; Rank < 8; ++Rank)
+   {
+      int Busiest = -1;
+      for(int Call = 0; Call < Opengl_Call_Count; ++Call)
+      {
+         if(Replay.Call_Counts[Call] > 0 && (Busiest < 0 || Replay.Call_Counts[Call] > Replay.Call_Counts[Busiest]))
+         {
+            Busiest = Call;
+         }
+      }
+      if(Busiest >= 0)
+      {
+         printf(" %s %llu", Opengl_Call_Names[Busiest], (unsigned long long)Replay.Call_Counts[Busiest]);
+         Replay.Call_Counts[Busiest] = 0;
+      }
+   }
+   printf("\n");
+
+   if(Replay.Readback_Count > 0)
+   {
+      printf("Read back %u frames, checksum %016llx\n", Replay.Readback_Count, (unsigned long long)Replay.Checksum);
+   }
+   if(Replay.Failed_Map_Count > 0)
+   {
+      fprintf(stderr, "%u buffer maps failed.\n", Replay.Failed_Map_Count);
+   }
+
+   GLenum Error = glGetError();
+   if(Error != GL_NO_ERROR)
+   {
+      fprintf(stderr, "Replay finished with GL error 0x%x.\n", Error);
+   }
+
+   Destroy_Replay_Egl(&Replay);
+   Unmap_Entire_File(File, File_Size);
+
+   return((Valid) ? 0 : 1);
+}
@@ -0,0 +1,451 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Shader management. Programs are registered once with
+// Add_Opengl_Program, and the returned handle stays valid across rebuilds.
+// Builds are issued all at once and polled for completion each frame, linked
+// programs are cached on disk, and edits under OPENGL_SHADER_DIRECTORY are
+// picked up and swapped in without restarting.
+
+static void Print_Shader_Info_Log(arena *Arena, GLuint Shader)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   GLint Length = 0;
+   glGetShaderiv(Shader, GL_INFO_LOG_LENGTH, &Length);
+   if(Length > 0)
+   {
+      GLchar *Message = Push_Array(Arena, Length, GLchar);
+      glGetShaderInfoLog(Shader, Length, 0, Message);
+      fprintf(stderr, "%s\n", Message);
+   }
+
+   End_Temporary_Memory(Temporary);
+}
+
+static void Print_Program_Info_Log(arena *Arena, GLuint Program)
+{
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   GLint Length = 0;
+   glGetProgramiv(Program, GL_INFO_LOG_LENGTH, &Length);
+   if(Length > 0)
+   {
+      GLchar *Message = Push_Array(Arena, Length, GLchar);
+      glGetProgramInfoLog(Program, Length, 0, Message);
+      fprintf(stderr, "%s\n", Message);
+   }
+
+   End_Temporary_Memory(Temporary);
+}
+
+static void Initialize_Opengl_Program_Cache(opengl_program_cache *Cache)
+{
+   // NOTE: A binary is only valid for the exact driver that produced it, so
+   // the driver identity is folded into every key.
+   char *Driver_Strings[] =
+   {
+      (char *)glGetString(GL_VENDOR),
+      (char *)glGetString(GL_RENDERER),
+      (char *)glGetString(GL_VERSION),
+   };
+
+   Cache->Driver_Hash = HASH_SEED;
+   for(u32 Index = 0; Index < Array_Count(Driver_Strings); ++Index)
+   {
+      char *String = (Driver_Strings[Index]) ? Driver_Strings[Index] : "";
+      Cache->Driver_Hash = Hash_Bytes(Cache->Driver_Hash, String, strlen(String) + 1);
+   }
+
+   GLint Format_Count = 0;
+   glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &Format_Count);
+   // NOTE: A captured binary would only load on the driver that made it,
+   // while a trace of the compile replays anywhere.
+   Cache->Enabled = (Format_Count > 0 && !Is_Opengl_Capture_Active());
+}
+
+static u64 Get_Opengl_Program_Key(opengl_program_cache *Cache, char *Shared_Code, char *Vertex_Code, char *Fragment_Code, char *Defines)
+{
+   u64 Result = Cache->Driver_Hash;
+   Result = Hash_Bytes(Result, Shared_Code, strlen(Shared_Code) + 1);
+   Result = Hash_Bytes(Result, Vertex_Code, strlen(Vertex_Code) + 1);
+   Result = Hash_Bytes(Result, Fragment_Code, strlen(Fragment_Code) + 1);
+   if(Defines)
+   {
+      Result = Hash_Bytes(Result, Defines, strlen(Defines));
+   }
+   return(Result);
+}
+
+static GLuint Load_Cached_Opengl_Program(arena *Arena, char *Path, u64 Key)
+{
+   GLuint Result = 0;
+
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   size File_Size = 0;
+   u8 *File = (u8 *)Read_Entire_File(Arena, Path, &File_Size);
+   if(File && File_Size >= (size)sizeof(opengl_program_cache_header))
+   {
+      opengl_program_cache_header *Header = (opengl_program_cache_header *)File;
+      if(Header->Magic == OPENGL_PROGRAM_CACHE_MAGIC &&
+         Header->Version == OPENGL_PROGRAM_CACHE_VERSION &&
+         Header->Key == Key &&
+         Header->Binary_Size == File_Size - sizeof(*Header))
+      {
+         Result = glCreateProgram();
+         glProgramBinary(Result, Header->Binary_Format, File + sizeof(*Header), Header->Binary_Size);
+
+         // NOTE: Drivers are allowed to reject a binary for any reason (e.g. an
+         // update that didn't change the version string), so this is not an
+         // error, just a miss.
+         GLint Link_Status = 0;
+         glGetProgramiv(Result, GL_LINK_STATUS, &Link_Status);
+         if(!Link_Status)
+         {
+            glDeleteProgram(Result);
+            Result = 0;
+         }
+      }
+   }
+
+   End_Temporary_Memory(Temporary);
+
+   return(Result);
+}
+
+static void Store_Cached_Opengl_Program(arena *Arena, char *Path, u64 Key, GLuint Program)
+{
+   GLint Binary_Size = 0;
+   glGetProgramiv(Program, GL_PROGRAM_BINARY_LENGTH, &Binary_Size);
+   if(Binary_Size > 0)
+   {
+      temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+      size File_Size = sizeof(opengl_program_cache_header) + Binary_Size;
+      u8 *File = Push_Size(Arena, File_Size);
+
+      opengl_program_cache_header *Header = (opengl_program_cache_header *)File;
+      Header->Magic = OPENGL_PROGRAM_CACHE_MAGIC;
+      Header->Version = OPENGL_PROGRAM_CACHE_VERSION;
+      Header->Key = Key;
+
+      GLsizei Written = 0;
+      GLenum Format = 0;
+      glGetProgramBinary(Program, Binary_Size, &Written, &Format, File + sizeof(*Header));
+      Header->Binary_Format = Format;
+      Header->Binary_Size = Written;
+
+      if(Written > 0)
+      {
+         Write_Entire_File(Path, File, sizeof(*Header) + Written);
+      }
+
+      End_Temporary_Memory(Temporary);
+   }
+}
+
+static void Initialize_Opengl_Shaders(opengl_context *GL)
+{
+   opengl_shader_manager *Shaders = &GL->Shaders;
+
+   // NOTE: With parallel compilation the driver compiles and links on its own
+   // threads, and we poll GL_COMPLETION_STATUS instead of blocking on the
+   // first status query.
+   Shaders->Has_Parallel_Compile = (Opengl_Has_Extension("GL_KHR_parallel_shader_compile") ||
+                                    Opengl_Has_Extension("GL_ARB_parallel_shader_compile"));
+   if(Shaders->Has_Parallel_Compile)
+   {
+      glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+   }
+
+   Shaders->Watching = Watch_Directory(OPENGL_SHADER_DIRECTORY);
+}
+
+static u32 Add_Opengl_Program(opengl_context *GL, char *Vertex_Path, char *Fragment_Path, char *Defines)
+{
+   opengl_shader_manager *Shaders = &GL->Shaders;
+   Assert(Shaders->Program_Count < OPENGL_MAX_PROGRAMS);
+
+   u32 Result = Shaders->Program_Count++;
+
+   opengl_program *Program = Shaders->Programs + Result;
+   Program->Vertex_Path = Vertex_Path;
+   Program->Fragment_Path = Fragment_Path;
+   Program->Defines = Defines;
+   Program->Dirty = true;
+
+   return(Result);
+}
+
+static GLuint Get_Opengl_Program(opengl_context *GL, u32 Handle)
+{
+   Assert(Handle < GL->Shaders.Program_Count);
+
+   GLuint Result = GL->Shaders.Programs[Handle].Program;
+   return(Result);
+}
+
+static bool Has_Pending_Opengl_Programs(opengl_context *GL)
+{
+   // NOTE: Builds only finish when a frame checks on them, so platforms that
+   // skip idle frames keep going while this is true.
+   bool Result = false;
+   for(u32 Index = 0; !Result && Index < GL->Shaders.Program_Count; ++Index)
+   {
+      opengl_program *Program = GL->Shaders.Programs + Index;
+      Result = (Program->Dirty || Program->Building);
+   }
+   return(Result);
+}
+
+static GLuint Issue_Opengl_Shader(GLenum Type, char *Source, char *Defines, char *Shared)
+{
+   // NOTE: Defines have to come after the #version directive, so the source is
+   // split around the end of that line and the defines are spliced in,
+   // followed by the shared declarations (which can depend on them).
+   char *Version_End = Source;
+   char *Version = strstr(Source, "#version");
+   if(Version)
+   {
+      Version_End = strchr(Version, '\n');
+      Version_End = (Version_End) ? Version_End + 1 : Version + strlen(Version);
+   }
+
+   const GLchar *Strings[] = {Source, (Defines) ? Defines : "", Shared, Version_End};
+   GLint Lengths[] = {(GLint)(Version_End - Source), -1, -1, -1};
+
+   // NOTE: No status query here. Asking for GL_COMPILE_STATUS right away
+   // would force the driver to finish this compile before we issue the next.
+   GLuint Result = glCreateShader(Type);
+   glShaderSource(Result, Array_Count(Strings), Strings, Lengths);
+   glCompileShader(Result);
+
+   return(Result);
+}
+
+static void Swap_Opengl_Program(opengl_shader_manager *Shaders, opengl_program *Program, GLuint New_Program)
+{
+   // NOTE: Swaps only happen while updating shaders at the top of a frame, so
+   // a frame never draws with a mix of old and new programs. GL defers the
+   // actual deletion until in-flight draws using the old program are done.
+   if(Program->Program)
+   {
+      glDeleteProgram(Program->Program);
+      Shaders->Reload_Count++;
+   }
+   Program->Program = New_Program;
+
+   // NOTE: GLSL 3.30 can't give blocks a binding in the source, so each one
+   // is pointed at its binding point by name. Blocks a program doesn't use
+   // are compiled out and come back as GL_INVALID_INDEX.
+   char *Block_Names[Uniform_Block_Count] =
+   {
+      [Uniform_Block_Camera] = "Camera_Uniforms",
+      [Uniform_Block_Pass] = "Pass_Uniforms",
+      [Uniform_Block_Object] = "Object_Uniforms",
+   };
+
+   Program->Uses_Object_Uniforms = false;
+   Program->Object_Index_Location = glGetUniformLocation(New_Program, "Object_Index");
+   Program->Pixel_Scale_Location = glGetUniformLocation(New_Program, "Pixel_Scale");
+   Program->Tint_Location = glGetUniformLocation(New_Program, "Tint");
+   for(u32 Block = 0; Block < Uniform_Block_Count; ++Block)
+   {
+      GLuint Block_Index = glGetUniformBlockIndex(New_Program, Block_Names[Block]);
+      if(Block_Index != GL_INVALID_INDEX)
+      {
+         glUniformBlockBinding(New_Program, Block_Index, Block);
+         if(Block == Uniform_Block_Object)
+         {
+            Program->Uses_Object_Uniforms = true;
+         }
+      }
+   }
+}
+
+static void Report_Opengl_Program_Build(opengl_context *GL, opengl_program *Program, bool Hit)
+{
+   opengl_program_cache *Cache = &GL->Program_Cache;
+
+   u64 Elapsed = Get_Clock() - Program->Build_Start;
+   if(Hit)
+   {
+      Cache->Hit_Count++;
+      Cache->Hit_Time += Elapsed;
+   }
+   else
+   {
+      Cache->Miss_Count++;
+      Cache->Miss_Time += Elapsed;
+   }
+
+   printf("Program %s + %s: %s in %.3f ms\n", Program->Vertex_Path, Program->Fragment_Path,
+          (Hit) ? "cache hit" : (Cache->Enabled) ? "cache miss, compiled" : "compiled (no cache)",
+          (double)Elapsed / 1e6);
+}
+
+static void Start_Opengl_Program_Build(opengl_context *GL, opengl_program *Program)
+{
+   opengl_program_cache *Cache = &GL->Program_Cache;
+   arena *Arena = &GL->Memory->Frame;
+
+   Program->Dirty = false;
+   Program->Build_Start = Get_Clock();
+
+   // NOTE: Shader sources are only needed until they're handed to GL.
+   temporary_memory Temporary = Begin_Temporary_Memory(Arena);
+
+   char *Shared_Code = Read_Entire_File(Arena, OPENGL_SHADER_SHARED_PATH, 0);
+   char *Vertex_Code = Read_Entire_File(Arena, Program->Vertex_Path, 0);
+   char *Fragment_Code = Read_Entire_File(Arena, Program->Fragment_Path, 0);
+   if(Shared_Code && Vertex_Code && Fragment_Code)
+   {
+      Program->Pending_Key = Get_Opengl_Program_Key(Cache, Shared_Code, Vertex_Code, Fragment_Code, Program->Defines);
+      snprintf(Program->Cache_Path, sizeof(Program->Cache_Path), OPENGL_PROGRAM_CACHE_DIRECTORY "/%016llx.bin",
+               (unsigned long long)Program->Pending_Key);
+
+      GLuint Cached_Program = 0;
+      if(Cache->Enabled && File_Exists(Program->Cache_Path))
+      {
+         Cached_Program = Load_Cached_Opengl_Program(Arena, Program->Cache_Path, Program->Pending_Key);
+      }
+
+      if(Cached_Program)
+      {
+         Swap_Opengl_Program(&GL->Shaders, Program, Cached_Program);
+         Report_Opengl_Program_Build(GL, Program, true);
+      }
+      else
+      {
+         Program->Pending_Shaders[0] = Issue_Opengl_Shader(GL_VERTEX_SHADER, Vertex_Code, Program->Defines, Shared_Code);
+         Program->Pending_Shaders[1] = Issue_Opengl_Shader(GL_FRAGMENT_SHADER, Fragment_Code, Program->Defines, Shared_Code);
+
+         Program->Pending_Program = glCreateProgram();
+         if(Cache->Enabled)
+         {
+            glProgramParameteri(Program->Pending_Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+         }
+         glAttachShader(Program->Pending_Program, Program->Pending_Shaders[0]);
+         glAttachShader(Program->Pending_Program, Program->Pending_Shaders[1]);
+         glLinkProgram(Program->Pending_Program);
+
+         Program->Building = true;
+      }
+   }
+   else
+   {
+      // NOTE: Editors can briefly leave a file missing while saving. Keep the
+      // live program; the next change event will retry.
+      fprintf(stderr, "Failed to load sources for %s + %s.\n", Program->Vertex_Path, Program->Fragment_Path);
+      Assert(Program->Program);
+   }
+
+   End_Temporary_Memory(Temporary);
+}
+
+static bool Is_Opengl_Program_Build_Complete(opengl_shader_manager *Shaders, opengl_program *Program)
+{
+   bool Result = true;
+   if(Shaders->Has_Parallel_Compile)
+   {
+      GLint Complete = GL_FALSE;
+      glGetProgramiv(Program->Pending_Program, GL_COMPLETION_STATUS_KHR, &Complete);
+      Result = (Complete == GL_TRUE);
+   }
+
+   return(Result);
+}
+
+static void Finish_Opengl_Program_Build(opengl_context *GL, opengl_program *Program)
+{
+   arena *Arena = &GL->Memory->Frame;
+
+   GLint Link_Status = 0;
+   glGetProgramiv(Program->Pending_Program, GL_LINK_STATUS, &Link_Status);
+   if(Link_Status)
+   {
+      if(GL->Program_Cache.Enabled)
+      {
+         Store_Cached_Opengl_Program(Arena, Program->Cache_Path, Program->Pending_Key, Program->Pending_Program);
+      }
+
+      Swap_Opengl_Program(&GL->Shaders, Program, Program->Pending_Program);
+      Report_Opengl_Program_Build(GL, Program, false);
+   }
+   else
+   {
+      for(u32 Index = 0; Index < Array_Count(Program->Pending_Shaders); ++Index)
+      {
+         GLint Compile_Status = 0;
+         glGetShaderiv(Program->Pending_Shaders[Index], GL_COMPILE_STATUS, &Compile_Status);
+         if(!Compile_Status)
+         {
+            Print_Shader_Info_Log(Arena, Program->Pending_Shaders[Index]);
+         }
+      }
+      Print_Program_Info_Log(Arena, Program->Pending_Program);
+      glDeleteProgram(Program->Pending_Program);
+
+      // NOTE: A broken edit keeps the previous program running. Failing
+      // without anything to fall back on is still fatal.
+      fprintf(stderr, "Failed to build %s + %s.\n", Program->Vertex_Path, Program->Fragment_Path);
+      Assert(Program->Program);
+   }
+
+   for(u32 Index = 0; Index < Array_Count(Program->Pending_Shaders); ++Index)
+   {
+      if(Link_Status)
+      {
+         glDetachShader(Program->Pending_Program, Program->Pending_Shaders[Index]);
+      }
+      glDeleteShader(Program->Pending_Shaders[Index]);
+      Program->Pending_Shaders[Index] = 0;
+   }
+
+   Program->Pending_Program = 0;
+   Program->Building = false;
+}
+
+static void Update_Opengl_Shaders(opengl_context *GL, bool Wait)
+{
+   opengl_shader_manager *Shaders = &GL->Shaders;
+
+   char *Changed_Path;
+   while((Changed_Path = Get_Changed_File()))
+   {
+      for(u32 Index = 0; Index < Shaders->Program_Count; ++Index)
+      {
+         opengl_program *Program = Shaders->Programs + Index;
+         // NOTE: Every program includes the shared declarations.
+         if(strcmp(Changed_Path, Program->Vertex_Path) == 0 ||
+            strcmp(Changed_Path, Program->Fragment_Path) == 0 ||
+            strcmp(Changed_Path, OPENGL_SHADER_SHARED_PATH) == 0)
+         {
+            Program->Dirty = true;
+         }
+      }
+   }
+
+   // NOTE: Every build is issued before any of them is checked, so the driver
+   // can work on all of them at once. A program edited again mid-build stays
+   // dirty and is restarted once the current build lands.
+   for(u32 Index = 0; Index < Shaders->Program_Count; ++Index)
+   {
+      opengl_program *Program = Shaders->Programs + Index;
+      if(Program->Dirty && !Program->Building)
+      {
+         Start_Opengl_Program_Build(GL, Program);
+         GL->Loading_This_Frame = true;
+      }
+   }
+
+   for(u32 Index = 0; Index < Shaders->Program_Count; ++Index)
+   {
+      opengl_program *Program = Shaders->Programs + Index;
+      if(Program->Building && (Wait || Is_Opengl_Program_Build_Complete(Shaders, Program)))
+      {
+         Finish_Opengl_Program_Build(GL, Program);
+         GL->Loading_This_Frame = true;
+      }
+   }
+}
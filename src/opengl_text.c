@@ -0,0 +1,484 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Text rendering (see opengl_text in opengl_renderer.h). Glyphs are
+// laid out and rasterized on the CPU, on the main thread; GL only sees the
+// atlas rows that changed and one instanced draw.
+
+#define OPENGL_TEXT_FONT_WIDTH 5
+#define OPENGL_TEXT_FONT_HEIGHT 7
+#define OPENGL_TEXT_FONT_ADVANCE 6 // NOTE: Font pixels, one of them spacing.
+#define OPENGL_TEXT_FONT_LINE_HEIGHT 10
+
+// NOTE: Each font pixel covers OPENGL_TEXT_TEXEL_SCALE texels, and the glyph
+// sits at OPENGL_TEXT_GLYPH_X/Y within its cell. The distance field is
+// clamped at OPENGL_TEXT_SPREAD texels, which is less than the margins, so
+// the texels along a cell's edges are always empty and filtering never
+// bleeds one glyph into the next.
+#define OPENGL_TEXT_TEXEL_SCALE 3
+#define OPENGL_TEXT_GLYPH_X 8
+#define OPENGL_TEXT_GLYPH_Y 5
+#define OPENGL_TEXT_SPREAD 4.0f
+
+// NOTE: Rows run top down, with bit 4 the leftmost pixel.
+static u8 Opengl_Text_Font[OPENGL_TEXT_CODEPOINT_COUNT][OPENGL_TEXT_FONT_HEIGHT] =
+{
+   {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+   {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}, // '!'
+   {0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00}, // '"'
+   {0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A}, // '#'
+   {0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04}, // '$'
+   {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}, // '%'
+   {0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D}, // '&'
+   {0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00}, // '''
+   {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}, // '('
+   {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}, // ')'
+   {0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00}, // '*'
+   {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00}, // '+'
+   {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08}, // ','
+   {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}, // '-'
+   {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}, // '.'
+   {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}, // '/'
+   {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, // '0'
+   {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}, // '1'
+   {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, // '2'
+   {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}, // '3'
+   {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, // '4'
+   {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}, // '5'
+   {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, // '6'
+   {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // '7'
+   {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, // '8'
+   {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}, // '9'
+   {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}, // ':'
+   {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08}, // ';'
+   {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02}, // '<'
+   {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00}, // '='
+   {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08}, // '>'
+   {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04}, // '?'
+   {0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E}, // '@'
+   {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // 'A'
+   {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}, // 'B'
+   {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, // 'C'
+   {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}, // 'D'
+   {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, // 'E'
+   {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}, // 'F'
+   {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, // 'G'
+   {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // 'H'
+   {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 'I'
+   {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}, // 'J'
+   {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // 'K'
+   {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}, // 'L'
+   {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, // 'M'
+   {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // 'N'
+   {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // 'O'
+   {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}, // 'P'
+   {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, // 'Q'
+   {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}, // 'R'
+   {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, // 'S'
+   {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // 'T'
+   {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // 'U'
+   {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}, // 'V'
+   {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, // 'W'
+   {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}, // 'X'
+   {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}, // 'Y'
+   {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}, // 'Z'
+   {0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E}, // '['
+   {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00}, // '\\'
+   {0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E}, // ']'
+   {0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00}, // '^'
+   {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F}, // '_'
+   {0x08, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00}, // '`'
+   {0x00, 0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F}, // 'a'
+   {0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1E}, // 'b'
+   {0x00, 0x00, 0x0E, 0x10, 0x10, 0x11, 0x0E}, // 'c'
+   {0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x0F}, // 'd'
+   {0x00, 0x00, 0x0E, 0x11, 0x1F, 0x10, 0x0E}, // 'e'
+   {0x06, 0x09, 0x08, 0x1C, 0x08, 0x08, 0x08}, // 'f'
+   {0x00, 0x0F, 0x11, 0x11, 0x0F, 0x01, 0x0E}, // 'g'
+   {0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11}, // 'h'
+   {0x04, 0x00, 0x0C, 0x04, 0x04, 0x04, 0x0E}, // 'i'
+   {0x02, 0x00, 0x06, 0x02, 0x02, 0x12, 0x0C}, // 'j'
+   {0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12}, // 'k'
+   {0x0C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 'l'
+   {0x00, 0x00, 0x1A, 0x15, 0x15, 0x11, 0x11}, // 'm'
+   {0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11}, // 'n'
+   {0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E}, // 'o'
+   {0x00, 0x00, 0x1E, 0x11, 0x1E, 0x10, 0x10}, // 'p'
+   {0x00, 0x00, 0x0D, 0x13, 0x0F, 0x01, 0x01}, // 'q'
+   {0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10}, // 'r'
+   {0x00, 0x00, 0x0E, 0x10, 0x0E, 0x01, 0x1E}, // 's'
+   {0x08, 0x08, 0x1C, 0x08, 0x08, 0x09, 0x06}, // 't'
+   {0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0D}, // 'u'
+   {0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04}, // 'v'
+   {0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A}, // 'w'
+   {0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11}, // 'x'
+   {0x00, 0x00, 0x11, 0x11, 0x0F, 0x01, 0x0E}, // 'y'
+   {0x00, 0x00, 0x1F, 0x02, 0x04, 0x08, 0x1F}, // 'z'
+   {0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02}, // '{'
+   {0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // '|'
+   {0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08}, // '}'
+   {0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00}, // '~'
+};
+
+static vertex_layout Opengl_Text_Layout =
+{
+   "text", sizeof(opengl_text_glyph), 1, 3,
+   {
+      {0, Vertex_Attribute_Float32, 4, offsetof(opengl_text_glyph, Min)},
+      {1, Vertex_Attribute_Unorm8, 4, offsetof(opengl_text_glyph, Color)},
+      {2, Vertex_Attribute_Uint32, 1, offsetof(opengl_text_glyph, Slot)},
+   },
+};
+
+static inline float Get_Opengl_Text_Box_Distance(float X, float Y, float Min_X, float Min_Y, float Max_X, float Max_Y)
+{
+   float Delta_X = fmaxf(fmaxf(Min_X - X, X - Max_X), 0.0f);
+   float Delta_Y = fmaxf(fmaxf(Min_Y - Y, Y - Max_Y), 0.0f);
+   float Result = sqrtf(Delta_X*Delta_X + Delta_Y*Delta_Y);
+   return(Result);
+}
+
+// NOTE: The exact distance from each texel center to the edge of the glyph's
+// filled pixels, negative inside. Outside it's the distance to the nearest
+// filled pixel; inside, to the nearest empty one or the edge of the grid.
+static void Rasterize_Opengl_Text_Glyph(opengl_text *Text, u32 Slot, u32 Font_Index)
+{
+   u8 *Rows = Opengl_Text_Font[Font_Index];
+   u32 Cell_X = (Slot % OPENGL_TEXT_ATLAS_COLUMNS)*OPENGL_TEXT_CELL_SIZE;
+   u32 Cell_Y = (Slot / OPENGL_TEXT_ATLAS_COLUMNS)*OPENGL_TEXT_CELL_SIZE;
+
+   float Grid_Min_X = (float)OPENGL_TEXT_GLYPH_X;
+   float Grid_Min_Y = (float)OPENGL_TEXT_GLYPH_Y;
+   float Grid_Max_X = Grid_Min_X + (float)(OPENGL_TEXT_FONT_WIDTH*OPENGL_TEXT_TEXEL_SCALE);
+   float Grid_Max_Y = Grid_Min_Y + (float)(OPENGL_TEXT_FONT_HEIGHT*OPENGL_TEXT_TEXEL_SCALE);
+
+   for(u32 Y = 0; Y < OPENGL_TEXT_CELL_SIZE; ++Y)
+   {
+      u8 *Row = Text->Atlas_Pixels + (Cell_Y + Y)*OPENGL_TEXT_ATLAS_SIZE + Cell_X;
+      for(u32 X = 0; X < OPENGL_TEXT_CELL_SIZE; ++X)
+      {
+         float Point_X = (float)X + 0.5f;
+         float Point_Y = (float)Y + 0.5f;
+
+         bool Inside = false;
+         float Filled_Distance = 1e30f;
+         float Empty_Distance = 1e30f;
+         for(u32 Font_Y = 0; Font_Y < OPENGL_TEXT_FONT_HEIGHT; ++Font_Y)
+         {
+            // NOTE: Font rows run top down, atlas rows bottom up.
+            u8 Bits = Rows[OPENGL_TEXT_FONT_HEIGHT - 1 - Font_Y];
+            float Min_Y = Grid_Min_Y + (float)(Font_Y*OPENGL_TEXT_TEXEL_SCALE);
+            for(u32 Font_X = 0; Font_X < OPENGL_TEXT_FONT_WIDTH; ++Font_X)
+            {
+               float Min_X = Grid_Min_X + (float)(Font_X*OPENGL_TEXT_TEXEL_SCALE);
+               float Distance = Get_Opengl_Text_Box_Distance(Point_X, Point_Y, Min_X, Min_Y,
+                                                             Min_X + OPENGL_TEXT_TEXEL_SCALE, Min_Y + OPENGL_TEXT_TEXEL_SCALE);
+               if(Bits & (0x10 >> Font_X))
+               {
+                  Filled_Distance = fminf(Filled_Distance, Distance);
+                  Inside |= (Distance == 0.0f);
+               }
+               else
+               {
+                  Empty_Distance = fminf(Empty_Distance, Distance);
+               }
+            }
+         }
+
+         float Distance = Filled_Distance;
+         if(Inside)
+         {
+            Empty_Distance = fminf(Empty_Distance, fminf(Point_X - Grid_Min_X, Grid_Max_X - Point_X));
+            Empty_Distance = fminf(Empty_Distance, fminf(Point_Y - Grid_Min_Y, Grid_Max_Y - Point_Y));
+            Distance = -Empty_Distance;
+         }
+
+         // NOTE: The edge lands on 127.5, which the shader reads as 0.5.
+         float Value = 127.5f - Distance*(127.5f / OPENGL_TEXT_SPREAD);
+         if(Value < 0.0f) Value = 0.0f;
+         if(Value > 255.0f) Value = 255.0f;
+         Row[X] = (u8)(Value + 0.5f);
+      }
+   }
+
+   if(Text->Dirty_Min_Y == Text->Dirty_Max_Y)
+   {
+      Text->Dirty_Min_Y = Cell_Y;
+      Text->Dirty_Max_Y = Cell_Y + OPENGL_TEXT_CELL_SIZE;
+   }
+   else
+   {
+      if(Cell_Y < Text->Dirty_Min_Y) Text->Dirty_Min_Y = Cell_Y;
+      if(Cell_Y + OPENGL_TEXT_CELL_SIZE > Text->Dirty_Max_Y) Text->Dirty_Max_Y = Cell_Y + OPENGL_TEXT_CELL_SIZE;
+   }
+}
+
+static void Unlink_Opengl_Text_Slot(opengl_text *Text, u16 Slot)
+{
+   opengl_text_slot *Entry = Text->Slots + Slot;
+   if(Entry->Previous != OPENGL_TEXT_NO_SLOT)
+   {
+      Text->Slots[Entry->Previous].Next = Entry->Next;
+   }
+   else
+   {
+      Text->Most_Recent = Entry->Next;
+   }
+
+   if(Entry->Next != OPENGL_TEXT_NO_SLOT)
+   {
+      Text->Slots[Entry->Next].Previous = Entry->Previous;
+   }
+   else
+   {
+      Text->Least_Recent = Entry->Previous;
+   }
+}
+
+static void Link_Opengl_Text_Slot(opengl_text *Text, u16 Slot)
+{
+   opengl_text_slot *Entry = Text->Slots + Slot;
+   Entry->Previous = OPENGL_TEXT_NO_SLOT;
+   Entry->Next = Text->Most_Recent;
+   if(Text->Most_Recent != OPENGL_TEXT_NO_SLOT)
+   {
+      Text->Slots[Text->Most_Recent].Previous = Slot;
+   }
+   else
+   {
+      Text->Least_Recent = Slot;
+   }
+   Text->Most_Recent = Slot;
+}
+
+// NOTE: Empties the cache and limits it to Slot_Count slots. The atlas keeps
+// its old contents, which are overwritten as slots are reused.
+static void Set_Opengl_Text_Slot_Count(opengl_context *GL, u32 Slot_Count)
+{
+   opengl_text *Text = &GL->Text;
+   Assert(Slot_Count <= OPENGL_TEXT_MAX_SLOTS);
+
+   Text->Slot_Count = Slot_Count;
+   Text->Used_Slot_Count = 0;
+   Text->Most_Recent = OPENGL_TEXT_NO_SLOT;
+   Text->Least_Recent = OPENGL_TEXT_NO_SLOT;
+   for(u32 Index = 0; Index < OPENGL_TEXT_CODEPOINT_COUNT; ++Index)
+   {
+      Text->Codepoint_Slots[Index] = OPENGL_TEXT_NO_SLOT;
+   }
+}
+
+// NOTE: Glyphs are only moved to the front of the LRU list the first time
+// they're used in a frame, so everything used this frame sits ahead of
+// everything that wasn't, and a least recently used glyph that was still
+// used this frame means the atlas is too small for the frame's text.
+static u32 Get_Opengl_Text_Slot(opengl_context *GL, u32 Codepoint)
+{
+   opengl_text *Text = &GL->Text;
+   u32 Index = Codepoint - OPENGL_TEXT_FIRST_CODEPOINT;
+   u16 Slot = Text->Codepoint_Slots[Index];
+
+   if(Slot != OPENGL_TEXT_NO_SLOT)
+   {
+      opengl_text_slot *Entry = Text->Slots + Slot;
+      if(Entry->Last_Used_Frame != Text->Frame_Index)
+      {
+         Unlink_Opengl_Text_Slot(Text, Slot);
+         Link_Opengl_Text_Slot(Text, Slot);
+         Entry->Last_Used_Frame = Text->Frame_Index;
+      }
+      Text->Hit_Count++;
+   }
+   else
+   {
+      if(Text->Used_Slot_Count < Text->Slot_Count)
+      {
+         Slot = (u16)Text->Used_Slot_Count++;
+      }
+      else if(Text->Least_Recent != OPENGL_TEXT_NO_SLOT &&
+              Text->Slots[Text->Least_Recent].Last_Used_Frame != Text->Frame_Index)
+      {
+         Slot = Text->Least_Recent;
+         Unlink_Opengl_Text_Slot(Text, Slot);
+         Text->Codepoint_Slots[Text->Slots[Slot].Codepoint - OPENGL_TEXT_FIRST_CODEPOINT] = OPENGL_TEXT_NO_SLOT;
+         Text->Eviction_Count++;
+      }
+
+      if(Slot != OPENGL_TEXT_NO_SLOT)
+      {
+         Rasterize_Opengl_Text_Glyph(Text, Slot, Index);
+
+         opengl_text_slot *Entry = Text->Slots + Slot;
+         Entry->Codepoint = (u16)Codepoint;
+         Entry->Last_Used_Frame = Text->Frame_Index;
+         Link_Opengl_Text_Slot(Text, Slot);
+         Text->Codepoint_Slots[Index] = Slot;
+
+         Text->Miss_Count++;
+         GL->Stats.Glyph_Misses++;
+      }
+      else
+      {
+         Text->Drop_Count++;
+      }
+   }
+
+   return(Slot);
+}
+
+static void Initialize_Opengl_Text(opengl_context *GL)
+{
+   opengl_text *Text = &GL->Text;
+   Text->Atlas_Pixels = Push_Array(&GL->Memory->Permanent, OPENGL_TEXT_ATLAS_SIZE*OPENGL_TEXT_ATLAS_SIZE, u8);
+   Set_Opengl_Text_Slot_Count(GL, OPENGL_TEXT_MAX_SLOTS);
+
+   // NOTE: Uploaded empty, so unused cells are defined too. Mips would have
+   // to be regenerated for every glyph, and a distance field minifies well
+   // enough without them at the sizes text is drawn.
+   glGenTextures(1, &Text->Atlas);
+   Bind_Opengl_Buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+   Bind_Opengl_Texture(0, GL_TEXTURE_2D_ARRAY, Text->Atlas);
+   glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R8, OPENGL_TEXT_ATLAS_SIZE, OPENGL_TEXT_ATLAS_SIZE, 1, 0, GL_RED, GL_UNSIGNED_BYTE, Text->Atlas_Pixels);
+   glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+   glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+   glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+   glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+   GL_CHECK;
+
+   // NOTE: As with the vertex stream, attribute offsets move with the
+   // partition and are respecified by each text draw.
+   Initialize_Opengl_Stream(&Text->Stream, &GL->Capabilities, GL_ARRAY_BUFFER, OPENGL_TEXT_PARTITION_SIZE);
+
+   glGenVertexArrays(1, &Text->VAO);
+   Bind_Opengl_Vertex_Array(Text->VAO);
+   Bind_Opengl_Vertex_Layout(&Opengl_Text_Layout, Text->Stream.Buffer, 0);
+   Bind_Opengl_Vertex_Array(0);
+}
+
+static void Begin_Opengl_Text(opengl_context *GL)
+{
+   opengl_text *Text = &GL->Text;
+   Begin_Opengl_Stream(&Text->Stream);
+   Text->Glyph_Base = 0;
+   Text->Glyph_Count = 0;
+   Text->Frame_Index++;
+}
+
+// NOTE: Uploads the atlas rows rasterized into this frame, in one call.
+static void Flush_Opengl_Text_Atlas(opengl_context *GL)
+{
+   opengl_text *Text = &GL->Text;
+   if(Text->Dirty_Max_Y > Text->Dirty_Min_Y)
+   {
+      u32 Row_Count = Text->Dirty_Max_Y - Text->Dirty_Min_Y;
+      u8 *Pixels = Text->Atlas_Pixels + Text->Dirty_Min_Y*OPENGL_TEXT_ATLAS_SIZE;
+
+      Bind_Opengl_Buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+      Bind_Opengl_Texture(0, GL_TEXTURE_2D_ARRAY, Text->Atlas);
+      glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, (GLint)Text->Dirty_Min_Y, 0, OPENGL_TEXT_ATLAS_SIZE, (GLsizei)Row_Count, 1,
+                      GL_RED, GL_UNSIGNED_BYTE, Pixels);
+
+      Text->Bytes_Uploaded += (u64)Row_Count*OPENGL_TEXT_ATLAS_SIZE;
+      Text->Dirty_Min_Y = 0;
+      Text->Dirty_Max_Y = 0;
+   }
+}
+
+// NOTE: Draws String with its first line's bottom left at Position, in
+// pixels, Size pixels tall. Newlines start a new line below; other control
+// characters are spaces. Returns the width of the widest line.
+static float Push_Text(opengl_context *GL, vec2 Position, float Size, vec4 Color, char *String)
+{
+   // NOTE: Like the vertex stream, the text stream is shared, so text can
+   // only be pushed from the main thread.
+   Assert(Get_Thread_Index() == 0);
+   opengl_text *Text = &GL->Text;
+
+   // NOTE: Every visible glyph gets a record, so the whole string is one
+   // contiguous push. A glyph the atlas has no room for is written empty.
+   u32 Glyph_Count = 0;
+   for(u8 *At = (u8 *)String; *At; ++At)
+   {
+      Glyph_Count += (*At > ' ');
+   }
+
+   opengl_text_glyph *Glyphs = 0;
+   if(Glyph_Count > 0)
+   {
+      size Offset = 0;
+      Glyphs = Push_Opengl_Stream(&Text->Stream, Glyph_Count*sizeof(opengl_text_glyph), sizeof(float), &Offset);
+      if(Glyphs)
+      {
+         if(Text->Glyph_Count == 0)
+         {
+            Text->Glyph_Base = Offset;
+         }
+         Text->Glyph_Count += Glyph_Count;
+         GL->Stats.Glyphs += Glyph_Count;
+      }
+   }
+
+   float Pixel = Size / (float)OPENGL_TEXT_FONT_HEIGHT;
+   float Cell = Pixel * (float)OPENGL_TEXT_CELL_SIZE / (float)OPENGL_TEXT_TEXEL_SCALE;
+   vec2 Cell_Offset = {Pixel * (float)OPENGL_TEXT_GLYPH_X / (float)OPENGL_TEXT_TEXEL_SCALE,
+                       Pixel * (float)OPENGL_TEXT_GLYPH_Y / (float)OPENGL_TEXT_TEXEL_SCALE};
+
+   opengl_text_glyph Glyph = {0};
+   Glyph.Color[0] = (u8)(Color.R*255.0f + 0.5f);
+   Glyph.Color[1] = (u8)(Color.G*255.0f + 0.5f);
+   Glyph.Color[2] = (u8)(Color.B*255.0f + 0.5f);
+   Glyph.Color[3] = (u8)(Color.A*255.0f + 0.5f);
+
+   vec2 Pen = Position;
+   float Result = 0.0f;
+   u32 Glyph_Index = 0;
+   for(u8 *At = (u8 *)String; *At; ++At)
+   {
+      u32 Codepoint = *At;
+      if(Codepoint == '\n')
+      {
+         Pen.X = Position.X;
+         Pen.Y -= Pixel*(float)OPENGL_TEXT_FONT_LINE_HEIGHT;
+         continue;
+      }
+
+      if(Codepoint > ' ' && Glyphs)
+      {
+         if(Codepoint >= OPENGL_TEXT_FIRST_CODEPOINT + OPENGL_TEXT_CODEPOINT_COUNT)
+         {
+            Codepoint = '?';
+         }
+
+         Glyph.Min = (vec2){Pen.X - Cell_Offset.X, Pen.Y - Cell_Offset.Y};
+         Glyph.Max = (vec2){Glyph.Min.X + Cell, Glyph.Min.Y + Cell};
+         Glyph.Slot = Get_Opengl_Text_Slot(GL, Codepoint);
+         if(Glyph.Slot == OPENGL_TEXT_NO_SLOT)
+         {
+            Glyph.Max = Glyph.Min;
+            Glyph.Slot = 0;
+         }
+
+         Glyphs[Glyph_Index++] = Glyph;
+         Track_Opengl_Text_Damage(GL, &Glyph, Codepoint);
+      }
+
+      // NOTE: The last column of the advance is spacing, so it isn't counted
+      // in the width.
+      Pen.X += Pixel*(float)OPENGL_TEXT_FONT_ADVANCE;
+      Result = fmaxf(Result, Pen.X - Pixel - Position.X);
+   }
+
+   return(Result);
+}
+
+static float Push_Text_Format(opengl_context *GL, vec2 Position, float Size, vec4 Color, char *Format, ...)
+{
+   char String[1024];
+
+   va_list Arguments;
+   va_start(Arguments, Format);
+   vsnprintf(String, sizeof(String), Format, Arguments);
+   va_end(Arguments);
+
+   float Result = Push_Text(GL, Position, Size, Color, String);
+   return(Result);
+}
@@ -0,0 +1,556 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Texture management. Handles returned by Load_Opengl_Texture are
+// indices into the texture table, plus one, and stay valid across eviction.
+// Images are binary PPMs for now, the one format the tree already writes.
+
+static bool Parse_Ppm_Number(u8 **At, u8 *End, u32 *Value)
+{
+   // NOTE: Header fields are separated by whitespace, and comments run from a
+   // '#' to the end of the line.
+   u8 *Cursor = *At;
+   while(Cursor < End && (*Cursor == ' ' || *Cursor == '\t' || *Cursor == '\r' || *Cursor == '\n' || *Cursor == '#'))
+   {
+      if(*Cursor == '#')
+      {
+         while(Cursor < End && *Cursor != '\n')
+         {
+            Cursor++;
+         }
+      }
+      else
+      {
+         Cursor++;
+      }
+   }
+
+   u64 Result = 0;
+   u8 *First = Cursor;
+   while(Cursor < End && *Cursor >= '0' && *Cursor <= '9' && Result <= 0xFFFFFFFF)
+   {
+      Result = Result*10 + (*Cursor++ - '0');
+   }
+
+   *At = Cursor;
+   *Value = (u32)Result;
+   return(Cursor > First && Result <= 0xFFFFFFFF);
+}
+
+// NOTE: Decodes a binary PPM (P6, 8 bits per channel) into RGBA8. Rows are
+// flipped on the way, since GL puts the first row at the bottom.
+static bool Decode_Ppm_Image(u8 *File, size File_Size, u8 *Pixels, size Capacity, u32 *Width, u32 *Height)
+{
+   bool Result = false;
+
+   u8 *At = File + 2;
+   u8 *End = File + File_Size;
+   u32 Max_Value;
+   if(File_Size > 2 && File[0] == 'P' && File[1] == '6' &&
+      Parse_Ppm_Number(&At, End, Width) &&
+      Parse_Ppm_Number(&At, End, Height) &&
+      Parse_Ppm_Number(&At, End, &Max_Value) &&
+      Max_Value == 255 && *Width > 0 && *Height > 0)
+   {
+      // NOTE: Exactly one whitespace character separates the header from the
+      // pixels.
+      At++;
+
+      u64 Row_Size = (u64)*Width * 3;
+      if((u64)*Width * *Height * 4 <= (u64)Capacity && At + Row_Size * *Height <= End)
+      {
+         for(u32 Y = 0; Y < *Height; ++Y)
+         {
+            u8 *Source = At + (u64)(*Height - 1 - Y)*Row_Size;
+            u8 *Dest = Pixels + (u64)Y * *Width * 4;
+            for(u32 X = 0; X < *Width; ++X)
+            {
+               Dest[0] = Source[0];
+               Dest[1] = Source[1];
+               Dest[2] = Source[2];
+               Dest[3] = 255;
+               Source += 3;
+               Dest += 4;
+            }
+         }
+         Result = true;
+      }
+   }
+
+   return(Result);
+}
+
+// NOTE: Appends the rest of the mip chain after the base level in Pixels, each
+// level a 2x2 box filter of the one before (clamped at odd edges), packed one
+// after another the way Copy_Opengl_Texture_Upload reads them. Returns the
+// size of the whole chain, or 0 if it doesn't fit in Capacity.
+static u64 Build_Texture_Mips(u8 *Pixels, size Capacity, u32 Width, u32 Height)
+{
+   u64 Result = (u64)Width*Height*4;
+   u8 *Source = Pixels;
+
+   while(Result && (Width > 1 || Height > 1))
+   {
+      u32 Mip_Width = (Width >> 1) ? (Width >> 1) : 1;
+      u32 Mip_Height = (Height >> 1) ? (Height >> 1) : 1;
+      u64 Mip_Size = (u64)Mip_Width*Mip_Height*4;
+      if(Result + Mip_Size > (u64)Capacity)
+      {
+         Result = 0;
+         break;
+      }
+
+      u8 *Dest = Pixels + Result;
+      for(u32 Y = 0; Y < Mip_Height; ++Y)
+      {
+         u8 *Row0 = Source + (u64)(2*Y)*Width*4;
+         u8 *Row1 = Source + (u64)((2*Y + 1 < Height) ? 2*Y + 1 : 2*Y)*Width*4;
+         for(u32 X = 0; X < Mip_Width; ++X)
+         {
+            u32 X0 = 2*X*4;
+            u32 X1 = ((2*X + 1 < Width) ? 2*X + 1 : 2*X)*4;
+            for(u32 Channel = 0; Channel < 4; ++Channel)
+            {
+               u32 Sum = (Row0[X0 + Channel] + Row0[X1 + Channel] +
+                          Row1[X0 + Channel] + Row1[X1 + Channel] + 2);
+               *Dest++ = (u8)(Sum / 4);
+            }
+         }
+      }
+
+      Source = Pixels + Result;
+      Result += Mip_Size;
+      Width = Mip_Width;
+      Height = Mip_Height;
+   }
+
+   return(Result);
+}
+
+// NOTE: The image and its mips are built in the loader's scratch buffer and
+// then copied into the upload buffer in one pass, since reading back from a
+// write-mapped buffer to filter it can be very slow.
+static JOB_FUNCTION(Decode_Texture_Job)
+{
+   opengl_texture_upload *Upload = Data;
+
+   u32 State = Texture_Upload_Failed;
+   size Size = 0;
+   u8 *File = Map_Entire_File(Upload->Path, &Size);
+   if(File)
+   {
+      u64 Chain_Size = 0;
+      if(Decode_Ppm_Image(File, Size, Upload->Scratch, OPENGL_TEXTURE_UPLOAD_SLOT_SIZE, &Upload->Width, &Upload->Height) &&
+         (Chain_Size = Build_Texture_Mips(Upload->Scratch, OPENGL_TEXTURE_UPLOAD_SLOT_SIZE, Upload->Width, Upload->Height)))
+      {
+         memcpy(Upload->Mapped, Upload->Scratch, Chain_Size);
+         State = Texture_Upload_Filled;
+      }
+      else
+      {
+         fprintf(stderr, "Texture %s is not a binary PPM that fits an upload buffer.\n", Upload->Path);
+      }
+      Unmap_Entire_File(File, Size);
+   }
+   else
+   {
+      fprintf(stderr, "Failed to load texture %s.\n", Upload->Path);
+   }
+
+   atomic_store_explicit(&Upload->State, State, memory_order_release);
+   Wake_Main_Thread();
+}
+
+static void Initialize_Opengl_Textures(opengl_context *GL)
+{
+   opengl_texture_manager *Manager = &GL->Textures;
+   Manager->Budget = OPENGL_TEXTURE_BUDGET;
+   Manager->Persistent = GL->Capabilities.Has_Buffer_Storage;
+
+   // NOTE: Background jobs run one at a time, so every slot can share one
+   // scratch buffer.
+   u8 *Scratch = Push_Array(&GL->Memory->Permanent, OPENGL_TEXTURE_UPLOAD_SLOT_SIZE, u8);
+
+   for(u32 Index = 0; Index < OPENGL_TEXTURE_UPLOAD_SLOTS; ++Index)
+   {
+      opengl_texture_upload *Upload = Manager->Uploads + Index;
+      Upload->Scratch = Scratch;
+      glGenBuffers(1, &Upload->Buffer);
+      Bind_Opengl_Buffer(GL_PIXEL_UNPACK_BUFFER, Upload->Buffer);
+
+      if(Manager->Persistent)
+      {
+         GLbitfield Flags = GL_MAP_WRITE_BIT|GL_MAP_PERSISTENT_BIT|GL_MAP_COHERENT_BIT;
+         glBufferStorage(GL_PIXEL_UNPACK_BUFFER, OPENGL_TEXTURE_UPLOAD_SLOT_SIZE, 0, Flags);
+         Upload->Mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, OPENGL_TEXTURE_UPLOAD_SLOT_SIZE, Flags);
+         if(!Upload->Mapped)
+         {
+            fprintf(stderr, "Failed to persistently map texture upload buffers, falling back to unsynchronized mapping.\n");
+            Manager->Persistent = false;
+         }
+      }
+   }
+
+   if(!Manager->Persistent)
+   {
+      // NOTE: Immutable storage can't be respecified, so every buffer is
+      // recreated, including any that did map.
+      for(u32 Index = 0; Index < OPENGL_TEXTURE_UPLOAD_SLOTS; ++Index)
+      {
+         opengl_texture_upload *Upload = Manager->Uploads + Index;
+         glDeleteBuffers(1, &Upload->Buffer);
+         glGenBuffers(1, &Upload->Buffer);
+         Bind_Opengl_Buffer(GL_PIXEL_UNPACK_BUFFER, Upload->Buffer);
+         glBufferData(GL_PIXEL_UNPACK_BUFFER, OPENGL_TEXTURE_UPLOAD_SLOT_SIZE, 0, GL_STREAM_DRAW);
+         Upload->Mapped = 0;
+      }
+   }
+   Bind_Opengl_Buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+   GL_CHECK;
+}
+
+static u32 Load_Opengl_Texture(opengl_context *GL, char *Path)
+{
+   u32 Result = 0;
+
+   opengl_texture_manager *Manager = &GL->Textures;
+   for(u32 Index = 0; Index < Manager->Texture_Count; ++Index)
+   {
+      if(strcmp(Manager->Textures[Index].Path, Path) == 0)
+      {
+         Result = Index + 1;
+         break;
+      }
+   }
+
+   if(!Result)
+   {
+      if(Manager->Texture_Count < OPENGL_MAX_TEXTURES && strlen(Path) < OPENGL_TEXTURE_PATH_SIZE)
+      {
+         opengl_texture *Texture = Manager->Textures + Manager->Texture_Count++;
+         strcpy(Texture->Path, Path);
+         Texture->State = Texture_Queued;
+         Texture->Last_Used_Frame = Manager->Frame_Index;
+         Result = Manager->Texture_Count;
+      }
+      else
+      {
+         fprintf(stderr, "Failed to add texture %s.\n", Path);
+      }
+   }
+
+   return(Result);
+}
+
+// NOTE: Marks the texture as used this frame, and returns the array and layer
+// to draw it with once it's resident. Using an evicted texture queues it to
+// be loaded again. Main thread only, since it touches the LRU state.
+static bool Use_Opengl_Texture(opengl_context *GL, u32 Handle, GLuint *Array_Texture, u32 *Layer)
+{
+   Assert(Get_Thread_Index() == 0);
+   bool Result = false;
+
+   opengl_texture_manager *Manager = &GL->Textures;
+   if(Handle > 0 && Handle <= Manager->Texture_Count)
+   {
+      opengl_texture *Texture = Manager->Textures + (Handle - 1);
+      Texture->Last_Used_Frame = Manager->Frame_Index;
+
+      if(Texture->State == Texture_Resident)
+      {
+         opengl_texture_array *Array = Manager->Arrays + Texture->Array;
+         Array->Last_Used_Frame = Manager->Frame_Index;
+
+         *Array_Texture = Array->Texture;
+         *Layer = Texture->Layer;
+         Result = true;
+      }
+      else if(Texture->State == Texture_Evicted)
+      {
+         Texture->State = Texture_Queued;
+      }
+   }
+
+   return(Result);
+}
+
+static bool Has_Pending_Opengl_Textures(opengl_context *GL)
+{
+   bool Result = false;
+
+   opengl_texture_manager *Manager = &GL->Textures;
+   for(u32 Index = 0; !Result && Index < Manager->Texture_Count; ++Index)
+   {
+      texture_state State = Manager->Textures[Index].State;
+      Result = (State == Texture_Queued || State == Texture_Loading);
+   }
+
+   return(Result);
+}
+
+static u64 Get_Texture_Layer_Size(opengl_texture_array *Array)
+{
+   u64 Result = 0;
+   for(u32 Level = 0; Level < Array->Mip_Count; ++Level)
+   {
+      u64 Width = (Array->Width >> Level) ? (Array->Width >> Level) : 1;
+      u64 Height = (Array->Height >> Level) ? (Array->Height >> Level) : 1;
+      Result += Width*Height*4;
+   }
+   return(Result);
+}
+
+// NOTE: Returns the array for this image size, creating it on first use, or
+// -1 if every array is taken by other sizes.
+static s32 Get_Opengl_Texture_Array(opengl_texture_manager *Manager, u32 Width, u32 Height)
+{
+   s32 Result = -1;
+
+   for(u32 Index = 0; Index < Manager->Array_Count; ++Index)
+   {
+      opengl_texture_array *Array = Manager->Arrays + Index;
+      if(Array->Width == Width && Array->Height == Height)
+      {
+         Result = (s32)Index;
+         break;
+      }
+   }
+
+   if(Result < 0 && Manager->Array_Count < OPENGL_MAX_TEXTURE_ARRAYS)
+   {
+      opengl_texture_array *Array = Manager->Arrays + Manager->Array_Count;
+      Array->Width = Width;
+      Array->Height = Height;
+      Array->Mip_Count = 1;
+      while((Width >> Array->Mip_Count) || (Height >> Array->Mip_Count))
+      {
+         Array->Mip_Count++;
+      }
+
+      // NOTE: Storage for every layer is allocated up front, so the layer
+      // count is capped to what fits in the budget.
+      u64 Layer_Count = Manager->Budget / Get_Texture_Layer_Size(Array);
+      if(Layer_Count > OPENGL_TEXTURE_ARRAY_LAYERS) Layer_Count = OPENGL_TEXTURE_ARRAY_LAYERS;
+      if(Layer_Count < 1) Layer_Count = 1;
+      Array->Used_Layers = (Layer_Count < 64) ? ~((1ull << Layer_Count) - 1) : 0;
+
+      glGenTextures(1, &Array->Texture);
+      Bind_Opengl_Texture(0, GL_TEXTURE_2D_ARRAY, Array->Texture);
+      for(u32 Level = 0; Level < Array->Mip_Count; ++Level)
+      {
+         GLsizei Level_Width = (Width >> Level) ? (Width >> Level) : 1;
+         GLsizei Level_Height = (Height >> Level) ? (Height >> Level) : 1;
+         glTexImage3D(GL_TEXTURE_2D_ARRAY, Level, GL_RGBA8, Level_Width, Level_Height, (GLsizei)Layer_Count, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+      }
+      glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      GL_CHECK;
+
+      Result = (s32)Manager->Array_Count++;
+   }
+
+   return(Result);
+}
+
+// NOTE: Evicts the least recently used resident texture, from one array or
+// (with Array_Index < 0) any of them. Textures used in the last frame are
+// never evicted, since they will almost certainly be drawn again right away;
+// uploads wait for room instead.
+static bool Evict_Opengl_Texture(opengl_texture_manager *Manager, s32 Array_Index)
+{
+   opengl_texture *Victim = 0;
+   for(u32 Index = 0; Index < Manager->Texture_Count; ++Index)
+   {
+      opengl_texture *Texture = Manager->Textures + Index;
+      if(Texture->State == Texture_Resident &&
+         (Array_Index < 0 || Texture->Array == (u32)Array_Index) &&
+         Texture->Last_Used_Frame + 1 < Manager->Frame_Index &&
+         (!Victim || Texture->Last_Used_Frame < Victim->Last_Used_Frame))
+      {
+         Victim = Texture;
+      }
+   }
+
+   if(Victim)
+   {
+      Manager->Arrays[Victim->Array].Used_Layers &= ~(1ull << Victim->Layer);
+      Manager->Resident_Bytes -= Victim->Size;
+      Manager->Eviction_Count++;
+      Victim->State = Texture_Evicted;
+   }
+
+   return(Victim != 0);
+}
+
+// NOTE: Copies a filled upload buffer (every mip level) into a free layer,
+// making room first if needed. Returns false if there's no room yet, in which
+// case the buffer keeps its contents and is retried next frame. With Force the
+// budget is allowed to overflow, so one upload a frame always gets through
+// even when a single layer is bigger than the budget.
+static bool Copy_Opengl_Texture_Upload(opengl_texture_manager *Manager, opengl_texture_upload *Upload, bool Force)
+{
+   bool Result = false;
+   opengl_texture *Texture = Manager->Textures + Upload->Texture;
+
+   s32 Array_Index = Get_Opengl_Texture_Array(Manager, Upload->Width, Upload->Height);
+   if(Array_Index < 0)
+   {
+      fprintf(stderr, "Texture %s needs a new size class, and all %d are in use.\n", Texture->Path, OPENGL_MAX_TEXTURE_ARRAYS);
+      Texture->State = Texture_Failed;
+      return(true);
+   }
+
+   opengl_texture_array *Array = Manager->Arrays + Array_Index;
+   u64 Size = Get_Texture_Layer_Size(Array);
+   while(Manager->Resident_Bytes + Size > Manager->Budget && Evict_Opengl_Texture(Manager, -1));
+   while(Array->Used_Layers == ~0ull && Evict_Opengl_Texture(Manager, Array_Index));
+
+   if((Force || Manager->Resident_Bytes + Size <= Manager->Budget) && Array->Used_Layers != ~0ull)
+   {
+      u32 Layer = (u32)__builtin_ctzll(~Array->Used_Layers);
+      Array->Used_Layers |= (1ull << Layer);
+
+      Bind_Opengl_Buffer(GL_PIXEL_UNPACK_BUFFER, Upload->Buffer);
+      if(!Manager->Persistent)
+      {
+         glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+         Upload->Mapped = 0;
+      }
+
+      // NOTE: With an unpack buffer bound these only record the copies, and
+      // only touch the new layer.
+      Bind_Opengl_Texture(0, GL_TEXTURE_2D_ARRAY, Array->Texture);
+      size Offset = 0;
+      for(u32 Level = 0; Level < Array->Mip_Count; ++Level)
+      {
+         GLsizei Level_Width = (Upload->Width >> Level) ? (Upload->Width >> Level) : 1;
+         GLsizei Level_Height = (Upload->Height >> Level) ? (Upload->Height >> Level) : 1;
+         glTexSubImage3D(GL_TEXTURE_2D_ARRAY, Level, 0, 0, Layer, Level_Width, Level_Height, 1,
+                         GL_RGBA, GL_UNSIGNED_BYTE, (void *)Offset);
+         Offset += (size)Level_Width*Level_Height*4;
+      }
+      Bind_Opengl_Buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+      Upload->Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+      Texture->State = Texture_Resident;
+      Texture->Array = (u32)Array_Index;
+      Texture->Layer = Layer;
+      Texture->Size = Size;
+      Manager->Resident_Bytes += Size;
+      Manager->Bytes_Uploaded += Size;
+      Manager->Upload_Count++;
+      Result = true;
+   }
+
+   return(Result);
+}
+
+static void Update_Opengl_Textures(opengl_context *GL)
+{
+   opengl_texture_manager *Manager = &GL->Textures;
+   Manager->Frame_Index++;
+
+   u32 Next_Texture = 0;
+   bool Copied = false;
+   for(u32 Index = 0; Index < OPENGL_TEXTURE_UPLOAD_SLOTS; ++Index)
+   {
+      opengl_texture_upload *Upload = Manager->Uploads + Index;
+      u32 State = atomic_load_explicit(&Upload->State, memory_order_acquire);
+      bool Start_Decode = false;
+
+      if(State == Texture_Upload_Copying)
+      {
+         GLenum Status = glClientWaitSync(Upload->Fence, 0, 0);
+         if(Status == GL_ALREADY_SIGNALED || Status == GL_CONDITION_SATISFIED)
+         {
+            glDeleteSync(Upload->Fence);
+            Upload->Fence = 0;
+            State = Texture_Upload_Free;
+         }
+      }
+      else if(State == Texture_Upload_Filled)
+      {
+         if(Copy_Opengl_Texture_Upload(Manager, Upload, !Copied))
+         {
+            Copied = true;
+            State = (Upload->Fence) ? Texture_Upload_Copying : Texture_Upload_Free;
+         }
+      }
+      else if(State == Texture_Upload_Failed)
+      {
+         Manager->Textures[Upload->Texture].State = Texture_Failed;
+         State = Texture_Upload_Free;
+      }
+
+      if(State == Texture_Upload_Free)
+      {
+         // NOTE: Queued textures are started in the order they were added.
+         while(Next_Texture < Manager->Texture_Count && Manager->Textures[Next_Texture].State != Texture_Queued)
+         {
+            Next_Texture++;
+         }
+
+         if(Next_Texture < Manager->Texture_Count)
+         {
+            if(!Manager->Persistent && !Upload->Mapped)
+            {
+               // NOTE: The fence has already told us the GPU is done with the
+               // old contents, so there's nothing to synchronize with.
+               GLbitfield Flags = GL_MAP_WRITE_BIT|GL_MAP_INVALIDATE_BUFFER_BIT|GL_MAP_UNSYNCHRONIZED_BIT;
+               Bind_Opengl_Buffer(GL_PIXEL_UNPACK_BUFFER, Upload->Buffer);
+               Upload->Mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, OPENGL_TEXTURE_UPLOAD_SLOT_SIZE, Flags);
+               Bind_Opengl_Buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            }
+
+            if(Upload->Mapped)
+            {
+               opengl_texture *Texture = Manager->Textures + Next_Texture;
+               Texture->State = Texture_Loading;
+               Upload->Texture = Next_Texture++;
+               Upload->Path = Texture->Path;
+               State = Texture_Upload_Filling;
+               Start_Decode = true;
+            }
+         }
+      }
+
+      // NOTE: The state is published before the job starts, since the job
+      // overwrites it when it's done.
+      atomic_store_explicit(&Upload->State, State, memory_order_relaxed);
+      if(Start_Decode)
+      {
+         Start_Background_Job(Decode_Texture_Job, Upload, &Manager->Pending);
+      }
+   }
+}
+
+static void Destroy_Opengl_Textures(opengl_context *GL)
+{
+   opengl_texture_manager *Manager = &GL->Textures;
+   Wait_For_Jobs(&Manager->Pending);
+
+   for(u32 Index = 0; Index < OPENGL_TEXTURE_UPLOAD_SLOTS; ++Index)
+   {
+      opengl_texture_upload *Upload = Manager->Uploads + Index;
+      if(Upload->Mapped && !Manager->Persistent)
+      {
+         Bind_Opengl_Buffer(GL_PIXEL_UNPACK_BUFFER, Upload->Buffer);
+         glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+      }
+      if(Upload->Fence)
+      {
+         glDeleteSync(Upload->Fence);
+      }
+      glDeleteBuffers(1, &Upload->Buffer);
+   }
+
+   for(u32 Index = 0; Index < Manager->Array_Count; ++Index)
+   {
+      glDeleteTextures(1, &Manager->Arrays[Index].Texture);
+   }
+   Invalidate_Opengl_State();
+
+   opengl_texture_manager Zero = {0};
+   *Manager = Zero;
+}
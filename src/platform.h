@@ -2,5 +2,185 @@
 
 // NOTE: Platform API.
 
-#define READ_ENTIRE_FILE(Name) char *Name(char *Path)
+// NOTE: Memory is reserved from the OS once at startup and handed out from
+// arenas afterwards. The permanent arena holds anything that lives for the
+// whole run (renderer state, assets). The frame arena is reset at the top of
+// every loop iteration, so anything pushed onto it is only valid until the end
+// of the current frame. Temporary memory markers allow a nested region of
+// either arena to be released early.
+typedef struct {
+   u8 *Base;
+   size Size;
+   size Used;
+   size Peak_Used;
+   int Temporary_Count;
+} arena;
+
+typedef struct {
+   arena *Arena;
+   size Used;
+} temporary_memory;
+
+typedef struct {
+   arena Permanent;
+   arena Frame;
+} platform_memory;
+
+// NOTE: The platform bumps these for every OS allocation and every syscall it
+// makes on behalf of the renderer, so the main loop can assert that a steady
+// state frame makes neither. They are per thread: I/O done on a background
+// thread is off the frame's critical path and doesn't count against it.
+typedef struct {
+   u64 Allocation_Count;
+   u64 Syscall_Count;
+} platform_counters;
+
+static _Thread_local platform_counters Platform_Counters;
+
+static void Initialize_Arena(arena *Arena, void *Base, size Size)
+{
+   Arena->Base = Base;
+   Arena->Size = Size;
+   Arena->Used = 0;
+   Arena->Peak_Used = 0;
+   Arena->Temporary_Count = 0;
+}
+
+#define Push_Struct(Arena, Type) (Type *)Push_Size((Arena), sizeof(Type))
+#define Push_Array(Arena, Count, Type) (Type *)Push_Size((Arena), (Count)*sizeof(Type))
+
+static void *Push_Size(arena *Arena, size Size)
+{
+   // NOTE: Everything is 16-byte aligned, which covers SIMD loads.
+   size Alignment = 16;
+   size Aligned = (Arena->Used + (Alignment - 1)) & ~(Alignment - 1);
+   Assert(Aligned + Size <= Arena->Size);
+
+   void *Result = Arena->Base + Aligned;
+   Arena->Used = Aligned + Size;
+   if(Arena->Used > Arena->Peak_Used)
+   {
+      Arena->Peak_Used = Arena->Used;
+   }
+
+   memset(Result, 0, Size);
+   return(Result);
+}
+
+static void Reset_Arena(arena *Arena)
+{
+   Assert(Arena->Temporary_Count == 0);
+   Arena->Used = 0;
+}
+
+static temporary_memory Begin_Temporary_Memory(arena *Arena)
+{
+   temporary_memory Result;
+   Result.Arena = Arena;
+   Result.Used = Arena->Used;
+
+   Arena->Temporary_Count++;
+   return(Result);
+}
+
+static void End_Temporary_Memory(temporary_memory Temporary)
+{
+   arena *Arena = Temporary.Arena;
+   Assert(Arena->Used >= Temporary.Used);
+   Assert(Arena->Temporary_Count > 0);
+
+   Arena->Used = Temporary.Used;
+   Arena->Temporary_Count--;
+}
+
+// NOTE: Reserves the backing store for both arenas in a single allocation.
+#define INITIALIZE_MEMORY(Name) bool Name(platform_memory *Memory, size Permanent_Size, size Frame_Size)
+static INITIALIZE_MEMORY(Initialize_Memory);
+
+// NOTE: Returns a null-terminated copy of the file pushed onto Arena, or 0 on
+// failure (in which case Arena is left untouched). Size is optional, and
+// receives the file size excluding the terminator.
+#define READ_ENTIRE_FILE(Name) char *Name(arena *Arena, char *Path, size *Size)
 static READ_ENTIRE_FILE(Read_Entire_File);
+
+// NOTE: Maps a whole file read-only, or returns 0 on failure. The pages are
+// read in before returning, so touching the mapping afterwards never blocks
+// on the disk. Size receives the file size.
+#define MAP_ENTIRE_FILE(Name) void *Name(char *Path, size *Size)
+static MAP_ENTIRE_FILE(Map_Entire_File);
+
+#define UNMAP_ENTIRE_FILE(Name) void Name(void *Memory, size Size)
+static UNMAP_ENTIRE_FILE(Unmap_Entire_File);
+
+#define FILE_EXISTS(Name) bool Name(char *Path)
+static FILE_EXISTS(File_Exists);
+
+// NOTE: Writes through a temporary file and renames it into place, so readers
+// never observe a partially written file. A missing parent directory is
+// created.
+#define WRITE_ENTIRE_FILE(Name) bool Name(char *Path, void *Data, size Size)
+static WRITE_ENTIRE_FILE(Write_Entire_File);
+
+// NOTE: Directory watches are polled by the platform as part of its event
+// processing each frame. Get_Changed_File then returns one changed path per
+// call (as "<watched directory>/<file name>"), and 0 once the frame's changes
+// are exhausted.
+#define WATCH_DIRECTORY(Name) bool Name(char *Path)
+static WATCH_DIRECTORY(Watch_Directory);
+
+#define GET_CHANGED_FILE(Name) char *Name(void)
+static GET_CHANGED_FILE(Get_Changed_File);
+
+// NOTE: Wakes the main loop if it is blocked waiting for events, so work
+// finished elsewhere (e.g. on a job) gets a frame. Safe to call from any
+// thread, and a no-op for platforms whose main loop never blocks.
+#define WAKE_MAIN_THREAD(Name) void Name(void)
+static WAKE_MAIN_THREAD(Wake_Main_Thread);
+
+// NOTE: Monotonic wall clock in nanoseconds. Only differences between two
+// readings are meaningful.
+#define GET_CLOCK(Name) u64 Name(void)
+static GET_CLOCK(Get_Clock);
+
+// NOTE: Job system. A fixed pool of worker threads runs jobs alongside the
+// thread that calls Initialize_Jobs, which becomes thread 0. Every thread owns
+// a work-stealing deque: Start_Job pushes onto the calling thread's deque
+// (jobs can start more jobs), owners pop from the bottom, and idle threads
+// steal from the top of someone else's. A job_counter is the fence: it counts
+// jobs started against it that haven't finished, and Wait_For_Jobs runs other
+// jobs until it reaches zero rather than blocking.
+#define JOB_FUNCTION(Name) void Name(void *Data)
+typedef JOB_FUNCTION(job_function);
+
+typedef struct {
+   _Atomic s64 Pending;
+} job_counter;
+
+// NOTE: A Worker_Count of zero picks one worker per remaining core.
+#define INITIALIZE_JOBS(Name) bool Name(u32 Worker_Count)
+static INITIALIZE_JOBS(Initialize_Jobs);
+
+#define DESTROY_JOBS(Name) void Name(void)
+static DESTROY_JOBS(Destroy_Jobs);
+
+#define START_JOB(Name) void Name(job_function *Function, void *Data, job_counter *Counter)
+static START_JOB(Start_Job);
+
+#define WAIT_FOR_JOBS(Name) void Name(job_counter *Counter)
+static WAIT_FOR_JOBS(Wait_For_Jobs);
+
+// NOTE: Background jobs run in order on a single dedicated thread, separate
+// from the workers, for slow blocking work like file I/O that must never hold
+// up a frame. Wait_For_Jobs never runs them itself, so waiting on their
+// counter from the main thread blocks until the background thread gets to
+// them. They can't start jobs or record render commands.
+#define START_BACKGROUND_JOB(Name) void Name(job_function *Function, void *Data, job_counter *Counter)
+static START_BACKGROUND_JOB(Start_Background_Job);
+
+// NOTE: Thread indices run from 0 (the initializing thread) to
+// Get_Thread_Count() - 1, so they can index per-thread data directly.
+#define GET_THREAD_INDEX(Name) u32 Name(void)
+static GET_THREAD_INDEX(Get_Thread_Index);
+
+#define GET_THREAD_COUNT(Name) u32 Name(void)
+static GET_THREAD_COUNT(Get_Thread_Count);
@@ -5,8 +5,11 @@
 
 #include <stdint.h>
 typedef int32_t s32;
+typedef int64_t s64;
 typedef uint8_t u8;
+typedef uint16_t u16;
 typedef uint32_t u32;
+typedef uint64_t u64;
 
 #include <stddef.h>
 typedef ptrdiff_t size;
@@ -28,3 +31,21 @@ typedef struct {
    float B;
    float A;
 } vec4;
+
+// NOTE: 64-bit FNV-1a. Chain calls by passing the previous result as Hash,
+// starting from HASH_SEED.
+#define HASH_SEED 0xcbf29ce484222325ull
+
+static inline u64 Hash_Bytes(u64 Hash, void *Data, size Size)
+{
+   u8 *Bytes = Data;
+   for(size Index = 0; Index < Size; ++Index)
+   {
+      Hash ^= Bytes[Index];
+      Hash *= 0x100000001b3ull;
+   }
+   return(Hash);
+}
+
+#include <math.h>
+#include "shared_math.h"
@@ -0,0 +1,466 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Math. The scalar types and functions are for one-off values. Anything
+// done to many values at once should use the batched kernels instead, which
+// take structure-of-arrays input so that each SIMD lane holds a different
+// element. Every kernel exists in a scalar, an SSE and an AVX2+FMA variant,
+// compiled from the same source in shared_math_kernels.h, and the widest one
+// the CPU supports is picked at runtime. Kernels may not be given
+// overlapping input and output arrays.
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <immintrin.h>
+#   define SHARED_MATH_X86 1
+#else
+#   define SHARED_MATH_X86 0
+#endif
+
+typedef struct {
+   float X;
+   float Y;
+   float Z;
+   float W;
+} quat;
+
+// NOTE: Column-major, matching GL: E[Column][Row].
+typedef struct {
+   float E[4][4];
+} mat4;
+
+typedef struct {
+   float *X;
+   float *Y;
+   float *Z;
+} vec3_array;
+
+typedef struct {
+   float *X;
+   float *Y;
+   float *Z;
+   float *W;
+} quat_array;
+
+// NOTE: One array per matrix element, indexed [Column*4 + Row].
+typedef struct {
+   float *E[16];
+} mat4_array;
+
+// NOTE: Points with Dot(Normal, P) + Offset >= 0 are on the inside.
+typedef struct {
+   vec3 Normal;
+   float Offset;
+} plane;
+
+typedef struct {
+   plane Planes[6];
+} frustum;
+
+typedef struct {
+   float *X;
+   float *Y;
+   float *Z;
+   float *Radius;
+} sphere_array;
+
+// NOTE: Boxes are stored as center and half extent, which is what the plane
+// tests want.
+typedef struct {
+   vec3_array Center;
+   vec3_array Extent;
+} aabb_array;
+
+static inline mat4 Mat4_Identity(void)
+{
+   mat4 Result = {{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}}};
+   return(Result);
+}
+
+static inline mat4 Mat4_Multiply(mat4 A, mat4 B)
+{
+   mat4 Result;
+   for(int Column = 0; Column < 4; ++Column)
+   {
+      for(int Row = 0; Row < 4; ++Row)
+      {
+         Result.E[Column][Row] = (A.E[0][Row]*B.E[Column][0] + A.E[1][Row]*B.E[Column][1] +
+                                  A.E[2][Row]*B.E[Column][2] + A.E[3][Row]*B.E[Column][3]);
+      }
+   }
+   return(Result);
+}
+
+static inline vec3 Mat4_Transform_Point(mat4 M, vec3 P)
+{
+   vec3 Result;
+   Result.X = M.E[0][0]*P.X + M.E[1][0]*P.Y + M.E[2][0]*P.Z + M.E[3][0];
+   Result.Y = M.E[0][1]*P.X + M.E[1][1]*P.Y + M.E[2][1]*P.Z + M.E[3][1];
+   Result.Z = M.E[0][2]*P.X + M.E[1][2]*P.Y + M.E[2][2]*P.Z + M.E[3][2];
+   return(Result);
+}
+
+static inline quat Quat_Axis_Angle(vec3 Axis, float Angle)
+{
+   // NOTE: Axis must be unit length.
+   float Sine = sinf(0.5f*Angle);
+   quat Result = {Axis.X*Sine, Axis.Y*Sine, Axis.Z*Sine, cosf(0.5f*Angle)};
+   return(Result);
+}
+
+static inline quat Quat_Multiply(quat A, quat B)
+{
+   quat Result;
+   Result.X = A.W*B.X + A.X*B.W + A.Y*B.Z - A.Z*B.Y;
+   Result.Y = A.W*B.Y - A.X*B.Z + A.Y*B.W + A.Z*B.X;
+   Result.Z = A.W*B.Z + A.X*B.Y - A.Y*B.X + A.Z*B.W;
+   Result.W = A.W*B.W - A.X*B.X - A.Y*B.Y - A.Z*B.Z;
+   return(Result);
+}
+
+static inline quat Quat_Normalize(quat Q)
+{
+   float Length = sqrtf(Q.X*Q.X + Q.Y*Q.Y + Q.Z*Q.Z + Q.W*Q.W);
+   float Scale = (Length > 0) ? 1.0f / Length : 0.0f;
+   quat Result = {Q.X*Scale, Q.Y*Scale, Q.Z*Scale, Q.W*Scale};
+   return(Result);
+}
+
+// NOTE: Translation * Rotation * Scale, for a unit quaternion.
+static inline mat4 Mat4_From_Trs(vec3 T, quat R, vec3 S)
+{
+   float XX = R.X*R.X, YY = R.Y*R.Y, ZZ = R.Z*R.Z;
+   float XY = R.X*R.Y, XZ = R.X*R.Z, YZ = R.Y*R.Z;
+   float WX = R.W*R.X, WY = R.W*R.Y, WZ = R.W*R.Z;
+
+   mat4 Result =
+      {{
+         {(1 - 2*(YY + ZZ))*S.X, 2*(XY + WZ)*S.X, 2*(XZ - WY)*S.X, 0},
+         {2*(XY - WZ)*S.Y, (1 - 2*(XX + ZZ))*S.Y, 2*(YZ + WX)*S.Y, 0},
+         {2*(XZ + WY)*S.Z, 2*(YZ - WX)*S.Z, (1 - 2*(XX + YY))*S.Z, 0},
+         {T.X, T.Y, T.Z, 1},
+      }};
+   return(Result);
+}
+
+static inline mat4 Mat4_Orthographic(float Left, float Right, float Bottom, float Top, float Near, float Far)
+{
+   mat4 Result = Mat4_Identity();
+   Result.E[0][0] = 2.0f / (Right - Left);
+   Result.E[1][1] = 2.0f / (Top - Bottom);
+   Result.E[2][2] = -2.0f / (Far - Near);
+   Result.E[3][0] = -(Right + Left) / (Right - Left);
+   Result.E[3][1] = -(Top + Bottom) / (Top - Bottom);
+   Result.E[3][2] = -(Far + Near) / (Far - Near);
+   return(Result);
+}
+
+// NOTE: Extracts the planes of the clip volume of a view projection matrix,
+// with GL's -1 to 1 depth range. The planes are normalized, so plane
+// distances are in world units and can be compared against radii.
+static inline frustum Frustum_From_Mat4(mat4 M)
+{
+   frustum Result;
+   for(int Index = 0; Index < 6; ++Index)
+   {
+      int Row = Index / 2;
+      float Sign = (Index % 2) ? -1.0f : 1.0f;
+
+      float X = M.E[0][3] + Sign*M.E[0][Row];
+      float Y = M.E[1][3] + Sign*M.E[1][Row];
+      float Z = M.E[2][3] + Sign*M.E[2][Row];
+      float W = M.E[3][3] + Sign*M.E[3][Row];
+
+      float Length = sqrtf(X*X + Y*Y + Z*Z);
+      float Scale = (Length > 0) ? 1.0f / Length : 0.0f;
+
+      plane *Plane = Result.Planes + Index;
+      Plane->Normal.X = X*Scale;
+      Plane->Normal.Y = Y*Scale;
+      Plane->Normal.Z = Z*Scale;
+      Plane->Offset = W*Scale;
+   }
+   return(Result);
+}
+
+typedef enum {
+   Frustum_Outside,
+   Frustum_Intersecting,
+   Frustum_Inside,
+} frustum_test;
+
+static inline frustum_test Test_Frustum_Aabb(frustum *Frustum, vec3 Center, vec3 Extent)
+{
+   frustum_test Result = Frustum_Inside;
+   for(int Index = 0; Index < 6; ++Index)
+   {
+      plane *Plane = Frustum->Planes + Index;
+      float Distance = Plane->Normal.X*Center.X + Plane->Normal.Y*Center.Y + Plane->Normal.Z*Center.Z + Plane->Offset;
+      float Radius = (fabsf(Plane->Normal.X)*Extent.X + fabsf(Plane->Normal.Y)*Extent.Y + fabsf(Plane->Normal.Z)*Extent.Z);
+      if(Distance + Radius < 0)
+      {
+         Result = Frustum_Outside;
+         break;
+      }
+      if(Distance - Radius < 0)
+      {
+         Result = Frustum_Intersecting;
+      }
+   }
+   return(Result);
+}
+
+// NOTE: Conversions for packed vertex attributes. Halves round to nearest
+// even and saturate to infinity above 65504; normalized values are clamped
+// to their range first.
+static inline u16 Float_To_Half(float Value)
+{
+   union { float Float; u32 Bits; } Convert = {Value};
+   u32 Sign = (Convert.Bits >> 16) & 0x8000;
+   u32 Magnitude = Convert.Bits & 0x7FFFFFFF;
+
+   u32 Result;
+   if(Magnitude > 0x7F800000)
+   {
+      Result = Sign | 0x7E00;
+   }
+   else if(Magnitude >= 0x477FF000)
+   {
+      Result = Sign | 0x7C00;
+   }
+   else if(Magnitude < 0x38800000)
+   {
+      // NOTE: Below the smallest normal half, so the result is a multiple of
+      // 2^-24, and rintf rounds to nearest even.
+      Result = Sign | (u32)rintf(fabsf(Value) * 16777216.0f);
+   }
+   else
+   {
+      u32 Rebased = Magnitude - 0x38000000;
+      Rebased += 0xFFF + ((Rebased >> 13) & 1);
+      Result = Sign | (Rebased >> 13);
+   }
+
+   return((u16)Result);
+}
+
+static inline float Half_To_Float(u16 Value)
+{
+   u32 Sign = ((u32)Value & 0x8000) << 16;
+   u32 Exponent = ((u32)Value >> 10) & 0x1F;
+   u32 Mantissa = (u32)Value & 0x3FF;
+
+   union { u32 Bits; float Float; } Convert;
+   if(Exponent == 0x1F)
+   {
+      Convert.Bits = Sign | 0x7F800000 | (Mantissa << 13);
+   }
+   else if(Exponent == 0)
+   {
+      // NOTE: Zero or subnormal, a multiple of 2^-24 either way.
+      Convert.Float = (float)Mantissa * (1.0f / 16777216.0f);
+      Convert.Bits |= Sign;
+   }
+   else
+   {
+      Convert.Bits = Sign | ((Exponent + 112) << 23) | (Mantissa << 13);
+   }
+
+   return(Convert.Float);
+}
+
+static inline u8 Pack_Unorm8(float Value)
+{
+   float Clamped = fminf(fmaxf(Value, 0.0f), 1.0f);
+   u8 Result = (u8)(Clamped*255.0f + 0.5f);
+   return(Result);
+}
+
+// NOTE: The GL_INT_2_10_10_10_REV layout: X in the low bits, W in the top two.
+static inline u32 Pack_Snorm_10_10_10_2(float X, float Y, float Z, float W)
+{
+   s32 Packed_X = (s32)rintf(fminf(fmaxf(X, -1.0f), 1.0f) * 511.0f);
+   s32 Packed_Y = (s32)rintf(fminf(fmaxf(Y, -1.0f), 1.0f) * 511.0f);
+   s32 Packed_Z = (s32)rintf(fminf(fmaxf(Z, -1.0f), 1.0f) * 511.0f);
+   s32 Packed_W = (s32)rintf(fminf(fmaxf(W, -1.0f), 1.0f));
+
+   u32 Result = (((u32)Packed_X & 0x3FF) |
+                 (((u32)Packed_Y & 0x3FF) << 10) |
+                 (((u32)Packed_Z & 0x3FF) << 20) |
+                 (((u32)Packed_W & 0x3) << 30));
+   return(Result);
+}
+
+typedef enum {
+   Simd_Scalar,
+   Simd_Sse,
+   Simd_Avx2,
+
+   Simd_Level_Count,
+} simd_level;
+
+static char *Simd_Level_Names[Simd_Level_Count] = {"scalar", "sse", "avx2"};
+
+static simd_level Get_Simd_Level(void)
+{
+   // NOTE: Detection is idempotent, so racing threads just agree.
+   static int Detected_Level = -1;
+   if(Detected_Level < 0)
+   {
+      simd_level Level = Simd_Scalar;
+#if SHARED_MATH_X86
+      __builtin_cpu_init();
+      if(__builtin_cpu_supports("sse2"))
+      {
+         Level = Simd_Sse;
+      }
+      if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      {
+         Level = Simd_Avx2;
+      }
+#endif
+      Detected_Level = (int)Level;
+   }
+   return((simd_level)Detected_Level);
+}
+
+// NOTE: Each kernel variant processes whole lanes from First up to Count and
+// returns where it stopped, so the dispatchers below run the widest variant
+// first and let narrower ones pick up the tail.
+#define MATH_LANE float
+#define MATH_LANE_WIDTH 1
+#define MATH_KERNEL(Name) Name##_Scalar
+#define MATH_TARGET
+#define Lane_Set1(Value) (Value)
+#define Lane_Load(Pointer) (*(Pointer))
+#define Lane_Store(Pointer, Value) (*(Pointer) = (Value))
+#define Lane_Add(A, B) ((A) + (B))
+#define Lane_Sub(A, B) ((A) - (B))
+#define Lane_Mul(A, B) ((A) * (B))
+#define Lane_Mul_Add(A, B, C) ((A)*(B) + (C))
+#define MATH_MASK int
+#define Lane_Less(A, B) ((A) < (B))
+#define Lane_Mask_Or(A, B) ((A) | (B))
+#define Lane_Mask_Bits(Mask) (Mask)
+#include "shared_math_kernels.h"
+
+#if SHARED_MATH_X86
+#define MATH_LANE __m128
+#define MATH_LANE_WIDTH 4
+#define MATH_KERNEL(Name) Name##_Sse
+#define MATH_TARGET __attribute__((target("sse2")))
+#define Lane_Set1(Value) _mm_set1_ps(Value)
+#define Lane_Load(Pointer) _mm_loadu_ps(Pointer)
+#define Lane_Store(Pointer, Value) _mm_storeu_ps((Pointer), (Value))
+#define Lane_Add(A, B) _mm_add_ps((A), (B))
+#define Lane_Sub(A, B) _mm_sub_ps((A), (B))
+#define Lane_Mul(A, B) _mm_mul_ps((A), (B))
+#define Lane_Mul_Add(A, B, C) _mm_add_ps(_mm_mul_ps((A), (B)), (C))
+#define MATH_MASK __m128
+#define Lane_Less(A, B) _mm_cmplt_ps((A), (B))
+#define Lane_Mask_Or(A, B) _mm_or_ps((A), (B))
+#define Lane_Mask_Bits(Mask) _mm_movemask_ps(Mask)
+#include "shared_math_kernels.h"
+
+#define MATH_LANE __m256
+#define MATH_LANE_WIDTH 8
+#define MATH_KERNEL(Name) Name##_Avx2
+#define MATH_TARGET __attribute__((target("avx2,fma")))
+#define Lane_Set1(Value) _mm256_set1_ps(Value)
+#define Lane_Load(Pointer) _mm256_loadu_ps(Pointer)
+#define Lane_Store(Pointer, Value) _mm256_storeu_ps((Pointer), (Value))
+#define Lane_Add(A, B) _mm256_add_ps((A), (B))
+#define Lane_Sub(A, B) _mm256_sub_ps((A), (B))
+#define Lane_Mul(A, B) _mm256_mul_ps((A), (B))
+#define Lane_Mul_Add(A, B, C) _mm256_fmadd_ps((A), (B), (C))
+#define MATH_MASK __m256
+#define Lane_Less(A, B) _mm256_cmp_ps((A), (B), _CMP_LT_OQ)
+#define Lane_Mask_Or(A, B) _mm256_or_ps((A), (B))
+#define Lane_Mask_Bits(Mask) _mm256_movemask_ps(Mask)
+#include "shared_math_kernels.h"
+#endif
+
+// NOTE: Out = M * (In, 1) for Count points.
+static void Transform_Points_With(simd_level Level, mat4 *M, vec3_array In, vec3_array Out, u32 Count)
+{
+   u32 Index = 0;
+#if SHARED_MATH_X86
+   if(Level >= Simd_Avx2) Index = Transform_Points_Avx2(M, In, Out, Index, Count);
+   if(Level >= Simd_Sse) Index = Transform_Points_Sse(M, In, Out, Index, Count);
+#endif
+   Transform_Points_Scalar(M, In, Out, Index, Count);
+}
+
+// NOTE: Out[i] = A[i] * B[i] for Count pairs of matrices.
+static void Multiply_Matrices_With(simd_level Level, mat4_array A, mat4_array B, mat4_array Out, u32 Count)
+{
+   u32 Index = 0;
+#if SHARED_MATH_X86
+   if(Level >= Simd_Avx2) Index = Multiply_Matrices_Avx2(A, B, Out, Index, Count);
+   if(Level >= Simd_Sse) Index = Multiply_Matrices_Sse(A, B, Out, Index, Count);
+#endif
+   Multiply_Matrices_Scalar(A, B, Out, Index, Count);
+}
+
+// NOTE: Out[i] = Mat4_From_Trs(T[i], R[i], S[i]) for Count transforms.
+static void Compose_Trs_With(simd_level Level, vec3_array T, quat_array R, vec3_array S, mat4_array Out, u32 Count)
+{
+   u32 Index = 0;
+#if SHARED_MATH_X86
+   if(Level >= Simd_Avx2) Index = Compose_Trs_Avx2(T, R, S, Out, Index, Count);
+   if(Level >= Simd_Sse) Index = Compose_Trs_Sse(T, R, S, Out, Index, Count);
+#endif
+   Compose_Trs_Scalar(T, R, S, Out, Index, Count);
+}
+
+// NOTE: Appends the index of every sphere (or box) that isn't entirely
+// outside the frustum to Visible, in order, and returns how many it added.
+// Visible needs room for Count indices.
+static u32 Frustum_Cull_Spheres_With(simd_level Level, frustum *Frustum, sphere_array Spheres, u32 *Visible, u32 Count)
+{
+   u32 Visible_Count = 0;
+   u32 Index = 0;
+#if SHARED_MATH_X86
+   if(Level >= Simd_Avx2) Index = Frustum_Cull_Spheres_Avx2(Frustum, Spheres, Visible, &Visible_Count, Index, Count);
+   if(Level >= Simd_Sse) Index = Frustum_Cull_Spheres_Sse(Frustum, Spheres, Visible, &Visible_Count, Index, Count);
+#endif
+   Frustum_Cull_Spheres_Scalar(Frustum, Spheres, Visible, &Visible_Count, Index, Count);
+   return(Visible_Count);
+}
+
+static u32 Frustum_Cull_Aabbs_With(simd_level Level, frustum *Frustum, aabb_array Boxes, u32 *Visible, u32 Count)
+{
+   u32 Visible_Count = 0;
+   u32 Index = 0;
+#if SHARED_MATH_X86
+   if(Level >= Simd_Avx2) Index = Frustum_Cull_Aabbs_Avx2(Frustum, Boxes, Visible, &Visible_Count, Index, Count);
+   if(Level >= Simd_Sse) Index = Frustum_Cull_Aabbs_Sse(Frustum, Boxes, Visible, &Visible_Count, Index, Count);
+#endif
+   Frustum_Cull_Aabbs_Scalar(Frustum, Boxes, Visible, &Visible_Count, Index, Count);
+   return(Visible_Count);
+}
+
+static inline void Transform_Points(mat4 *M, vec3_array In, vec3_array Out, u32 Count)
+{
+   Transform_Points_With(Get_Simd_Level(), M, In, Out, Count);
+}
+
+static inline void Multiply_Matrices(mat4_array A, mat4_array B, mat4_array Out, u32 Count)
+{
+   Multiply_Matrices_With(Get_Simd_Level(), A, B, Out, Count);
+}
+
+static inline void Compose_Trs(vec3_array T, quat_array R, vec3_array S, mat4_array Out, u32 Count)
+{
+   Compose_Trs_With(Get_Simd_Level(), T, R, S, Out, Count);
+}
+
+static inline u32 Frustum_Cull_Spheres(frustum *Frustum, sphere_array Spheres, u32 *Visible, u32 Count)
+{
+   u32 Result = Frustum_Cull_Spheres_With(Get_Simd_Level(), Frustum, Spheres, Visible, Count);
+   return(Result);
+}
+
+static inline u32 Frustum_Cull_Aabbs(frustum *Frustum, aabb_array Boxes, u32 *Visible, u32 Count)
+{
+   u32 Result = Frustum_Cull_Aabbs_With(Get_Simd_Level(), Frustum, Boxes, Visible, Count);
+   return(Result);
+}
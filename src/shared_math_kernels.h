@@ -0,0 +1,222 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Batched math kernels, written once against the Lane_ macros and
+// included by shared_math.h once per lane width. The includer defines
+// MATH_LANE, MATH_LANE_WIDTH, MATH_MASK, MATH_KERNEL, MATH_TARGET and the
+// Lane_ macros; this file undefines them again at the bottom. MATH_MASK is
+// the result of a lane comparison, and Lane_Mask_Bits packs it into one bit
+// per lane.
+
+static MATH_TARGET u32 MATH_KERNEL(Transform_Points)(mat4 *M, vec3_array In, vec3_array Out, u32 First, u32 Count)
+{
+   MATH_LANE M00 = Lane_Set1(M->E[0][0]), M01 = Lane_Set1(M->E[0][1]), M02 = Lane_Set1(M->E[0][2]);
+   MATH_LANE M10 = Lane_Set1(M->E[1][0]), M11 = Lane_Set1(M->E[1][1]), M12 = Lane_Set1(M->E[1][2]);
+   MATH_LANE M20 = Lane_Set1(M->E[2][0]), M21 = Lane_Set1(M->E[2][1]), M22 = Lane_Set1(M->E[2][2]);
+   MATH_LANE M30 = Lane_Set1(M->E[3][0]), M31 = Lane_Set1(M->E[3][1]), M32 = Lane_Set1(M->E[3][2]);
+
+   u32 Index = First;
+   for(; Index + MATH_LANE_WIDTH <= Count; Index += MATH_LANE_WIDTH)
+   {
+      MATH_LANE X = Lane_Load(In.X + Index);
+      MATH_LANE Y = Lane_Load(In.Y + Index);
+      MATH_LANE Z = Lane_Load(In.Z + Index);
+
+      Lane_Store(Out.X + Index, Lane_Mul_Add(M00, X, Lane_Mul_Add(M10, Y, Lane_Mul_Add(M20, Z, M30))));
+      Lane_Store(Out.Y + Index, Lane_Mul_Add(M01, X, Lane_Mul_Add(M11, Y, Lane_Mul_Add(M21, Z, M31))));
+      Lane_Store(Out.Z + Index, Lane_Mul_Add(M02, X, Lane_Mul_Add(M12, Y, Lane_Mul_Add(M22, Z, M32))));
+   }
+
+   return(Index);
+}
+
+static MATH_TARGET u32 MATH_KERNEL(Multiply_Matrices)(mat4_array A, mat4_array B, mat4_array Out, u32 First, u32 Count)
+{
+   u32 Index = First;
+   for(; Index + MATH_LANE_WIDTH <= Count; Index += MATH_LANE_WIDTH)
+   {
+      // NOTE: A is loaded once and kept in registers, then each column of B
+      // is combined with it.
+      MATH_LANE A_Lanes[16];
+      for(int Element = 0; Element < 16; ++Element)
+      {
+         A_Lanes[Element] = Lane_Load(A.E[Element] + Index);
+      }
+
+      for(int Column = 0; Column < 4; ++Column)
+      {
+         MATH_LANE B0 = Lane_Load(B.E[Column*4 + 0] + Index);
+         MATH_LANE B1 = Lane_Load(B.E[Column*4 + 1] + Index);
+         MATH_LANE B2 = Lane_Load(B.E[Column*4 + 2] + Index);
+         MATH_LANE B3 = Lane_Load(B.E[Column*4 + 3] + Index);
+
+         for(int Row = 0; Row < 4; ++Row)
+         {
+            MATH_LANE Value = Lane_Mul(A_Lanes[0*4 + Row], B0);
+            Value = Lane_Mul_Add(A_Lanes[1*4 + Row], B1, Value);
+            Value = Lane_Mul_Add(A_Lanes[2*4 + Row], B2, Value);
+            Value = Lane_Mul_Add(A_Lanes[3*4 + Row], B3, Value);
+            Lane_Store(Out.E[Column*4 + Row] + Index, Value);
+         }
+      }
+   }
+
+   return(Index);
+}
+
+static MATH_TARGET u32 MATH_KERNEL(Compose_Trs)(vec3_array T, quat_array R, vec3_array S, mat4_array Out, u32 First, u32 Count)
+{
+   MATH_LANE Zero = Lane_Set1(0.0f);
+   MATH_LANE One = Lane_Set1(1.0f);
+   MATH_LANE Two = Lane_Set1(2.0f);
+
+   u32 Index = First;
+   for(; Index + MATH_LANE_WIDTH <= Count; Index += MATH_LANE_WIDTH)
+   {
+      MATH_LANE X = Lane_Load(R.X + Index);
+      MATH_LANE Y = Lane_Load(R.Y + Index);
+      MATH_LANE Z = Lane_Load(R.Z + Index);
+      MATH_LANE W = Lane_Load(R.W + Index);
+
+      // NOTE: Pre-doubling the vector part folds the factors of two in
+      // Mat4_From_Trs into the products.
+      MATH_LANE X2 = Lane_Mul(X, Two), Y2 = Lane_Mul(Y, Two), Z2 = Lane_Mul(Z, Two);
+      MATH_LANE XX = Lane_Mul(X, X2), YY = Lane_Mul(Y, Y2), ZZ = Lane_Mul(Z, Z2);
+      MATH_LANE XY = Lane_Mul(X, Y2), XZ = Lane_Mul(X, Z2), YZ = Lane_Mul(Y, Z2);
+      MATH_LANE WX = Lane_Mul(W, X2), WY = Lane_Mul(W, Y2), WZ = Lane_Mul(W, Z2);
+
+      MATH_LANE SX = Lane_Load(S.X + Index);
+      MATH_LANE SY = Lane_Load(S.Y + Index);
+      MATH_LANE SZ = Lane_Load(S.Z + Index);
+
+      Lane_Store(Out.E[0] + Index, Lane_Mul(Lane_Sub(One, Lane_Add(YY, ZZ)), SX));
+      Lane_Store(Out.E[1] + Index, Lane_Mul(Lane_Add(XY, WZ), SX));
+      Lane_Store(Out.E[2] + Index, Lane_Mul(Lane_Sub(XZ, WY), SX));
+      Lane_Store(Out.E[3] + Index, Zero);
+
+      Lane_Store(Out.E[4] + Index, Lane_Mul(Lane_Sub(XY, WZ), SY));
+      Lane_Store(Out.E[5] + Index, Lane_Mul(Lane_Sub(One, Lane_Add(XX, ZZ)), SY));
+      Lane_Store(Out.E[6] + Index, Lane_Mul(Lane_Add(YZ, WX), SY));
+      Lane_Store(Out.E[7] + Index, Zero);
+
+      Lane_Store(Out.E[8] + Index, Lane_Mul(Lane_Add(XZ, WY), SZ));
+      Lane_Store(Out.E[9] + Index, Lane_Mul(Lane_Sub(YZ, WX), SZ));
+      Lane_Store(Out.E[10] + Index, Lane_Mul(Lane_Sub(One, Lane_Add(XX, YY)), SZ));
+      Lane_Store(Out.E[11] + Index, Zero);
+
+      Lane_Store(Out.E[12] + Index, Lane_Load(T.X + Index));
+      Lane_Store(Out.E[13] + Index, Lane_Load(T.Y + Index));
+      Lane_Store(Out.E[14] + Index, Lane_Load(T.Z + Index));
+      Lane_Store(Out.E[15] + Index, One);
+   }
+
+   return(Index);
+}
+
+// NOTE: The cull kernels write the indices of the lanes that survived every
+// plane, taking them off the lane mask lowest bit first so the output stays
+// in input order.
+static MATH_TARGET u32 MATH_KERNEL(Frustum_Cull_Spheres)(frustum *Frustum, sphere_array Spheres, u32 *Visible, u32 *Visible_Count, u32 First, u32 Count)
+{
+   MATH_LANE Zero = Lane_Set1(0.0f);
+   MATH_LANE Normal_X[6], Normal_Y[6], Normal_Z[6], Offset[6];
+   for(int Plane = 0; Plane < 6; ++Plane)
+   {
+      Normal_X[Plane] = Lane_Set1(Frustum->Planes[Plane].Normal.X);
+      Normal_Y[Plane] = Lane_Set1(Frustum->Planes[Plane].Normal.Y);
+      Normal_Z[Plane] = Lane_Set1(Frustum->Planes[Plane].Normal.Z);
+      Offset[Plane] = Lane_Set1(Frustum->Planes[Plane].Offset);
+   }
+
+   u32 Written = *Visible_Count;
+   u32 Index = First;
+   for(; Index + MATH_LANE_WIDTH <= Count; Index += MATH_LANE_WIDTH)
+   {
+      MATH_LANE X = Lane_Load(Spheres.X + Index);
+      MATH_LANE Y = Lane_Load(Spheres.Y + Index);
+      MATH_LANE Z = Lane_Load(Spheres.Z + Index);
+      MATH_LANE Radius = Lane_Load(Spheres.Radius + Index);
+
+      MATH_MASK Outside = Lane_Less(Zero, Zero);
+      for(int Plane = 0; Plane < 6; ++Plane)
+      {
+         MATH_LANE Distance = Lane_Mul_Add(Normal_X[Plane], X, Lane_Mul_Add(Normal_Y[Plane], Y, Lane_Mul_Add(Normal_Z[Plane], Z, Lane_Add(Offset[Plane], Radius))));
+         Outside = Lane_Mask_Or(Outside, Lane_Less(Distance, Zero));
+      }
+
+      u32 Inside = ~(u32)Lane_Mask_Bits(Outside) & ((1u << MATH_LANE_WIDTH) - 1);
+      while(Inside)
+      {
+         Visible[Written++] = Index + (u32)__builtin_ctz(Inside);
+         Inside &= Inside - 1;
+      }
+   }
+
+   *Visible_Count = Written;
+   return(Index);
+}
+
+static MATH_TARGET u32 MATH_KERNEL(Frustum_Cull_Aabbs)(frustum *Frustum, aabb_array Boxes, u32 *Visible, u32 *Visible_Count, u32 First, u32 Count)
+{
+   // NOTE: A box's projected radius onto a plane is its extent dotted with
+   // the absolute normal, so those are precomputed per plane.
+   MATH_LANE Zero = Lane_Set1(0.0f);
+   MATH_LANE Normal_X[6], Normal_Y[6], Normal_Z[6], Offset[6];
+   MATH_LANE Abs_X[6], Abs_Y[6], Abs_Z[6];
+   for(int Plane = 0; Plane < 6; ++Plane)
+   {
+      vec3 Normal = Frustum->Planes[Plane].Normal;
+      Normal_X[Plane] = Lane_Set1(Normal.X);
+      Normal_Y[Plane] = Lane_Set1(Normal.Y);
+      Normal_Z[Plane] = Lane_Set1(Normal.Z);
+      Offset[Plane] = Lane_Set1(Frustum->Planes[Plane].Offset);
+      Abs_X[Plane] = Lane_Set1(fabsf(Normal.X));
+      Abs_Y[Plane] = Lane_Set1(fabsf(Normal.Y));
+      Abs_Z[Plane] = Lane_Set1(fabsf(Normal.Z));
+   }
+
+   u32 Written = *Visible_Count;
+   u32 Index = First;
+   for(; Index + MATH_LANE_WIDTH <= Count; Index += MATH_LANE_WIDTH)
+   {
+      MATH_LANE X = Lane_Load(Boxes.Center.X + Index);
+      MATH_LANE Y = Lane_Load(Boxes.Center.Y + Index);
+      MATH_LANE Z = Lane_Load(Boxes.Center.Z + Index);
+      MATH_LANE Extent_X = Lane_Load(Boxes.Extent.X + Index);
+      MATH_LANE Extent_Y = Lane_Load(Boxes.Extent.Y + Index);
+      MATH_LANE Extent_Z = Lane_Load(Boxes.Extent.Z + Index);
+
+      MATH_MASK Outside = Lane_Less(Zero, Zero);
+      for(int Plane = 0; Plane < 6; ++Plane)
+      {
+         MATH_LANE Radius = Lane_Mul_Add(Abs_X[Plane], Extent_X, Lane_Mul_Add(Abs_Y[Plane], Extent_Y, Lane_Mul(Abs_Z[Plane], Extent_Z)));
+         MATH_LANE Distance = Lane_Mul_Add(Normal_X[Plane], X, Lane_Mul_Add(Normal_Y[Plane], Y, Lane_Mul_Add(Normal_Z[Plane], Z, Lane_Add(Offset[Plane], Radius))));
+         Outside = Lane_Mask_Or(Outside, Lane_Less(Distance, Zero));
+      }
+
+      u32 Inside = ~(u32)Lane_Mask_Bits(Outside) & ((1u << MATH_LANE_WIDTH) - 1);
+      while(Inside)
+      {
+         Visible[Written++] = Index + (u32)__builtin_ctz(Inside);
+         Inside &= Inside - 1;
+      }
+   }
+
+   *Visible_Count = Written;
+   return(Index);
+}
+
+#undef MATH_LANE
+#undef MATH_LANE_WIDTH
+#undef MATH_KERNEL
+#undef MATH_TARGET
+#undef Lane_Set1
+#undef Lane_Load
+#undef Lane_Store
+#undef Lane_Add
+#undef Lane_Sub
+#undef Lane_Mul
+#undef Lane_Mul_Add
+#undef MATH_MASK
+#undef Lane_Less
+#undef Lane_Mask_Or
+#undef Lane_Mask_Bits
@@ -0,0 +1,160 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: The software rasterizer's inner loop, written once against the lane
+// macros and included by software_renderer.c once per SIMD level, the same
+// way shared_math_kernels.h is. Every lane type holds four horizontally
+// adjacent pixels: EDGE_LANE one 64-bit edge function value per pixel,
+// COLOR_LANE one float channel per pixel, and PIXEL_LANE the packed RGBA8
+// pixels. Masks are plain ints with one bit per pixel, lowest pixel first.
+// The includer defines SOFTWARE_KERNEL, SOFTWARE_TARGET, the lane types and
+// the macros below; this file undefines them again at the bottom.
+
+// NOTE: Draws the part of Triangle inside the tile [X0, X1) x [Y0, Y1). X0 is
+// a multiple of four, and whole groups of four pixels may be touched up to
+// X1 rounded up, which the framebuffer pitch always leaves room for.
+static SOFTWARE_TARGET void SOFTWARE_KERNEL(Rasterize_Triangle)(software_renderer *Software, software_triangle *Triangle,
+                                                                int Tile_X0, int Tile_Y0, int Tile_X1, int Tile_Y1)
+{
+   int X0 = (Triangle->Min_X > Tile_X0) ? Triangle->Min_X : Tile_X0;
+   int Y0 = (Triangle->Min_Y > Tile_Y0) ? Triangle->Min_Y : Tile_Y0;
+   int X1 = (Triangle->Max_X < Tile_X1) ? Triangle->Max_X : Tile_X1;
+   int Y1 = (Triangle->Max_Y < Tile_Y1) ? Triangle->Max_Y : Tile_Y1;
+   if(X0 >= X1 || Y0 >= Y1)
+   {
+      return;
+   }
+
+   // NOTE: Edges are linear, so checking the corners of the rectangle tells
+   // whether an edge passes every pixel in it or none of them. Only the edges
+   // in between are tested per pixel, and a rectangle entirely inside the
+   // triangle is filled without any tests at all.
+   s64 Step = (s64)1 << SOFTWARE_SUBPIXEL_BITS;
+   s64 Half = Step / 2;
+   s64 Left = X0*Step + Half;
+   s64 Right = (X1 - 1)*Step + Half;
+   s64 Bottom = Y0*Step + Half;
+   s64 Top = (Y1 - 1)*Step + Half;
+
+   int Partial_Count = 0;
+   int Partial[3];
+   for(int Edge = 0; Edge < 3; ++Edge)
+   {
+      s64 A = Triangle->A[Edge];
+      s64 B = Triangle->B[Edge];
+      s64 C = Triangle->C[Edge];
+      s64 Min_X = (A < 0) ? A*Right : A*Left;
+      s64 Max_X = (A < 0) ? A*Left : A*Right;
+      s64 Min_Y = (B < 0) ? B*Top : B*Bottom;
+      s64 Max_Y = (B < 0) ? B*Bottom : B*Top;
+
+      if(Max_X + Max_Y + C < 0)
+      {
+         return;
+      }
+      if(Min_X + Min_Y + C < 0)
+      {
+         Partial[Partial_Count++] = Edge;
+      }
+   }
+
+   // NOTE: Unused edge slots repeat a real one, which changes nothing.
+   int E0 = (Partial_Count > 0) ? Partial[0] : 0;
+   int E1 = (Partial_Count > 1) ? Partial[1] : E0;
+   int E2 = (Partial_Count > 2) ? Partial[2] : E0;
+
+   int First_X = X0 & ~3;
+   s64 First_Center = First_X*Step + Half;
+   EDGE_LANE Step_0 = Edge_Set1((s64)Triangle->A[E0]*Step*4);
+   EDGE_LANE Step_1 = Edge_Set1((s64)Triangle->A[E1]*Step*4);
+   EDGE_LANE Step_2 = Edge_Set1((s64)Triangle->A[E2]*Step*4);
+
+   COLOR_LANE Dx[4];
+   for(int Channel = 0; Channel < 4; ++Channel)
+   {
+      Dx[Channel] = Color_Set1(Triangle->Color_Dx[Channel]);
+   }
+   PIXEL_LANE Flat = Pixel_Set1(Triangle->Flat_Color);
+
+   for(int Y = Y0; Y < Y1; ++Y)
+   {
+      s64 Center_Y = Y*Step + Half;
+      EDGE_LANE Edge_0 = Edge_Ramp((s64)Triangle->A[E0]*First_Center + (s64)Triangle->B[E0]*Center_Y + Triangle->C[E0], (s64)Triangle->A[E0]*Step);
+      EDGE_LANE Edge_1 = Edge_Ramp((s64)Triangle->A[E1]*First_Center + (s64)Triangle->B[E1]*Center_Y + Triangle->C[E1], (s64)Triangle->A[E1]*Step);
+      EDGE_LANE Edge_2 = Edge_Ramp((s64)Triangle->A[E2]*First_Center + (s64)Triangle->B[E2]*Center_Y + Triangle->C[E2], (s64)Triangle->A[E2]*Step);
+
+      COLOR_LANE Row[4];
+      for(int Channel = 0; Channel < 4; ++Channel)
+      {
+         Row[Channel] = Color_Set1(Triangle->Color[Channel] + Triangle->Color_Dy[Channel]*((float)Y + 0.5f));
+      }
+
+      u32 *Pixels = Software->Pixels + (size)Y*Software->Pitch;
+      for(int X = First_X; X < X1; X += 4)
+      {
+         int Mask = 0xF;
+         if(X < X0)
+         {
+            Mask &= 0xF << (X0 - X);
+         }
+         if(X + 4 > X1)
+         {
+            Mask &= 0xF >> (X + 4 - X1);
+         }
+         if(Partial_Count > 0)
+         {
+            Mask &= ~Edge_Outside_Bits(Edge_0, Edge_1, Edge_2);
+         }
+
+         if(Mask)
+         {
+            PIXEL_LANE Color = Flat;
+            if(!Triangle->Flat)
+            {
+               COLOR_LANE Center_X = Color_Ramp((float)X + 0.5f);
+               Color = Pixel_Pack(Color_Add(Row[0], Color_Mul(Dx[0], Center_X)),
+                                  Color_Add(Row[1], Color_Mul(Dx[1], Center_X)),
+                                  Color_Add(Row[2], Color_Mul(Dx[2], Center_X)),
+                                  Color_Add(Row[3], Color_Mul(Dx[3], Center_X)));
+            }
+
+            if(Triangle->Blend)
+            {
+               PIXEL_LANE Dest = Pixel_Load(Pixels + X);
+               Pixel_Store(Pixels + X, Pixel_Select(Mask, Pixel_Blend(Color, Dest), Dest));
+            }
+            else if(Mask == 0xF)
+            {
+               Pixel_Store(Pixels + X, Color);
+            }
+            else
+            {
+               Pixel_Store(Pixels + X, Pixel_Select(Mask, Color, Pixel_Load(Pixels + X)));
+            }
+         }
+
+         Edge_0 = Edge_Add(Edge_0, Step_0);
+         Edge_1 = Edge_Add(Edge_1, Step_1);
+         Edge_2 = Edge_Add(Edge_2, Step_2);
+      }
+   }
+}
+
+#undef SOFTWARE_KERNEL
+#undef SOFTWARE_TARGET
+#undef EDGE_LANE
+#undef COLOR_LANE
+#undef PIXEL_LANE
+#undef Edge_Set1
+#undef Edge_Ramp
+#undef Edge_Add
+#undef Edge_Outside_Bits
+#undef Color_Set1
+#undef Color_Ramp
+#undef Color_Add
+#undef Color_Mul
+#undef Pixel_Set1
+#undef Pixel_Load
+#undef Pixel_Store
+#undef Pixel_Pack
+#undef Pixel_Select
+#undef Pixel_Blend
@@ -0,0 +1,1041 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Software renderer. See software_renderer.h for the overview; this
+// file has the lane helpers the kernels are built from, triangle setup and
+// binning, the tile jobs, and the command executor.
+
+typedef struct {
+   s64 E[4];
+} software_edge_lanes;
+
+typedef struct {
+   float E[4];
+} software_color_lanes;
+
+typedef struct {
+   u32 E[4];
+} software_pixel_lanes;
+
+static inline u32 Pack_Software_Channel(float Value)
+{
+   // NOTE: Rounds to nearest even, like the SIMD conversions.
+   float Clamped = fminf(fmaxf(Value, 0.0f), 1.0f);
+   u32 Result = (u32)lrintf(Clamped*255.0f);
+   return(Result);
+}
+
+static inline u32 Pack_Software_Color(float R, float G, float B, float A)
+{
+   u32 Result = (Pack_Software_Channel(R) |
+                 (Pack_Software_Channel(G) << 8) |
+                 (Pack_Software_Channel(B) << 16) |
+                 (Pack_Software_Channel(A) << 24));
+   return(Result);
+}
+
+// NOTE: X*Y/255 for bytes, rounded to nearest, as done by fixed point blenders.
+static inline u32 Multiply_Unorm8(u32 X, u32 Y)
+{
+   u32 Product = X*Y + 128;
+   u32 Result = (Product + (Product >> 8)) >> 8;
+   return(Result);
+}
+
+static inline software_edge_lanes Scalar_Edge_Set1(s64 Value)
+{
+   software_edge_lanes Result = {{Value, Value, Value, Value}};
+   return(Result);
+}
+
+static inline software_edge_lanes Scalar_Edge_Ramp(s64 Value, s64 Step)
+{
+   software_edge_lanes Result = {{Value, Value + Step, Value + 2*Step, Value + 3*Step}};
+   return(Result);
+}
+
+static inline software_edge_lanes Scalar_Edge_Add(software_edge_lanes A, software_edge_lanes B)
+{
+   software_edge_lanes Result;
+   for(int Lane = 0; Lane < 4; ++Lane)
+   {
+      Result.E[Lane] = A.E[Lane] + B.E[Lane];
+   }
+   return(Result);
+}
+
+static inline int Scalar_Edge_Outside_Bits(software_edge_lanes A, software_edge_lanes B, software_edge_lanes C)
+{
+   int Result = 0;
+   for(int Lane = 0; Lane < 4; ++Lane)
+   {
+      Result |= ((A.E[Lane] | B.E[Lane] | C.E[Lane]) < 0) << Lane;
+   }
+   return(Result);
+}
+
+static inline software_color_lanes Scalar_Color_Set1(float Value)
+{
+   software_color_lanes Result = {{Value, Value, Value, Value}};
+   return(Result);
+}
+
+static inline software_color_lanes Scalar_Color_Ramp(float Value)
+{
+   software_color_lanes Result = {{Value, Value + 1.0f, Value + 2.0f, Value + 3.0f}};
+   return(Result);
+}
+
+static inline software_color_lanes Scalar_Color_Add(software_color_lanes A, software_color_lanes B)
+{
+   software_color_lanes Result;
+   for(int Lane = 0; Lane < 4; ++Lane)
+   {
+      Result.E[Lane] = A.E[Lane] + B.E[Lane];
+   }
+   return(Result);
+}
+
+static inline software_color_lanes Scalar_Color_Mul(software_color_lanes A, software_color_lanes B)
+{
+   software_color_lanes Result;
+   for(int Lane = 0; Lane < 4; ++Lane)
+   {
+      Result.E[Lane] = A.E[Lane] * B.E[Lane];
+   }
+   return(Result);
+}
+
+static inline software_pixel_lanes Scalar_Pixel_Set1(u32 Value)
+{
+   software_pixel_lanes Result = {{Value, Value, Value, Value}};
+   return(Result);
+}
+
+static inline software_pixel_lanes Scalar_Pixel_Load(u32 *Pixels)
+{
+   software_pixel_lanes Result = {{Pixels[0], Pixels[1], Pixels[2], Pixels[3]}};
+   return(Result);
+}
+
+static inline void Scalar_Pixel_Store(u32 *Pixels, software_pixel_lanes Value)
+{
+   for(int Lane = 0; Lane < 4; ++Lane)
+   {
+      Pixels[Lane] = Value.E[Lane];
+   }
+}
+
+static inline software_pixel_lanes Scalar_Pixel_Pack(software_color_lanes R, software_color_lanes G, software_color_lanes B, software_color_lanes A)
+{
+   software_pixel_lanes Result;
+   for(int Lane = 0; Lane < 4; ++Lane)
+   {
+      Result.E[Lane] = Pack_Software_Color(R.E[Lane], G.E[Lane], B.E[Lane], A.E[Lane]);
+   }
+   return(Result);
+}
+
+static inline software_pixel_lanes Scalar_Pixel_Select(int Mask, software_pixel_lanes New, software_pixel_lanes Old)
+{
+   software_pixel_lanes Result;
+   for(int Lane = 0; Lane < 4; ++Lane)
+   {
+      Result.E[Lane] = (Mask & (1 << Lane)) ? New.E[Lane] : Old.E[Lane];
+   }
+   return(Result);
+}
+
+// NOTE: GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA on all four channels.
+static inline software_pixel_lanes Scalar_Pixel_Blend(software_pixel_lanes Source, software_pixel_lanes Dest)
+{
+   software_pixel_lanes Result;
+   for(int Lane = 0; Lane < 4; ++Lane)
+   {
+      u32 Alpha = Source.E[Lane] >> 24;
+      u32 Blended = 0;
+      for(int Shift = 0; Shift < 32; Shift += 8)
+      {
+         u32 Value = (Multiply_Unorm8((Source.E[Lane] >> Shift) & 0xFF, Alpha) +
+                      Multiply_Unorm8((Dest.E[Lane] >> Shift) & 0xFF, 255 - Alpha));
+         Blended |= Value << Shift;
+      }
+      Result.E[Lane] = Blended;
+   }
+   return(Result);
+}
+
+#define SOFTWARE_KERNEL(Name) Name##_Scalar
+#define SOFTWARE_TARGET
+#define EDGE_LANE software_edge_lanes
+#define COLOR_LANE software_color_lanes
+#define PIXEL_LANE software_pixel_lanes
+#define Edge_Set1(Value) Scalar_Edge_Set1(Value)
+#define Edge_Ramp(Value, Step) Scalar_Edge_Ramp((Value), (Step))
+#define Edge_Add(A, B) Scalar_Edge_Add((A), (B))
+#define Edge_Outside_Bits(A, B, C) Scalar_Edge_Outside_Bits((A), (B), (C))
+#define Color_Set1(Value) Scalar_Color_Set1(Value)
+#define Color_Ramp(Value) Scalar_Color_Ramp(Value)
+#define Color_Add(A, B) Scalar_Color_Add((A), (B))
+#define Color_Mul(A, B) Scalar_Color_Mul((A), (B))
+#define Pixel_Set1(Value) Scalar_Pixel_Set1(Value)
+#define Pixel_Load(Pointer) Scalar_Pixel_Load(Pointer)
+#define Pixel_Store(Pointer, Value) Scalar_Pixel_Store((Pointer), (Value))
+#define Pixel_Pack(R, G, B, A) Scalar_Pixel_Pack((R), (G), (B), (A))
+#define Pixel_Select(Mask, New, Old) Scalar_Pixel_Select((Mask), (New), (Old))
+#define Pixel_Blend(Source, Dest) Scalar_Pixel_Blend((Source), (Dest))
+#include "software_kernels.h"
+
+#if SHARED_MATH_X86
+// NOTE: SSE2 has 64-bit adds but no 64-bit compares, so edge signs are read
+// straight out of the top bits with a double precision movemask.
+typedef struct {
+   __m128i Low;
+   __m128i High;
+} software_edge_lanes_sse;
+
+static inline __attribute__((target("sse2"))) software_edge_lanes_sse Sse_Edge_Set1(s64 Value)
+{
+   software_edge_lanes_sse Result = {_mm_set1_epi64x(Value), _mm_set1_epi64x(Value)};
+   return(Result);
+}
+
+static inline __attribute__((target("sse2"))) software_edge_lanes_sse Sse_Edge_Ramp(s64 Value, s64 Step)
+{
+   software_edge_lanes_sse Result = {_mm_set_epi64x(Value + Step, Value), _mm_set_epi64x(Value + 3*Step, Value + 2*Step)};
+   return(Result);
+}
+
+static inline __attribute__((target("sse2"))) software_edge_lanes_sse Sse_Edge_Add(software_edge_lanes_sse A, software_edge_lanes_sse B)
+{
+   software_edge_lanes_sse Result = {_mm_add_epi64(A.Low, B.Low), _mm_add_epi64(A.High, B.High)};
+   return(Result);
+}
+
+static inline __attribute__((target("sse2"))) int Sse_Edge_Outside_Bits(software_edge_lanes_sse A, software_edge_lanes_sse B, software_edge_lanes_sse C)
+{
+   __m128i Low = _mm_or_si128(_mm_or_si128(A.Low, B.Low), C.Low);
+   __m128i High = _mm_or_si128(_mm_or_si128(A.High, B.High), C.High);
+   int Result = _mm_movemask_pd(_mm_castsi128_pd(Low)) | (_mm_movemask_pd(_mm_castsi128_pd(High)) << 2);
+   return(Result);
+}
+
+static inline __attribute__((target("sse2"))) __m128i Sse_Pixel_Pack(__m128 R, __m128 G, __m128 B, __m128 A)
+{
+   __m128 Zero = _mm_setzero_ps();
+   __m128 One = _mm_set1_ps(1.0f);
+   __m128 Scale = _mm_set1_ps(255.0f);
+   __m128i Red = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(R, Zero), One), Scale));
+   __m128i Green = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(G, Zero), One), Scale));
+   __m128i Blue = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(B, Zero), One), Scale));
+   __m128i Alpha = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(A, Zero), One), Scale));
+
+   __m128i Result = _mm_or_si128(_mm_or_si128(Red, _mm_slli_epi32(Green, 8)),
+                                 _mm_or_si128(_mm_slli_epi32(Blue, 16), _mm_slli_epi32(Alpha, 24)));
+   return(Result);
+}
+
+static inline __attribute__((target("sse2"))) __m128i Sse_Pixel_Select(int Mask, __m128i New, __m128i Old)
+{
+   __m128i Bits = _mm_set_epi32(8, 4, 2, 1);
+   __m128i Lanes = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(Mask), Bits), Bits);
+   __m128i Result = _mm_or_si128(_mm_and_si128(Lanes, New), _mm_andnot_si128(Lanes, Old));
+   return(Result);
+}
+
+static inline __attribute__((target("sse2"))) __m128i Sse_Multiply_Unorm8(__m128i X, __m128i Y)
+{
+   __m128i Product = _mm_add_epi16(_mm_mullo_epi16(X, Y), _mm_set1_epi16(128));
+   __m128i Result = _mm_srli_epi16(_mm_add_epi16(Product, _mm_srli_epi16(Product, 8)), 8);
+   return(Result);
+}
+
+static inline __attribute__((target("sse2"))) __m128i Sse_Blend_Half(__m128i Source, __m128i Dest)
+{
+   // NOTE: Two pixels as eight 16-bit channels, alpha in the fourth of each.
+   __m128i Alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(Source, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+   __m128i Inverse = _mm_sub_epi16(_mm_set1_epi16(255), Alpha);
+   __m128i Result = _mm_add_epi16(Sse_Multiply_Unorm8(Source, Alpha), Sse_Multiply_Unorm8(Dest, Inverse));
+   return(Result);
+}
+
+static inline __attribute__((target("sse2"))) __m128i Sse_Pixel_Blend(__m128i Source, __m128i Dest)
+{
+   __m128i Zero = _mm_setzero_si128();
+   __m128i Low = Sse_Blend_Half(_mm_unpacklo_epi8(Source, Zero), _mm_unpacklo_epi8(Dest, Zero));
+   __m128i High = Sse_Blend_Half(_mm_unpackhi_epi8(Source, Zero), _mm_unpackhi_epi8(Dest, Zero));
+   __m128i Result = _mm_packus_epi16(Low, High);
+   return(Result);
+}
+
+#define SOFTWARE_KERNEL(Name) Name##_Sse
+#define SOFTWARE_TARGET __attribute__((target("sse2")))
+#define EDGE_LANE software_edge_lanes_sse
+#define COLOR_LANE __m128
+#define PIXEL_LANE __m128i
+#define Edge_Set1(Value) Sse_Edge_Set1(Value)
+#define Edge_Ramp(Value, Step) Sse_Edge_Ramp((Value), (Step))
+#define Edge_Add(A, B) Sse_Edge_Add((A), (B))
+#define Edge_Outside_Bits(A, B, C) Sse_Edge_Outside_Bits((A), (B), (C))
+#define Color_Set1(Value) _mm_set1_ps(Value)
+#define Color_Ramp(Value) _mm_add_ps(_mm_set1_ps(Value), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f))
+#define Color_Add(A, B) _mm_add_ps((A), (B))
+#define Color_Mul(A, B) _mm_mul_ps((A), (B))
+#define Pixel_Set1(Value) _mm_set1_epi32((int)(Value))
+#define Pixel_Load(Pointer) _mm_loadu_si128((__m128i *)(Pointer))
+#define Pixel_Store(Pointer, Value) _mm_storeu_si128((__m128i *)(Pointer), (Value))
+#define Pixel_Pack(R, G, B, A) Sse_Pixel_Pack((R), (G), (B), (A))
+#define Pixel_Select(Mask, New, Old) Sse_Pixel_Select((Mask), (New), (Old))
+#define Pixel_Blend(Source, Dest) Sse_Pixel_Blend((Source), (Dest))
+#include "software_kernels.h"
+
+// NOTE: AVX2 holds all four edge values in one register. Colors stay four
+// wide, and FMA is left off so every level rounds the same way.
+static inline __attribute__((target("avx2"))) __m256i Avx2_Edge_Ramp(s64 Value, s64 Step)
+{
+   __m256i Result = _mm256_set_epi64x(Value + 3*Step, Value + 2*Step, Value + Step, Value);
+   return(Result);
+}
+
+static inline __attribute__((target("avx2"))) int Avx2_Edge_Outside_Bits(__m256i A, __m256i B, __m256i C)
+{
+   __m256i Combined = _mm256_or_si256(_mm256_or_si256(A, B), C);
+   int Result = _mm256_movemask_pd(_mm256_castsi256_pd(Combined));
+   return(Result);
+}
+
+#define SOFTWARE_KERNEL(Name) Name##_Avx2
+#define SOFTWARE_TARGET __attribute__((target("avx2")))
+#define EDGE_LANE __m256i
+#define COLOR_LANE __m128
+#define PIXEL_LANE __m128i
+#define Edge_Set1(Value) _mm256_set1_epi64x(Value)
+#define Edge_Ramp(Value, Step) Avx2_Edge_Ramp((Value), (Step))
+#define Edge_Add(A, B) _mm256_add_epi64((A), (B))
+#define Edge_Outside_Bits(A, B, C) Avx2_Edge_Outside_Bits((A), (B), (C))
+#define Color_Set1(Value) _mm_set1_ps(Value)
+#define Color_Ramp(Value) _mm_add_ps(_mm_set1_ps(Value), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f))
+#define Color_Add(A, B) _mm_add_ps((A), (B))
+#define Color_Mul(A, B) _mm_mul_ps((A), (B))
+#define Pixel_Set1(Value) _mm_set1_epi32((int)(Value))
+#define Pixel_Load(Pointer) _mm_loadu_si128((__m128i *)(Pointer))
+#define Pixel_Store(Pointer, Value) _mm_storeu_si128((__m128i *)(Pointer), (Value))
+#define Pixel_Pack(R, G, B, A) Sse_Pixel_Pack((R), (G), (B), (A))
+#define Pixel_Select(Mask, New, Old) Sse_Pixel_Select((Mask), (New), (Old))
+#define Pixel_Blend(Source, Dest) Sse_Pixel_Blend((Source), (Dest))
+#include "software_kernels.h"
+#endif
+
+typedef void software_rasterizer(software_renderer *Software, software_triangle *Triangle, int Tile_X0, int Tile_Y0, int Tile_X1, int Tile_Y1);
+
+static software_rasterizer *Get_Software_Rasterizer(simd_level Level)
+{
+   software_rasterizer *Result = Rasterize_Triangle_Scalar;
+#if SHARED_MATH_X86
+   if(Level == Simd_Sse) Result = Rasterize_Triangle_Sse;
+   if(Level == Simd_Avx2) Result = Rasterize_Triangle_Avx2;
+#endif
+   return(Result);
+}
+
+typedef struct {
+   software_renderer *Software;
+   u32 Tile;
+} software_tile_job;
+
+static JOB_FUNCTION(Rasterize_Software_Tile)
+{
+   software_tile_job *Job = Data;
+   software_renderer *Software = Job->Software;
+
+   int X0 = (int)(Job->Tile % (u32)Software->Tiles_X)*SOFTWARE_TILE_SIZE;
+   int Y0 = (int)(Job->Tile / (u32)Software->Tiles_X)*SOFTWARE_TILE_SIZE;
+   int X1 = X0 + SOFTWARE_TILE_SIZE;
+   int Y1 = Y0 + SOFTWARE_TILE_SIZE;
+
+   if(Software->Clear_Pending)
+   {
+      for(int Y = Y0; Y < Y1; ++Y)
+      {
+         u32 *Row = Software->Pixels + (size)Y*Software->Pitch;
+         for(int X = X0; X < X1; ++X)
+         {
+            Row[X] = Software->Clear_Color;
+         }
+      }
+   }
+
+   software_rasterizer *Rasterize = Get_Software_Rasterizer(Software->Simd_Level);
+   u32 *Entries = Software->Bin_Entries + Software->Bin_Offsets[Job->Tile];
+   for(u32 Index = 0; Index < Software->Bin_Counts[Job->Tile]; ++Index)
+   {
+      Rasterize(Software, Software->Triangles + Entries[Index], X0, Y0, X1, Y1);
+   }
+}
+
+static void Get_Software_Tile_Range(software_triangle *Triangle, int *Tile_X0, int *Tile_Y0, int *Tile_X1, int *Tile_Y1)
+{
+   *Tile_X0 = Triangle->Min_X / SOFTWARE_TILE_SIZE;
+   *Tile_Y0 = Triangle->Min_Y / SOFTWARE_TILE_SIZE;
+   *Tile_X1 = (Triangle->Max_X - 1) / SOFTWARE_TILE_SIZE + 1;
+   *Tile_Y1 = (Triangle->Max_Y - 1) / SOFTWARE_TILE_SIZE + 1;
+}
+
+// NOTE: Bins the batch's triangles in order, rasterizes every tile that has
+// anything to do, and starts the next batch empty.
+static void Rasterize_Software_Batch(software_renderer *Software)
+{
+   if(Software->Triangle_Count == 0 && !Software->Clear_Pending)
+   {
+      return;
+   }
+
+   u64 Start = Get_Clock();
+
+   u32 Tile_Count = (u32)(Software->Tiles_X*Software->Tiles_Y);
+   memset(Software->Bin_Counts, 0, Tile_Count*sizeof(u32));
+   for(u32 Index = 0; Index < Software->Triangle_Count; ++Index)
+   {
+      int Tile_X0, Tile_Y0, Tile_X1, Tile_Y1;
+      Get_Software_Tile_Range(Software->Triangles + Index, &Tile_X0, &Tile_Y0, &Tile_X1, &Tile_Y1);
+      for(int Tile_Y = Tile_Y0; Tile_Y < Tile_Y1; ++Tile_Y)
+      {
+         for(int Tile_X = Tile_X0; Tile_X < Tile_X1; ++Tile_X)
+         {
+            Software->Bin_Counts[Tile_Y*Software->Tiles_X + Tile_X]++;
+         }
+      }
+   }
+
+   u32 Total = 0;
+   for(u32 Tile = 0; Tile < Tile_Count; ++Tile)
+   {
+      Software->Bin_Offsets[Tile] = Total;
+      Total += Software->Bin_Counts[Tile];
+   }
+   Assert(Total == Software->Bin_Entry_Count);
+
+   // NOTE: Counts are rebuilt as the bins fill, which leaves each tile's
+   // triangles in submission order.
+   memset(Software->Bin_Counts, 0, Tile_Count*sizeof(u32));
+   for(u32 Index = 0; Index < Software->Triangle_Count; ++Index)
+   {
+      int Tile_X0, Tile_Y0, Tile_X1, Tile_Y1;
+      Get_Software_Tile_Range(Software->Triangles + Index, &Tile_X0, &Tile_Y0, &Tile_X1, &Tile_Y1);
+      for(int Tile_Y = Tile_Y0; Tile_Y < Tile_Y1; ++Tile_Y)
+      {
+         for(int Tile_X = Tile_X0; Tile_X < Tile_X1; ++Tile_X)
+         {
+            u32 Tile = (u32)(Tile_Y*Software->Tiles_X + Tile_X);
+            Software->Bin_Entries[Software->Bin_Offsets[Tile] + Software->Bin_Counts[Tile]++] = Index;
+         }
+      }
+   }
+
+   // NOTE: The job system takes a pointer per job, so the tile jobs live in
+   // the frame arena only as long as the wait below.
+   arena *Frame = Software->Frame;
+   temporary_memory Temporary = Begin_Temporary_Memory(Frame);
+   software_tile_job *Jobs = Push_Array(Frame, Tile_Count, software_tile_job);
+
+   job_counter Counter = {0};
+   for(u32 Tile = 0; Tile < Tile_Count; ++Tile)
+   {
+      if(Software->Clear_Pending || Software->Bin_Counts[Tile] > 0)
+      {
+         Jobs[Tile].Software = Software;
+         Jobs[Tile].Tile = Tile;
+         Start_Job(Rasterize_Software_Tile, Jobs + Tile, &Counter);
+         Software->Stats.Tiles_Rasterized++;
+      }
+   }
+   Wait_For_Jobs(&Counter);
+   End_Temporary_Memory(Temporary);
+
+   Software->Stats.Triangles += Software->Triangle_Count;
+   Software->Stats.Bin_Entries += Software->Bin_Entry_Count;
+   Software->Stats.Batches++;
+
+   Software->Clear_Pending = false;
+   Software->Triangle_Count = 0;
+   Software->Bin_Entry_Count = 0;
+
+   Software->Stats.Raster_Time += Get_Clock() - Start;
+}
+
+typedef struct {
+   float X;
+   float Y;
+   vec4 Color;
+} software_vertex; // NOTE: In window coordinates.
+
+static void Setup_Software_Triangle(software_renderer *Software, software_vertex *V0, software_vertex *V1, software_vertex *V2, bool Blend)
+{
+   // NOTE: Without a clipper, vertices far enough out would overflow the
+   // edge functions, so their triangles are dropped instead.
+   float Guard = (float)SOFTWARE_GUARD_BAND;
+   software_vertex *Vertices[3] = {V0, V1, V2};
+   for(int Index = 0; Index < 3; ++Index)
+   {
+      software_vertex *Vertex = Vertices[Index];
+      if(!(Vertex->X >= -Guard && Vertex->X <= (float)Software->Width + Guard &&
+           Vertex->Y >= -Guard && Vertex->Y <= (float)Software->Height + Guard))
+      {
+         Software->Stats.Triangles_Dropped++;
+         return;
+      }
+   }
+
+   float Scale = (float)(1 << SOFTWARE_SUBPIXEL_BITS);
+   s32 X[3], Y[3];
+   for(int Index = 0; Index < 3; ++Index)
+   {
+      X[Index] = (s32)lrintf(Vertices[Index]->X*Scale);
+      Y[Index] = (s32)lrintf(Vertices[Index]->Y*Scale);
+   }
+
+   // NOTE: Counter-clockwise from here on, so the inside of every edge is
+   // where its function is positive. Nothing is culled by winding.
+   s64 Area = (s64)(X[1] - X[0])*(Y[2] - Y[0]) - (s64)(X[2] - X[0])*(Y[1] - Y[0]);
+   if(Area == 0)
+   {
+      Software->Stats.Triangles_Dropped++;
+      return;
+   }
+   if(Area < 0)
+   {
+      s32 Swap_X = X[1]; X[1] = X[2]; X[2] = Swap_X;
+      s32 Swap_Y = Y[1]; Y[1] = Y[2]; Y[2] = Swap_Y;
+      software_vertex *Swap = Vertices[1]; Vertices[1] = Vertices[2]; Vertices[2] = Swap;
+      Area = -Area;
+   }
+
+   // NOTE: Pixels are covered when their center is, so the box is rounded
+   // inwards from the subpixel extent, then clipped to the viewport.
+   s32 Half = 1 << (SOFTWARE_SUBPIXEL_BITS - 1);
+   s32 Min_X = X[0], Max_X = X[0], Min_Y = Y[0], Max_Y = Y[0];
+   for(int Index = 1; Index < 3; ++Index)
+   {
+      if(X[Index] < Min_X) Min_X = X[Index];
+      if(X[Index] > Max_X) Max_X = X[Index];
+      if(Y[Index] < Min_Y) Min_Y = Y[Index];
+      if(Y[Index] > Max_Y) Max_Y = Y[Index];
+   }
+
+   int *Viewport = Software->Viewport;
+   s32 Clip_X0 = (Viewport[0] > 0) ? Viewport[0] : 0;
+   s32 Clip_Y0 = (Viewport[1] > 0) ? Viewport[1] : 0;
+   s32 Clip_X1 = (Viewport[0] + Viewport[2] < Software->Width) ? Viewport[0] + Viewport[2] : Software->Width;
+   s32 Clip_Y1 = (Viewport[1] + Viewport[3] < Software->Height) ? Viewport[1] + Viewport[3] : Software->Height;
+
+   software_triangle Triangle = {0};
+   Triangle.Min_X = (Min_X - Half + (1 << SOFTWARE_SUBPIXEL_BITS) - 1) >> SOFTWARE_SUBPIXEL_BITS;
+   Triangle.Min_Y = (Min_Y - Half + (1 << SOFTWARE_SUBPIXEL_BITS) - 1) >> SOFTWARE_SUBPIXEL_BITS;
+   Triangle.Max_X = ((Max_X - Half) >> SOFTWARE_SUBPIXEL_BITS) + 1;
+   Triangle.Max_Y = ((Max_Y - Half) >> SOFTWARE_SUBPIXEL_BITS) + 1;
+   if(Triangle.Min_X < Clip_X0) Triangle.Min_X = Clip_X0;
+   if(Triangle.Min_Y < Clip_Y0) Triangle.Min_Y = Clip_Y0;
+   if(Triangle.Max_X > Clip_X1) Triangle.Max_X = Clip_X1;
+   if(Triangle.Max_Y > Clip_Y1) Triangle.Max_Y = Clip_Y1;
+   if(Triangle.Min_X >= Triangle.Max_X || Triangle.Min_Y >= Triangle.Max_Y)
+   {
+      return;
+   }
+
+   // NOTE: The fill rule takes pixels exactly on an edge only for left edges
+   // (going down, counter-clockwise) and bottom ones (going right), which is
+   // D3D's top-left rule with Y pointing up, as llvmpipe does it.
+   for(int Edge = 0; Edge < 3; ++Edge)
+   {
+      int From = (Edge + 1) % 3;
+      int To = (Edge + 2) % 3;
+      s32 A = Y[From] - Y[To];
+      s32 B = X[To] - X[From];
+      s64 C = -(s64)A*X[From] - (s64)B*Y[From];
+
+      bool Inclusive = (A > 0 || (A == 0 && B > 0));
+      Triangle.A[Edge] = A;
+      Triangle.B[Edge] = B;
+      Triangle.C[Edge] = (Inclusive) ? C : C - 1;
+   }
+
+   // NOTE: Colors are planes through the snapped vertices, in pixel units.
+   float X0 = (float)X[0] / Scale, Y0 = (float)Y[0] / Scale;
+   float X1 = (float)X[1] / Scale - X0, Y1 = (float)Y[1] / Scale - Y0;
+   float X2 = (float)X[2] / Scale - X0, Y2 = (float)Y[2] / Scale - Y0;
+   float Inverse_Area = (Scale*Scale) / (float)Area;
+
+   float *C0 = &Vertices[0]->Color.R;
+   float *C1 = &Vertices[1]->Color.R;
+   float *C2 = &Vertices[2]->Color.R;
+   Triangle.Flat = true;
+   for(int Channel = 0; Channel < 4; ++Channel)
+   {
+      float D1 = C1[Channel] - C0[Channel];
+      float D2 = C2[Channel] - C0[Channel];
+      if(D1 != 0.0f || D2 != 0.0f)
+      {
+         Triangle.Flat = false;
+         Triangle.Color_Dx[Channel] = (D1*Y2 - D2*Y1)*Inverse_Area;
+         Triangle.Color_Dy[Channel] = (D2*X1 - D1*X2)*Inverse_Area;
+      }
+      Triangle.Color[Channel] = C0[Channel] - Triangle.Color_Dx[Channel]*X0 - Triangle.Color_Dy[Channel]*Y0;
+   }
+   if(Triangle.Flat)
+   {
+      Triangle.Flat_Color = Pack_Software_Color(C0[0], C0[1], C0[2], C0[3]);
+   }
+   Triangle.Blend = Blend;
+
+   int Tile_X0, Tile_Y0, Tile_X1, Tile_Y1;
+   Get_Software_Tile_Range(&Triangle, &Tile_X0, &Tile_Y0, &Tile_X1, &Tile_Y1);
+   u64 Entry_Count = (u64)(Tile_X1 - Tile_X0)*(u64)(Tile_Y1 - Tile_Y0);
+   if(Software->Triangle_Count == SOFTWARE_MAX_TRIANGLES ||
+      Software->Bin_Entry_Count + Entry_Count > SOFTWARE_MAX_BIN_ENTRIES)
+   {
+      Rasterize_Software_Batch(Software);
+   }
+
+   Software->Triangles[Software->Triangle_Count++] = Triangle;
+   Software->Bin_Entry_Count += Entry_Count;
+}
+
+// NOTE: Returns the bytes [Offset, Offset + Size) of a GL buffer, read back
+// once per frame, or 0 if the frame's geometry memory is used up.
+static u8 *Fetch_Software_Buffer(software_renderer *Software, GLuint Buffer, size Offset, size Size)
+{
+   u8 *Result = 0;
+   for(u32 Index = 0; Index < Software->Fetched_Count; ++Index)
+   {
+      software_fetched_buffer *Fetched = Software->Fetched + Index;
+      if(Fetched->Buffer == Buffer && Fetched->Offset == Offset && Fetched->Size >= Size)
+      {
+         Result = Fetched->Data;
+         break;
+      }
+   }
+
+   arena *Geometry = &Software->Geometry;
+   if(!Result && Software->Fetched_Count < SOFTWARE_MAX_FETCHED_BUFFERS &&
+      Geometry->Used + Size + 16 <= Geometry->Size)
+   {
+      Result = Push_Size(Geometry, Size);
+
+      // NOTE: The copy binding isn't tracked by the state cache, and has no
+      // other users.
+      glBindBuffer(GL_COPY_READ_BUFFER, Buffer);
+      glGetBufferSubData(GL_COPY_READ_BUFFER, Offset, Size, Result);
+      glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+      software_fetched_buffer *Fetched = Software->Fetched + Software->Fetched_Count++;
+      Fetched->Buffer = Buffer;
+      Fetched->Offset = Offset;
+      Fetched->Size = Size;
+      Fetched->Data = Result;
+      Software->Stats.Bytes_Fetched += (u64)Size;
+   }
+
+   return(Result);
+}
+
+static vec4 Decode_Software_Attribute(u8 *Vertex, vertex_attribute *Attribute)
+{
+   // NOTE: Missing components default to (0, 0, 0, 1), as in GL.
+   float Values[4] = {0, 0, 0, 1};
+   u8 *Source = Vertex + Attribute->Offset;
+   for(u32 Index = 0; Index < Attribute->Component_Count && Index < 4; ++Index)
+   {
+      switch(Attribute->Type)
+      {
+         case Vertex_Attribute_Float32:
+         {
+            memcpy(Values + Index, Source + Index*sizeof(float), sizeof(float));
+         } break;
+
+         case Vertex_Attribute_Float16:
+         {
+            u16 Half;
+            memcpy(&Half, Source + Index*sizeof(u16), sizeof(u16));
+            Values[Index] = Half_To_Float(Half);
+         } break;
+
+         case Vertex_Attribute_Unorm8:
+         {
+            Values[Index] = (float)Source[Index] / 255.0f;
+         } break;
+
+         default: break;
+      }
+   }
+
+   vec4 Result = {Values[0], Values[1], Values[2], Values[3]};
+   return(Result);
+}
+
+typedef struct {
+   bool Has_Instance;
+   opengl_instance Instance;
+   bool Uses_Camera;
+   bool Blend;
+} software_draw_state;
+
+// NOTE: The vertex shader, in the same order of operations, followed by the
+// viewport transform.
+static software_vertex Shade_Software_Vertex(opengl_context *GL, software_renderer *Software, software_draw_state *State, vec4 Position, vec4 Color)
+{
+   static vec4 Material_Tints[4] =
+   {
+      {1.0f, 1.0f, 1.0f, 1.0f},
+      {1.0f, 0.5f, 0.5f, 1.0f},
+      {0.5f, 1.0f, 0.5f, 1.0f},
+      {0.5f, 0.5f, 1.0f, 1.0f},
+   };
+
+   float X = Position.R;
+   float Y = Position.G;
+   if(State->Has_Instance)
+   {
+      opengl_instance *Instance = &State->Instance;
+      vec4 Tint = Material_Tints[Instance->Material % 4];
+      X = (Instance->Offset.X + Position.R*Instance->Basis_X.X) + Position.G*Instance->Basis_Y.X;
+      Y = (Instance->Offset.Y + Position.R*Instance->Basis_X.Y) + Position.G*Instance->Basis_Y.Y;
+      Color.R = Color.R*Instance->Color.R*Tint.R;
+      Color.G = Color.G*Instance->Color.G*Tint.G;
+      Color.B = Color.B*Instance->Color.B*Tint.B;
+      Color.A = Color.A*Instance->Color.A*Tint.A;
+   }
+   if(State->Uses_Camera)
+   {
+      X = X*GL->Camera_Scale.X + GL->Camera_Offset.X;
+      Y = Y*GL->Camera_Scale.Y + GL->Camera_Offset.Y;
+   }
+
+   float Half_Width = 0.5f*(float)Software->Viewport[2];
+   float Half_Height = 0.5f*(float)Software->Viewport[3];
+   // NOTE: Fused, as llvmpipe does it. Rounding twice moves the odd vertex
+   // across a pixel center.
+   software_vertex Result;
+   Result.X = fmaf(X, Half_Width, ((float)Software->Viewport[0] + Half_Width));
+   Result.Y = fmaf(Y, Half_Height, ((float)Software->Viewport[1] + Half_Height));
+   Result.Color = Color;
+   return(Result);
+}
+
+// NOTE: Draws Count vertices (or indices, when Indices is set) from First as
+// a triangle list. Only the vertices the draw references are shaded, each
+// once.
+static void Draw_Software_Triangles(opengl_context *GL, software_renderer *Software, software_draw_state *State,
+                                    u8 *Vertices, vertex_layout *Layout, u32 Vertex_Count,
+                                    void *Indices, GLenum Index_Type, u32 First, u32 Count, s32 Base_Vertex)
+{
+   vertex_attribute *Position_Attribute = 0;
+   vertex_attribute *Color_Attribute = 0;
+   for(u32 Index = 0; Index < Layout->Attribute_Count; ++Index)
+   {
+      vertex_attribute *Attribute = Layout->Attributes + Index;
+      if(Attribute->Location == 0) Position_Attribute = Attribute;
+      if(Attribute->Location == 1) Color_Attribute = Attribute;
+   }
+
+   Count -= Count % 3;
+   if(!Position_Attribute || Count == 0)
+   {
+      return;
+   }
+
+   s64 Min_Vertex = First;
+   s64 Max_Vertex = (s64)First + Count - 1;
+   if(Indices)
+   {
+      Min_Vertex = 0xFFFFFFFF;
+      Max_Vertex = 0;
+      for(u32 Index = First; Index < First + Count; ++Index)
+      {
+         u32 Value = (Index_Type == GL_UNSIGNED_INT) ? ((u32 *)Indices)[Index] : ((u16 *)Indices)[Index];
+         if(Value < Min_Vertex) Min_Vertex = Value;
+         if(Value > Max_Vertex) Max_Vertex = Value;
+      }
+      Min_Vertex += Base_Vertex;
+      Max_Vertex += Base_Vertex;
+   }
+   if(Min_Vertex < 0 || Max_Vertex >= Vertex_Count)
+   {
+      Software->Stats.Triangles_Dropped += Count / 3;
+      return;
+   }
+
+   arena *Geometry = &Software->Geometry;
+   temporary_memory Temporary = Begin_Temporary_Memory(Geometry);
+   u32 Shaded_Count = (u32)(Max_Vertex - Min_Vertex + 1);
+   if(Geometry->Used + (size)(Shaded_Count*sizeof(software_vertex)) + 16 <= Geometry->Size)
+   {
+      software_vertex *Shaded = Push_Array(Geometry, Shaded_Count, software_vertex);
+      vec4 White = {1, 1, 1, 1};
+      for(u32 Index = 0; Index < Shaded_Count; ++Index)
+      {
+         u8 *Vertex = Vertices + (Min_Vertex + Index)*Layout->Stride;
+         vec4 Position = Decode_Software_Attribute(Vertex, Position_Attribute);
+         vec4 Color = (Color_Attribute) ? Decode_Software_Attribute(Vertex, Color_Attribute) : White;
+         Shaded[Index] = Shade_Software_Vertex(GL, Software, State, Position, Color);
+      }
+
+      for(u32 Index = First; Index < First + Count; Index += 3)
+      {
+         s64 Corners[3];
+         for(int Corner = 0; Corner < 3; ++Corner)
+         {
+            if(!Indices)
+            {
+               Corners[Corner] = Index + Corner;
+            }
+            else if(Index_Type == GL_UNSIGNED_INT)
+            {
+               Corners[Corner] = (s64)((u32 *)Indices)[Index + Corner] + Base_Vertex;
+            }
+            else
+            {
+               Corners[Corner] = (s64)((u16 *)Indices)[Index + Corner] + Base_Vertex;
+            }
+         }
+         Setup_Software_Triangle(Software, Shaded + (Corners[0] - Min_Vertex), Shaded + (Corners[1] - Min_Vertex), Shaded + (Corners[2] - Min_Vertex), State->Blend);
+      }
+   }
+   else
+   {
+      Software->Stats.Triangles_Dropped += Count / 3;
+   }
+   End_Temporary_Memory(Temporary);
+}
+
+static void Draw_Software_Mesh(opengl_context *GL, software_renderer *Software, software_draw_state *State, opengl_mesh *Mesh, u32 Lod)
+{
+   u8 *Vertices = Fetch_Software_Buffer(Software, Mesh->VBO, 0, (size)Mesh->Vertex_Count*Mesh->Layout->Stride);
+   if(!Vertices)
+   {
+      Software->Stats.Draws_Unsupported++;
+      return;
+   }
+
+   if(Mesh->Index_Count > 0)
+   {
+      size Index_Size = (Mesh->Index_Type == GL_UNSIGNED_INT) ? sizeof(u32) : sizeof(u16);
+      u8 *Indices = Fetch_Software_Buffer(Software, Mesh->EBO, 0, (size)Mesh->Index_Count*Index_Size);
+      if(Indices)
+      {
+         opengl_mesh_lod *Range = Mesh->Lods + Lod;
+         Draw_Software_Triangles(GL, Software, State, Vertices, Mesh->Layout, Mesh->Vertex_Count,
+                                 Indices, Mesh->Index_Type, Range->First_Index, Range->Index_Count, 0);
+      }
+      else
+      {
+         Software->Stats.Draws_Unsupported++;
+      }
+   }
+   else
+   {
+      Draw_Software_Triangles(GL, Software, State, Vertices, Mesh->Layout, Mesh->Vertex_Count, 0, 0, 0, Mesh->Vertex_Count, 0);
+   }
+}
+
+static void Draw_Software_Indirect_Batch(opengl_context *GL, software_renderer *Software, software_draw_state *State, opengl_indirect_batch *Batch)
+{
+   opengl_mesh_pool *Pool = Batch->Pool;
+   u8 *Vertices = Fetch_Software_Buffer(Software, Pool->VBO, 0, (size)Pool->Vertex_Count*Pool->Layout->Stride);
+   u8 *Indices = Fetch_Software_Buffer(Software, Pool->EBO, 0, (size)Pool->Index_Count*Pool->Index_Size);
+   if(!Vertices || !Indices)
+   {
+      Software->Stats.Draws_Unsupported++;
+      return;
+   }
+
+   for(u32 Index = 0; Index < Batch->Count; ++Index)
+   {
+      opengl_draw_command *Command = Batch->Commands + Index;
+      for(u32 Instance = 0; Instance < Command->Instance_Count; ++Instance)
+      {
+         State->Instance = Batch->Instances[Command->Base_Instance + Instance];
+         Draw_Software_Triangles(GL, Software, State, Vertices, Pool->Layout, Pool->Vertex_Count,
+                                 Indices, Pool->Index_Type, Command->First_Index, Command->Index_Count, Command->Base_Vertex);
+      }
+   }
+}
+
+static void Set_Software_Framebuffer_Size(software_renderer *Software, int Width, int Height)
+{
+   Software->Width = Width;
+   Software->Height = Height;
+   Software->Tiles_X = (Width + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+   Software->Tiles_Y = (Height + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+   Software->Pitch = Software->Tiles_X*SOFTWARE_TILE_SIZE;
+
+   Software->Viewport[0] = 0;
+   Software->Viewport[1] = 0;
+   Software->Viewport[2] = Width;
+   Software->Viewport[3] = Height;
+}
+
+static void Allocate_Software_Framebuffer(software_renderer *Software, arena *Arena, int Width, int Height)
+{
+   Set_Software_Framebuffer_Size(Software, Width, Height);
+
+   size Tile_Count = (size)Software->Tiles_X*Software->Tiles_Y;
+   Software->Pixels = Push_Array(Arena, Tile_Count*SOFTWARE_TILE_SIZE*SOFTWARE_TILE_SIZE, u32);
+   Software->Bin_Counts = Push_Array(Arena, Tile_Count, u32);
+   Software->Bin_Offsets = Push_Array(Arena, Tile_Count, u32);
+   Software->Tile_Capacity = Tile_Count;
+}
+
+static INITIALIZE_SOFTWARE(Initialize_Software)
+{
+   arena *Arena = &Memory->Permanent;
+   Software->Frame = &Memory->Frame;
+   Software->Simd_Level = Get_Simd_Level();
+
+   Software->Triangles = Push_Array(Arena, SOFTWARE_MAX_TRIANGLES, software_triangle);
+   Software->Bin_Entries = Push_Array(Arena, SOFTWARE_MAX_BIN_ENTRIES, u32);
+   Initialize_Arena(&Software->Geometry, Push_Size(Arena, SOFTWARE_GEOMETRY_SIZE), SOFTWARE_GEOMETRY_SIZE);
+
+   Allocate_Software_Framebuffer(Software, Arena, Width, Height);
+}
+
+static RESIZE_SOFTWARE(Resize_Software)
+{
+   // NOTE: A smaller framebuffer reuses the old memory with a tighter pitch,
+   // so its pixels are garbage until the next clear either way.
+   size Tile_Count = (size)((Width + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE)*((Height + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE);
+   if(Tile_Count > Software->Tile_Capacity)
+   {
+      Allocate_Software_Framebuffer(Software, &Memory->Permanent, Width, Height);
+   }
+   else
+   {
+      Set_Software_Framebuffer_Size(Software, Width, Height);
+   }
+}
+
+static RENDER_WITH_SOFTWARE(Render_With_Software)
+{
+   PROFILE_BEGIN_CPU(&GL->Profiler, "Software");
+   u64 Start = Get_Clock();
+
+   // NOTE: Nothing reads the uniform stream here, so it's only closed.
+   End_Render_Recording(GL);
+   End_Opengl_Stream(&GL->Uniform_Stream);
+
+   software_stats Zero_Stats = {0};
+   Software->Stats = Zero_Stats;
+   Reset_Arena(&Software->Geometry);
+   Software->Fetched_Count = 0;
+
+   arena *Frame = Software->Frame;
+   temporary_memory Temporary = Begin_Temporary_Memory(Frame);
+
+   u32 Count = 0;
+   u32 Dropped = 0;
+   render_sort_entry *Entries = Sort_Render_Commands(&GL->Commands, Frame, &Count, &Dropped);
+   Software->Stats.Commands_Submitted = Count;
+   Software->Stats.Commands_Dropped = Dropped;
+
+   for(u32 Entry_Index = 0; Entry_Index < Count; ++Entry_Index)
+   {
+      render_sort_entry *Entry = Entries + Entry_Index;
+      render_command *Command = Entry->Command;
+
+      // NOTE: As in Apply_Render_Pass_State and Upload_Opengl_Uniforms.
+      u32 Pass = (u32)(Entry->Key >> RENDER_KEY_PASS_SHIFT) & RENDER_KEY_PASS_MASK;
+      software_draw_state State = {0};
+      State.Uses_Camera = (Pass != Render_Pass_Overlay);
+      State.Blend = (Pass == Render_Pass_Overlay);
+      State.Has_Instance = (Command->Material.Program != GL->Basic_Program);
+
+      // NOTE: Nothing here samples textures, so textured draws and text are
+      // left out.
+      bool Supported = (Command->Type == Render_Command_Clear ||
+                        Command->Type == Render_Command_Viewport ||
+                        (Command->Type != Render_Command_Draw_Text &&
+                         Command->Material.Program != GL->Textured_Program));
+      if(!Supported)
+      {
+         Software->Stats.Draws_Unsupported++;
+         continue;
+      }
+
+      switch(Command->Type)
+      {
+         case Render_Command_Clear:
+         {
+            // NOTE: Triangles already binned have to land before the clear.
+            if(Software->Triangle_Count > 0)
+            {
+               Rasterize_Software_Batch(Software);
+            }
+            vec4 Color = Command->Clear.Color;
+            Software->Clear_Pending = true;
+            Software->Clear_Color = Pack_Software_Color(Color.R, Color.G, Color.B, Color.A);
+         } break;
+
+         case Render_Command_Viewport:
+         {
+            render_command_viewport *Viewport = &Command->Viewport;
+            Software->Viewport[0] = Viewport->X;
+            Software->Viewport[1] = Viewport->Y;
+            Software->Viewport[2] = Viewport->Width;
+            Software->Viewport[3] = Viewport->Height;
+         } break;
+
+         case Render_Command_Draw_Mesh:
+         {
+            State.Instance = Command->Draw_Mesh.Instance;
+            Draw_Software_Mesh(GL, Software, &State, Command->Draw_Mesh.Mesh, Command->Draw_Mesh.Lod);
+         } break;
+
+         case Render_Command_Draw_Instances:
+         {
+            opengl_instance_batch *Batch = Command->Draw_Instances.Batch;
+            for(u32 Index = 0; Index < Batch->Count; ++Index)
+            {
+               State.Instance = Batch->Instances[Index];
+               Draw_Software_Mesh(GL, Software, &State, Batch->Mesh, 0);
+            }
+         } break;
+
+         case Render_Command_Draw_Indirect:
+         {
+            if(Command->Draw_Indirect.Batch->Count > 0)
+            {
+               Draw_Software_Indirect_Batch(GL, Software, &State, Command->Draw_Indirect.Batch);
+            }
+         } break;
+
+         case Render_Command_Draw_Stream:
+         {
+            u32 Vertex_Count = Command->Draw_Stream.Vertex_Count;
+            u8 *Vertices = Fetch_Software_Buffer(Software, GL->Vertex_Stream.Buffer, Command->Draw_Stream.Vertex_Base, (size)Vertex_Count*sizeof(vertex));
+            if(Vertices)
+            {
+               vertex_layout *Layout = Opengl_Vertex_Layouts + Mesh_Vertex_Format_Standard;
+               Draw_Software_Triangles(GL, Software, &State, Vertices, Layout, Vertex_Count, 0, 0, 0, Vertex_Count, 0);
+            }
+            else
+            {
+               Software->Stats.Draws_Unsupported++;
+            }
+         } break;
+
+         case Render_Command_Draw_Text: break;
+      }
+   }
+
+   Rasterize_Software_Batch(Software);
+   End_Temporary_Memory(Temporary);
+
+   Software->Stats.Setup_Time = (Get_Clock() - Start) - Software->Stats.Raster_Time;
+   PROFILE_END_CPU(&GL->Profiler, "Software");
+}
+
+static READ_SOFTWARE_PIXELS(Read_Software_Pixels)
+{
+   for(int Y = 0; Y < Software->Height; ++Y)
+   {
+      memcpy(Pixels + (size)Y*Software->Width*4, Software->Pixels + (size)Y*Software->Pitch, (size)Software->Width*4);
+   }
+}
@@ -0,0 +1,140 @@
+/* (c) copyright 2025 Lawrence D. Kern /////////////////////////////////////// */
+
+// NOTE: Software renderer API. This is a second backend for the render
+// commands recorded through opengl_renderer.h: Render_With_Software consumes
+// the same sorted command list as Render_With_Opengl, but rasterizes it on the
+// CPU into a framebuffer of its own, for machines where the only GL driver is
+// itself a software one.
+//
+// GL still owns every resource. Meshes, pools and the vertex stream live in
+// GL buffers, so the geometry a frame draws is read back with
+// glGetBufferSubData the first time it's used that frame (instances already
+// have CPU copies). That keeps the recording API and every asset path
+// unchanged, at the price of one copy per buffer per frame.
+//
+// Each batch of triangles is transformed and set up on the main thread, then
+// binned into SOFTWARE_TILE_SIZE square tiles, and the tiles are rasterized in
+// parallel on the job system. A tile walks its bin in command order, so
+// blending and overdraw come out the same as submitting the draws one by one.
+// When the triangle or bin storage fills up mid-frame, the batch so far is
+// rasterized and setup carries on with an empty one.
+//
+// Rasterization follows GL's rules closely enough to cross-check against
+// llvmpipe: window coordinates are snapped to SOFTWARE_SUBPIXEL_BITS of
+// subpixel precision, coverage is sampled at pixel centers with 64-bit integer
+// edge functions and a top-left fill rule, and colors are interpolated per
+// pixel and rounded to 8 bits. Coverage is exact; interpolated and blended
+// colors can still be a unit off, since the driver's float maths isn't ours.
+// Four pixels are tested and shaded at a time, with scalar, SSE and AVX2
+// variants of the kernel picked at runtime like the ones in shared_math.h.
+//
+// Only what the vertex and fragment shaders in shaders/ do without textures
+// is supported. Draws with the textured program are skipped and counted, and
+// so are triangles with a vertex beyond SOFTWARE_GUARD_BAND pixels of the
+// framebuffer, since there is no clipper.
+#define SOFTWARE_TILE_SIZE 64
+#define SOFTWARE_SUBPIXEL_BITS 8
+#define SOFTWARE_GUARD_BAND (1 << 14)
+#define SOFTWARE_MAX_TRIANGLES (64*1024)
+#define SOFTWARE_MAX_BIN_ENTRIES (1024*1024)
+#define SOFTWARE_MAX_FETCHED_BUFFERS 256
+#define SOFTWARE_GEOMETRY_SIZE (64*1024*1024)
+
+typedef struct {
+   // NOTE: Edge I is A[I]*X + B[I]*Y + C[I] at subpixel position (X, Y),
+   // biased by the fill rule so that a pixel is covered when all three are
+   // non-negative.
+   s64 C[3];
+   s32 A[3];
+   s32 B[3];
+
+   // NOTE: Covered pixels, clipped to the viewport; max is exclusive.
+   s32 Min_X;
+   s32 Min_Y;
+   s32 Max_X;
+   s32 Max_Y;
+
+   // NOTE: Color planes, as RGBA at the window origin and their steps per
+   // pixel in X and Y.
+   float Color[4];
+   float Color_Dx[4];
+   float Color_Dy[4];
+   u32 Flat_Color; // NOTE: Packed RGBA8, when Flat is set.
+
+   bool Flat;
+   bool Blend;
+} software_triangle;
+
+typedef struct {
+   GLuint Buffer;
+   size Offset;
+   size Size;
+   u8 *Data;
+} software_fetched_buffer;
+
+typedef struct {
+   u64 Triangles;
+   u64 Triangles_Dropped; // NOTE: Degenerate, or outside the guard band.
+   u64 Bin_Entries;
+   u32 Batches;
+   u32 Tiles_Rasterized;
+   u32 Draws_Unsupported;
+   u32 Commands_Submitted;
+   u32 Commands_Dropped; // NOTE: Didn't fit the frame arena.
+   u64 Bytes_Fetched;
+
+   u64 Setup_Time;
+   u64 Raster_Time;
+} software_stats;
+
+typedef struct {
+   int Width;
+   int Height;
+   int Pitch; // NOTE: In pixels. Both are rounded up to whole tiles.
+   int Tiles_X;
+   int Tiles_Y;
+   u32 *Pixels; // NOTE: RGBA8, bottom-up rows, like glReadPixels.
+   size Tile_Capacity;
+
+   simd_level Simd_Level;
+   arena *Frame; // NOTE: Scratch for sorting and the tile jobs.
+
+   // NOTE: The current batch. A clear is applied by each tile before its
+   // bin, and only ever ahead of every triangle in it.
+   bool Clear_Pending;
+   u32 Clear_Color;
+   u32 Triangle_Count;
+   software_triangle *Triangles;
+   u64 Bin_Entry_Count;
+   u32 *Bin_Entries;
+   u32 *Bin_Counts;
+   u32 *Bin_Offsets;
+
+   // NOTE: The viewport, in pixels.
+   int Viewport[4];
+
+   // NOTE: Buffers read back from GL this frame. Reset by every render.
+   arena Geometry;
+   u32 Fetched_Count;
+   software_fetched_buffer Fetched[SOFTWARE_MAX_FETCHED_BUFFERS];
+
+   software_stats Stats;
+} software_renderer;
+
+#define INITIALIZE_SOFTWARE(Name) void Name(software_renderer *Software, platform_memory *Memory, int Width, int Height)
+static INITIALIZE_SOFTWARE(Initialize_Software);
+
+// NOTE: Growing the framebuffer takes new memory from the permanent arena,
+// so resizes should be rare.
+#define RESIZE_SOFTWARE(Name) void Name(software_renderer *Software, platform_memory *Memory, int Width, int Height)
+static RESIZE_SOFTWARE(Resize_Software);
+
+// NOTE: Renders the frame recorded since Begin_Opengl_Frame. A frame can be
+// rendered by both backends, to compare them, as long as Render_With_Opengl
+// goes first.
+#define RENDER_WITH_SOFTWARE(Name) void Name(opengl_context *GL, software_renderer *Software)
+static RENDER_WITH_SOFTWARE(Render_With_Software);
+
+// NOTE: Copies the framebuffer out as tightly packed RGBA8 rows, bottom-up.
+#define READ_SOFTWARE_PIXELS(Name) void Name(software_renderer *Software, u8 *Pixels)
+static READ_SOFTWARE_PIXELS(Read_Software_Pixels);